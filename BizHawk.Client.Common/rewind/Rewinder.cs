@@ -2,6 +2,7 @@
 using System.IO;
 
 using BizHawk.Common;
+using BizHawk.Emulation.Common;
 using BizHawk.Emulation.Common.IEmulatorExtensions;
 
 namespace BizHawk.Client.Common
@@ -19,6 +20,9 @@ namespace BizHawk.Client.Common
 		private bool _lastRewindLoadedState;
 		private byte[] _deltaBuffer = new byte[0];
 
+		// cores that can make cheaper rewind states than full savestates; null to use IStatable
+		private IRewindStatable _rewindStatable;
+
 		public Action<string> MessageCallback { get; set; }
 
 		public bool RewindActive => RewindEnabled && !SuspendRewind;
@@ -75,6 +79,13 @@ namespace BizHawk.Client.Common
 				_rewindBuffer = new StreamBlobDatabase(Global.Config.Rewind_OnDisk, capacity, BufferManage);
 
 				_rewindThread = new RewindThreader(CaptureInternal, RewindInternal, Global.Config.Rewind_IsThreaded);
+
+				// rewind states only stay loadable until the next reset, so only reset once the old buffer and thread are gone
+				if (Global.Emulator.HasRewindStates())
+				{
+					_rewindStatable = Global.Emulator.AsRewindStatable();
+					_rewindStatable.ResetRewindStates();
+				}
 			}
 		}
 
@@ -94,6 +105,7 @@ namespace BizHawk.Client.Common
 
 			Clear();
 
+			_rewindStatable = null;
 			RewindEnabled = false;
 			RewindFrequency = 0;
 		}
@@ -161,7 +173,9 @@ namespace BizHawk.Client.Common
 				return;
 			}
 
-			_rewindThread.Capture(Global.Emulator.AsStatable().SaveStateBinary());
+			_rewindThread.Capture(_rewindStatable != null
+				? _rewindStatable.SaveRewindState()
+				: Global.Emulator.AsStatable().SaveStateBinary());
 		}
 
 		private void CaptureInternal(byte[] coreSavestate)
@@ -377,7 +391,7 @@ namespace BizHawk.Client.Common
 
 					using (var lastStateReader = new BinaryReader(new MemoryStream(_lastState)))
 					{
-						Global.Emulator.AsStatable().LoadStateBinary(lastStateReader);
+						LoadState(lastStateReader);
 					}
 				}
 				else
@@ -387,9 +401,21 @@ namespace BizHawk.Client.Common
 						throw new InvalidOperationException();
 					}
 
-					Global.Emulator.AsStatable().LoadStateBinary(reader);
+					LoadState(reader);
 				}
 			}
 		}
+
+		private void LoadState(BinaryReader reader)
+		{
+			if (_rewindStatable != null)
+			{
+				_rewindStatable.LoadRewindState(reader);
+			}
+			else
+			{
+				Global.Emulator.AsStatable().LoadStateBinary(reader);
+			}
+		}
 	}
 }
@@ -44,6 +44,22 @@ namespace BizHawk.Common.BizInvoke
 
 		public byte[] XorHash { get; private set; }
 
+		/// <summary>
+		/// one DirtyTracker state byte per page, or zero if SaveDirtyBase() has never been called
+		/// </summary>
+		private IntPtr _dirtyState;
+
+		/// <summary>
+		/// contents of each page as of the last SaveDirtyBase(), copied there by the write fault handler just before the
+		/// first write to the page.  the whole block is committed, but only the pages actually written are ever touched
+		/// </summary>
+		private UIntPtr _dirtyBase;
+
+		/// <summary>
+		/// our range's index in the DirtyTracker table, or -1 if not registered
+		/// </summary>
+		private int _dirtySlot = -1;
+
 		/// <summary>
 		/// get a page index within the block
 		/// </summary>
@@ -109,6 +125,8 @@ namespace BizHawk.Common.BizInvoke
 				throw new InvalidOperationException("MapViewOfFileEx() returned NULL");
 			}
 			ProtectAll();
+			if (_dirtyState != IntPtr.Zero)
+				_dirtySlot = DirtyTracker.Register(Start, End, _dirtyState, _dirtyBase);
 			Active = true;
 		}
 
@@ -119,6 +137,11 @@ namespace BizHawk.Common.BizInvoke
 		{
 			if (!Active)
 				throw new InvalidOperationException("Not active");
+			if (_dirtySlot != -1)
+			{
+				DirtyTracker.Unregister(_dirtySlot);
+				_dirtySlot = -1;
+			}
 			if (!Kernel32.UnmapViewOfFile(Z.US(Start)))
 				throw new InvalidOperationException("UnmapViewOfFile() returned NULL");
 			Active = false;
@@ -203,6 +226,151 @@ namespace BizHawk.Common.BizInvoke
 			return ret;
 		}
 
+		/// <summary>
+		/// start tracking writes to the block against its current contents.  from here on, the first write to each page
+		/// saves the page's old contents and marks it dirty, and SaveDirtyPages and LoadDirtyPages only touch dirty pages.
+		/// calling this again makes the current contents the new base
+		/// </summary>
+		public unsafe void SaveDirtyBase()
+		{
+			if (!Active)
+				throw new InvalidOperationException("Not active");
+
+			if (_dirtyState == IntPtr.Zero)
+			{
+				_dirtyBase = Kernel32.VirtualAlloc(UIntPtr.Zero, Z.UU(Size),
+					Kernel32.AllocationType.RESERVE | Kernel32.AllocationType.COMMIT, Kernel32.MemoryProtection.READWRITE);
+				if (_dirtyBase == UIntPtr.Zero)
+					throw new InvalidOperationException("VirtualAlloc() returned NULL");
+				_dirtyState = Marshal.AllocHGlobal(_pageData.Length);
+			}
+			else
+			{
+				// drop the old copies, so that only pages written from now on take up any memory
+				if (!Kernel32.VirtualFree(_dirtyBase, Z.UU(Size), Kernel32.FreeType.DECOMMIT)
+					|| Kernel32.VirtualAlloc(_dirtyBase, Z.UU(Size), Kernel32.AllocationType.COMMIT, Kernel32.MemoryProtection.READWRITE) != _dirtyBase)
+				{
+					throw new InvalidOperationException("Couldn't reset the dirty base");
+				}
+			}
+
+			var s = (byte*)_dirtyState;
+			for (int i = 0; i < _pageData.Length; i++)
+				s[i] = _pageData[i] == Protection.RW ? DirtyTracker.Writable : (byte)0;
+			if (_dirtySlot == -1)
+				_dirtySlot = DirtyTracker.Register(Start, End, _dirtyState, _dirtyBase);
+			ProtectAll();
+		}
+
+		/// <summary>
+		/// write out every page in part of the block that has been written to and no longer matches the dirty base.
+		/// Does not check for or change Protect()!
+		/// </summary>
+		public unsafe void SaveDirtyPages(BinaryWriter bw, ulong start, ulong length)
+		{
+			if (_dirtyState == IntPtr.Zero)
+				throw new InvalidOperationException("No dirty base taken!");
+			if (!WaterboxUtils.Aligned(start) || !WaterboxUtils.Aligned(length))
+				throw new ArgumentOutOfRangeException();
+			if (length == 0)
+			{
+				bw.Write(0);
+				return;
+			}
+			int pstart = GetPage(start);
+			int pend = GetPage(start + length - 1);
+			int psize = WaterboxUtils.PageSize;
+
+			var s = (byte*)_dirtyState;
+			var dirty = new List<int>();
+			for (int i = pstart; i <= pend; i++)
+			{
+				if ((s[i] & DirtyTracker.Dirty) != 0 && !PageMatchesBase(i))
+					dirty.Add(i);
+			}
+
+			bw.Write(dirty.Count);
+			var buff = new byte[psize];
+			foreach (var i in dirty)
+			{
+				bw.Write(i);
+				Marshal.Copy(Z.US(GetStartAddr(i)), buff, 0, psize);
+				bw.Write(buff);
+			}
+		}
+
+		/// <summary>
+		/// read back the output of SaveDirtyPages, restoring every other dirty page in the range from the dirty base.
+		/// the saved pages must be writable.  Does not check for or change Protect()!
+		/// </summary>
+		public unsafe void LoadDirtyPages(BinaryReader br, ulong start, ulong length)
+		{
+			if (_dirtyState == IntPtr.Zero)
+				throw new InvalidOperationException("No dirty base taken!");
+			if (!WaterboxUtils.Aligned(start) || !WaterboxUtils.Aligned(length))
+				throw new ArgumentOutOfRangeException();
+			int count = br.ReadInt32();
+			if (length == 0)
+			{
+				if (count != 0)
+					throw new InvalidOperationException("Unexpected dirty page count");
+				return;
+			}
+			int pstart = GetPage(start);
+			int pend = GetPage(start + length - 1);
+			int psize = WaterboxUtils.PageSize;
+
+			var s = (byte*)_dirtyState;
+			int next = pstart;
+			for (int n = 0; n <= count; n++)
+			{
+				int page = pend + 1;
+				if (n < count)
+				{
+					page = br.ReadInt32();
+					if (page < next || page > pend)
+						throw new InvalidOperationException("Dirty page out of range");
+				}
+				// everything between the previous saved page and this one matched the base when saved
+				int restored = next;
+				for (; next < page; next++)
+				{
+					if ((s[next] & DirtyTracker.Dirty) != 0)
+					{
+						var offset = (ulong)next << WaterboxUtils.PageShift;
+						Buffer.MemoryCopy((void*)(_dirtyBase.ToUInt64() + offset), (void*)(Start + offset), psize, psize);
+						s[next] &= unchecked((byte)~DirtyTracker.Dirty);
+					}
+				}
+				// clean pages go back to being write protected
+				if (Active && restored < page)
+					ProtectPages(restored, page - 1);
+				if (n < count)
+				{
+					// if this page is clean, the write fault handler will save its base first
+					Marshal.Copy(br.ReadBytes(psize), 0, Z.US(GetStartAddr(page)), psize);
+					next = page + 1;
+				}
+			}
+		}
+
+		/// <summary>
+		/// true if a page of the block is identical to the same page in the dirty base
+		/// </summary>
+		private unsafe bool PageMatchesBase(int page)
+		{
+			var offset = (ulong)page << WaterboxUtils.PageShift;
+			var p = (ulong*)(Start + offset);
+			var q = (ulong*)(_dirtyBase.ToUInt64() + offset);
+			var e = p + (WaterboxUtils.PageSize >> 3);
+			while (p < e)
+			{
+				if (*p++ != *q++)
+					return false;
+			}
+			return true;
+		}
+
 		private static Kernel32.MemoryProtection GetKernelMemoryProtectionValue(Protection prot)
 		{
 			Kernel32.MemoryProtection p;
@@ -218,51 +386,68 @@ namespace BizHawk.Common.BizInvoke
 		}
 
 		/// <summary>
-		/// restore all recorded protections
+		/// the protection actually applied to a page: the recorded one, except that writable pages that haven't been
+		/// written since the last SaveDirtyBase() stay read only until the write fault handler marks them dirty
 		/// </summary>
-		private void ProtectAll()
+		private unsafe Kernel32.MemoryProtection GetEffectiveProtection(int page)
 		{
-			int ps = 0;
-			for (int i = 0; i < _pageData.Length; i++)
+			if (_dirtyState != IntPtr.Zero && ((byte*)_dirtyState)[page] == DirtyTracker.Writable)
+				return Kernel32.MemoryProtection.READONLY;
+			return GetKernelMemoryProtectionValue(_pageData[page]);
+		}
+
+		/// <summary>
+		/// apply recorded protections to pages [pstart, pend]
+		/// </summary>
+		private void ProtectPages(int pstart, int pend)
+		{
+			int ps = pstart;
+			var p = GetEffectiveProtection(pstart);
+			for (int i = pstart; i <= pend; i++)
 			{
-				if (i == _pageData.Length - 1 || _pageData[i] != _pageData[i + 1])
+				var pnext = i == pend ? p : GetEffectiveProtection(i + 1);
+				if (i == pend || p != pnext)
 				{
-					var p = GetKernelMemoryProtectionValue(_pageData[i]);
 					ulong zstart = GetStartAddr(ps);
 					ulong zend = GetStartAddr(i + 1);
 					Kernel32.MemoryProtection old;
 					if (!Kernel32.VirtualProtect(Z.UU(zstart), Z.UU(zend - zstart), p, out old))
 						throw new InvalidOperationException("VirtualProtect() returned FALSE!");
 					ps = i + 1;
+					p = pnext;
 				}
 			}
 		}
 
+		/// <summary>
+		/// restore all recorded protections
+		/// </summary>
+		private void ProtectAll()
+		{
+			ProtectPages(0, _pageData.Length - 1);
+		}
+
 		/// <summary>
 		/// set r/w/x protection on a portion of memory.  rounded to encompassing pages
 		/// </summary>
-		public void Protect(ulong start, ulong length, Protection prot)
+		public unsafe void Protect(ulong start, ulong length, Protection prot)
 		{
 			if (length == 0)
 				return;
 			int pstart = GetPage(start);
 			int pend = GetPage(start + length - 1);
 
-			var p = GetKernelMemoryProtectionValue(prot);
 			for (int i = pstart; i <= pend; i++)
 				_pageData[i] = prot; // also store the value for later use
-
-			if (Active) // it's legal to Protect() if we're not active; the information is just saved for the next activation
+			if (_dirtyState != IntPtr.Zero)
 			{
-				var computedStart = WaterboxUtils.AlignDown(start);
-				var computedEnd = WaterboxUtils.AlignUp(start + length);
-				var computedLength = computedEnd - computedStart;
-
-				Kernel32.MemoryProtection old;
-				if (!Kernel32.VirtualProtect(Z.UU(computedStart),
-					Z.UU(computedLength), p, out old))
-					throw new InvalidOperationException("VirtualProtect() returned FALSE!");
+				var s = (byte*)_dirtyState;
+				for (int i = pstart; i <= pend; i++)
+					s[i] = (byte)((s[i] & DirtyTracker.Dirty) | (prot == Protection.RW ? DirtyTracker.Writable : 0));
 			}
+
+			if (Active) // it's legal to Protect() if we're not active; the information is just saved for the next activation
+				ProtectPages(pstart, pend);
 		}
 
 		public void Dispose()
@@ -280,6 +465,12 @@ namespace BizHawk.Common.BizInvoke
 				Kernel32.CloseHandle(_handle);
 				_handle = IntPtr.Zero;
 			}
+			if (_dirtyState != IntPtr.Zero)
+			{
+				Kernel32.VirtualFree(_dirtyBase, UIntPtr.Zero, Kernel32.FreeType.RELEASE);
+				Marshal.FreeHGlobal(_dirtyState);
+				_dirtyState = IntPtr.Zero;
+			}
 		}
 
 		~MemoryBlock()
@@ -440,6 +631,119 @@ namespace BizHawk.Common.BizInvoke
 			}
 		}
 
+		/// <summary>
+		/// vectored exception handler that does the actual dirty tracking.  clean writable pages of tracked blocks are
+		/// kept read only; on the first write to one, the handler copies the page to the block's dirty base, marks it
+		/// dirty, makes it writable, and retries the write.  the handler is native code because writes can come from
+		/// the host too (Marshal.Copy, memory domains), and managed code can't run in the middle of those
+		/// </summary>
+		private static class DirtyTracker
+		{
+			/// <summary>
+			/// page state flags; the handler also uses 4 to mark a page whose base is being saved by another thread
+			/// </summary>
+			public const byte Writable = 1;
+			public const byte Dirty = 2;
+
+			private const ulong Placeholder = 0xdeadbeeffeedface;
+			private const int SlotSize = 32;
+			private const int MaxSlots = (4096 - 16) / SlotSize;
+
+			/// <summary>
+			/// if the exception is a write access violation to a page whose state is Writable, change the state to 4,
+			/// copy the page to the slot's base, VirtualProtect the page to READWRITE, set the state to Writable | Dirty,
+			/// and return EXCEPTION_CONTINUE_EXECUTION.  the table pointer goes in the placeholder
+			/// </summary>
+			private static readonly byte[] Handler =
+			{
+				0x53, 0x56, 0x57, 0x41, 0x54, 0x41, 0x55, 0x48, 0x83, 0xec, 0x30, 0x48, 0x8b, 0x01, 0x81, 0x38, 0x05, 0x00, 0x00, 0xc0, 0x0f, 0x85, 0xad, 0x00,
+				0x00, 0x00, 0x83, 0x78, 0x18, 0x02, 0x0f, 0x82, 0xa3, 0x00, 0x00, 0x00, 0x48, 0x83, 0x78, 0x20, 0x01, 0x0f, 0x85, 0x98, 0x00, 0x00, 0x00, 0x48,
+				0x8b, 0x50, 0x28, 0x48, 0xbb, 0xce, 0xfa, 0xed, 0xfe, 0xef, 0xbe, 0xad, 0xde, 0x48, 0x8b, 0x4b, 0x08, 0x48, 0x8d, 0x73, 0x10, 0x48, 0x85, 0xc9,
+				0x74, 0x7d, 0x48, 0x3b, 0x16, 0x72, 0x06, 0x48, 0x3b, 0x56, 0x08, 0x72, 0x09, 0x48, 0x83, 0xc6, 0x20, 0x48, 0xff, 0xc9, 0xeb, 0xe7, 0x49, 0x89,
+				0xd4, 0x4c, 0x2b, 0x26, 0x49, 0xc1, 0xec, 0x0c, 0x4c, 0x8b, 0x6e, 0x10, 0x4d, 0x01, 0xe5, 0xb0, 0x01, 0xb1, 0x04, 0xf0, 0x41, 0x0f, 0xb0, 0x4d,
+				0x00, 0x74, 0x0e, 0x3c, 0x04, 0x75, 0x04, 0xf3, 0x90, 0xeb, 0xec, 0x3c, 0x03, 0x74, 0x39, 0xeb, 0x3e, 0x49, 0xc1, 0xe4, 0x0c, 0x4c, 0x8b, 0x06,
+				0x4d, 0x01, 0xe0, 0x48, 0x8b, 0x7e, 0x18, 0x4c, 0x01, 0xe7, 0x4c, 0x89, 0xc6, 0xb9, 0x00, 0x02, 0x00, 0x00, 0xfc, 0xf3, 0x48, 0xa5, 0x4c, 0x89,
+				0xc1, 0xba, 0x00, 0x10, 0x00, 0x00, 0x41, 0xb8, 0x04, 0x00, 0x00, 0x00, 0x4c, 0x8d, 0x4c, 0x24, 0x20, 0xff, 0x13, 0x41, 0xc6, 0x45, 0x00, 0x03,
+				0xb8, 0xff, 0xff, 0xff, 0xff, 0xeb, 0x02, 0x31, 0xc0, 0x48, 0x83, 0xc4, 0x30, 0x41, 0x5d, 0x41, 0x5c, 0x5f, 0x5e, 0x5b, 0xc3,
+			};
+
+			private static readonly object Sync = new object();
+
+			/// <summary>
+			/// the table read by the handler:  [0] VirtualProtect, [8] number of slots ever used,
+			/// [16 + 32 * n] start, end, state bytes, base for slot n.  a slot with end == 0 is free
+			/// </summary>
+			private static IntPtr _table;
+
+			private static void Init()
+			{
+				if (_table != IntPtr.Zero)
+					return;
+				if (WaterboxUtils.PageSize != 4096)
+					throw new InvalidOperationException("Dirty tracking needs 4KiB pages");
+
+				var table = Kernel32.VirtualAlloc(UIntPtr.Zero, Z.UU(4096),
+					Kernel32.AllocationType.RESERVE | Kernel32.AllocationType.COMMIT, Kernel32.MemoryProtection.READWRITE);
+				var code = Kernel32.VirtualAlloc(UIntPtr.Zero, Z.UU(4096),
+					Kernel32.AllocationType.RESERVE | Kernel32.AllocationType.COMMIT, Kernel32.MemoryProtection.READWRITE);
+				if (table == UIntPtr.Zero || code == UIntPtr.Zero)
+					throw new InvalidOperationException("VirtualAlloc() returned NULL");
+				var virtualProtect = Kernel32.GetProcAddress(Kernel32.GetModuleHandle("kernel32.dll"), "VirtualProtect");
+				if (virtualProtect == IntPtr.Zero)
+					throw new InvalidOperationException("Couldn't find VirtualProtect()");
+				Marshal.WriteIntPtr(Z.US(table.ToUInt64()), virtualProtect);
+
+				var data = (byte[])Handler.Clone();
+				var index = Enumerable.Range(0, data.Length - 7)
+					.Single(i => BitConverter.ToUInt64(data, i) == Placeholder);
+				BitConverter.GetBytes(table.ToUInt64()).CopyTo(data, index);
+				Marshal.Copy(data, 0, Z.US(code.ToUInt64()), data.Length);
+				Kernel32.MemoryProtection old;
+				if (!Kernel32.VirtualProtect(code, Z.UU(4096), Kernel32.MemoryProtection.EXECUTE_READ, out old))
+					throw new InvalidOperationException("VirtualProtect() returned FALSE!");
+				if (Kernel32.AddVectoredExceptionHandler(1, Z.US(code.ToUInt64())) == IntPtr.Zero)
+					throw new InvalidOperationException("AddVectoredExceptionHandler() returned NULL");
+				_table = Z.US(table.ToUInt64());
+			}
+
+			/// <summary>
+			/// start tracking writes to [start, end)
+			/// </summary>
+			/// <returns>the slot to pass to Unregister</returns>
+			public static int Register(ulong start, ulong end, IntPtr state, UIntPtr dirtyBase)
+			{
+				lock (Sync)
+				{
+					Init();
+					var used = (int)Marshal.ReadInt64(_table, 8);
+					int slot = 0;
+					while (slot < used && Marshal.ReadInt64(_table, 16 + slot * SlotSize + 8) != 0)
+						slot++;
+					if (slot == MaxSlots)
+						throw new InvalidOperationException("Too many dirty tracked blocks");
+					// the handler can run at any time on any thread, so the range has to be the last thing filled in
+					var p = _table + 16 + slot * SlotSize;
+					Marshal.WriteIntPtr(p, 16, state);
+					Marshal.WriteInt64(p, 24, (long)dirtyBase.ToUInt64());
+					Marshal.WriteInt64(p, 0, (long)start);
+					Marshal.WriteInt64(p, 8, (long)end);
+					if (slot == used)
+						Marshal.WriteInt64(_table, 8, used + 1);
+					return slot;
+				}
+			}
+
+			public static void Unregister(int slot)
+			{
+				lock (Sync)
+				{
+					var p = _table + 16 + slot * SlotSize;
+					Marshal.WriteInt64(p, 8, 0);
+					Marshal.WriteInt64(p, 0, 0);
+				}
+			}
+		}
+
 		private static class Kernel32
 		{
 			[DllImport("kernel32.dll", SetLastError = true)]
@@ -489,6 +793,15 @@ namespace BizHawk.Common.BizInvoke
 				WRITECOMBINE_Modifierflag = 0x400
 			}
 
+			[DllImport("kernel32.dll")]
+			public static extern IntPtr AddVectoredExceptionHandler(uint first, IntPtr handler);
+
+			[DllImport("kernel32.dll", CharSet = CharSet.Ansi)]
+			public static extern IntPtr GetModuleHandle(string lpModuleName);
+
+			[DllImport("kernel32.dll", CharSet = CharSet.Ansi)]
+			public static extern IntPtr GetProcAddress(IntPtr hModule, string lpProcName);
+
 			[DllImport("kernel32.dll", SetLastError = true)]
 			public static extern IntPtr CreateFileMapping(
 				IntPtr hFile,
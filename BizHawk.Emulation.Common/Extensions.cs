@@ -113,6 +113,21 @@ namespace BizHawk.Emulation.Common.IEmulatorExtensions
 			return core.ServiceProvider.GetService<IStatable>();
 		}
 
+		public static bool HasRewindStates(this IEmulator core)
+		{
+			if (core == null)
+			{
+				return false;
+			}
+
+			return core.ServiceProvider.HasService<IRewindStatable>();
+		}
+
+		public static IRewindStatable AsRewindStatable(this IEmulator core)
+		{
+			return core.ServiceProvider.GetService<IRewindStatable>();
+		}
+
 		public static bool CanPollInput(this IEmulator core)
 		{
 			if (core == null)
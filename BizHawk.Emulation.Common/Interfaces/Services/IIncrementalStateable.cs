@@ -0,0 +1,15 @@
+﻿using System.IO;
+
+namespace BizHawk.Emulation.Common
+{
+	/// <summary>
+	/// A savestate component that can also save only the memory written since an earlier base.
+	/// Incremental states are only loadable into the same instance while that base is current
+	/// </summary>
+	public interface IIncrementalStateable : IBinaryStateable
+	{
+		void SaveIncrementalBase();
+		void SaveStateIncremental(BinaryWriter writer);
+		void LoadStateIncremental(BinaryReader reader);
+	}
+}
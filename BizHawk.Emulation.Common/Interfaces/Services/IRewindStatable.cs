@@ -0,0 +1,21 @@
+﻿using System.IO;
+
+namespace BizHawk.Emulation.Common
+{
+	/// <summary>
+	/// This service lets the rewinder capture states that are cheaper than full savestates, such as a core whose state
+	/// only holds the memory written since some base.  Rewind states can only be loaded into the same core instance,
+	/// and only until the next ResetRewindStates()
+	/// If unavailable the rewinder uses IStatable
+	/// </summary>
+	public interface IRewindStatable : IEmulatorService
+	{
+		/// <summary>
+		/// Called when the rewinder starts over.  Every rewind state saved before this call becomes unloadable
+		/// </summary>
+		void ResetRewindStates();
+
+		byte[] SaveRewindState();
+		void LoadRewindState(BinaryReader reader);
+	}
+}
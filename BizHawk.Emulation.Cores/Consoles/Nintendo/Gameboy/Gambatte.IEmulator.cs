@@ -15,6 +15,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 		public void FrameAdvance(IController controller, bool render, bool rendersound)
 		{
 			FrameAdvancePrep(controller);
+			LibGambatte.gambatte_setskiprender(GambatteState, !render);
 			if (_syncSettings.EqualLengthFrames)
 			{
 				while (true)
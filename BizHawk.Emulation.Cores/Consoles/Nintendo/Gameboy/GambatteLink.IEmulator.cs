@@ -42,6 +42,8 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 			Frame++;
 			L.FrameAdvancePrep(LCont);
 			R.FrameAdvancePrep(RCont);
+			LibGambatte.gambatte_setskiprender(L.GambatteState, !render);
+			LibGambatte.gambatte_setskiprender(R.GambatteState, !render);
 
 			unsafe
 			{
@@ -58,62 +60,71 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 						int nL = _overflowL;
 						int nR = _overflowR;
 
-						// slowly step our way through the frame, while continually checking and resolving link cable status
-						for (int target = 0; target < SampPerFrame;)
+						if (_memorycallbacks.HasReads || _memorycallbacks.HasWrites || _memorycallbacks.HasExecutes || _inputCallbacks.Count > 0)
 						{
-							target += Step;
-							if (target > SampPerFrame)
+							// slowly step our way through the frame, while continually checking and resolving link cable status
+							for (int target = 0; target < SampPerFrame;)
 							{
-								target = SampPerFrame; // don't run for slightly too long depending on step
-							}
-
-							// gambatte_runfor() aborts early when a frame is produced, but we don't want that, hence the while()
-							while (nL < target)
-							{
-								uint nsamp = (uint)(target - nL);
-								if (LibGambatte.gambatte_runfor(L.GambatteState, leftsbuff + (nL * 2), ref nsamp) > 0)
+								target += Step;
+								if (target > SampPerFrame)
 								{
-									LibGambatte.gambatte_blitto(L.GambatteState, leftvbuff, Pitch);
+									target = SampPerFrame; // don't run for slightly too long depending on step
 								}
 
-								nL += (int)nsamp;
-							}
-
-							while (nR < target)
-							{
-								uint nsamp = (uint)(target - nR);
-								if (LibGambatte.gambatte_runfor(R.GambatteState, rightsbuff + (nR * 2), ref nsamp) > 0)
+								// gambatte_runfor() aborts early when a frame is produced, but we don't want that, hence the while()
+								while (nL < target)
 								{
-									LibGambatte.gambatte_blitto(R.GambatteState, rightvbuff, Pitch);
+									uint nsamp = (uint)(target - nL);
+									if (LibGambatte.gambatte_runfor(L.GambatteState, leftsbuff + (nL * 2), ref nsamp) > 0)
+									{
+										LibGambatte.gambatte_blitto(L.GambatteState, leftvbuff, Pitch);
+									}
+
+									nL += (int)nsamp;
 								}
 
-								nR += (int)nsamp;
-							}
+								while (nR < target)
+								{
+									uint nsamp = (uint)(target - nR);
+									if (LibGambatte.gambatte_runfor(R.GambatteState, rightsbuff + (nR * 2), ref nsamp) > 0)
+									{
+										LibGambatte.gambatte_blitto(R.GambatteState, rightvbuff, Pitch);
+									}
 
-							// poll link cable statuses, but not when the cable is disconnected
-							if (!_cableconnected)
-							{
-								continue;
-							}
+									nR += (int)nsamp;
+								}
 
-							if (LibGambatte.gambatte_linkstatus(L.GambatteState, 256) != 0) // ClockTrigger
-							{
-								LibGambatte.gambatte_linkstatus(L.GambatteState, 257); // ack
-								int lo = LibGambatte.gambatte_linkstatus(L.GambatteState, 258); // GetOut
-								int ro = LibGambatte.gambatte_linkstatus(R.GambatteState, 258);
-								LibGambatte.gambatte_linkstatus(L.GambatteState, ro & 0xff); // ShiftIn
-								LibGambatte.gambatte_linkstatus(R.GambatteState, lo & 0xff); // ShiftIn
-							}
+								// poll link cable statuses, but not when the cable is disconnected
+								if (!_cableconnected)
+								{
+									continue;
+								}
 
-							if (LibGambatte.gambatte_linkstatus(R.GambatteState, 256) != 0) // ClockTrigger
-							{
-								LibGambatte.gambatte_linkstatus(R.GambatteState, 257); // ack
-								int lo = LibGambatte.gambatte_linkstatus(L.GambatteState, 258); // GetOut
-								int ro = LibGambatte.gambatte_linkstatus(R.GambatteState, 258);
-								LibGambatte.gambatte_linkstatus(L.GambatteState, ro & 0xff); // ShiftIn
-								LibGambatte.gambatte_linkstatus(R.GambatteState, lo & 0xff); // ShiftIn
+								if (LibGambatte.gambatte_linkstatus(L.GambatteState, 256) != 0) // ClockTrigger
+								{
+									LibGambatte.gambatte_linkstatus(L.GambatteState, 257); // ack
+									int lo = LibGambatte.gambatte_linkstatus(L.GambatteState, 258); // GetOut
+									int ro = LibGambatte.gambatte_linkstatus(R.GambatteState, 258);
+									LibGambatte.gambatte_linkstatus(L.GambatteState, ro & 0xff); // ShiftIn
+									LibGambatte.gambatte_linkstatus(R.GambatteState, lo & 0xff); // ShiftIn
+								}
+
+								if (LibGambatte.gambatte_linkstatus(R.GambatteState, 256) != 0) // ClockTrigger
+								{
+									LibGambatte.gambatte_linkstatus(R.GambatteState, 257); // ack
+									int lo = LibGambatte.gambatte_linkstatus(L.GambatteState, 258); // GetOut
+									int ro = LibGambatte.gambatte_linkstatus(R.GambatteState, 258);
+									LibGambatte.gambatte_linkstatus(L.GambatteState, ro & 0xff); // ShiftIn
+									LibGambatte.gambatte_linkstatus(R.GambatteState, lo & 0xff); // ShiftIn
+								}
 							}
 						}
+						else
+						{
+							// nothing calls back into us during the frame, so the cores can run on their own threads.
+							// the native side steps through the frame exactly like the loop above does
+							LibGambatte.gambatte_linkrunfor(_linkRunner, leftsbuff, rightsbuff, ref nL, ref nR, SampPerFrame, Step, _cableconnected, leftvbuff, rightvbuff, Pitch);
+						}
 
 						_overflowL = nL - SampPerFrame;
 						_overflowR = nR - SampPerFrame;
@@ -171,6 +182,9 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 		{
 			if (!_disposed)
 			{
+				LibGambatte.gambatte_linkdestroy(_linkRunner);
+				_linkRunner = IntPtr.Zero;
+
 				L.Dispose();
 				L = null;
 
@@ -1,4 +1,6 @@
-﻿using BizHawk.Emulation.Common;
+﻿using System;
+
+using BizHawk.Emulation.Common;
 
 namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 {
@@ -26,6 +28,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 			// connect link cable
 			LibGambatte.gambatte_linkstatus(L.GambatteState, 259);
 			LibGambatte.gambatte_linkstatus(R.GambatteState, 259);
+			_linkRunner = LibGambatte.gambatte_linkcreate(L.GambatteState, R.GambatteState);
 
 			L.ConnectInputCallbackSystem(_inputCallbacks);
 			R.ConnectInputCallbackSystem(_inputCallbacks);
@@ -58,6 +61,9 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 		private Gameboy L;
 		private Gameboy R;
 
+		// runs L and R together in native code, when nothing needs to call back into us mid-frame
+		private IntPtr _linkRunner;
+
 		// counter to ensure we do 35112 samples per frame
 		private int _overflowL = 0;
 		private int _overflowR = 0;
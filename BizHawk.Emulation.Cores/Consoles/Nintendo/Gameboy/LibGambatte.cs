@@ -251,6 +251,15 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
 		public static extern void gambatte_setlayers(IntPtr core, int mask);
 
+		/// <summary>
+		/// skips drawing, starting with the next frame.  timing, interrupts and state are unaffected, and the
+		/// video buffer keeps the last frame drawn
+		/// </summary>
+		/// <param name="core">opaque state pointer</param>
+		/// <param name="skip">true to skip drawing</param>
+		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern void gambatte_setskiprender(IntPtr core, bool skip);
+
 		/// <summary>
 		/// type of the scanline callback
 		/// </summary>
@@ -436,6 +445,40 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
 		public static extern int gambatte_linkstatus(IntPtr core, int which);
 
+		/// <summary>
+		/// create a runner that advances two linked cores together, the right one on its own thread
+		/// </summary>
+		/// <param name="left">opaque state pointer of the left core</param>
+		/// <param name="right">opaque state pointer of the right core</param>
+		/// <returns>opaque runner pointer</returns>
+		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern IntPtr gambatte_linkcreate(IntPtr left, IntPtr right);
+
+		/// <summary>
+		/// destroy a runner created with gambatte_linkcreate.  the cores are left alone
+		/// </summary>
+		/// <param name="runner">opaque runner pointer</param>
+		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern void gambatte_linkdestroy(IntPtr runner);
+
+		/// <summary>
+		/// run both cores until each has produced at least target samples, stepping step samples at a time and trading
+		/// link cable bytes in between, the same way as calling gambatte_runfor and gambatte_linkstatus on one thread would.
+		/// </summary>
+		/// <param name="runner">opaque runner pointer</param>
+		/// <param name="lsoundbuf">left sample buffer, with space for target + 2064 samples</param>
+		/// <param name="rsoundbuf">right sample buffer, with space for target + 2064 samples</param>
+		/// <param name="lpos">in: samples already in the left buffer, out: samples in the left buffer</param>
+		/// <param name="rpos">in: samples already in the right buffer, out: samples in the right buffer</param>
+		/// <param name="target">number of samples to reach</param>
+		/// <param name="step">samples to run between link cable checks</param>
+		/// <param name="connected">false to run both without trading bytes</param>
+		/// <param name="lvideobuf">left video buffer, blitted to whenever the left core finishes a frame</param>
+		/// <param name="rvideobuf">right video buffer, blitted to whenever the right core finishes a frame</param>
+		/// <param name="pitch">pitch of both video buffers, in pixels</param>
+		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
+		unsafe public static extern void gambatte_linkrunfor(IntPtr runner, short* lsoundbuf, short* rsoundbuf, ref int lpos, ref int rpos, int target, int step, bool connected, int* lvideobuf, int* rvideobuf, int pitch);
+
 		/// <summary>
 		/// get reg and flag values
 		/// </summary>
@@ -124,6 +124,69 @@ namespace BizHawk.Emulation.Cores.Consoles.Nintendo.QuickNES
 		[BizImport(CallingConvention.Cdecl)]
 		public abstract IntPtr qn_state_load(IntPtr e, byte[] src, int size);
 		/// <summary>
+		/// get the size of a raw in-memory snapshot.  always the same for a given build of the core
+		/// </summary>
+		/// <param name="e">context</param>
+		/// <returns>size in bytes</returns>
+		[BizImport(CallingConvention.Cdecl)]
+		public abstract int qn_flat_state_size(IntPtr e);
+		/// <summary>
+		/// save a raw in-memory snapshot to buffer.  much faster than qn_state_save, but only loadable by the same build
+		/// </summary>
+		/// <param name="e">context</param>
+		/// <param name="dest">target buffer</param>
+		/// <param name="size">length of buffer, must be qn_flat_state_size(e)</param>
+		/// <returns>string error</returns>
+		[BizImport(CallingConvention.Cdecl)]
+		public abstract IntPtr qn_flat_state_save(IntPtr e, byte[] dest, int size);
+		/// <summary>
+		/// load a raw in-memory snapshot from buffer
+		/// </summary>
+		/// <param name="e">context</param>
+		/// <param name="src">source buffer</param>
+		/// <param name="size">length of buffer</param>
+		/// <returns>string error</returns>
+		[BizImport(CallingConvention.Cdecl)]
+		public abstract IntPtr qn_flat_state_load(IntPtr e, byte[] src, int size);
+		/// <summary>
+		/// create a new context that's a copy of an existing one.  the cartridge is shared, not copied
+		/// </summary>
+		/// <param name="e">context to copy; may be deleted before the new one</param>
+		/// <returns>NULL on failure</returns>
+		[BizImport(CallingConvention.Cdecl)]
+		public abstract IntPtr qn_fork(IntPtr e);
+		/// <summary>
+		/// copy the current state of a context into one previously forked from it
+		/// </summary>
+		/// <param name="dest">context returned from qn_fork(e)</param>
+		/// <param name="e">context</param>
+		/// <returns>string error</returns>
+		[BizImport(CallingConvention.Cdecl)]
+		public abstract IntPtr qn_fork_sync(IntPtr dest, IntPtr e);
+		/// <summary>
+		/// create a thread pool for running many contexts at once
+		/// </summary>
+		/// <param name="threads">number of threads, or 0 for one per hardware thread</param>
+		[BizImport(CallingConvention.Cdecl)]
+		public abstract IntPtr qn_batch_new(int threads);
+		/// <summary>
+		/// destroy a thread pool
+		/// </summary>
+		/// <param name="b">pool previously returned from qn_batch_new()</param>
+		[BizImport(CallingConvention.Cdecl)]
+		public abstract void qn_batch_delete(IntPtr b);
+		/// <summary>
+		/// emulate a single frame on each of a list of contexts, in parallel
+		/// </summary>
+		/// <param name="b">pool</param>
+		/// <param name="e">contexts, all different</param>
+		/// <param name="pad1">pad 1 input for each context</param>
+		/// <param name="pad2">pad 2 input for each context</param>
+		/// <param name="count">number of contexts</param>
+		/// <returns>string error</returns>
+		[BizImport(CallingConvention.Cdecl)]
+		public abstract IntPtr qn_batch_emulate_frame(IntPtr b, IntPtr[] e, int[] pad1, int[] pad2, int count);
+		/// <summary>
 		/// query battery ram state
 		/// </summary>
 		/// <param name="e">context</param>
@@ -6,7 +6,7 @@ using BizHawk.Emulation.Common;
 
 namespace BizHawk.Emulation.Cores.Consoles.Nintendo.QuickNES
 {
-	public partial class QuickNES : IStatable
+	public partial class QuickNES : IStatable, IRewindStatable
 	{
 		public bool BinarySaveStatesPreferred { get { return true; } }
 
@@ -65,8 +65,65 @@ namespace BizHawk.Emulation.Cores.Consoles.Nintendo.QuickNES
 			return SaveStateBuff2;
 		}
 
+		/// <summary>
+		/// flat states hold everything themselves, so there is no base to reset
+		/// </summary>
+		public void ResetRewindStates()
+		{
+		}
+
+		/// <summary>
+		/// save a raw snapshot for rewind.  much faster than SaveStateBinary, but the layout depends on how the core was built,
+		/// so it only serves rewind, which keeps its states in memory.  TAStudio branches and greenzone states can end up
+		/// in a project file, so they stay on SaveStateBinary
+		/// </summary>
+		public byte[] SaveRewindState()
+		{
+			CheckDisposed();
+			var ms = new System.IO.MemoryStream(FlatStateBuff2, true);
+			var bw = new System.IO.BinaryWriter(ms);
+			SaveStateFlat(bw);
+			bw.Flush();
+			if (ms.Position != FlatStateBuff2.Length)
+				throw new InvalidOperationException("Unexpected flat state length!");
+			bw.Close();
+			return FlatStateBuff2;
+		}
+
+		/// <summary>
+		/// load a snapshot made by SaveRewindState in this session
+		/// </summary>
+		public void LoadRewindState(System.IO.BinaryReader reader)
+		{
+			LoadStateFlat(reader);
+		}
+
+		private void SaveStateFlat(System.IO.BinaryWriter writer)
+		{
+			CheckDisposed();
+			LibQuickNES.ThrowStringError(QN.qn_flat_state_save(Context, FlatStateBuff, FlatStateBuff.Length));
+			writer.Write(FlatStateBuff);
+			// other variables
+			writer.Write(IsLagFrame);
+			writer.Write(LagCount);
+			writer.Write(Frame);
+		}
+
+		private void LoadStateFlat(System.IO.BinaryReader reader)
+		{
+			CheckDisposed();
+			reader.Read(FlatStateBuff, 0, FlatStateBuff.Length);
+			LibQuickNES.ThrowStringError(QN.qn_flat_state_load(Context, FlatStateBuff, FlatStateBuff.Length));
+			// other variables
+			IsLagFrame = reader.ReadBoolean();
+			LagCount = reader.ReadInt32();
+			Frame = reader.ReadInt32();
+		}
+
 		private byte[] SaveStateBuff;
 		private byte[] SaveStateBuff2;
+		private byte[] FlatStateBuff;
+		private byte[] FlatStateBuff2;
 
 		private void InitSaveStateBuff()
 		{
@@ -74,6 +131,8 @@ namespace BizHawk.Emulation.Cores.Consoles.Nintendo.QuickNES
 			LibQuickNES.ThrowStringError(QN.qn_state_size(Context, ref size));
 			SaveStateBuff = new byte[size];
 			SaveStateBuff2 = new byte[size + 13];
+			FlatStateBuff = new byte[QN.qn_flat_state_size(Context)];
+			FlatStateBuff2 = new byte[FlatStateBuff.Length + 9];
 		}
 	}
 }
@@ -60,11 +60,21 @@ namespace BizHawk.Emulation.Cores.Nintendo.SNES
 			_readonlyFiles.Add(name);
 		}
 
-		public LibsnesApi(string dllPath)
+		public LibsnesApi(string dllPath, string profile)
 		{
+			var filename = profile == "Performance" ? "libsnes_perf.wbx" : "libsnes.wbx";
+
+			// the performance build isn't shipped with releases; it only exists if someone built it from waterbox/libsnes
+			if (profile == "Performance"
+				&& !File.Exists(Path.Combine(dllPath, filename))
+				&& !File.Exists(Path.Combine(dllPath, filename + ".gz")))
+			{
+				throw new InvalidOperationException($"The SNES Performance profile needs {filename}, which was not found in {dllPath}. Build it with waterbox/libsnes's Makefile, or set the Profile sync setting back to Compatibility.");
+			}
+
 			_exe = new PeRunner(new PeRunnerOptions
 			{
-				Filename = "libsnes.wbx",
+				Filename = filename,
 				Path = dllPath,
 				SbrkHeapSizeKB = 4 * 1024,
 				InvisibleHeapSizeKB = 8 * 1024,
@@ -394,5 +404,21 @@ namespace BizHawk.Emulation.Cores.Nintendo.SNES
 			_exe.LoadStateBinary(reader);
 			_core.PostLoadState();
 		}
+
+		public void SaveIncrementalBase()
+		{
+			_exe.SaveIncrementalBase();
+		}
+
+		public void SaveStateIncremental(BinaryWriter writer)
+		{
+			_exe.SaveStateIncremental(writer);
+		}
+
+		public void LoadStateIncremental(BinaryReader reader)
+		{
+			_exe.LoadStateIncremental(reader);
+			_core.PostLoadState();
+		}
 	}
 }
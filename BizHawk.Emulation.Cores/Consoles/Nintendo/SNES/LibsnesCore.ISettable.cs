@@ -1,4 +1,6 @@
-﻿using BizHawk.Emulation.Common;
+﻿using System.ComponentModel;
+
+using BizHawk.Emulation.Common;
 
 namespace BizHawk.Emulation.Cores.Nintendo.SNES
 {
@@ -30,7 +32,8 @@ namespace BizHawk.Emulation.Cores.Nintendo.SNES
 		{
 			bool ret = o.LeftPort != _syncSettings.LeftPort
 				|| o.RightPort != _syncSettings.RightPort
-				|| o.LimitAnalogChangeSensitivity != _syncSettings.LimitAnalogChangeSensitivity;
+				|| o.LimitAnalogChangeSensitivity != _syncSettings.LimitAnalogChangeSensitivity
+				|| o.Profile != _syncSettings.Profile;
 
 			_syncSettings = o;
 			return ret;
@@ -71,6 +74,11 @@ namespace BizHawk.Emulation.Cores.Nintendo.SNES
 
 			public bool LimitAnalogChangeSensitivity { get; set; } = true;
 
+			// "Compatibility" runs the dot-based PPU; "Performance" runs the scanline PPU and the faster CPU/SMP cores from libsnes_perf.wbx.
+			// libsnes_perf.wbx isn't shipped yet, so this stays out of the settings UI until it is
+			[Browsable(false)]
+			public string Profile { get; set; } = "Compatibility";
+
 			public SnesSyncSettings Clone()
 			{
 				return (SnesSyncSettings)MemberwiseClone();
@@ -6,7 +6,7 @@ using BizHawk.Emulation.Common;
 
 namespace BizHawk.Emulation.Cores.Nintendo.SNES
 {
-	public unsafe partial class LibsnesCore : IStatable
+	public unsafe partial class LibsnesCore : IStatable, IRewindStatable
 	{
 		public bool BinarySaveStatesPreferred => true;
 
@@ -27,14 +27,24 @@ namespace BizHawk.Emulation.Cores.Nintendo.SNES
 		public void SaveStateBinary(BinaryWriter writer)
 		{
 			Api.SaveStateBinary(writer);
+			SaveOther(writer);
+		}
+
+		public void LoadStateBinary(BinaryReader reader)
+		{
+			Api.LoadStateBinary(reader);
+			LoadOther(reader);
+		}
+
+		private void SaveOther(BinaryWriter writer)
+		{
 			writer.Write(IsLagFrame);
 			writer.Write(LagCount);
 			writer.Write(Frame);
 		}
 
-		public void LoadStateBinary(BinaryReader reader)
+		private void LoadOther(BinaryReader reader)
 		{
-			Api.LoadStateBinary(reader);
 			IsLagFrame = reader.ReadBoolean();
 			LagCount = reader.ReadInt32();
 			Frame = reader.ReadInt32();
@@ -54,5 +64,29 @@ namespace BizHawk.Emulation.Cores.Nintendo.SNES
 			bw.Flush();
 			return ms.ToArray();
 		}
+
+		public void ResetRewindStates()
+		{
+			Api.SaveIncrementalBase();
+		}
+
+		/// <summary>
+		/// like SaveStateBinary, but only holds the waterbox memory written since the last ResetRewindStates()
+		/// </summary>
+		public byte[] SaveRewindState()
+		{
+			var ms = new MemoryStream();
+			var bw = new BinaryWriter(ms);
+			Api.SaveStateIncremental(bw);
+			SaveOther(bw);
+			bw.Flush();
+			return ms.ToArray();
+		}
+
+		public void LoadRewindState(BinaryReader reader)
+		{
+			Api.LoadStateIncremental(reader);
+			LoadOther(reader);
+		}
 	}
 }
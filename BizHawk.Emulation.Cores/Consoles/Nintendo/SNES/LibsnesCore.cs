@@ -58,8 +58,8 @@ namespace BizHawk.Emulation.Cores.Nintendo.SNES
 			_settings = (SnesSettings)settings ?? new SnesSettings();
 			_syncSettings = (SnesSyncSettings)syncSettings ?? new SnesSyncSettings();
 
-			// TODO: pass profile here
-			Api = new LibsnesApi(CoreComm.CoreFileProvider.DllPath())
+			CurrentProfile = _syncSettings.Profile == "Performance" ? "Performance" : "Compatibility";
+			Api = new LibsnesApi(CoreComm.CoreFileProvider.DllPath(), CurrentProfile)
 			{
 				ReadHook = ReadHook,
 				ExecHook = ExecHook,
@@ -166,10 +166,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.SNES
 
 			SetupMemoryDomains(romData, sgbRomData);
 
-			if (CurrentProfile == "Compatibility")
-			{
-				ser.Register<ITraceable>(_tracer);
-			}
+			ser.Register<ITraceable>(_tracer);
 
 			Api.QUERY_set_path_request(null);
 			Api.QUERY_set_video_refresh(snes_video_refresh);
@@ -202,7 +199,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.SNES
 			public string BoardName => "SGB";
 		}
 
-		public string CurrentProfile => "Compatibility"; // We no longer support performance, and accuracy isn't worth the effort so we shall just hardcode this one
+		public string CurrentProfile { get; } // "Compatibility" or "Performance"; accuracy isn't worth the effort so it isn't offered
 
 		public LibsnesApi Api { get; }
 
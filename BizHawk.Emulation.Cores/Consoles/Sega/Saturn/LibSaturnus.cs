@@ -39,6 +39,7 @@ namespace BizHawk.Emulation.Cores.Consoles.Sega.Saturn
 		public new class FrameInfo : LibWaterboxCore.FrameInfo
 		{
 			public int ResetPushed;
+			public int SlaveIdleSkip;
 		}
 
 		[UnmanagedFunctionPointer(CC)]
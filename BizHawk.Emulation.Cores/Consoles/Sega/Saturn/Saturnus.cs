@@ -180,7 +180,11 @@ namespace BizHawk.Emulation.Cores.Consoles.Sega.Saturn
 
 			SetVideoParameters();
 
-			return new LibSaturnus.FrameInfo { ResetPushed = controller.IsPressed("Reset") ? 1 : 0 };
+			return new LibSaturnus.FrameInfo
+			{
+				ResetPushed = controller.IsPressed("Reset") ? 1 : 0,
+				SlaveIdleSkip = _syncSettings.SkipSlaveIdleLoops ? 1 : 0
+			};
 		}
 
 		public DisplayType Region => _isPal ? DisplayType.PAL : DisplayType.NTSC;
@@ -419,6 +423,11 @@ namespace BizHawk.Emulation.Cores.Consoles.Sega.Saturn
 			[DefaultValue(false)]
 			public bool UseRealTime { get; set; }
 
+			[DisplayName("Skip Slave CPU Idle Loops")]
+			[Description("Fast-forwards the slave SH-2 through polling loops that can't see anything change until an event or the master CPU does something.  Meant to give the same results as leaving it off; compare state hashes with it off if in doubt.")]
+			[DefaultValue(false)]
+			public bool SkipSlaveIdleLoops { get; set; }
+
 			public SyncSettings()
 			{
 				SettingsUtil.SetDefaultValues(this);
@@ -758,11 +758,13 @@ namespace BizHawk.Emulation.Cores.Sony.PSX
 			SetInput();
 
 			OctoshockDll.shock_SetLEC(psx, _SyncSettings.EnableLEC);
+			OctoshockDll.shock_SetRecompiler(psx, _Settings.Recompiler);
 
 			var ropts = new OctoshockDll.ShockRenderOptions()
 			{
 				scanline_start = SystemVidStandard == OctoshockDll.eVidStandard.NTSC ? _Settings.ScanlineStart_NTSC : _Settings.ScanlineStart_PAL,
 				scanline_end = SystemVidStandard == OctoshockDll.eVidStandard.NTSC ? _Settings.ScanlineEnd_NTSC : _Settings.ScanlineEnd_PAL,
+				renderThreads = _Settings.RenderThreads,
 			};
 			if (_Settings.HorizontalClipping == eHorizontalClipping.Basic)
 				ropts.renderType = OctoshockDll.eShockRenderType.ClipOverscan;
@@ -809,8 +811,9 @@ namespace BizHawk.Emulation.Cores.Sony.PSX
 			OctoshockDll.shock_GetFramebuffer(psx, ref fb);
 			CurrentVideoSize = new System.Drawing.Size(fb.width, fb.height);
 
+			//normalize straight into our buffer; the core's own normalized copy is never needed afterwards
 			if (_Settings.ResolutionMode == eResolutionMode.PixelPro)
-				fb.flags = OctoshockDll.eShockFramebufferFlags.Normalize;
+				fb.flags = OctoshockDll.eShockFramebufferFlags.Normalize | OctoshockDll.eShockFramebufferFlags.Direct;
 
 			OctoshockDll.shock_GetFramebuffer(psx, ref fb);
 
@@ -1276,12 +1279,24 @@ namespace BizHawk.Emulation.Cores.Sony.PSX
 			[DefaultValue(eDeinterlaceMode.Weave)]
 			public eDeinterlaceMode DeinterlaceMode { get; set; }
 
+			[DisplayName("Render Threads")]
+			[Description("Number of extra threads used to draw untextured GPU primitives. 0 draws everything on the emulation thread. Doesn't affect sync or output.")]
+			[DefaultValue(0)]
+			public int RenderThreads { get; set; }
+
+			[DisplayName("Dynamic Recompiler")]
+			[Description("Runs the CPU through an x86-64 block recompiler where possible. Has no effect on other hosts. Doesn't affect sync.")]
+			[DefaultValue(false)]
+			public bool Recompiler { get; set; }
+
 			public void Validate()
 			{
 				if (ScanlineStart_NTSC < 0) ScanlineStart_NTSC = 0;
 				if (ScanlineStart_PAL < 0) ScanlineStart_PAL = 0;
 				if (ScanlineEnd_NTSC > 239) ScanlineEnd_NTSC = 239;
 				if (ScanlineEnd_PAL > 287) ScanlineEnd_PAL = 287;
+				if (RenderThreads < 0) RenderThreads = 0;
+				if (RenderThreads > 8) RenderThreads = 8;
 
 				//make sure theyre not in the wrong order
 				if (ScanlineEnd_NTSC < ScanlineStart_NTSC)
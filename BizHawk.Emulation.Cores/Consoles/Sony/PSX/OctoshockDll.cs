@@ -31,10 +31,12 @@ namespace BizHawk.Emulation.Cores.Sony.PSX
 			Frame
 		};
 
+		[Flags]
 		public enum eShockFramebufferFlags
 		{
 			None = 0,
-			Normalize = 1
+			Normalize = 1,
+			Direct = 2
 		}
 
 		public enum eMemType
@@ -154,6 +156,7 @@ namespace BizHawk.Emulation.Cores.Sony.PSX
 			public eShockRenderType renderType;
 			public eShockDeinterlaceMode deinterlaceMode;
 			public bool skip;
+			public int renderThreads;
 		};
 
 		[StructLayout(LayoutKind.Sequential)]
@@ -295,6 +298,9 @@ namespace BizHawk.Emulation.Cores.Sony.PSX
 		[DllImport(dd, CallingConvention = cc)]
 		public static extern int shock_SetLEC(IntPtr psx, bool enable);
 
+		[DllImport(dd, CallingConvention = cc)]
+		public static extern int shock_SetRecompiler(IntPtr psx, bool enable);
+
 		[DllImport(dd, CallingConvention = cc)]
 		public static extern int shock_GetGPUUnlagged(IntPtr psx);
 	}
@@ -11,7 +11,7 @@ namespace BizHawk.Emulation.Cores.Waterbox
 	/// <summary>
 	/// a simple grow-only fixed max size heap
 	/// </summary>
-	internal sealed class Heap : IBinaryStateable, IDisposable
+	internal sealed class Heap : IIncrementalStateable, IDisposable
 	{
 		public MemoryBlock Memory { get; private set; }
 		/// <summary>
@@ -134,6 +134,51 @@ namespace BizHawk.Emulation.Cores.Waterbox
 			}
 		}
 
+		public void SaveIncrementalBase()
+		{
+			if (!Sealed)
+				Memory.SaveDirtyBase();
+		}
+
+		public void SaveStateIncremental(BinaryWriter bw)
+		{
+			bw.Write(Name);
+			bw.Write(Used);
+			if (!Sealed)
+			{
+				Memory.SaveDirtyPages(bw, Memory.Start, WaterboxUtils.AlignUp(Used));
+			}
+			else
+			{
+				bw.Write(_hash);
+			}
+		}
+
+		public void LoadStateIncremental(BinaryReader br)
+		{
+			var name = br.ReadString();
+			if (name != Name)
+				throw new InvalidOperationException(string.Format("Name did not match for heap {0}", Name));
+			var used = br.ReadUInt64();
+			if (used > Memory.Size)
+				throw new InvalidOperationException(string.Format("Heap {0} used {1} larger than available {2}", Name, used, Memory.Size));
+			if (!Sealed)
+			{
+				Memory.Protect(Memory.Start, Memory.Size, MemoryBlock.Protection.None);
+				Memory.Protect(Memory.Start, used, MemoryBlock.Protection.RW);
+				Memory.LoadDirtyPages(br, Memory.Start, WaterboxUtils.AlignUp(used));
+				Used = used;
+			}
+			else
+			{
+				var hash = br.ReadBytes(_hash.Length);
+				if (!hash.SequenceEqual(_hash))
+				{
+					throw new InvalidOperationException(string.Format("Hash did not match for heap {0}.  Is this the same rom with the same SyncSettings?", Name));
+				}
+			}
+		}
+
 		public void Dispose()
 		{
 			if (Memory != null)
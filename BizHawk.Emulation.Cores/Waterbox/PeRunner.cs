@@ -9,6 +9,7 @@ using System.IO.Compression;
 using System.Linq;
 using System.Runtime.InteropServices;
 using System.Text;
+using System.Threading;
 
 namespace BizHawk.Emulation.Cores.Waterbox
 {
@@ -190,7 +191,7 @@ namespace BizHawk.Emulation.Cores.Waterbox
 		/// <summary>
 		/// special emulator-functions
 		/// </summary>
-		private class Emu
+		private class Emu : IDisposable
 		{
 			private readonly PeRunner _parent;
 			public Emu(PeRunner parent)
@@ -198,6 +199,103 @@ namespace BizHawk.Emulation.Cores.Waterbox
 				_parent = parent;
 			}
 
+			[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+			private delegate void WorkerEntryD(IntPtr arg);
+
+			/// <summary>
+			/// the most worker threads a core can have, whatever the number of cores
+			/// </summary>
+			private const int MaxWorkers = 4;
+
+			// a worker thread only runs guest code between worker_start() and worker_join(), which the core must call
+			// before returning, so it never runs while the core is swapped out or savestated
+			private class Worker
+			{
+				public Thread Thread;
+				public IntPtr EntryPtr;
+				public WorkerEntryD Entry;
+				public IntPtr Arg;
+				public bool Quit;
+				public readonly AutoResetEvent Start = new AutoResetEvent(false);
+				public readonly ManualResetEvent Idle = new ManualResetEvent(true);
+				public readonly AutoResetEvent Wake = new AutoResetEvent(false);
+
+				public void Main()
+				{
+					while (true)
+					{
+						Start.WaitOne();
+						if (Quit)
+							return;
+						Entry(Arg);
+						Idle.Set();
+					}
+				}
+			}
+
+			// leave one core for the thread calling into the core
+			private readonly Worker[] _workers = new Worker[Math.Max(Math.Min(Environment.ProcessorCount - 1, MaxWorkers), 0)];
+
+			[BizExport(CallingConvention.Cdecl, EntryPoint = "worker_start")]
+			public int WorkerStart(int which, IntPtr entry, IntPtr arg)
+			{
+				// nothing to gain from another thread here; the core does the work itself
+				if (which < 0 || which >= _workers.Length)
+					return 0;
+				var w = _workers[which];
+				if (w == null)
+				{
+					w = _workers[which] = new Worker();
+					w.Thread = new Thread(w.Main) { IsBackground = true, Name = "Waterbox worker " + which };
+					w.Thread.Start();
+				}
+				if (!w.Idle.WaitOne(0))
+					throw new InvalidOperationException("Worker is already running!");
+				if (entry != w.EntryPtr)
+				{
+					w.Entry = (WorkerEntryD)CallingConventionAdapters.Waterbox.GetDelegateForFunctionPointer(entry, typeof(WorkerEntryD));
+					w.EntryPtr = entry;
+				}
+				w.Arg = arg;
+				w.Idle.Reset();
+				w.Start.Set();
+				return 1;
+			}
+
+			[BizExport(CallingConvention.Cdecl, EntryPoint = "worker_join")]
+			public void WorkerJoin(int which)
+			{
+				_workers[which].Idle.WaitOne();
+			}
+
+			[BizExport(CallingConvention.Cdecl, EntryPoint = "worker_wait")]
+			public void WorkerWait(int which)
+			{
+				_workers[which].Wake.WaitOne();
+			}
+
+			[BizExport(CallingConvention.Cdecl, EntryPoint = "worker_signal")]
+			public void WorkerSignal(int which)
+			{
+				_workers[which].Wake.Set();
+			}
+
+			public void Dispose()
+			{
+				for (int i = 0; i < _workers.Length; i++)
+				{
+					var w = _workers[i];
+					if (w != null)
+					{
+						w.Idle.WaitOne();
+						w.Quit = true;
+						w.Start.Set();
+						w.Thread.Join();
+						_workers[i] = null;
+					}
+				}
+			}
+
 			[BizExport(CallingConvention.Cdecl, EntryPoint = "alloc_sealed")]
 			public IntPtr AllocSealed(UIntPtr size)
 			{
@@ -963,6 +1061,11 @@ namespace BizHawk.Emulation.Cores.Waterbox
 		/// </summary>
 		private readonly long _createstamp = WaterboxUtils.Timestamp();
 
+		/// <summary>
+		/// timestamp of the last SaveIncrementalBase(); 0 if none has been taken
+		/// </summary>
+		private long _incrementalBasestamp;
+
 		private Heap CreateHeapHelper(uint sizeKB, string name, bool saveStated)
 		{
 			if (sizeKB != 0)
@@ -997,6 +1100,7 @@ namespace BizHawk.Emulation.Cores.Waterbox
 				_exports.Add("libpsxscl.so", BizExvoker.GetExvoker(_psx, CallingConventionAdapters.Waterbox));
 				_emu = new Emu(this);
 				_exports.Add("libemuhost.so", BizExvoker.GetExvoker(_emu, CallingConventionAdapters.Waterbox));
+				_disposeList.Add(_emu);
 				_syscalls = new Syscalls(this);
 				_exports.Add("__syscalls", BizExvoker.GetExvoker(_syscalls, CallingConventionAdapters.Waterbox));
 
@@ -1224,6 +1328,67 @@ namespace BizHawk.Emulation.Cores.Waterbox
 			}
 		}
 
+		/// <summary>
+		/// Record the current memory contents as the base for SaveStateIncremental.  Every incremental state saved
+		/// against an earlier base becomes unloadable.
+		/// </summary>
+		public void SaveIncrementalBase()
+		{
+			using (this.EnterExit())
+			{
+				foreach (var c in _savestateComponents.OfType<IIncrementalStateable>())
+				{
+					c.SaveIncrementalBase();
+				}
+			}
+			_incrementalBasestamp = Math.Max(WaterboxUtils.Timestamp(), _incrementalBasestamp + 1);
+		}
+
+		/// <summary>
+		/// Save a state containing only the pages of savestated memory that differ from the incremental base.
+		/// The state can only be loaded back into this same instance, and only while that base is current.
+		/// </summary>
+		public void SaveStateIncremental(BinaryWriter bw)
+		{
+			if (_incrementalBasestamp == 0)
+				throw new InvalidOperationException("No incremental base taken!");
+			bw.Write(_createstamp);
+			bw.Write(_incrementalBasestamp);
+			bw.Write(_savestateComponents.Count);
+			using (this.EnterExit())
+			{
+				foreach (var c in _savestateComponents)
+				{
+					var ic = c as IIncrementalStateable;
+					if (ic != null)
+						ic.SaveStateIncremental(bw);
+					else
+						c.SaveStateBinary(bw);
+				}
+			}
+		}
+
+		public void LoadStateIncremental(BinaryReader br)
+		{
+			if (br.ReadInt64() != _createstamp)
+				throw new InvalidOperationException("Incremental state was made by a different core instance");
+			if (br.ReadInt64() != _incrementalBasestamp || _incrementalBasestamp == 0)
+				throw new InvalidOperationException("Incremental state was made against a different base");
+			if (br.ReadInt32() != _savestateComponents.Count)
+				throw new InvalidOperationException("Internal savestate error");
+			using (this.EnterExit())
+			{
+				foreach (var c in _savestateComponents)
+				{
+					var ic = c as IIncrementalStateable;
+					if (ic != null)
+						ic.LoadStateIncremental(br);
+					else
+						c.LoadStateBinary(br);
+				}
+			}
+		}
+
 		protected override void Dispose(bool disposing)
 		{
 			base.Dispose(disposing);
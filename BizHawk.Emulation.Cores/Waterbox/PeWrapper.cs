@@ -14,7 +14,7 @@ namespace BizHawk.Emulation.Cores.Waterbox
 	/// <summary>
 	/// represents one PE file.  used in PeRunner
 	/// </summary>
-	internal class PeWrapper : IImportResolver, IBinaryStateable, IDisposable
+	internal class PeWrapper : IImportResolver, IIncrementalStateable, IDisposable
 	{
 		public Dictionary<int, IntPtr> ExportsByOrdinal { get; } = new Dictionary<int, IntPtr>();
 		/// <summary>
@@ -443,5 +443,56 @@ namespace BizHawk.Emulation.Cores.Waterbox
 
 			ProtectMemory();
 		}
+
+		public void SaveIncrementalBase()
+		{
+			if (!_everythingSealed)
+				throw new InvalidOperationException(".idata sections must be closed before saving state");
+			Memory.SaveDirtyBase();
+		}
+
+		public void SaveStateIncremental(BinaryWriter bw)
+		{
+			if (!_everythingSealed)
+				throw new InvalidOperationException(".idata sections must be closed before saving state");
+
+			bw.Write(MAGIC);
+			bw.Write(Start);
+
+			foreach (var s in _sections)
+			{
+				if (!s.W || s == _invisible)
+					continue;
+
+				bw.Write(s.SavedSize);
+				Memory.SaveDirtyPages(bw, s.Start, s.SavedSize);
+			}
+		}
+
+		public void LoadStateIncremental(BinaryReader br)
+		{
+			if (!_everythingSealed)
+				throw new InvalidOperationException(".idata sections must be closed before loading state");
+
+			if (br.ReadUInt64() != MAGIC)
+				throw new InvalidOperationException("Savestate corrupted!");
+			if (br.ReadUInt64() != Start)
+				throw new InvalidOperationException("Trickys elves moved on you!");
+
+			Memory.Protect(Memory.Start, Memory.Size, MemoryBlock.Protection.RW);
+
+			foreach (var s in _sections)
+			{
+				if (!s.W || s == _invisible)
+					continue;
+
+				if (br.ReadUInt64() != s.SavedSize)
+					throw new InvalidOperationException("Unexpected section size for " + s.Name);
+
+				Memory.LoadDirtyPages(br, s.Start, s.SavedSize);
+			}
+
+			ProtectMemory();
+		}
 	}
 }
@@ -13,7 +13,7 @@ using System.Threading.Tasks;
 namespace BizHawk.Emulation.Cores.Waterbox
 {
 	public abstract class WaterboxCore : IEmulator, IVideoProvider, ISoundProvider, IStatable,
-		IInputPollable, ISaveRam
+		IRewindStatable, IInputPollable, ISaveRam
 	{
 		private LibWaterboxCore _core;
 		protected PeRunner _exe;
@@ -271,16 +271,7 @@ namespace BizHawk.Emulation.Cores.Waterbox
 		public void LoadStateBinary(BinaryReader reader)
 		{
 			_exe.LoadStateBinary(reader);
-			// other variables
-			Frame = reader.ReadInt32();
-			LagCount = reader.ReadInt32();
-			IsLagFrame = reader.ReadBoolean();
-			BufferWidth = reader.ReadInt32();
-			BufferHeight = reader.ReadInt32();
-			_clockTime = reader.ReadInt64();
-			_clockRemainder = reader.ReadInt32();
-			// reset pointers here!
-			_core.SetInputCallback(null);
+			LoadOther(reader);
 			//_exe.PrintDebuggingInfo();
 			LoadStateBinaryInternal(reader);
 		}
@@ -288,6 +279,12 @@ namespace BizHawk.Emulation.Cores.Waterbox
 		public void SaveStateBinary(BinaryWriter writer)
 		{
 			_exe.SaveStateBinary(writer);
+			SaveOther(writer);
+			SaveStateBinaryInternal(writer);
+		}
+
+		private void SaveOther(BinaryWriter writer)
+		{
 			// other variables
 			writer.Write(Frame);
 			writer.Write(LagCount);
@@ -296,7 +293,20 @@ namespace BizHawk.Emulation.Cores.Waterbox
 			writer.Write(BufferHeight);
 			writer.Write(_clockTime);
 			writer.Write(_clockRemainder);
-			SaveStateBinaryInternal(writer);
+		}
+
+		private void LoadOther(BinaryReader reader)
+		{
+			// other variables
+			Frame = reader.ReadInt32();
+			LagCount = reader.ReadInt32();
+			IsLagFrame = reader.ReadBoolean();
+			BufferWidth = reader.ReadInt32();
+			BufferHeight = reader.ReadInt32();
+			_clockTime = reader.ReadInt64();
+			_clockRemainder = reader.ReadInt32();
+			// reset pointers here!
+			_core.SetInputCallback(null);
 		}
 
 		public byte[] SaveStateBinary()
@@ -333,6 +343,40 @@ namespace BizHawk.Emulation.Cores.Waterbox
 
 		#endregion
 
+		#region IRewindStatable
+
+		/// <summary>
+		/// record the current waterbox memory as the base that rewind states save against
+		/// </summary>
+		public void ResetRewindStates()
+		{
+			_exe.SaveIncrementalBase();
+		}
+
+		/// <summary>
+		/// save a state that only holds the waterbox memory written since the last ResetRewindStates()
+		/// </summary>
+		public byte[] SaveRewindState()
+		{
+			var ms = new MemoryStream();
+			var bw = new BinaryWriter(ms);
+			_exe.SaveStateIncremental(bw);
+			SaveOther(bw);
+			SaveStateBinaryInternal(bw);
+			bw.Flush();
+			ms.Close();
+			return ms.ToArray();
+		}
+
+		public void LoadRewindState(BinaryReader reader)
+		{
+			_exe.LoadStateIncremental(reader);
+			LoadOther(reader);
+			LoadStateBinaryInternal(reader);
+		}
+
+		#endregion
+
 		#region ISoundProvider
 
 		public void SetSyncMode(SyncSoundMode mode)
@@ -19,7 +19,11 @@ namespace BizHawk.Emulation.DiscSystem
 			if (!IsLibraryAvailable)
 				throw new InvalidOperationException("MednaDisc library is not available!");
 
-			handle = mednadisc_LoadCD(pathToDisc);
+			//prefer the memory-mapped, cached, read-ahead access mode when the library has it
+			if (IsCacheAvailable)
+				handle = mednadisc_LoadCDCached(pathToDisc, CacheSectors, PrefetchSectors);
+			else
+				handle = mednadisc_LoadCD(pathToDisc);
 			if (handle == IntPtr.Zero)
 				throw new InvalidOperationException("Failed to load MednaDisc: " + pathToDisc);
 
@@ -34,6 +38,9 @@ namespace BizHawk.Emulation.DiscSystem
 
 		IntPtr handle;
 
+		const int CacheSectors = 1024;
+		const int PrefetchSectors = 64;
+
 		public MednadiscTOC TOC;
 		public MednadiscTOCTrack[] TOCTracks;
 
@@ -48,6 +55,15 @@ namespace BizHawk.Emulation.DiscSystem
 				mednadisc_ReadSector(handle, LBA, pBuffer + offset);
 		}
 
+		/// <summary>
+		/// reads count sectors starting at LBA, 2448 bytes each, back to back into the target buffer
+		/// </summary>
+		public void Read_2442(int LBA, int count, byte[] buffer, int offset)
+		{
+			fixed (byte* pBuffer = &buffer[0])
+				mednadisc_ReadSectors(handle, LBA, count, pBuffer + offset);
+		}
+
 		//public void ReadSubcodeDeinterleaved(int LBA, byte[] buffer, int offset)
 		//{
 		//  fixed (byte* pBuffer = buf2442)
@@ -99,6 +115,7 @@ namespace BizHawk.Emulation.DiscSystem
 				return;
 			}
 			IntPtr addr = GetProcAddress(lib, "mednadisc_LoadCD");
+			_IsCacheAvailable = GetProcAddress(lib, "mednadisc_LoadCDCached") != IntPtr.Zero;
 			FreeLibrary(lib);
 			if (addr == IntPtr.Zero)
 			{
@@ -115,6 +132,9 @@ namespace BizHawk.Emulation.DiscSystem
 		static bool _IsLibraryAvailable;
 		public static bool IsLibraryAvailable { get { return _IsLibraryAvailable; } }
 
+		static bool _IsCacheAvailable;
+		static bool IsCacheAvailable { get { return _IsCacheAvailable; } }
+
 		public void Dispose()
 		{
 			if(handle == IntPtr.Zero) return;
@@ -155,6 +175,12 @@ namespace BizHawk.Emulation.DiscSystem
 		[DllImport("mednadisc.dll", CallingConvention = CallingConvention.Cdecl)]
 		public static extern int mednadisc_ReadSector(IntPtr disc, int lba, byte* buf2448);
 
+		[DllImport("mednadisc.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern IntPtr mednadisc_LoadCDCached(string path, int cache_sectors, int prefetch_sectors);
+
+		[DllImport("mednadisc.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern int mednadisc_ReadSectors(IntPtr disc, int lba, int count, byte* buf);
+
 		[DllImport("mednadisc.dll", CallingConvention = CallingConvention.Cdecl)]
 		public static extern void mednadisc_CloseCD(IntPtr disc);
 
@@ -0,0 +1,124 @@
+#ifndef COREBATCH_H
+#define COREBATCH_H
+
+// a pool of threads for the native cores' batch exports, which run many independent instances of a core at once.
+// the threads live as long as the CoreBatch, so repeated batches don't pay for starting them.  the jobs of a batch are
+// handed out one at a time to whichever thread is free next, and the calling thread does its share too
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class CoreBatch
+{
+public:
+	// threads counts the caller; 0 or less for one per hardware thread
+	CoreBatch(int threads)
+		:job(0), running(0), quit(false)
+	{
+		if (threads <= 0)
+			threads = std::thread::hardware_concurrency();
+		for (int i = 1; i < threads; i++)
+			workers.push_back(std::thread(&CoreBatch::WorkerMain, this, i));
+	}
+
+	~CoreBatch()
+	{
+		{
+			std::lock_guard<std::mutex> lk(lock);
+			quit = true;
+		}
+		wake.notify_all();
+		for (size_t i = 0; i < workers.size(); i++)
+			workers[i].join();
+	}
+
+	// number of threads jobs run on, counting the caller
+	int Threads() const
+	{
+		return (int)workers.size() + 1;
+	}
+
+	// calls work(i, thread) for each i < count, and returns once they have all finished.  thread is below Threads() and
+	// 0 for the caller; no two jobs run on the same thread at once, so it can pick that thread's scratch buffers
+	void Run(int count, const std::function<void(int, int)> &work)
+	{
+		this->work = &work;
+		this->count = count;
+		next.store(0);
+
+		{
+			std::lock_guard<std::mutex> lk(lock);
+			running = (int)workers.size();
+			job++;
+		}
+		wake.notify_all();
+
+		Work(0);
+
+		std::unique_lock<std::mutex> lk(lock);
+		done.wait(lk, [&]{ return running == 0; });
+	}
+
+	// FNV-1a, for comparing savestates between instances
+	static uint64_t Hash(const void *data, size_t length)
+	{
+		const uint8_t *p = (const uint8_t *)data;
+		uint64_t hash = 0xcbf29ce484222325ULL;
+		for (size_t i = 0; i < length; i++)
+		{
+			hash ^= p[i];
+			hash *= 0x100000001b3ULL;
+		}
+		return hash;
+	}
+
+private:
+	std::vector<std::thread> workers;
+	std::mutex lock;
+	std::condition_variable wake;
+	std::condition_variable done;
+	unsigned job;
+	int running;
+	bool quit;
+
+	const std::function<void(int, int)> *work;
+	int count;
+	std::atomic<int> next;
+
+	void Work(int thread)
+	{
+		for (int i; (i = next.fetch_add(1)) < count;)
+			(*work)(i, thread);
+	}
+
+	void WorkerMain(int thread)
+	{
+		unsigned seen = 0;
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lk(lock);
+				wake.wait(lk, [&]{ return quit || job != seen; });
+				if (quit)
+					return;
+				seen = job;
+			}
+
+			Work(thread);
+
+			{
+				std::lock_guard<std::mutex> lk(lock);
+				if (--running == 0)
+					done.notify_all();
+			}
+		}
+	}
+};
+
+#endif
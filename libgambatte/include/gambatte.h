@@ -90,6 +90,11 @@ public:
 
 	void setLayers(unsigned mask);
 
+	/** When set, runFor() keeps all video timing, interrupts and sprite evaluation exact but doesn't draw anything.
+	  * Takes effect at the next frame boundary; the video buffer keeps the last frame drawn until then.
+	  */
+	void setSkipRender(bool skip);
+
 	/** Reset to initial state.
 	  * Equivalent to reloading a ROM image, or turning a Game Boy Color off and on again.
 	  */
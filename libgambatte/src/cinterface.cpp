@@ -3,6 +3,7 @@
 #include <cstdlib>
 #include <cstring>
 #include "newstate.h"
+#include "linkrunner.h"
 
 using namespace gambatte;
 
@@ -65,6 +66,11 @@ GBEXPORT void gambatte_setlayers(GB *g, unsigned mask)
 	g->setLayers(mask);
 }
 
+GBEXPORT void gambatte_setskiprender(GB *g, int skip)
+{
+	g->setSkipRender(!!skip);
+}
+
 GBEXPORT void gambatte_reset(GB *g, long long now, unsigned div)
 {
 	g->reset(now, div);
@@ -209,6 +215,22 @@ GBEXPORT int gambatte_linkstatus(GB *g, int which)
 	return g->LinkStatus(which);
 }
 
+GBEXPORT LinkRunner *gambatte_linkcreate(GB *left, GB *right)
+{
+	return new LinkRunner(left, right);
+}
+
+GBEXPORT void gambatte_linkdestroy(LinkRunner *lr)
+{
+	delete lr;
+}
+
+GBEXPORT void gambatte_linkrunfor(LinkRunner *lr, short *lsoundbuf, short *rsoundbuf, int *lpos, int *rpos, int target, int step, int connected,
+	unsigned int *lvideobuf, unsigned int *rvideobuf, int pitch)
+{
+	lr->runFor((unsigned int *)lsoundbuf, (unsigned int *)rsoundbuf, lpos, rpos, target, step, !!connected, lvideobuf, rvideobuf, pitch);
+}
+
 GBEXPORT void gambatte_getregs(GB *g, int *dest)
 {
 	g->GetRegs(dest);
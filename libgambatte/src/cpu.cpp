@@ -111,15 +111,15 @@ void CPU::loadState(const SaveState &state) {
 #define DE() ( D << 8 | E )
 #define HL() ( H << 8 | L )
 
-#define READ(dest, addr) do { (dest) = memory.read(addr, cycleCounter); cycleCounter += 4; } while (0)
-#define PEEK(dest, addr) do { (dest) = memory.read(addr, cycleCounter); } while(0)
+#define READ(dest, addr) do { (dest) = memory.read<hooks>(addr, cycleCounter); cycleCounter += 4; } while (0)
+#define PEEK(dest, addr) do { (dest) = memory.read<hooks>(addr, cycleCounter); } while(0)
 // #define PC_READ(dest, addr) do { (dest) = memory.pc_read(addr, cycleCounter); cycleCounter += 4; } while (0)
-#define PC_READ(dest) do { (dest) = memory.read_excb(PC, cycleCounter, false); PC = (PC + 1) & 0xFFFF; cycleCounter += 4; } while (0)
-#define PC_READ_FIRST(dest) do { (dest) = memory.read_excb(PC, cycleCounter, true); PC = (PC + 1) & 0xFFFF; cycleCounter += 4; } while (0)
+#define PC_READ(dest) do { (dest) = memory.read_excb<hooks>(PC, cycleCounter, false); PC = (PC + 1) & 0xFFFF; cycleCounter += 4; } while (0)
+#define PC_READ_FIRST(dest) do { (dest) = memory.read_excb<hooks>(PC, cycleCounter, true); PC = (PC + 1) & 0xFFFF; cycleCounter += 4; } while (0)
 #define FF_READ(dest, addr) do { (dest) = memory.ff_read(addr, cycleCounter); cycleCounter += 4; } while (0)
 
-#define WRITE(addr, data) do { memory.write(addr, data, cycleCounter); cycleCounter += 4; } while (0)
-#define FF_WRITE(addr, data) do { memory.ff_write(addr, data, cycleCounter); cycleCounter += 4; } while (0)
+#define WRITE(addr, data) do { memory.write<hooks>(addr, data, cycleCounter); cycleCounter += 4; } while (0)
+#define FF_WRITE(addr, data) do { memory.ff_write<hooks>(addr, data, cycleCounter); cycleCounter += 4; } while (0)
 
 #define PC_MOD(data) do { PC = data; cycleCounter += 4; } while (0)
 
@@ -489,31 +489,20 @@ void CPU::loadState(const SaveState &state) {
 	PC_MOD(ret_var_h << 8 | ret_var_l); \
 } while (0)
 
-void CPU::process(const unsigned long cycles) {
-	memory.setEndtime(cycleCounter_, cycles);
-	hitInterruptAddress = 0;
-	memory.updateInput();
-
-	//unsigned char A = A_;
-	unsigned long cycleCounter = cycleCounter_;
-	
-	while (memory.isActive()) {
-		//unsigned short PC = PC_;
-		
-		if (memory.halted()) {
-			if (cycleCounter < memory.nextEventTime()) {
-				const unsigned long cycles = memory.nextEventTime() - cycleCounter;
-				cycleCounter += cycles + (-cycles & 3);
-			}
-		} else while (cycleCounter < memory.nextEventTime()) {
+// The opcode loop, run until the next event.  It is compiled twice: with hooks set, it checks the debugger and CDL callbacks,
+// the mapped boot ROM, the trace callback and the interrupt addresses on every access and instruction; without, none of them.
+// process() picks the variant anew for every slice between events, so hooks set or cleared between frames take effect right away.
+template<bool hooks>
+unsigned long CPU::execute(unsigned long cycleCounter) {
+		while (cycleCounter < memory.nextEventTime()) {
 			unsigned char opcode = 0x00;
 			
 			int FullPC = PC;
 
-			if (PC >= 0x4000 && PC <= 0x7FFF)
+			if (hooks && PC >= 0x4000 && PC <= 0x7FFF)
 				FullPC |= memory.curRomBank() << 16;
 
-			for (int i = 0; i < numInterruptAddresses; i++) {
+			for (int i = 0; hooks && i < numInterruptAddresses; i++) {
 				if (FullPC == interruptAddresses[i]) {
 					hitInterruptAddress = interruptAddresses[i];
 					memory.setEndtime(cycleCounter, 0);
@@ -523,7 +512,7 @@ void CPU::process(const unsigned long cycles) {
 
 			if (!hitInterruptAddress)
 			{
-				if (tracecallback) {
+				if (hooks && tracecallback) {
 					int result[14];
 					result[0] = cycleCounter;
 					result[1] = PC;
@@ -967,7 +956,7 @@ void CPU::process(const unsigned long cycles) {
 				{
 					unsigned addr = HL();
 					
-					A = memory.read(addr, cycleCounter);
+					A = memory.read<hooks>(addr, cycleCounter);
 					cycleCounter += 4;
 					
 					addr = (addr - 1) & 0xFFFF;
@@ -2862,6 +2851,30 @@ void CPU::process(const unsigned long cycles) {
 			}
 		}
 		
+	return cycleCounter;
+}
+
+void CPU::process(const unsigned long cycles) {
+	memory.setEndtime(cycleCounter_, cycles);
+	hitInterruptAddress = 0;
+	memory.updateInput();
+
+	//unsigned char A = A_;
+	unsigned long cycleCounter = cycleCounter_;
+	
+	while (memory.isActive()) {
+		//unsigned short PC = PC_;
+		
+		if (memory.halted()) {
+			if (cycleCounter < memory.nextEventTime()) {
+				const unsigned long cycles = memory.nextEventTime() - cycleCounter;
+				cycleCounter += cycles + (-cycles & 3);
+			}
+		} else if (tracecallback || numInterruptAddresses || memory.hooksActive()) {
+			cycleCounter = execute<true>(cycleCounter);
+		} else
+			cycleCounter = execute<false>(cycleCounter);
+		
 		//PC_ = PC;
 		cycleCounter = memory.event(cycleCounter);
 	}
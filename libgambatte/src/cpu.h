@@ -43,6 +43,7 @@ class CPU {
 	int hitInterruptAddress;
 
 	void process(unsigned long cycles);
+	template<bool hooks> unsigned long execute(unsigned long cycleCounter);
 	
 	void (*tracecallback)(void *);
 
@@ -57,6 +58,7 @@ public:
 	void setStatePtrs(SaveState &state);
 	void loadState(const SaveState &state);
 	void setLayers(unsigned mask) { memory.setLayers(mask); }
+	void setSkipRender(bool skip) { memory.setSkipRender(skip); }
 	
 	void loadSavedata(const char *data) { memory.loadSavedata(data); }
 	int saveSavedataLength() {return memory.saveSavedataLength(); }
@@ -132,7 +134,7 @@ public:
 	unsigned char ExternalRead(unsigned short addr) { return memory.peek(addr); }
 	void ExternalWrite(unsigned short addr, unsigned char val) { memory.write_nocb(addr, val, cycleCounter_); }
 
-	int LinkStatus(int which) { return memory.LinkStatus(which); }
+	int LinkStatus(int which) { return memory.LinkStatus(which, cycleCounter_); }
 
 	void GetRegs(int *dest);
 
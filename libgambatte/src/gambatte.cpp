@@ -68,6 +68,11 @@ void GB::setLayers(unsigned mask)
 	p_->cpu.setLayers(mask);
 }
 
+void GB::setSkipRender(bool skip)
+{
+	p_->cpu.setSkipRender(skip);
+}
+
 void GB::blitTo(gambatte::uint_least32_t *videoBuf, int pitch)
 {
 	gambatte::uint_least32_t *src = p_->vbuff;
@@ -0,0 +1,184 @@
+#include "linkrunner.h"
+
+namespace gambatte {
+
+// How many samples a LinkStatus(260) bound may be off by: the sides overshoot the step targets by up to an instruction and
+// interrupt dispatch, and the sound buffer is only filled at the end of runFor().
+static const int horizonSlack = 64;
+
+LinkRunner::LinkRunner(GB *left, GB *right)
+: job(0), jobDone(0), quit(false)
+{
+	sides[0].gb = left;
+	sides[1].gb = right;
+	threaded = std::thread::hardware_concurrency() > 1;
+	if (threaded)
+		worker = std::thread(&LinkRunner::workerMain, this);
+}
+
+LinkRunner::~LinkRunner() {
+	if (!threaded)
+		return;
+	{
+		std::lock_guard<std::mutex> lk(lock);
+		quit = true;
+	}
+	cond.notify_all();
+	worker.join();
+}
+
+void LinkRunner::workerMain() {
+	unsigned seen = 0;
+
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lk(lock);
+			cond.wait(lk, [&]{ return quit || job != seen; });
+			if (quit)
+				return;
+			seen = job;
+		}
+
+		runSide(sides[1], sides[0], false);
+
+		{
+			std::lock_guard<std::mutex> lk(lock);
+			jobDone = seen;
+		}
+		cond.notify_all();
+	}
+}
+
+void LinkRunner::runStep(Side &s, const int stepTarget) {
+	// runFor() returns early when a frame is produced, so keep going until the target is reached
+	while (s.pos < stepTarget) {
+		unsigned nsamp = stepTarget - s.pos;
+		if (s.gb->runFor(s.soundbuf + s.pos, nsamp) > 0)
+			s.gb->blitTo(s.videobuf, pitch);
+		s.pos += nsamp;
+	}
+}
+
+int LinkRunner::computeHorizon(const Side &s, const int k) const {
+	const int delay = s.gb->LinkStatus(260);
+	if (delay < 0)
+		return numSteps;
+
+	// at most 4 cycles per sample, in double speed mode
+	const long long earliest = s.pos + delay / 4 - horizonSlack;
+	int j = k + 1;
+	while (j < numSteps && stepTarget(j) <= earliest)
+		j++;
+	return j;
+}
+
+// the same as the serial loop, left side first
+void LinkRunner::exchange() {
+	for (int i = 0; i < 2; i++) {
+		if (sides[i].gb->LinkStatus(256)) { // ClockTrigger
+			sides[i].gb->LinkStatus(257); // ack
+			const int lo = sides[0].gb->LinkStatus(258); // GetOut
+			const int ro = sides[1].gb->LinkStatus(258);
+			sides[0].gb->LinkStatus(ro & 0xff); // ShiftIn
+			sides[1].gb->LinkStatus(lo & 0xff);
+		}
+	}
+}
+
+void LinkRunner::runSide(Side &self, Side &other, const bool exchanger) {
+	for (int k = 0; k < numSteps; k++) {
+		runStep(self, stepTarget(k));
+
+		if (!connected)
+			continue;
+
+		self.triggered = self.gb->LinkStatus(256) != 0;
+		self.horizon.store(self.triggered ? k : computeHorizon(self, k), std::memory_order_release);
+		self.done.store(k, std::memory_order_release);
+
+		// wait until we know whether the other side signaled the clock at this step, and if either side did, for the bytes
+		// to be traded.  only the exchanger (the calling thread) touches both sides, while the other one is parked here.
+		bool traded = false;
+		for (unsigned spin = 0;; spin++) {
+			if (!exchanger && exchanged.load(std::memory_order_acquire) >= k) {
+				traded = true;
+				break;
+			}
+
+			const int done = other.done.load(std::memory_order_acquire);
+			const int horizon = other.horizon.load(std::memory_order_acquire);
+
+			if (!self.triggered && horizon > k)
+				break;
+
+			if (exchanger && done >= k && (self.triggered || horizon == k)) {
+				exchange();
+				exchanged.store(k, std::memory_order_release);
+				traded = true;
+				break;
+			}
+
+			if (spin >= 256)
+				std::this_thread::yield();
+		}
+
+		if (traded)
+			self.horizon.store(computeHorizon(self, k), std::memory_order_release);
+	}
+}
+
+void LinkRunner::runFor(gambatte::uint_least32_t *lsoundbuf, gambatte::uint_least32_t *rsoundbuf, int *lpos, int *rpos, int target, int step, bool connected,
+	gambatte::uint_least32_t *lvideobuf, gambatte::uint_least32_t *rvideobuf, int pitch)
+{
+	this->target = target;
+	this->step = step;
+	this->numSteps = (target + step - 1) / step;
+	this->connected = connected;
+	this->pitch = pitch;
+
+	sides[0].soundbuf = lsoundbuf;
+	sides[0].videobuf = lvideobuf;
+	sides[0].pos = *lpos;
+	sides[1].soundbuf = rsoundbuf;
+	sides[1].videobuf = rvideobuf;
+	sides[1].pos = *rpos;
+
+	for (int i = 0; i < 2; i++) {
+		sides[i].triggered = false;
+		sides[i].horizon.store(computeHorizon(sides[i], -1), std::memory_order_relaxed);
+		sides[i].done.store(-1, std::memory_order_relaxed);
+	}
+	exchanged.store(-1, std::memory_order_relaxed);
+
+	if (!threaded) {
+		for (int k = 0; k < numSteps; k++) {
+			runStep(sides[0], stepTarget(k));
+			runStep(sides[1], stepTarget(k));
+			if (connected)
+				exchange();
+		}
+
+		*lpos = sides[0].pos;
+		*rpos = sides[1].pos;
+		return;
+	}
+
+	unsigned thisJob;
+	{
+		std::lock_guard<std::mutex> lk(lock);
+		thisJob = ++job;
+	}
+	cond.notify_all();
+
+	runSide(sides[0], sides[1], true);
+
+	{
+		std::unique_lock<std::mutex> lk(lock);
+		cond.wait(lk, [&]{ return jobDone == thisJob; });
+	}
+
+	*lpos = sides[0].pos;
+	*rpos = sides[1].pos;
+}
+
+}
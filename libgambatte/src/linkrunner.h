@@ -0,0 +1,72 @@
+#ifndef LINKRUNNER_H
+#define LINKRUNNER_H
+
+#include "gambatte.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace gambatte {
+
+// Runs two GBs joined by a link cable, the right one on a worker thread.
+//
+// The results are the same as stepping both on one thread: run each for `step` samples, then if either has signaled the
+// serial clock, trade their output bytes (left first, then right).  The threads only meet at the steps where one of them
+// can have signaled the clock; each one publishes how far ahead that can happen at the earliest(LinkStatus(260)), and the
+// other one runs freely up to there.  On a single core machine, both just run on the calling thread.
+class LinkRunner {
+public:
+	LinkRunner(GB *left, GB *right);
+	~LinkRunner();
+
+	// Produces samples from *lpos and *rpos up to at least `target`, blitting each side's frames to its video buffer.
+	// The positions are updated to the ones reached.  If not connected, the sides never trade bytes or wait for each other.
+	void runFor(gambatte::uint_least32_t *lsoundbuf, gambatte::uint_least32_t *rsoundbuf, int *lpos, int *rpos, int target, int step, bool connected,
+		gambatte::uint_least32_t *lvideobuf, gambatte::uint_least32_t *rvideobuf, int pitch);
+
+private:
+	struct Side {
+		GB *gb;
+		gambatte::uint_least32_t *soundbuf;
+		gambatte::uint_least32_t *videobuf;
+		int pos;
+		bool triggered;
+
+		// last step completed, and first step at which this side may see the clock signaled.  always stored horizon first.
+		std::atomic<int> done;
+		std::atomic<int> horizon;
+		char pad[64];
+	};
+
+	void workerMain();
+	void runSide(Side &self, Side &other, bool exchanger);
+	void runStep(Side &s, int stepTarget);
+	int computeHorizon(const Side &s, int k) const;
+	void exchange();
+
+	int stepTarget(int k) const {
+		return k >= numSteps - 1 ? target : (k + 1) * step;
+	}
+
+	Side sides[2];
+	int target;
+	int step;
+	int numSteps;
+	bool connected;
+	int pitch;
+
+	std::atomic<int> exchanged;
+
+	bool threaded;
+	std::thread worker;
+	std::mutex lock;
+	std::condition_variable cond;
+	unsigned job;
+	unsigned jobDone;
+	bool quit;
+};
+
+}
+
+#endif
@@ -1104,10 +1104,25 @@ bool Memory::getMemoryArea(int which, unsigned char **data, int *length) {
 	}
 }
 
-int Memory::LinkStatus(int which)
+int Memory::LinkStatus(int which, unsigned long cycleCounter)
 {
 	switch (which)
 	{
+	case 260: // ClockDelay: lower bound on the cycles until the clock can next be signaled, or -1 if it can't be
+		if (linkClockTrigger)
+			return 0;
+		if (!LINKCABLE)
+			return -1;
+		{
+			// a transfer started right now finishes no sooner than this (see the 0xFF02 write), and may replace the one in flight
+			const unsigned long restart = isCgb() ? 0x10 * 8 - 7 : 0x200 * 8 - 0xFF;
+			const unsigned long serial = intreq.eventTime(SERIAL);
+			if (serial == static_cast<unsigned long>(DISABLED_TIME))
+				return restart;
+			if (serial <= cycleCounter)
+				return 0;
+			return serial - cycleCounter < restart ? serial - cycleCounter : restart;
+		}
 	case 256: // ClockSignaled
 		return linkClockTrigger;
 	case 257: // AckClockSignal
@@ -121,6 +121,7 @@ public:
 	unsigned long nextEventTime() const { return intreq.minEventTime(); }
 
 	void setLayers(unsigned mask) { display.setLayers(mask); }
+	void setSkipRender(bool skip) { display.setSkipRender(skip); }
 	
 	bool isActive() const { return intreq.eventTime(END) != DISABLED_TIME; }
 	
@@ -204,32 +205,43 @@ public:
 		return dmgBios[P];
 	}
 
+	// true if anything read/read_excb/write/ff_write check on every access is live; the CPU uses the hooks=false variants otherwise.
+	bool hooksActive() const {
+		return readCallback || writeCallback || execCallback || cdCallback || biosMode;
+	}
+
+	template<bool hooks = true>
 	unsigned read(const unsigned P, const unsigned long cycleCounter) {
-		if (readCallback)
-			readCallback(P);
-		if(cdCallback)
-		{
-			CDMapResult map = CDMap(P);
-			if(map.type != eCDLog_AddrType_None)
-				cdCallback(map.addr,map.type,eCDLog_Flags_Data);
-		}
-		if (biosMode && ((!gbIsCgb_ && P < 0x100) || (gbIsCgb_ && P < 0x900 && (P < 0x100 || P >= 0x200)))) {
-			return readBios(P);
+		if (hooks) {
+			if (readCallback)
+				readCallback(P);
+			if(cdCallback)
+			{
+				CDMapResult map = CDMap(P);
+				if(map.type != eCDLog_AddrType_None)
+					cdCallback(map.addr,map.type,eCDLog_Flags_Data);
+			}
+			if (biosMode && ((!gbIsCgb_ && P < 0x100) || (gbIsCgb_ && P < 0x900 && (P < 0x100 || P >= 0x200)))) {
+				return readBios(P);
+			}
 		}
 		return cart.rmem(P >> 12) ? cart.rmem(P >> 12)[P] : nontrivial_read(P, cycleCounter);
 	}
 
+	template<bool hooks = true>
 	unsigned read_excb(const unsigned P, const unsigned long cycleCounter, bool first) {
-		if (execCallback)
-			execCallback(P);
-		if(cdCallback)
-		{
-			CDMapResult map = CDMap(P);
-			if(map.type != eCDLog_AddrType_None)
-				cdCallback(map.addr,map.type,first?eCDLog_Flags_ExecFirst : eCDLog_Flags_ExecOperand);
-		}
-		if (biosMode && ((!gbIsCgb_ && P < 0x100) || (gbIsCgb_ && P < 0x900 && (P < 0x100 || P >= 0x200)))) {
-			return readBios(P);
+		if (hooks) {
+			if (execCallback)
+				execCallback(P);
+			if(cdCallback)
+			{
+				CDMapResult map = CDMap(P);
+				if(map.type != eCDLog_AddrType_None)
+					cdCallback(map.addr,map.type,first?eCDLog_Flags_ExecFirst : eCDLog_Flags_ExecOperand);
+			}
+			if (biosMode && ((!gbIsCgb_ && P < 0x100) || (gbIsCgb_ && P < 0x900 && (P < 0x100 || P >= 0x200)))) {
+				return readBios(P);
+			}
 		}
 		return cart.rmem(P >> 12) ? cart.rmem(P >> 12)[P] : nontrivial_read(P, cycleCounter);
 	}
@@ -248,11 +260,14 @@ public:
 			nontrivial_write(P, data, cycleCounter);
 	}
 	
+	template<bool hooks = true>
 	void write(const unsigned P, const unsigned data, const unsigned long cycleCounter) {
 		if (cart.wmem(P >> 12)) {
 			cart.wmem(P >> 12)[P] = data;
 		} else
 			nontrivial_write(P, data, cycleCounter);
+		if (!hooks)
+			return;
 		if (writeCallback)
 			writeCallback(P);
 		if(cdCallback)
@@ -263,12 +278,13 @@ public:
 		}
 	}
 	
+	template<bool hooks = true>
 	void ff_write(const unsigned P, const unsigned data, const unsigned long cycleCounter) {
 		if (P - 0xFF80u < 0x7Fu) {
 			ioamhram[P - 0xFE00] = data;
 		} else
 			nontrivial_ff_write(P, data, cycleCounter);
-		if(cdCallback)
+		if(hooks && cdCallback)
 		{
 			CDMapResult map = CDMap(P);
 			if(map.type != eCDLog_AddrType_None)
@@ -326,7 +342,7 @@ public:
 		display.blackScreen();
 	}
 
-	int LinkStatus(int which);
+	int LinkStatus(int which, unsigned long cycleCounter);
 
 	template<bool isReader>void SyncState(NewState *ns);
 };
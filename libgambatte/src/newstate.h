@@ -9,6 +9,7 @@ namespace gambatte {
 class NewState
 {
 public:
+	virtual ~NewState() { }
 	virtual void Save(const void *ptr, size_t size, const char *name) = 0;
 	virtual void Load(void *ptr, size_t size, const char *name) = 0;
 	virtual void EnterSection(const char *name) { }
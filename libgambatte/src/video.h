@@ -175,6 +175,7 @@ public:
 	void setCgbPalette(unsigned *lut);
 	void setVideoBuffer(uint_least32_t *videoBuf, int pitch);
 	void setLayers(unsigned mask) { ppu.setLayers(mask); }
+	void setSkipRender(bool skip) { ppu.setSkipRender(skip); }
 	void setCgb(bool cgb);
 	void copyCgbPalettesToDmg();
 	void blackScreen();
@@ -126,6 +126,7 @@ namespace M2 {
 		static void f0(PPUPriv &p) {
 			p.weMaster = (p.lcdc & 0x20) && 0 == p.wy;
 			p.winYPos = 0xFF;
+			p.skipRender = p.skipRenderReq;
 			nextCall(m3StartLineCycle(p.cgb), M3Start::f0_, p);
 		}
 	}
@@ -293,6 +294,9 @@ namespace M3Start {
 }
 
 namespace M3Loop {
+	// With render false, only the parts that affect timing and state are done: sprite fetches, the shifting out of sprite
+	// pixels, and the tile fetches.  Nothing is written to dbufline.
+	template<bool render>
 	static void doFullTilesUnrolledDmg(PPUPriv &p, const int xend, uint_least32_t *const dbufline,
 			const unsigned char *const tileMapLine, const unsigned tileline, unsigned tileMapXpos) {
 		const unsigned tileIndexSign = ~p.lcdc << 3 & 0x80;
@@ -359,21 +363,25 @@ namespace M3Loop {
 				xpos += n;
 				
 				if (!(p.lcdc & 1)) {
-					do { *dst++ = p.bgPalette[0]; } while (dst != dstend);
+					if (render)
+						do { *dst++ = p.bgPalette[0]; } while (dst != dstend);
 					tileMapXpos += n >> 3;
 
 					unsigned const tno = tileMapLine[(tileMapXpos - 1) & 0x1F];
 					ntileword = expand_lut[(tileDataLine + tno * 16 - (tno & tileIndexSign) * 32)[0]]
 					          + expand_lut[(tileDataLine + tno * 16 - (tno & tileIndexSign) * 32)[1]] * 2;
 				} else do {
-					dst[0] = p.bgPalette[ ntileword & 0x0003       ];
-					dst[1] = p.bgPalette[(ntileword & 0x000C) >>  2];
-					dst[2] = p.bgPalette[(ntileword & 0x0030) >>  4];
-					dst[3] = p.bgPalette[(ntileword & 0x00C0) >>  6];
-					dst[4] = p.bgPalette[(ntileword & 0x0300) >>  8];
-					dst[5] = p.bgPalette[(ntileword & 0x0C00) >> 10];
-					dst[6] = p.bgPalette[(ntileword & 0x3000) >> 12];
-					dst[7] = p.bgPalette[ ntileword           >> 14];
+					if (render) {
+						dst[0] = p.bgPalette[ ntileword & 0x0003       ];
+						dst[1] = p.bgPalette[(ntileword & 0x000C) >>  2];
+						dst[2] = p.bgPalette[(ntileword & 0x0030) >>  4];
+						dst[3] = p.bgPalette[(ntileword & 0x00C0) >>  6];
+						dst[4] = p.bgPalette[(ntileword & 0x0300) >>  8];
+						dst[5] = p.bgPalette[(ntileword & 0x0C00) >> 10];
+						dst[6] = p.bgPalette[(ntileword & 0x3000) >> 12];
+						dst[7] = p.bgPalette[ ntileword           >> 14];
+					}
+					
 					dst += 8;
 					
 					unsigned const tno = tileMapLine[tileMapXpos & 0x1F];
@@ -397,20 +405,22 @@ namespace M3Loop {
 				uint_least32_t *const dst = dbufline + (xpos - 8);
 				const unsigned tileword = -(p.lcdc & 1U) & p.ntileword;
 				
-				dst[0] = p.bgPalette[ tileword & 0x0003       ];
-				dst[1] = p.bgPalette[(tileword & 0x000C) >>  2];
-				dst[2] = p.bgPalette[(tileword & 0x0030) >>  4];
-				dst[3] = p.bgPalette[(tileword & 0x00C0) >>  6];
-				dst[4] = p.bgPalette[(tileword & 0x0300) >>  8];
-				dst[5] = p.bgPalette[(tileword & 0x0C00) >> 10];
-				dst[6] = p.bgPalette[(tileword & 0x3000) >> 12];
-				dst[7] = p.bgPalette[ tileword           >> 14];
+				if (render) {
+					dst[0] = p.bgPalette[ tileword & 0x0003       ];
+					dst[1] = p.bgPalette[(tileword & 0x000C) >>  2];
+					dst[2] = p.bgPalette[(tileword & 0x0030) >>  4];
+					dst[3] = p.bgPalette[(tileword & 0x00C0) >>  6];
+					dst[4] = p.bgPalette[(tileword & 0x0300) >>  8];
+					dst[5] = p.bgPalette[(tileword & 0x0C00) >> 10];
+					dst[6] = p.bgPalette[(tileword & 0x3000) >> 12];
+					dst[7] = p.bgPalette[ tileword           >> 14];
+				}
 				
 				int i = nextSprite - 1;
 			
 				if(p.layersMask & LAYER_MASK_OBJ)
 				{
-					if (!(p.lcdc & 2)) {
+					if (!render || !(p.lcdc & 2)) {
 						do {
 							const int pos = static_cast<int>(p.spriteList[i].spx) - xpos;
 							p.spwordList[i] >>= pos * 2 >= 0 ? 16 - pos * 2 : 16 + pos * 2;
@@ -489,6 +499,7 @@ namespace M3Loop {
 		p.xpos = xpos;
 	}
 	
+	template<bool render>
 	static void doFullTilesUnrolledCgb(PPUPriv &p, const int xend, uint_least32_t *const dbufline,
 			const unsigned char *const tileMapLine, const unsigned tileline, unsigned tileMapXpos) {
 		int xpos = p.xpos;
@@ -497,8 +508,9 @@ namespace M3Loop {
 
 		if(!(p.layersMask & LAYER_MASK_BG))
 		{
-			for(int x=xpos,i=0;x<xend;x++,i++)
-				dbufline[i] = p.bgPalette[0]; //guessing?
+			if (render)
+				for(int x=xpos,i=0;x<xend;x++,i++)
+					dbufline[i] = p.bgPalette[0]; //guessing?
 			return;
 		}
 		
@@ -553,15 +565,18 @@ namespace M3Loop {
 				xpos += n;
 				
 				do {
-					const unsigned long *const bgPalette = p.bgPalette + (nattrib & 7) * 4;
-					dst[0] = bgPalette[ ntileword & 0x0003       ];
-					dst[1] = bgPalette[(ntileword & 0x000C) >>  2];
-					dst[2] = bgPalette[(ntileword & 0x0030) >>  4];
-					dst[3] = bgPalette[(ntileword & 0x00C0) >>  6];
-					dst[4] = bgPalette[(ntileword & 0x0300) >>  8];
-					dst[5] = bgPalette[(ntileword & 0x0C00) >> 10];
-					dst[6] = bgPalette[(ntileword & 0x3000) >> 12];
-					dst[7] = bgPalette[ ntileword           >> 14];
+					if (render) {
+						const unsigned long *const bgPalette = p.bgPalette + (nattrib & 7) * 4;
+						dst[0] = bgPalette[ ntileword & 0x0003       ];
+						dst[1] = bgPalette[(ntileword & 0x000C) >>  2];
+						dst[2] = bgPalette[(ntileword & 0x0030) >>  4];
+						dst[3] = bgPalette[(ntileword & 0x00C0) >>  6];
+						dst[4] = bgPalette[(ntileword & 0x0300) >>  8];
+						dst[5] = bgPalette[(ntileword & 0x0C00) >> 10];
+						dst[6] = bgPalette[(ntileword & 0x3000) >> 12];
+						dst[7] = bgPalette[ ntileword           >> 14];
+					}
+					
 					dst += 8;
 					
 					unsigned const tno = tileMapLine[ tileMapXpos & 0x1F          ];
@@ -593,20 +608,22 @@ namespace M3Loop {
 				const unsigned attrib   = p.nattrib;
 				const unsigned long *const bgPalette = p.bgPalette + (attrib & 7) * 4;
 				
-				dst[0] = bgPalette[ tileword & 0x0003       ];
-				dst[1] = bgPalette[(tileword & 0x000C) >>  2];
-				dst[2] = bgPalette[(tileword & 0x0030) >>  4];
-				dst[3] = bgPalette[(tileword & 0x00C0) >>  6];
-				dst[4] = bgPalette[(tileword & 0x0300) >>  8];
-				dst[5] = bgPalette[(tileword & 0x0C00) >> 10];
-				dst[6] = bgPalette[(tileword & 0x3000) >> 12];
-				dst[7] = bgPalette[ tileword           >> 14];
+				if (render) {
+					dst[0] = bgPalette[ tileword & 0x0003       ];
+					dst[1] = bgPalette[(tileword & 0x000C) >>  2];
+					dst[2] = bgPalette[(tileword & 0x0030) >>  4];
+					dst[3] = bgPalette[(tileword & 0x00C0) >>  6];
+					dst[4] = bgPalette[(tileword & 0x0300) >>  8];
+					dst[5] = bgPalette[(tileword & 0x0C00) >> 10];
+					dst[6] = bgPalette[(tileword & 0x3000) >> 12];
+					dst[7] = bgPalette[ tileword           >> 14];
+				}
 				
 				int i = nextSprite - 1;
 
 				if(p.layersMask & LAYER_MASK_OBJ)
 				{
-					if (!(p.lcdc & 2)) {
+					if (!render || !(p.lcdc & 2)) {
 						do {
 							const int pos = static_cast<int>(p.spriteList[i].spx) - xpos;
 							p.spwordList[i] >>= pos * 2 >= 0 ? 16 - pos * 2 : 16 + pos * 2;
@@ -722,14 +739,14 @@ namespace M3Loop {
 		p.xpos = xpos;
 	}
 	
-	static void doFullTilesUnrolled(PPUPriv &p) {
+	template<bool render>
+	static void doFullTilesUnrolled(PPUPriv &p, uint_least32_t *const dbufline) {
 		int xpos = p.xpos;
 		const int xend = static_cast<int>(p.wx) < xpos || p.wx >= 168 ? 161 : static_cast<int>(p.wx) - 7;
 		
 		if (xpos >= xend)
 			return;
 	
-		uint_least32_t *const dbufline = p.framebuf.fbline();
 		const unsigned char *tileMapLine;
 		unsigned tileline;
 		unsigned tileMapXpos;
@@ -748,13 +765,13 @@ namespace M3Loop {
 			uint_least32_t prebuf[16];
 			
 			if (p.cgb) {
-				doFullTilesUnrolledCgb(p, xend < 8 ? xend : 8, prebuf + (8 - xpos), tileMapLine, tileline, tileMapXpos);
+				doFullTilesUnrolledCgb<render>(p, xend < 8 ? xend : 8, prebuf + (8 - xpos), tileMapLine, tileline, tileMapXpos);
 			} else
-				doFullTilesUnrolledDmg(p, xend < 8 ? xend : 8, prebuf + (8 - xpos), tileMapLine, tileline, tileMapXpos);
+				doFullTilesUnrolledDmg<render>(p, xend < 8 ? xend : 8, prebuf + (8 - xpos), tileMapLine, tileline, tileMapXpos);
 			
 			const int newxpos = p.xpos;
 			
-			if (newxpos > 8) {
+			if (render && newxpos > 8) {
 				std::memcpy(dbufline, prebuf + (8 - xpos), (newxpos - 8) * sizeof *dbufline);
 			} else if (newxpos < 8)
 				return;
@@ -766,9 +783,16 @@ namespace M3Loop {
 		}
 		
 		if (p.cgb) {
-			doFullTilesUnrolledCgb(p, xend, dbufline, tileMapLine, tileline, tileMapXpos);
+			doFullTilesUnrolledCgb<render>(p, xend, dbufline, tileMapLine, tileline, tileMapXpos);
 		} else
-			doFullTilesUnrolledDmg(p, xend, dbufline, tileMapLine, tileline, tileMapXpos);
+			doFullTilesUnrolledDmg<render>(p, xend, dbufline, tileMapLine, tileline, tileMapXpos);
+	}
+	
+	static void doFullTilesUnrolled(PPUPriv &p) {
+		if (p.skipRender) {
+			doFullTilesUnrolled<false>(p, p.framebuf.fbline());
+		} else
+			doFullTilesUnrolled<true>(p, p.framebuf.fbline());
 	}
 	
 	static void plotPixel(PPUPriv &p) {
@@ -785,6 +809,15 @@ namespace M3Loop {
 				p.winDrawState |= WIN_DRAW_START;
 		}
 		
+		if (p.skipRender) {
+			for (int i = static_cast<int>(p.nextSprite) - 1; i >= 0 && static_cast<int>(p.spriteList[i].spx) > xpos - 8; --i)
+				p.spwordList[i] >>= 2;
+			
+			p.xpos = xpos + 1;
+			p.tileword = tileword >> 2;
+			return;
+		}
+		
 		const unsigned twdata = tileword & ((p.lcdc & 1) | p.cgb) * 3;
 		unsigned long pixel = p.bgPalette[twdata + (p.attrib & 7) * 4];
 		int i = static_cast<int>(p.nextSprite) - 1;
@@ -1471,6 +1504,8 @@ PPUPriv::PPUPriv(NextM0Time &nextM0Time, const unsigned char *const oamram, cons
 	nextSprite(0),
 	currentSprite(0xFF),
 	layersMask(LAYER_MASK_BG|LAYER_MASK_OBJ),
+	skipRender(false),
+	skipRenderReq(false),
 	vram(vram),
 	nextCallPtr(&M2::Ly0::f0_),
 	now(0),
@@ -1706,6 +1741,7 @@ void PPU::setLcdc(const unsigned lcdc, const unsigned long cc) {
 		p_.spriteMapper.enableDisplay(cc);
 		p_.weMaster = (lcdc & 0x20) && 0 == p_.wy;
 		p_.winDrawState = 0;
+		p_.skipRender = p_.skipRenderReq;
 		p_.nextCallPtr = &M3Start::f0_;
 		p_.cycles = -static_cast<int>(m3StartLineCycle(p_.cgb) + M2_DS_OFFSET * p_.lyCounter.isDoubleSpeed());
 	} else if ((p_.lcdc ^ lcdc) & 0x20) {
@@ -60,6 +60,8 @@ struct PPUPriv {
 	unsigned char nextSprite;
 	unsigned char currentSprite;
 	unsigned layersMask;
+	bool skipRender; // timing and state only, no pixels are written to framebuf
+	bool skipRenderReq; // latched into skipRender when a frame starts, so that frames are drawn in full or not at all
 
 	const unsigned char *vram;
 	const PPUState *nextCallPtr;
@@ -133,6 +135,7 @@ public:
 	unsigned long * spPalette() { return p_.spPalette; }
 	void update(unsigned long cc);
 	void setLayers(unsigned mask) { p_.layersMask = mask; }
+	void setSkipRender(bool skip) { p_.skipRenderReq = skip; }
 	void setCgb(bool cgb) { p_.cgb = cgb; }
 
 	template<bool isReader>void SyncState(NewState *ns);
@@ -1,7 +1,10 @@
 
 #include <cstdlib>
+#include <atomic>
+#include <vector>
 
 #include "system.h"
+#include "../corebatch/corebatch.h"
 
 void *operator new(std::size_t n)
 {
@@ -54,13 +57,18 @@ EXPORT void GetReadOnlyCartPtrs(CSystem *s, int *s0, uint8 **p0, int *s1, uint8
 
 EXPORT int BinStateSize(CSystem *s)
 {
-	NewStateDummy dummy;
-	s->SyncState<false>(&dummy);
-	return dummy.GetLength();
+	if (!s->stateLayout.IsValid())
+		s->stateLayout.Build(s);
+	return s->stateLayout.GetLength();
 }
 
 EXPORT int BinStateSave(CSystem *s, char *data, int length)
 {
+	if (!s->stateLayout.IsValid())
+		s->stateLayout.Build(s);
+	if (s->stateLayout.IsReplayable())
+		return s->stateLayout.SaveTo(data, length);
+
 	NewStateExternalBuffer saver(data, length);
 	s->SyncState<false>(&saver);
 	return !saver.Overflow() && saver.GetLength() == length;
@@ -73,6 +81,78 @@ EXPORT int BinStateLoad(CSystem *s, const char *data, int length)
 	return !loader.Overflow() && loader.GetLength() == length;
 }
 
+// runs batches of systems on a CoreBatch.  the systems don't share anything, so each one is run start to finish by
+// whichever thread picks it up
+class Batch
+{
+public:
+	Batch(int threads)
+		:pool(threads), scratch(pool.Threads())
+	{
+	}
+
+	// advances each of count systems for frames frames, with buttons[i][f] as the input of system i on frame f, and then
+	// hashes its savestate into hashes[i].  returns false if any state couldn't be saved; its hash is 0
+	bool Advance(CSystem **systems, int count, const int *const *buttons, int frames, uint64 *hashes)
+	{
+		std::atomic<bool> ok(true);
+		pool.Run(count, [&](int i, int thread)
+		{
+			Scratch &sc = scratch[thread];
+			CSystem *s = systems[i];
+			for (int f = 0; f < frames; f++)
+			{
+				int sbuffsize = sc.sbuff.size();
+				s->Advance(buttons[i][f], &sc.vbuff[0], &sc.sbuff[0], sbuffsize);
+			}
+
+			sc.state.resize(BinStateSize(s));
+			if (BinStateSave(s, &sc.state[0], sc.state.size()))
+			{
+				hashes[i] = CoreBatch::Hash(&sc.state[0], sc.state.size());
+			}
+			else
+			{
+				hashes[i] = 0;
+				ok = false;
+			}
+		});
+		return ok;
+	}
+
+private:
+	// each thread's buffers, kept from one batch to the next
+	struct Scratch
+	{
+		std::vector<uint32> vbuff;
+		std::vector<int16> sbuff;
+		std::vector<char> state;
+		Scratch()
+			:vbuff(HANDY_SCREEN_WIDTH * HANDY_SCREEN_HEIGHT), sbuff(2048)
+		{
+		}
+	};
+
+	CoreBatch pool;
+	std::vector<Scratch> scratch;
+};
+
+// threads is the number of threads to run batches on, counting the caller; 0 for one per core
+EXPORT Batch *BatchCreate(int threads)
+{
+	return new Batch(threads);
+}
+
+EXPORT int BatchAdvance(Batch *b, CSystem **systems, int count, const int *const *buttons, int frames, uint64 *hashes)
+{
+	return b->Advance(systems, count, buttons, frames, hashes);
+}
+
+EXPORT void BatchDestroy(Batch *b)
+{
+	delete b;
+}
+
 EXPORT void TxtStateSave(CSystem *s, FPtrs *ff)
 {
 	NewStateExternalFunctions saver(ff);
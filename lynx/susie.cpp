@@ -274,6 +274,7 @@ uint32 CSusie::PaintSprites(void)
 	int	sprcount=0;
 	int data=0;
 	int everonscreen=0;
+	uint8 pens[LINE_MAX_PIXELS];
 
 	TRACE_SUSIE0("                                                              ");
 	TRACE_SUSIE0("                                                              ");
@@ -685,31 +686,40 @@ uint32 CSusie::PaintSprites(void)
 								if(hsign!=hquadoff) hoff+=hsign;
 
 								// Initialise our line
-								LineInit(voff);
+								uint32 offset=LineInit(voff);
 								onscreen=FALSE;
 
-								// Now render an individual destination line
-								while((pixel=LineGetPixel())!=LINE_END)
+								if(LineSpansSafe(offset))
 								{
-									// This is allowed to update every pixel
-									mHSIZACUM.Val16+=mSPRHSIZ.Val16;
-									pixel_width=mHSIZACUM.Union8.High;
-									mHSIZACUM.Union8.High=0;
-
-									for(hloop=0;hloop<pixel_width;hloop++)
+									// Decode the whole line, then draw it
+									int count=LineDecode(pens);
+									if(LineDraw(pens,count,hoff,hsign)) everonscreen=TRUE;
+								}
+								else
+								{
+									// Now render an individual destination line
+									while((pixel=LineGetPixel())!=LINE_END)
 									{
-										// Draw if onscreen but break loop on transition to offscreen
-										if(hoff>=0 && hoff<SCREEN_WIDTH)
-										{
-											ProcessPixel(hoff,pixel);
-											onscreen = TRUE;
-											everonscreen = TRUE;
-										}
-										else
+										// This is allowed to update every pixel
+										mHSIZACUM.Val16+=mSPRHSIZ.Val16;
+										pixel_width=mHSIZACUM.Union8.High;
+										mHSIZACUM.Union8.High=0;
+
+										for(hloop=0;hloop<pixel_width;hloop++)
 										{
-											if(onscreen) break;
+											// Draw if onscreen but break loop on transition to offscreen
+											if(hoff>=0 && hoff<SCREEN_WIDTH)
+											{
+												ProcessPixel(hoff,pixel);
+												onscreen = TRUE;
+												everonscreen = TRUE;
+											}
+											else
+											{
+												if(onscreen) break;
+											}
+											hoff+=hsign;
 										}
-										hoff+=hsign;
 									}
 								}
 							}
@@ -1306,6 +1316,249 @@ uint32 CSusie::LineGetPixel()
 	return mLinePixel;
 }
 
+//
+// Line spans: rather than decoding and drawing a pixel at a time, a whole
+// destination line is decoded into a buffer of pens, then drawn by a loop
+// made for the sprite type.  The result is the same, cycle counts included,
+// unless drawing the line overwrites the sprite data being decoded; that
+// can only happen if the data is in the screen or collision buffer line.
+//
+
+bool CSusie::LineSpansSafe(uint32 offset)
+{
+	// LineGetBits() reads 3 bytes at a time, so up to 2 past the line
+	uint32 start=mSPRDLINE.Val16;
+	uint32 length=offset+2;
+	uint32 buffers[2]={mLineBaseAddress,mLineCollisionAddress};
+
+	// An offset of 0 or 1 here means an earlier line overwrote the data, leave it to the slow path
+	if(offset<2) return FALSE;
+
+	for(int loop=0;loop<2;loop++)
+	{
+		if(((buffers[loop]-start)&0xffff)<length || ((start-buffers[loop])&0xffff)<SCREEN_WIDTH/2) return FALSE;
+	}
+	return TRUE;
+}
+
+// Same as calling LineGetPixel() until LINE_END, returns the number of pixels
+int CSusie::LineDecode(uint8 *pens)
+{
+	uint32 shiftreg=mLineShiftReg;
+	uint32 shiftcount=mLineShiftRegCount;
+	uint32 bitsleft=mLinePacketBitsLeft;
+	uint32 repeat=mLineRepeatCount;
+	uint32 pixel=mLinePixel;
+	uint32 type=mLineType;
+	uint16 tmpadr=mTMPADR.Val16;
+	uint32 cycles=0;
+	const uint32 pixelbits=mSPRCTL0_PixelBits;
+	int count=0;
+
+	// LineGetBits()
+	auto getbits=[&](uint32 bits) -> uint32
+	{
+		if(bitsleft<=bits) return 0;
+		if(shiftcount<bits)
+		{
+			shiftreg<<=24;
+			shiftreg|=RAM_PEEK(tmpadr)<<16; tmpadr++;
+			shiftreg|=RAM_PEEK(tmpadr)<<8; tmpadr++;
+			shiftreg|=RAM_PEEK(tmpadr); tmpadr++;
+			shiftcount+=24;
+			cycles+=3*SPR_RDWR_CYC;
+		}
+		uint32 retval=(shiftreg>>(shiftcount-bits))&((1<<bits)-1);
+		shiftcount-=bits;
+		bitsleft-=bits;
+		return retval;
+	};
+
+	for(;;)
+	{
+		if(!repeat)
+		{
+			// Normal sprites fetch their counts on a packet basis
+			if(type!=line_abs_literal)
+				type=getbits(1)?line_literal:line_packed;
+
+			if(type==line_abs_literal)
+			{
+				pixel=LINE_END;
+				break;
+			}
+
+			repeat=getbits(4);
+			if(type==line_packed)
+			{
+				if(!repeat)
+				{
+					pixel=LINE_END;
+					repeat++;
+					break;
+				}
+				pixel=mPenIndex[getbits(pixelbits)];
+			}
+			repeat++;
+		}
+
+		repeat--;
+		if(type==line_abs_literal)
+		{
+			pixel=getbits(pixelbits);
+			// Check the special case of a zero in the last pixel
+			if(!repeat && !pixel)
+			{
+				pixel=LINE_END;
+				break;
+			}
+			pixel=mPenIndex[pixel];
+		}
+		else if(type==line_literal)
+		{
+			pixel=mPenIndex[getbits(pixelbits)];
+		}
+		pens[count++]=pixel;
+	}
+
+	mLineShiftReg=shiftreg;
+	mLineShiftRegCount=shiftcount;
+	mLinePacketBitsLeft=bitsleft;
+	mLineRepeatCount=repeat;
+	mLinePixel=pixel;
+	mLineType=type;
+	mTMPADR.Val16=tmpadr;
+	cycles_used+=cycles;
+	return count;
+}
+
+// Same as the pixel loop in PaintSprites() with ProcessPixel(), returns TRUE if any pixel was on screen
+template<int type,bool collide>
+bool CSusie::LineWrite(const uint8 *pens,int count,int hoff,int hsign)
+{
+	uint8 *screen=mRamPointer+mLineBaseAddress;
+	uint8 *coll=mRamPointer+mLineCollisionAddress;
+	const uint32 hsiz=mSPRHSIZ.Val16;
+	const uint32 number=mSPRCOLL_Number;
+	uint32 acum=mHSIZACUM.Val16;
+	uint32 cycles=0;
+	int collision=mCollision;
+	bool onscreen=FALSE;
+
+	for(int loop=0;loop<count;loop++)
+	{
+		acum=(uint16)(acum+hsiz);
+		int width=acum>>8;
+		acum&=0xff;
+
+		const uint32 pixel=pens[loop];
+		for(;width;width--,hoff+=hsign)
+		{
+			if((uint32)hoff>=SCREEN_WIDTH)
+			{
+				if(!onscreen) continue;
+				// Nothing more is drawn on this line, but the accumulator still counts the pixels
+				acum=(acum+(count-1-loop)*hsiz)&0xff;
+				goto done;
+			}
+			onscreen=TRUE;
+
+			uint8 *dest=screen+(hoff>>1);
+			uint8 *coldest=coll+(hoff>>1);
+			const int shift=(hoff&0x01)?0:4;
+			const uint8 keep=(hoff&0x01)?0xf0:0x0f;
+
+			bool write,collide_pixel;
+			switch(type)
+			{
+			case sprite_background_shadow:
+				write=TRUE;
+				collide_pixel=FALSE;
+				if(collide && pixel!=0x0e)
+				{
+					// Collision number written without checking
+					*dest=(*dest&keep)|(pixel<<shift);
+					*coldest=(*coldest&keep)|(number<<shift);
+					cycles+=4*SPR_RDWR_CYC;
+					continue;
+				}
+				break;
+			case sprite_background_noncollide:
+				write=TRUE;
+				collide_pixel=FALSE;
+				break;
+			case sprite_noncollide:
+				write=pixel!=0x00;
+				collide_pixel=FALSE;
+				break;
+			case sprite_boundary:
+				write=pixel!=0x00 && pixel!=0x0f;
+				collide_pixel=pixel!=0x00;
+				break;
+			case sprite_normal:
+				write=pixel!=0x00;
+				collide_pixel=pixel!=0x00;
+				break;
+			case sprite_boundary_shadow:
+				write=pixel!=0x00 && pixel!=0x0e && pixel!=0x0f;
+				collide_pixel=pixel!=0x00 && pixel!=0x0e;
+				break;
+			case sprite_shadow:
+				write=pixel!=0x00;
+				collide_pixel=pixel!=0x00 && pixel!=0x0e;
+				break;
+			default: // sprite_xor_shadow
+				if(pixel!=0x00)
+				{
+					*dest^=pixel<<shift;
+					cycles+=3*SPR_RDWR_CYC;
+				}
+				write=FALSE;
+				collide_pixel=pixel!=0x00 && pixel!=0x0e;
+				break;
+			}
+
+			if(write)
+			{
+				*dest=(*dest&keep)|(pixel<<shift);
+				cycles+=2*SPR_RDWR_CYC;
+			}
+			if(collide && collide_pixel)
+			{
+				int data=(*coldest>>shift)&0x0f;
+				if(data>collision) collision=data;
+				*coldest=(*coldest&keep)|(number<<shift);
+				cycles+=3*SPR_RDWR_CYC;
+			}
+		}
+	}
+
+done:
+	mHSIZACUM.Val16=acum;
+	mCollision=collision;
+	cycles_used+=cycles;
+	return onscreen;
+}
+
+bool CSusie::LineDraw(const uint8 *pens,int count,int hoff,int hsign)
+{
+	typedef bool (CSusie::*LineWriter)(const uint8 *,int,int,int);
+	static const LineWriter writers[8][2]=
+	{
+		{&CSusie::LineWrite<sprite_background_shadow,false>,&CSusie::LineWrite<sprite_background_shadow,true>},
+		{&CSusie::LineWrite<sprite_background_noncollide,false>,&CSusie::LineWrite<sprite_background_noncollide,true>},
+		{&CSusie::LineWrite<sprite_boundary_shadow,false>,&CSusie::LineWrite<sprite_boundary_shadow,true>},
+		{&CSusie::LineWrite<sprite_boundary,false>,&CSusie::LineWrite<sprite_boundary,true>},
+		{&CSusie::LineWrite<sprite_normal,false>,&CSusie::LineWrite<sprite_normal,true>},
+		{&CSusie::LineWrite<sprite_noncollide,false>,&CSusie::LineWrite<sprite_noncollide,true>},
+		{&CSusie::LineWrite<sprite_xor_shadow,false>,&CSusie::LineWrite<sprite_xor_shadow,true>},
+		{&CSusie::LineWrite<sprite_shadow,false>,&CSusie::LineWrite<sprite_shadow,true>},
+	};
+	const bool collide=!mSPRCOLL_Collide && !mSPRSYS_NoCollide;
+
+	return (this->*writers[mSPRCTL0_Type][collide])(pens,count,hoff,hsign);
+}
+
 
 void CSusie::Poke(uint32 addr,uint8 data)
 {
@@ -70,6 +70,7 @@ class CSystem;
 #define SCREEN_HEIGHT	102
 
 #define LINE_END		0x80
+#define LINE_MAX_PIXELS	8192	// more than the 255 bytes of a sprite line can encode
 
 //
 // Define button values
@@ -337,6 +338,10 @@ class CSusie : public CLynxBase
 		uint32	LineInit(uint32 voff);
 		uint32	LineGetPixel(void);
 		uint32	LineGetBits(uint32 bits);
+		int		LineDecode(uint8 *pens);
+		bool	LineSpansSafe(uint32 offset);
+		bool	LineDraw(const uint8 *pens,int count,int hoff,int hsign);
+		template<int type,bool collide> bool LineWrite(const uint8 *pens,int count,int hoff,int hsign);
 
 		void	ProcessPixel(uint32 hoff,uint32 pixel);
 		void	WritePixel(uint32 hoff,uint32 pixel);
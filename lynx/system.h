@@ -225,6 +225,8 @@ public:
 	uint32 *videobuffer;
 
 	template<bool isReader>void SyncState(NewState *ns);
+
+	NewStateLayout stateLayout; // cached for BinStateSize/BinStateSave
 };
 
 #endif
@@ -42,6 +42,10 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#elif defined(WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <io.h>
 #endif
 
 // Some really bad preprocessor abuse follows to handle platforms that don't have fseeko and ftello...and of course
@@ -197,6 +201,27 @@ uint8 *FileStream::map(void) noexcept
    madvise(mapping, mapping_size, MADV_SEQUENTIAL | MADV_WILLNEED);
    #endif
   }
+#elif defined(WIN32)
+  uint64 length = size();
+
+  // Only read-only mappings, which is all anything here needs.
+  if(OpenedMode == MODE_READ && length > 0 && length <= SIZE_MAX)
+  {
+   HANDLE fmh = CreateFileMapping((HANDLE)_get_osfhandle(fileno(fp)), NULL, PAGE_READONLY, 0, 0, NULL);
+
+   if(fmh != NULL)
+   {
+    void* tptr = MapViewOfFile(fmh, FILE_MAP_READ, 0, 0, 0);
+
+    CloseHandle(fmh);	// The view keeps the mapping object alive.
+
+    if(tptr != NULL)
+    {
+     mapping = tptr;
+     mapping_size = length;
+    }
+   }
+  }
 #endif
  }
 
@@ -214,6 +239,8 @@ void FileStream::unmap(void) noexcept
  {
 #ifdef HAVE_MMAP
   munmap(mapping, mapping_size);
+#elif defined(WIN32)
+  UnmapViewOfFile(mapping);
 #endif
   mapping = NULL;
   mapping_size = 0;
@@ -9,16 +9,225 @@
 #include "cdrom/cdromif.h"
 #include "cdrom/CDAccess_Image.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+//A least-recently-used cache of finished 2448 byte sectors (subcode and all), with a thread that reads ahead
+//of the caller while it's reading sequentially, which is what FMV and XA streaming look like.
+//CDAccess isn't thread safe, so every read from it goes through disc_lock.
+class SectorCache
+{
+public:
+	SectorCache(CDAccess* disc, int capacity, int prefetch, int end_lba)
+		: disc(disc), capacity(capacity), prefetch(prefetch), end_lba(end_lba)
+		, head(-1), tail(-1), used(0), last_lba(-1), pf_next(0), pf_end(0), quit(false)
+	{
+		data.resize((size_t)capacity * 2448);
+		entries.resize(capacity);
+		lookup.reserve(capacity * 2);
+		if(prefetch > 0)
+			thread = std::thread(&SectorCache::PrefetchMain, this);
+	}
+
+	~SectorCache()
+	{
+		{
+			std::lock_guard<std::mutex> lk(lock);
+			quit = true;
+		}
+		wake.notify_one();
+		if(thread.joinable())
+			thread.join();
+	}
+
+	bool Read(int lba, uint8* buf2448)
+	{
+		{
+			std::lock_guard<std::mutex> lk(lock);
+			bool hit = Fetch(lba, buf2448);
+			Follow(lba);
+			if(hit)
+				return true;
+		}
+
+		{
+			std::lock_guard<std::mutex> dlk(disc_lock);
+
+			//the prefetcher may have just finished this one
+			{
+				std::lock_guard<std::mutex> lk(lock);
+				if(Fetch(lba, buf2448))
+					return true;
+			}
+
+			try
+			{
+				disc->Read_Raw_Sector(buf2448, lba);
+			}
+			catch(MDFN_Error &) {
+				return false;
+			}
+		}
+
+		std::lock_guard<std::mutex> lk(lock);
+		Insert(lba, buf2448);
+		return true;
+	}
+
+private:
+	struct Entry
+	{
+		int lba;
+		int prev, next; //LRU list links, most recent at head
+	};
+
+	CDAccess* disc;
+	const int capacity, prefetch, end_lba;
+
+	std::vector<uint8> data;
+	std::vector<Entry> entries;
+	std::unordered_map<int, int> lookup;
+	int head, tail, used;
+
+	int last_lba;
+	int pf_next, pf_end; //sectors the prefetcher still has to read, [pf_next, pf_end)
+
+	std::mutex lock; //guards everything above
+	std::mutex disc_lock;
+	std::condition_variable wake;
+	std::thread thread;
+	bool quit;
+
+	void Unlink(int i)
+	{
+		Entry &e = entries[i];
+		if(e.prev >= 0) entries[e.prev].next = e.next; else head = e.next;
+		if(e.next >= 0) entries[e.next].prev = e.prev; else tail = e.prev;
+	}
+
+	void LinkHead(int i)
+	{
+		Entry &e = entries[i];
+		e.prev = -1;
+		e.next = head;
+		if(head >= 0) entries[head].prev = i;
+		head = i;
+		if(tail < 0) tail = i;
+	}
+
+	bool Fetch(int lba, uint8* buf2448)
+	{
+		std::unordered_map<int, int>::iterator it = lookup.find(lba);
+		if(it == lookup.end())
+			return false;
+		int i = it->second;
+		memcpy(buf2448, &data[(size_t)i * 2448], 2448);
+		if(head != i)
+		{
+			Unlink(i);
+			LinkHead(i);
+		}
+		return true;
+	}
+
+	void Insert(int lba, const uint8* buf2448)
+	{
+		if(lookup.count(lba))
+			return;
+
+		int i;
+		if(used < capacity)
+			i = used++;
+		else
+		{
+			i = tail;
+			Unlink(i);
+			lookup.erase(entries[i].lba);
+		}
+
+		entries[i].lba = lba;
+		memcpy(&data[(size_t)i * 2448], buf2448, 2448);
+		LinkHead(i);
+		lookup[lba] = i;
+	}
+
+	//keeps the prefetch window ahead of sequential reads, and drops it on a seek
+	void Follow(int lba)
+	{
+		if(!prefetch)
+			return;
+
+		if(lba == last_lba + 1)
+		{
+			if(pf_next <= lba)
+				pf_next = lba + 1;
+			pf_end = std::min(lba + 1 + prefetch, end_lba);
+			if(pf_next < pf_end)
+				wake.notify_one();
+		}
+		else
+			pf_next = pf_end = 0;
+
+		last_lba = lba;
+	}
+
+	void PrefetchMain()
+	{
+		uint8 tmp[2448];
+		std::unique_lock<std::mutex> lk(lock);
+
+		for(;;)
+		{
+			wake.wait(lk, [&]{ return quit || pf_next < pf_end; });
+			if(quit)
+				break;
+
+			int lba = pf_next++;
+			if(lookup.count(lba))
+				continue;
+
+			lk.unlock();
+			bool ok = true;
+			{
+				std::lock_guard<std::mutex> dlk(disc_lock);
+				try
+				{
+					disc->Read_Raw_Sector(tmp, lba);
+				}
+				catch(MDFN_Error &) {
+					ok = false;
+				}
+			}
+			lk.lock();
+
+			if(ok)
+				Insert(lba, tmp);
+			else
+				pf_next = pf_end = 0;
+		}
+	}
+};
+
 
 class MednaDisc
 {
 public:
+	MednaDisc()
+		: disc(NULL), cache(NULL)
+	{
+	}
 	~MednaDisc()
 	{
+		delete cache;
 		delete disc;
 	}
 	CDAccess* disc;
 	CDUtility::TOC toc;
+	SectorCache* cache;
 };
 
 EW_EXPORT void* mednadisc_LoadCD(const char* fname)
@@ -37,6 +246,33 @@ EW_EXPORT void* mednadisc_LoadCD(const char* fname)
 	return md;
 }
 
+EW_EXPORT void* mednadisc_LoadCDCached(const char* fname, int cache_sectors, int prefetch_sectors)
+{
+	CDAccess* disc = NULL;
+	try {
+		disc = CDAccess_Open(fname,false,true);
+	}
+	catch(MDFN_Error &) {
+		return NULL;
+	}
+
+	MednaDisc* md = new MednaDisc();
+	md->disc = disc;
+	disc->Read_TOC(&md->toc);
+
+	if(cache_sectors > 0)
+	{
+		//the read-ahead window can't be allowed to evict what the caller's about to ask for
+		if(prefetch_sectors > cache_sectors / 2)
+			prefetch_sectors = cache_sectors / 2;
+		if(prefetch_sectors < 0)
+			prefetch_sectors = 0;
+		md->cache = new SectorCache(disc, cache_sectors, prefetch_sectors, md->toc.tracks[100].lba);
+	}
+
+	return md;
+}
+
 struct JustTOC
 {
   uint8 first_track;
@@ -60,6 +296,10 @@ EW_EXPORT int32 mednadisc_ReadSector(MednaDisc* md, int lba, void* buf2448)
 {
 	CDAccess* disc = md->disc;
 	CDUtility::TOC &toc = md->toc;
+
+	if(md->cache)
+		return md->cache->Read(lba, (uint8*)buf2448) ? 1 : 0;
+
 	try
 	{
 		//EDIT: this is handled now by the individual readers
@@ -75,6 +315,18 @@ EW_EXPORT int32 mednadisc_ReadSector(MednaDisc* md, int lba, void* buf2448)
 	return 1;
 }
 
+//reads count sectors starting at lba, back to back, 2448 bytes each (with the same interleaved subcode as mednadisc_ReadSector)
+EW_EXPORT int32 mednadisc_ReadSectors(MednaDisc* md, int lba, int count, void* buf)
+{
+	uint8* dest = (uint8*)buf;
+	for(int i = 0; i < count; i++)
+	{
+		if(!mednadisc_ReadSector(md, lba + i, dest + i * 2448))
+			return 0;
+	}
+	return 1;
+}
+
 EW_EXPORT void mednadisc_CloseCD(MednaDisc* md)
 {
 	delete md;
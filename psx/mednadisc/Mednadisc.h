@@ -5,5 +5,7 @@
 class MednaDisc;
 
 EW_EXPORT void* mednadisc_LoadCD(const char* fname);
+EW_EXPORT void* mednadisc_LoadCDCached(const char* fname, int cache_sectors, int prefetch_sectors);
 EW_EXPORT int32 mednadisc_ReadSector(MednaDisc* disc, int lba, void* buf2448);
+EW_EXPORT int32 mednadisc_ReadSectors(MednaDisc* disc, int lba, int count, void* buf);
 EW_EXPORT void mednadisc_CloseCD(MednaDisc* disc);
\ No newline at end of file
@@ -32,14 +32,14 @@ CDAccess::~CDAccess()
 
 }
 
-CDAccess* CDAccess_Open(const std::string& path, bool image_memcache)
+CDAccess* CDAccess_Open(const std::string& path, bool image_memcache, bool image_mmap)
 {
  CDAccess *ret = NULL;
 
  if(path.size() >= 4 && !strcasecmp(path.c_str() + path.size() - 4, ".ccd"))
-  ret = new CDAccess_CCD(path, image_memcache);
+  ret = new CDAccess_CCD(path, image_memcache, image_mmap);
  else
-  ret = new CDAccess_Image(path, image_memcache);
+  ret = new CDAccess_Image(path, image_memcache, image_mmap);
 
  return ret;
 }
@@ -28,6 +28,7 @@ class CDAccess
  CDAccess& operator=(const CDAccess&); // No assignment operator.
 };
 
-CDAccess* CDAccess_Open(const std::string& path, bool image_memcache);
+// If image_mmap is true, image files are memory-mapped where the OS allows it, and read through the mapping.
+CDAccess* CDAccess_Open(const std::string& path, bool image_memcache, bool image_mmap = false);
 
 #endif
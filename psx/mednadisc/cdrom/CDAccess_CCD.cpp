@@ -96,7 +96,7 @@ static T CCD_ReadInt(CCD_Section &s, const std::string &propname, const bool hav
 }
 
 
-CDAccess_CCD::CDAccess_CCD(const std::string& path, bool image_memcache) : img_numsectors(0)
+CDAccess_CCD::CDAccess_CCD(const std::string& path, bool image_memcache, bool image_mmap) : img_mmap(image_mmap), img_numsectors(0)
 {
  Load(path, image_memcache);
 }
@@ -400,8 +400,15 @@ void CDAccess_CCD::Read_Raw_Sector(uint8 *buf, int32 lba)
   return;
  }
 
- img_stream->seek(lba * 2352, SEEK_SET);
- img_stream->read(buf, 2352);
+ const uint8* map = img_mmap ? img_stream->map() : NULL;
+
+ if(map && (uint64)(lba + 1) * 2352 <= img_stream->map_size())
+  memcpy(buf, map + lba * 2352, 2352);
+ else
+ {
+  img_stream->seek(lba * 2352, SEEK_SET);
+  img_stream->read(buf, 2352);
+ }
 
  subpw_interleave(&sub_data[lba * 96], buf + 2352);
 }
@@ -24,7 +24,7 @@ class CDAccess_CCD : public CDAccess
 {
  public:
 
- CDAccess_CCD(const std::string& path, bool image_memcache);
+ CDAccess_CCD(const std::string& path, bool image_memcache, bool image_mmap);
  virtual ~CDAccess_CCD();
 
  virtual void Read_Raw_Sector(uint8 *buf, int32 lba);
@@ -42,6 +42,7 @@ class CDAccess_CCD : public CDAccess
 
  std::unique_ptr<Stream> img_stream;
  std::unique_ptr<uint8[]> sub_data;
+ bool img_mmap;
 
  size_t img_numsectors;
  CDUtility::TOC tocd;
@@ -963,7 +963,7 @@ void CDAccess_Image::Cleanup(void)
  }
 }
 
-CDAccess_Image::CDAccess_Image(const std::string& path, bool image_memcache) : NumTracks(0), FirstTrack(0), LastTrack(0), total_sectors(0)
+CDAccess_Image::CDAccess_Image(const std::string& path, bool image_memcache, bool image_mmap) : NumTracks(0), FirstTrack(0), LastTrack(0), total_sectors(0), ImageMMap(image_mmap)
 {
  memset(Tracks, 0, sizeof(Tracks));
 
@@ -983,6 +983,25 @@ CDAccess_Image::~CDAccess_Image()
  Cleanup();
 }
 
+//
+// Reads from the track's file at pos(which is advanced past the read), copying from its memory mapping if it has one that covers the range.
+// Otherwise the file position is assumed to already be at pos, unless there's a mapping.
+//
+INLINE void CDAccess_Image::ReadTrackData(CDRFILE_TRACK_INFO *ct, const uint8 *map, uint64 &pos, uint8 *buf, uint32 count)
+{
+ if(map && (pos + count) <= ct->fp->map_size())
+  memcpy(buf, map + pos, count);
+ else
+ {
+  if(map)
+   ct->fp->seek(pos, SEEK_SET);
+
+  ct->fp->read(buf, count);
+ }
+
+ pos += count;
+}
+
 void CDAccess_Image::Read_Raw_Sector(uint8 *buf, int32 lba)
 {
   uint8 SimuQ[0xC];
@@ -1091,36 +1110,41 @@ void CDAccess_Image::Read_Raw_Sector(uint8 *buf, int32 lba)
    {
     long SeekPos = ct->FileOffset;
     long LBARelPos = lba - ct->LBA;
+    const uint8* map = ImageMMap ? ct->fp->map() : NULL;
+    uint64 pos;
 
     SeekPos += LBARelPos * DI_Size_Table[ct->DIFormat];
 
     if(ct->SubchannelMode)
      SeekPos += 96 * (lba - ct->LBA);
 
-    ct->fp->seek(SeekPos, SEEK_SET);
+    pos = SeekPos;
+
+    if(!map)
+     ct->fp->seek(SeekPos, SEEK_SET);
 
     switch(ct->DIFormat)
     {
 	case DI_FORMAT_AUDIO:
-		ct->fp->read(buf, 2352);
+		ReadTrackData(ct, map, pos, buf, 2352);
 
 		if(ct->RawAudioMSBFirst)
 		 Endian_A16_Swap(buf, 588 * 2);
 		break;
 
 	case DI_FORMAT_MODE1:
-		ct->fp->read(buf + 12 + 3 + 1, 2048);
+		ReadTrackData(ct, map, pos, buf + 12 + 3 + 1, 2048);
 		encode_mode1_sector(lba + 150, buf);
 		break;
 
 	case DI_FORMAT_MODE1_RAW:
 	case DI_FORMAT_MODE2_RAW:
 	case DI_FORMAT_CDI_RAW:
-		ct->fp->read(buf, 2352);
+		ReadTrackData(ct, map, pos, buf, 2352);
 		break;
 
 	case DI_FORMAT_MODE2:
-		ct->fp->read(buf + 16, 2336);
+		ReadTrackData(ct, map, pos, buf + 16, 2336);
 		encode_mode2_sector(lba + 150, buf);
 		break;
 
@@ -1128,19 +1152,19 @@ void CDAccess_Image::Read_Raw_Sector(uint8 *buf, int32 lba)
 	// FIXME: M2F1, M2F2, does sub-header come before or after user data(standards say before, but I wonder
 	// about cdrdao...).
 	case DI_FORMAT_MODE2_FORM1:
-		ct->fp->read(buf + 24, 2048);
+		ReadTrackData(ct, map, pos, buf + 24, 2048);
 		//encode_mode2_form1_sector(lba + 150, buf);
 		break;
 
 	case DI_FORMAT_MODE2_FORM2:
-		ct->fp->read(buf + 24, 2324);
+		ReadTrackData(ct, map, pos, buf + 24, 2324);
 		//encode_mode2_form2_sector(lba + 150, buf);
 		break;
 
     }
 
     if(ct->SubchannelMode)
-     ct->fp->read(buf + 2352, 96);
+     ReadTrackData(ct, map, pos, buf + 2352, 96);
    }
   } // end if audible part of audio track read.
 }
@@ -64,7 +64,7 @@ class CDAccess_Image : public CDAccess
 {
  public:
 
- CDAccess_Image(const std::string& path, bool image_memcache);
+ CDAccess_Image(const std::string& path, bool image_memcache, bool image_mmap);
  virtual ~CDAccess_Image();
 
  virtual void Read_Raw_Sector(uint8 *buf, int32 lba);
@@ -87,11 +87,15 @@ class CDAccess_Image : public CDAccess
 
  std::string base_dir;
 
+ bool ImageMMap;	// Read binary track data through the files' memory mappings when possible.
+
  void ImageOpen(const std::string& path, bool image_memcache);
  void LoadSBI(const std::string& sbi_path);
  void GenerateTOC(void);
  void Cleanup(void);
 
+ void ReadTrackData(CDRFILE_TRACK_INFO *ct, const uint8 *map, uint64 &pos, uint8 *buf, uint32 count);
+
  // MakeSubPQ will OR the simulated P and Q subchannel data into SubPWBuf.
  int32 MakeSubPQ(int32 lba, uint8 *SubPWBuf) const;
 
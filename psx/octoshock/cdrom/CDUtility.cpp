@@ -19,6 +19,7 @@
 
 #include <string.h>
 #include <assert.h>
+#include <mutex>
 
 #include "dvdisaster.h"
 #include "octoshock.h"
@@ -67,7 +68,7 @@ static uint16 subq_crctab[256] =
 
 static uint8 scramble_table[2352 - 12];
 
-static bool CDUtility_Inited = false;
+static std::once_flag CDUtility_Inited;
 
 static void InitScrambleTable(void)
 {
@@ -94,15 +95,14 @@ static void InitScrambleTable(void)
 
 void CDUtility_Init(void)
 {
-	if (!CDUtility_Inited)
+	//several emulator instances may get here from different threads at once
+	std::call_once(CDUtility_Inited, []()
 	{
 		#ifdef WANT_LEC_CHECK
 			Init_LEC_Correct();
 			InitScrambleTable();
 		#endif
-
-		CDUtility_Inited = true;
-	}
+	});
 }
 
 
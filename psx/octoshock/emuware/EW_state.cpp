@@ -43,6 +43,57 @@ void NewStateExternalBuffer::Load(void *ptr, size_t size, const char *name)
 	length += size;
 }
 
+NewStateLayout::NewStateLayout()
+	:length(0), valid(false), replayable(false)
+{
+}
+
+void NewStateLayout::Begin()
+{
+	runs.clear();
+	length = 0;
+	valid = false;
+	replayable = true;
+}
+
+void NewStateLayout::Save(const void *ptr, size_t size, const char *name)
+{
+	const char *src = static_cast<const char *>(ptr);
+	if (!runs.empty() && runs.back().ptr + runs.back().size == src)
+	{
+		runs.back().size += size;
+	}
+	else
+	{
+		Run run = { src, size };
+		runs.push_back(run);
+	}
+	length += size;
+}
+
+void NewStateLayout::Load(void *ptr, size_t size, const char *name)
+{
+}
+
+// the temporary is gone by the time SaveTo() would copy from it, so only the length counts
+void NewStateLayout::SaveTemporary(const void *ptr, size_t size, const char *name)
+{
+	replayable = false;
+	length += size;
+}
+
+bool NewStateLayout::SaveTo(char *buffer, long maxlength)
+{
+	if (maxlength != length)
+		return false;
+	for (std::vector<Run>::const_iterator it = runs.begin(); it != runs.end(); ++it)
+	{
+		std::memcpy(buffer, it->ptr, it->size);
+		buffer += it->size;
+	}
+	return true;
+}
+
 NewStateExternalFunctions::NewStateExternalFunctions(const FPtrs *ff)
 	:Save_(ff->Save_),
 	Load_(ff->Load_),
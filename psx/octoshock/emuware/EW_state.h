@@ -3,6 +3,7 @@
 
 #include <cstring>
 #include <cstddef>
+#include <vector>
 
 namespace EW
 {
@@ -10,8 +11,11 @@ namespace EW
 	class NewState
 	{
 	public:
+		virtual ~NewState() { }
 		virtual void Save(const void *ptr, size_t size, const char *name) = 0;
 		virtual void Load(void *ptr, size_t size, const char *name) = 0;
+		// like Save, but ptr is a temporary that SyncState staged the field through(EBS, RSS) rather than the field itself
+		virtual void SaveTemporary(const void *ptr, size_t size, const char *name) { Save(ptr, size, name); }
 		virtual void EnterSection(const char *name, ...) { }
 		virtual void ExitSection(const char *name, ...) { }
 	};
@@ -43,6 +47,42 @@ namespace EW
 		virtual void Load(void *ptr, size_t size, const char *name);
 	};
 
+	// Records where each field of a SyncState<false> pass lives, merging fields that sit next to each other in memory into
+	// single runs.  Once built, the binary state size is known without another pass, and a binary save is a handful of
+	// memcpys instead of a virtual call per field.
+	// Fields that SyncState stages in a local first(EBS, RSS) come through SaveTemporary() and can't be copied that way;
+	// when there are any, IsReplayable() is false and saves still need a normal pass.  Invalidate() whenever anything that gets saved is reallocated.
+	class NewStateLayout : public NewState
+	{
+	private:
+		struct Run
+		{
+			const char *ptr;
+			size_t size;
+		};
+		std::vector<Run> runs;
+		long length;
+		bool valid;
+		bool replayable;
+		void Begin();
+	public:
+		NewStateLayout();
+		template<typename T>void Build(T *t)
+		{
+			Begin();
+			t->template SyncState<false>(this);
+			valid = true;
+		}
+		bool IsValid() { return valid; }
+		bool IsReplayable() { return replayable; }
+		void Invalidate() { valid = false; }
+		long GetLength() { return length; }
+		bool SaveTo(char *buffer, long maxlength);
+		virtual void Save(const void *ptr, size_t size, const char *name);
+		virtual void Load(void *ptr, size_t size, const char *name);
+		virtual void SaveTemporary(const void *ptr, size_t size, const char *name);
+	};
+
 	struct FPtrs
 	{
 		void (*Save_)(const void *ptr, size_t size, const char *name);
@@ -83,12 +123,12 @@ namespace EW
 	// first line is default value in converted enum; last line is default value in argument x
 	#define EBS(x,d) do { int _ttmp = (d); if (isReader) ns->Load(&_ttmp, sizeof(_ttmp), #x); if (0)
 	#define EVS(x,v,n) else if (!isReader && (x) == (v)) _ttmp = (n); else if (isReader && _ttmp == (n)) (x) = (v)
-	#define EES(x,d) else if (isReader) (x) = (d); if (!isReader) ns->Save(&_ttmp, sizeof(_ttmp), #x); } while (0)
+	#define EES(x,d) else if (isReader) (x) = (d); if (!isReader) ns->SaveTemporary(&_ttmp, sizeof(_ttmp), #x); } while (0)
 
 	#define RSS(x,b) do { if (isReader)\
 	{ ptrdiff_t _ttmp; ns->Load(&_ttmp, sizeof(_ttmp), #x); (x) = (_ttmp == (ptrdiff_t)0xdeadbeef ? 0 : (b) + _ttmp); }\
 		else\
-	{ ptrdiff_t _ttmp = (x) == 0 ? 0xdeadbeef : (x) - (b); ns->Save(&_ttmp, sizeof(_ttmp), #x); } } while (0)
+	{ ptrdiff_t _ttmp = (x) == 0 ? 0xdeadbeef : (x) - (b); ns->SaveTemporary(&_ttmp, sizeof(_ttmp), #x); } } while (0)
 
 	#define PSS(x,s) do { if (isReader) ns->Load((x), (s), #x); else ns->Save((x), (s), #x); } while (0)
 
@@ -119,7 +119,10 @@ char (*BLAHBLAHBLAH( UNALIGNED T (&)[N] ))[N];
 #endif
 //---------------------------------------------
 
-#ifdef EW_EXPORT
+#if !defined(_WIN32)
+#undef EW_EXPORT
+#define EW_EXPORT extern "C" __attribute__((visibility("default")))
+#elif defined(EW_EXPORT)
 #undef EW_EXPORT
 #define EW_EXPORT extern "C" __declspec(dllexport)
 #else
@@ -1,6 +1,10 @@
 #pragma once
 
+#ifdef _MSC_VER
 #include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
 
 //
 // Result is defined for all possible inputs(including 0).
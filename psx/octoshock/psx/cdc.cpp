@@ -67,6 +67,18 @@ PS_CDC::PS_CDC() : DMABuffer(4096)
 
  DriveStatus = DS_STOPPED;
  PendingCommandPhase = 0;
+
+ // Not touched by Power(), but saved in states; keep them from differing between otherwise identical runs.
+ memset(SB, 0, sizeof(SB));
+ memset(SectorPipe, 0, sizeof(SectorPipe));
+ ArgsReceiveLatch = 0;
+ memset(ArgsReceiveBuf, 0, sizeof(ArgsReceiveBuf));
+ ArgsReceiveIn = 0;
+ memset(AsyncResultsPending, 0, sizeof(AsyncResultsPending));
+ xa_cur_set = false;
+ xa_cur_file = 0;
+ xa_cur_chan = 0;
+ ReportLastF = 0;
 }
 
 PS_CDC::~PS_CDC()
@@ -258,13 +270,13 @@ void PS_CDC::SoftReset(void)
 
 void PS_CDC::Power(void)
 {
- SPU->Power();
+ PSX_I->SPU->Power();
 
  SoftReset();
 
  DiscStartupDelay = 0;
 
- SPUCounter = SPU->UpdateFromCDC(0);
+ SPUCounter = PSX_I->SPU->UpdateFromCDC(0);
  lastts = 0;
 }
 
@@ -1093,6 +1105,8 @@ void PS_CDC::HandlePlayRead(void)
 
 pscpu_timestamp_t PS_CDC::Update(const pscpu_timestamp_t timestamp)
 {
+ PSX_PERF_SCOPE(PSX_PERF_CDC);
+
  int32 clocks = timestamp - lastts;
 
  //doom_ts = timestamp;
@@ -1325,7 +1339,7 @@ pscpu_timestamp_t PS_CDC::Update(const pscpu_timestamp_t timestamp)
    }
   }
 
-  SPUCounter = SPU->UpdateFromCDC(chunk_clocks);
+  SPUCounter = PSX_I->SPU->UpdateFromCDC(chunk_clocks);
 
   clocks -= chunk_clocks;
  } // end while(clocks > 0)
@@ -26,13 +26,6 @@
 #define EXP_ILL_CHECK(n) {}
 #endif
 
-//not very organized, is it
-void* g_ShockTraceCallbackOpaque = NULL;
-ShockCallback_Trace g_ShockTraceCallback = NULL;
-ShockCallback_Mem g_ShockMemCallback;
-eShockMemCb g_ShockMemCbType;
-char disasm_buf[128];
-
 /* TODO
 	Make sure load delays are correct.
 
@@ -55,6 +48,9 @@ PS_CPU::PS_CPU()
 {
  Halted = false;
 
+ Recompiler = NULL;
+ RecompilerTimestamp = 0;
+
  memset(FastMap, 0, sizeof(FastMap));
  memset(DummyPage, 0xFF, sizeof(DummyPage));	// 0xFF to trigger an illegal instruction exception, so we'll know what's up when debugging.
 
@@ -64,6 +60,11 @@ PS_CPU::PS_CPU()
  CPUHook = NULL;
  ADDBT = NULL;
 
+ TraceCallbackOpaque = NULL;
+ TraceCallback = NULL;
+ MemCallback = NULL;
+ MemCallbackMask = eShockMemCb_None;
+
  GTE_Init();
 
  for(unsigned i = 0; i < 24; i++)
@@ -82,8 +83,9 @@ PS_CPU::PS_CPU()
 
 PS_CPU::~PS_CPU()
 {
+ SetRecompiler(false);
 
-
+ GTE_Kill();
 }
 
 void PS_CPU::SetFastMap(void *region_mem, uint32 region_address, uint32 region_size)
@@ -255,8 +257,8 @@ INLINE T PS_CPU::ReadMemory(pscpu_timestamp_t &timestamp, uint32 address, bool D
  ReadAbsorb[ReadAbsorbWhich] = 0;
  ReadAbsorbWhich = 0;
 
- if (g_ShockMemCallback && (g_ShockMemCbType & eShockMemCb_Read))
-	 g_ShockMemCallback(address, eShockMemCb_Read, DS24 ? 24 : 32, 0);
+ if (MemCallback && (MemCallbackMask & eShockMemCb_Read))
+	 MemCallback(address, eShockMemCb_Read, DS24 ? 24 : 32, 0);
 
  address &= addr_mask[address >> 29];
 
@@ -302,8 +304,8 @@ INLINE T PS_CPU::ReadMemory(pscpu_timestamp_t &timestamp, uint32 address, bool D
 template<typename T>
 INLINE void PS_CPU::WriteMemory(pscpu_timestamp_t &timestamp, uint32 address, uint32 value, bool DS24)
 {
-	if (g_ShockMemCallback && (g_ShockMemCbType & eShockMemCb_Write))
-		g_ShockMemCallback(address, eShockMemCb_Write, DS24 ? 24 : 32, value);
+	if (MemCallback && (MemCallbackMask & eShockMemCb_Write))
+		MemCallback(address, eShockMemCb_Write, DS24 ? 24 : 32, value);
 
  if(MDFN_LIKELY(!(CP0.SR & 0x10000)))
  {
@@ -473,6 +475,24 @@ pscpu_timestamp_t PS_CPU::RunReal(pscpu_timestamp_t timestamp_in)
    uint32 instr;
    uint32 opf;
 
+   // Let the recompiler have a go at anything starting outside of a branch delay slot, provided nothing is hooked that needs
+   // to see each instruction or memory access.  If it can't run even one instruction from here, interpret that one as usual.
+   if(!DebugMode && !BIOSPrintMode && !ILHMode && Recompiler && new_PC_mask == ~0U && !TraceCallback && !MemCallback)
+   {
+    bool ran;
+
+    ACTIVE_TO_BACKING;
+    RecompilerTimestamp = timestamp;
+
+    ran = RunRecompiled();
+
+    timestamp = RecompilerTimestamp;
+    BACKING_TO_ACTIVE;
+
+    if(ran)
+     continue;
+   }
+
    // Zero must be zero...until the Master Plan is enacted.
    GPR[0] = 0;
 
@@ -573,11 +593,11 @@ pscpu_timestamp_t PS_CPU::RunReal(pscpu_timestamp_t timestamp_in)
    //for(int i = 0; i < 32; i++)
    // printf("%02x : %08x\n", i, GPR[i]);
    //printf("\n");
-   if (g_ShockTraceCallback)
+   if (TraceCallback)
    {
 	//_asm int 3;
 	shock_Util_DisassembleMIPS(PC, instr, disasm_buf, ARRAY_SIZE(disasm_buf));
-    g_ShockTraceCallback(NULL, PC, instr, disasm_buf);
+    TraceCallback(NULL, PC, instr, disasm_buf);
    }
 
    opf = instr & 0x3F;
@@ -614,6 +634,8 @@ pscpu_timestamp_t PS_CPU::RunReal(pscpu_timestamp_t timestamp_in)
    #define DO_LDS() { GPR[LDWhich] = LDValue; ReadAbsorb[LDWhich] = LDAbsorb; ReadFudge = LDWhich; ReadAbsorbWhich |= LDWhich & 0x1F; LDWhich = 0x20; }
    #define BEGIN_OPF(name) { op_##name:
    #define END_OPF goto OpDone; }
+   #define BEGIN_COMMON_OPF(name, op, funct) BEGIN_OPF(name)
+   #define OPF_ADDRESS_ERROR(exc, address) { CP0.BADVA = (address); new_PC = Exception((exc), PC, new_PC, new_PC_mask, instr); new_PC_mask = 0; }
 
 
 #define DO_BRANCH(arg_cond, arg_offset, arg_mask, arg_dolink, arg_linkreg)\
@@ -1346,69 +1368,6 @@ pscpu_timestamp_t PS_CPU::RunReal(pscpu_timestamp_t timestamp_in)
 	DO_LDS();
     END_OPF;
 
-    //
-    // DIV - Divide Word
-    //
-    BEGIN_OPF(DIV);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
-
-        if(!GPR[rt])
-        {
-	 if(GPR[rs] & 0x80000000)
-	  LO = 1;
-	 else
-	  LO = 0xFFFFFFFF;
-
-	 HI = GPR[rs];
-        }
-	else if(GPR[rs] == 0x80000000 && GPR[rt] == 0xFFFFFFFF)
-	{
-	 LO = 0x80000000;
-	 HI = 0;
-	}
-        else
-        {
-         LO = (int32)GPR[rs] / (int32)GPR[rt];
-         HI = (int32)GPR[rs] % (int32)GPR[rt];
-        }
-	muldiv_ts_done = timestamp + 37;
-
-	DO_LDS();
-
-    END_OPF;
-
-
-    //
-    // DIVU - Divide Unsigned Word
-    //
-    BEGIN_OPF(DIVU);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
-
-	if(!GPR[rt])
-	{
-	 LO = 0xFFFFFFFF;
-	 HI = GPR[rs];
-	}
-	else
-	{
-	 LO = GPR[rs] / GPR[rt];
-	 HI = GPR[rs] % GPR[rt];
-	}
- 	muldiv_ts_done = timestamp + 37;
-
-	DO_LDS();
-    END_OPF;
-
     //
     // J - Jump
     //
@@ -1487,148 +1446,6 @@ pscpu_timestamp_t PS_CPU::RunReal(pscpu_timestamp_t timestamp_in)
 
     END_OPF;
 
-    //
-    // MFHI - Move from HI
-    //
-    BEGIN_OPF(MFHI);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
- 	GPR_RES(rd);
-	GPR_DEPRES_END
-
-	DO_LDS();
-
-	if(timestamp < muldiv_ts_done)
-	{
-	 if(timestamp == muldiv_ts_done - 1)
-	  muldiv_ts_done--;
-	 else
-	 {
-	  do
-	  {
-	   if(ReadAbsorb[ReadAbsorbWhich])
-	    ReadAbsorb[ReadAbsorbWhich]--;
-	   timestamp++;
-	  } while(timestamp < muldiv_ts_done);
-	 }
-	}
-
-	GPR[rd] = HI;
-
-    END_OPF;
-
-
-    //
-    // MFLO - Move from LO
-    //
-    BEGIN_OPF(MFLO);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
- 	GPR_RES(rd);
-	GPR_DEPRES_END
-
-	DO_LDS();
-
-	if(timestamp < muldiv_ts_done)
-	{
-	 if(timestamp == muldiv_ts_done - 1)
-	  muldiv_ts_done--;
-	 else
-	 {
-	  do
-	  {
-	   if(ReadAbsorb[ReadAbsorbWhich])
-	    ReadAbsorb[ReadAbsorbWhich]--;
-	   timestamp++;
-	  } while(timestamp < muldiv_ts_done);
-	 }
-	}
-
-	GPR[rd] = LO;
-
-    END_OPF;
-
-
-    //
-    // MTHI - Move to HI
-    //
-    BEGIN_OPF(MTHI);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEPRES_END
-
-	HI = GPR[rs];
-
-	DO_LDS();
-
-    END_OPF;
-
-    //
-    // MTLO - Move to LO
-    //
-    BEGIN_OPF(MTLO);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEPRES_END
-
-	LO = GPR[rs];
-
-	DO_LDS();
-
-    END_OPF;
-
-
-    //
-    // MULT - Multiply Word
-    //
-    BEGIN_OPF(MULT);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
-
-	uint64 result;
-
-	result = (int64)(int32)GPR[rs] * (int32)GPR[rt];
-	muldiv_ts_done = timestamp + MULT_Tab24[MDFN_lzcount32((GPR[rs] ^ ((int32)GPR[rs] >> 31)) | 0x400)];
-	DO_LDS();
-
-	LO = result;
-	HI = result >> 32;
-
-    END_OPF;
-
-    //
-    // MULTU - Multiply Unsigned Word
-    //
-    BEGIN_OPF(MULTU);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
-
-	uint64 result;
-
-	result = (uint64)GPR[rs] * GPR[rt];
-	muldiv_ts_done = timestamp + MULT_Tab24[MDFN_lzcount32(GPR[rs] | 0x400)];
-	DO_LDS();
-
-	LO = result;
-	HI = result >> 32;
-
-    END_OPF;
-
-
     //
     // NOR - NOR
     //
@@ -1991,363 +1808,7 @@ pscpu_timestamp_t PS_CPU::RunReal(pscpu_timestamp_t timestamp_in)
 	GPR[rt] = result;
     END_OPF;
 
-    //
-    // Memory access instructions(besides the coprocessor ones) follow:
-    //
-
-    //
-    // LB - Load Byte
-    //
-    BEGIN_OPF(LB);
-	ITYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEPRES_END
-
-	uint32 address = GPR[rs] + immediate;
-
-	if(MDFN_UNLIKELY(LDWhich == rt))
-	 LDWhich = 0;
-
-	DO_LDS();
-
-	LDWhich = rt;
-	LDValue = (int32)ReadMemory<int8>(timestamp, address);
-    END_OPF;
-
-    //
-    // LBU - Load Byte Unsigned
-    //
-    BEGIN_OPF(LBU);
-        ITYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEPRES_END
-
-        uint32 address = GPR[rs] + immediate;
-
-	if(MDFN_UNLIKELY(LDWhich == rt))
-	 LDWhich = 0;
-
-	DO_LDS();
-
-        LDWhich = rt;
-	LDValue = ReadMemory<uint8>(timestamp, address);
-    END_OPF;
-
-    //
-    // LH - Load Halfword
-    //
-    BEGIN_OPF(LH);
-        ITYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEPRES_END
-
-        uint32 address = GPR[rs] + immediate;
-
-	if(MDFN_UNLIKELY(address & 1))
-	{
-	 DO_LDS();
-
-	 CP0.BADVA = address;
-	 new_PC = Exception(EXCEPTION_ADEL, PC, new_PC, new_PC_mask, instr);
-         new_PC_mask = 0;
-	}
-	else
-	{
-	 if(MDFN_UNLIKELY(LDWhich == rt))
-	  LDWhich = 0;
-
-	 DO_LDS();
-
-	 LDWhich = rt;
-         LDValue = (int32)ReadMemory<int16>(timestamp, address);
-	}
-    END_OPF;
-
-    //
-    // LHU - Load Halfword Unsigned
-    //
-    BEGIN_OPF(LHU);
-        ITYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEPRES_END
-
-        uint32 address = GPR[rs] + immediate;
-
-        if(MDFN_UNLIKELY(address & 1))
-	{
-	 DO_LDS();
-
-	 CP0.BADVA = address;
-         new_PC = Exception(EXCEPTION_ADEL, PC, new_PC, new_PC_mask, instr);
-         new_PC_mask = 0;
-	}
-	else
-	{
-	 if(MDFN_UNLIKELY(LDWhich == rt))
-	  LDWhich = 0;
-
-	 DO_LDS();
-
-	 LDWhich = rt;
-         LDValue = ReadMemory<uint16>(timestamp, address);
-	}
-    END_OPF;
-
-
-    //
-    // LW - Load Word
-    //
-    BEGIN_OPF(LW);
-        ITYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEPRES_END
-
-        uint32 address = GPR[rs] + immediate;
-
-        if(MDFN_UNLIKELY(address & 3))
-	{
-	 DO_LDS();
-
-	 CP0.BADVA = address;
-         new_PC = Exception(EXCEPTION_ADEL, PC, new_PC, new_PC_mask, instr);
-         new_PC_mask = 0;
-	}
-        else
-	{
-	 if(MDFN_UNLIKELY(LDWhich == rt))
-	  LDWhich = 0;
-
-	 DO_LDS();
-
-	 LDWhich = rt;
-         LDValue = ReadMemory<uint32>(timestamp, address);
-	}
-    END_OPF;
-
-    //
-    // SB - Store Byte
-    //
-    BEGIN_OPF(SB);
-	ITYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
-
-	uint32 address = GPR[rs] + immediate;
-
-	WriteMemory<uint8>(timestamp, address, GPR[rt]);
-
-	DO_LDS();
-    END_OPF;
-
-    // 
-    // SH - Store Halfword
-    //
-    BEGIN_OPF(SH);
-        ITYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
-
-        uint32 address = GPR[rs] + immediate;
-
-	if(MDFN_UNLIKELY(address & 0x1))
-	{
-	 CP0.BADVA = address;
-	 new_PC = Exception(EXCEPTION_ADES, PC, new_PC, new_PC_mask, instr);
-         new_PC_mask = 0;
-	}
-	else
-	 WriteMemory<uint16>(timestamp, address, GPR[rt]);
-
-	DO_LDS();
-    END_OPF;
-
-    // 
-    // SW - Store Word
-    //
-    BEGIN_OPF(SW);
-        ITYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
-
-        uint32 address = GPR[rs] + immediate;
-
-	if(MDFN_UNLIKELY(address & 0x3))
-	{
-	 CP0.BADVA = address;
-	 new_PC = Exception(EXCEPTION_ADES, PC, new_PC, new_PC_mask, instr);
-         new_PC_mask = 0;
-	}
-	else
-	 WriteMemory<uint32>(timestamp, address, GPR[rt]);
-
-	DO_LDS();
-    END_OPF;
-
-    // LWL and LWR load delay slot tomfoolery appears to apply even to MFC0! (and probably MFCn and CFCn as well, though they weren't explicitly tested)
-
-    //
-    // LWL - Load Word Left
-    //
-    BEGIN_OPF(LWL);
-	ITYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	//GPR_DEP(rt);
-	GPR_DEPRES_END
-
-	uint32 address = GPR[rs] + immediate;
-	uint32 v = GPR[rt];
-
-	if(LDWhich == rt)
-	{
-	 v = LDValue;
-	 ReadFudge = 0;
-	}
-	else
-	{
-	 DO_LDS();
-	}
-
-	LDWhich = rt;
-	switch(address & 0x3)
-	{
-	 case 0: LDValue = (v & ~(0xFF << 24)) | (ReadMemory<uint8>(timestamp, address & ~3) << 24);
-		 break;
-
-	 case 1: LDValue = (v & ~(0xFFFF << 16)) | (ReadMemory<uint16>(timestamp, address & ~3) << 16);
-	         break;
-
-	 case 2: LDValue = (v & ~(0xFFFFFF << 8)) | (ReadMemory<uint32>(timestamp, address & ~3, true) << 8);
-		 break;
-
-	 case 3: LDValue = (v & ~(0xFFFFFFFF << 0)) | (ReadMemory<uint32>(timestamp, address & ~3) << 0);
-		 break;
-	}
-    END_OPF;
-
-    //
-    // SWL - Store Word Left
-    //
-    BEGIN_OPF(SWL);
-        ITYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
-
-        uint32 address = GPR[rs] + immediate;
-
-	switch(address & 0x3)
-	{
-	 case 0: WriteMemory<uint8>(timestamp, address & ~3, GPR[rt] >> 24);
-		 break;
-
-	 case 1: WriteMemory<uint16>(timestamp, address & ~3, GPR[rt] >> 16);
-	         break;
-
-	 case 2: WriteMemory<uint32>(timestamp, address & ~3, GPR[rt] >> 8, true);
-		 break;
-
-	 case 3: WriteMemory<uint32>(timestamp, address & ~3, GPR[rt] >> 0);
-		 break;
-	}
-	DO_LDS();
-
-    END_OPF;
-
-    //
-    // LWR - Load Word Right
-    //
-    BEGIN_OPF(LWR);
-        ITYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	//GPR_DEP(rt);
-	GPR_DEPRES_END
-
-        uint32 address = GPR[rs] + immediate;
-	uint32 v = GPR[rt];
-
-	if(LDWhich == rt)
-	{
-	 v = LDValue;
-	 ReadFudge = 0;
-	}
-	else
-	{
-	 DO_LDS();
-	}
-
-	LDWhich = rt;
-	switch(address & 0x3)
-	{
-	 case 0: LDValue = (v & ~(0xFFFFFFFF)) | ReadMemory<uint32>(timestamp, address);
-		 break;
-
-	 case 1: LDValue = (v & ~(0xFFFFFF)) | ReadMemory<uint32>(timestamp, address, true);
-		 break;
-
-	 case 2: LDValue = (v & ~(0xFFFF)) | ReadMemory<uint16>(timestamp, address);
-	         break;
-
-	 case 3: LDValue = (v & ~(0xFF)) | ReadMemory<uint8>(timestamp, address);
-		 break;
-	}
-    END_OPF;
-
-    //
-    // SWR - Store Word Right
-    //
-    BEGIN_OPF(SWR);
-        ITYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
-
-        uint32 address = GPR[rs] + immediate;
-
-	switch(address & 0x3)
-	{
-	 case 0: WriteMemory<uint32>(timestamp, address, GPR[rt]);
-		 break;
-
-	 case 1: WriteMemory<uint32>(timestamp, address, GPR[rt], true);
-		 break;
-
-	 case 2: WriteMemory<uint16>(timestamp, address, GPR[rt]);
-	         break;
-
-	 case 3: WriteMemory<uint8>(timestamp, address, GPR[rt]);
-		 break;
-	}
-
-	DO_LDS();
-
-    END_OPF;
+#include "cpu_common_ops.inc"
 
     //
     // Mednafen special instruction
@@ -2391,6 +1852,8 @@ pscpu_timestamp_t PS_CPU::RunReal(pscpu_timestamp_t timestamp_in)
 
 pscpu_timestamp_t PS_CPU::Run(pscpu_timestamp_t timestamp_in, bool BIOSPrintMode, bool ILHMode)
 {
+ PSX_PERF_SCOPE(PSX_PERF_CPU);
+
  if(CPUHook || ADDBT)
   return(RunReal<true, true, false>(timestamp_in));
  else
@@ -2413,6 +1876,18 @@ void PS_CPU::SetCPUHook(void (*cpuh)(const pscpu_timestamp_t timestamp, uint32 p
  CPUHook = cpuh;
 }
 
+void PS_CPU::SetTraceCallback(void* opaque, ShockCallback_Trace callback)
+{
+ TraceCallbackOpaque = opaque;
+ TraceCallback = callback;
+}
+
+void PS_CPU::SetMemCallback(ShockCallback_Mem callback, eShockMemCb mask)
+{
+ MemCallback = callback;
+ MemCallbackMask = mask;
+}
+
 uint32 PS_CPU::GetRegister(unsigned int which, char *special, const uint32 special_len)
 {
  uint32 ret = 0;
@@ -2721,6 +2196,38 @@ void PS_CPU::CheckBreakpoints(void (*callback)(bool write, uint32 address, unsig
  }
 }
 
+//
+// Body of a load, store, or multiply/divide unit instruction for a block from cpu_recompiler.cpp.  The block has already done the fetch and
+// ReadAbsorb bookkeeping for the instruction and made sure the access is aligned, so the address error paths are never taken here.
+//
+#undef BEGIN_COMMON_OPF
+#undef OPF_ADDRESS_ERROR
+
+#define BEGIN_COMMON_OPF(name, op, funct) BEGIN_OPF(op, funct)
+#define OPF_ADDRESS_ERROR(exc, address) assert(0)
+
+void PS_CPU::RecompilerOp(uint32 instr)
+{
+ pscpu_timestamp_t &timestamp = RecompilerTimestamp;
+ uint32 &LDWhich = BACKED_LDWhich;
+ uint32 &LDValue = BACKED_LDValue;
+ uint32 opf;
+
+ opf = instr & 0x3F;
+
+ if(instr & (0x3F << 26))
+  opf = 0x40 | (instr >> 26);
+
+ switch(opf)
+ {
+  default:
+	assert(0);
+	break;
+
+#include "cpu_common_ops.inc"
+ }
+}
+
 
 
 SYNCFUNC(PS_CPU)
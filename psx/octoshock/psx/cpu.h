@@ -45,6 +45,8 @@ namespace MDFN_IEN_PSX
 
 #define PS_CPU_EMULATE_ICACHE 1
 
+	class PS_CPU_Recompiler;
+
 	class PS_CPU
 	{
 	public:
@@ -79,6 +81,9 @@ namespace MDFN_IEN_PSX
 		void SetBIU(uint32 val);
 		uint32 GetBIU(void);
 
+		// Turns the x86-64 dynamic recompiler(cpu_recompiler.cpp) on or off.  Does nothing on other hosts.
+		void SetRecompiler(bool enabled);
+
 	private:
 
 		uint32 GPR[32 + 1];	// GPR[32] Used as dummy in load delay simulation(indexing past the end of real GPR)
@@ -217,12 +222,21 @@ namespace MDFN_IEN_PSX
 		template<typename T> T ReadMemory(pscpu_timestamp_t &timestamp, uint32 address, bool DS24 = false, bool LWC_timing = false);
 		template<typename T> void WriteMemory(pscpu_timestamp_t &timestamp, uint32 address, uint32 value, bool DS24 = false);
 
+		friend class PS_CPU_Recompiler;
+		PS_CPU_Recompiler* Recompiler;
+		pscpu_timestamp_t RecompilerTimestamp;	// Stands in for RunReal()'s timestamp while a recompiled block runs.
+
+		bool RunRecompiled(void);
+		void RecompilerOp(uint32 instr);
+
 
 		//
 		// Mednafen debugger stuff follows:
 		//
 	public:
 		void SetCPUHook(void(*cpuh)(const pscpu_timestamp_t timestamp, uint32 pc), void(*addbt)(uint32 from, uint32 to, bool exception));
+		void SetTraceCallback(void* opaque, ShockCallback_Trace callback);
+		void SetMemCallback(ShockCallback_Mem callback, eShockMemCb mask);
 		void CheckBreakpoints(void(*callback)(bool write, uint32 address, unsigned int len), uint32 instr);
 		void* debug_GetScratchRAMPtr() { return ScratchRAM.data8; }
 		void* debug_GetGPRPtr() { return GPR; }
@@ -255,6 +269,12 @@ namespace MDFN_IEN_PSX
 	private:
 		void(*CPUHook)(const pscpu_timestamp_t timestamp, uint32 pc);
 		void(*ADDBT)(uint32 from, uint32 to, bool exception);
+
+		void* TraceCallbackOpaque;
+		ShockCallback_Trace TraceCallback;
+		ShockCallback_Mem MemCallback;
+		eShockMemCb MemCallbackMask;
+		char disasm_buf[128];
 	};
 
 }
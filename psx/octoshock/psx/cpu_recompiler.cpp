@@ -0,0 +1,984 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <assert.h>
+#include "psx.h"
+#include "cpu.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+ #define PS_CPU_RECOMPILER_X64 1
+
+ #ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #include <windows.h>
+ #else
+  #include <sys/mman.h>
+ #endif
+#endif
+
+/*
+ x86-64 dynamic recompiler.
+
+ Blocks are straight runs of instructions in cached(KUSEG/KSEG0) memory, ending at the first instruction we don't handle or after the
+ delay slot of the first branch.  They run only when RunReal() would have used its plain <false, false, false> instance and is at an
+ instruction boundary outside of a branch delay slot, and they keep all state in the same PS_CPU members the interpreter uses(the BACKED_*
+ set, plus RecompilerTimestamp for the timestamp), so the interpreter can pick up after any instruction.
+
+ Every instruction still goes through the interpreter's checks, in the same order:  the block returns to RunReal() before an instruction if
+ an event is due, if its ICache entry isn't a hit holding the word it was compiled from, or if an interrupt is pending(only rechecked
+ after calls out of the block, since nothing else inside can change it).  ICache misses, self-modifying code, and isolated-cache writes are
+ thus left to the interpreter, and a block compiled from stale memory just stops at the first word that doesn't match.
+
+ ALU ops, branches and jumps are emitted inline, and replicate ReadAbsorb, load delay, and delay slot handling exactly.  Loads, stores,
+ and the multiply/divide unit call PS_CPU::RecompilerOp() for the interpreter's own code.  Anything that would take an exception(overflow,
+ misaligned access) is caught before the instruction changes any state and left to the interpreter, as are COP, SYSCALL, BREAK, and
+ illegal instructions.
+*/
+
+namespace MDFN_IEN_PSX
+{
+
+#ifdef PS_CPU_RECOMPILER_X64
+
+class PS_CPU_Recompiler
+{
+ public:
+
+ PS_CPU_Recompiler(PS_CPU* cpu) MDFN_COLD;
+ ~PS_CPU_Recompiler() MDFN_COLD;
+
+ INLINE bool IsUsable(void) { return CodeBase != NULL; }
+
+ bool Run(uint32 PC);
+
+ private:
+
+ typedef uint32 (*BlockFunc)(PS_CPU* cpu);
+
+ struct Block
+ {
+  uint32 PC;		// Unaligned(never looked up) for an empty entry.
+  uint32 Instr;		// First instruction word, to notice when the code at PC changes.
+  BlockFunc Func;	// NULL if nothing at PC can be recompiled.
+ };
+
+ enum { TableSize = 1 << 16 };
+ enum { CodeSize = 32 << 20 };
+ enum { MaxBlockInstrs = 32 };
+ enum { MaxBlockBytes = (MaxBlockInstrs + 1) * 512 };
+
+ enum { KindNone = 0, KindALU, KindBranch, KindHelper };
+
+ static unsigned Classify(uint32 instr);
+ static void CallOp(PS_CPU* cpu, uint32 instr);
+
+ uint32 FetchInstr(uint32 PC);
+ void Flush(void);
+ void Compile(Block* b, uint32 PC);
+ void CompileInstr(uint32 PC, uint32 instr, unsigned index);
+
+ //
+ // Code emission; memory operands are always [rbx + disp32], rbx holding the PS_CPU pointer.
+ //
+ enum { EAX = 0, ECX = 1, EDX = 2, EBX = 3, ESI = 6, EDI = 7 };
+ enum { CC_O = 0x0, CC_B = 0x2, CC_E = 0x4, CC_NE = 0x5, CC_S = 0x8, CC_NS = 0x9, CC_L = 0xC, CC_GE = 0xD, CC_LE = 0xE, CC_G = 0xF };
+ enum { ALU_ADD = 0, ALU_OR = 1, ALU_AND = 4, ALU_SUB = 5, ALU_XOR = 6, ALU_CMP = 7 };
+ enum { SH_SHL = 4, SH_SHR = 5, SH_SAR = 7 };
+
+ INLINE void Emit8(uint8 v) { *CodePtr++ = v; }
+ INLINE void Emit32(uint32 v) { MDFN_en32lsb(CodePtr, v); CodePtr += 4; }
+
+ void EmitMem(unsigned reg, uint32 disp);
+ void EmitMemIndex(unsigned reg, unsigned index, unsigned scale_shift, uint32 disp);
+
+ void LoadReg(unsigned reg, uint32 disp);
+ void StoreReg(uint32 disp, unsigned reg);
+ void StoreImm(uint32 disp, uint32 imm);
+ void StoreImm8(uint32 disp, uint8 imm);
+ void MovImm(unsigned reg, uint32 imm);
+ void AluRegMem(unsigned alu, unsigned reg, uint32 disp);
+ void AluRegImm(unsigned alu, unsigned reg, uint32 imm);
+ void AluMemImm(unsigned alu, uint32 disp, uint32 imm);
+ void ShiftImm(unsigned sh, unsigned reg, unsigned count);
+ void ShiftCL(unsigned sh, unsigned reg);
+ void SetCC(unsigned cc, unsigned reg);
+ void TestReg(unsigned reg);
+ uint8* Jcc32(unsigned cc);
+ uint8* Jcc8(unsigned cc);
+ uint8* Jmp32(void);
+ uint8* Jmp8(void);
+ void Patch32(uint8* at, const uint8* target);
+ void Patch8(uint8* at, const uint8* target);
+
+ void ExitIf(unsigned cc, unsigned index);
+ void EmitDepRes(unsigned a, unsigned b = 0, unsigned c = 0);
+ void EmitReadAbsorb(void);
+ void EmitLDS(void);
+
+ PS_CPU* CPU;
+ Block* Table;
+
+ uint8* CodeBase;
+ uint8* CodePtr;
+
+ // Block being compiled.
+ uint32 BlockPC;
+ unsigned BlockLength;
+ bool BlockBranches;
+
+ // What's known at this point in the block being compiled, to skip redundant work.
+ enum
+ {
+  LDS_Unknown = 0,	// LDWhich could be anything.
+  LDS_Settling,		// LDWhich is 0x20, but the last DO_LDS() may have been for a real register.
+  LDS_Idle		// LDWhich is 0x20 and a DO_LDS() for it has run since; another changes nothing.
+ };
+ unsigned LDS;
+ bool GPR0Clean;	// GPR[0] is already 0.
+ bool IPClean;		// IPCache is known to be 0.
+
+ struct ExitPatch
+ {
+  uint8* at;
+  unsigned index;
+ } Exits[MaxBlockInstrs * 8];
+ unsigned ExitCount;
+
+ // Offsets of PS_CPU members from rbx.
+ uint32 OffsGPR;
+ uint32 OffsPC;
+ uint32 OffsNewPC;
+ uint32 OffsNewPCMask;
+ uint32 OffsIPCache;
+ uint32 OffsLDWhich;
+ uint32 OffsLDValue;
+ uint32 OffsLDAbsorb;
+ uint32 OffsNextEventTS;
+ uint32 OffsICache;
+ uint32 OffsReadAbsorb;
+ uint32 OffsReadAbsorbWhich;
+ uint32 OffsReadFudge;
+ uint32 OffsTimestamp;
+};
+
+#define CPU_OFFS(m) ((uint32)((uint8*)&cpu->m - (uint8*)cpu))
+
+PS_CPU_Recompiler::PS_CPU_Recompiler(PS_CPU* cpu) : CPU(cpu)
+{
+ OffsGPR = CPU_OFFS(GPR[0]);
+ OffsPC = CPU_OFFS(BACKED_PC);
+ OffsNewPC = CPU_OFFS(BACKED_new_PC);
+ OffsNewPCMask = CPU_OFFS(BACKED_new_PC_mask);
+ OffsIPCache = CPU_OFFS(IPCache);
+ OffsLDWhich = CPU_OFFS(BACKED_LDWhich);
+ OffsLDValue = CPU_OFFS(BACKED_LDValue);
+ OffsLDAbsorb = CPU_OFFS(LDAbsorb);
+ OffsNextEventTS = CPU_OFFS(next_event_ts);
+ OffsICache = CPU_OFFS(ICache[0]);
+ OffsReadAbsorb = CPU_OFFS(ReadAbsorb[0]);
+ OffsReadAbsorbWhich = CPU_OFFS(ReadAbsorbWhich);
+ OffsReadFudge = CPU_OFFS(ReadFudge);
+ OffsTimestamp = CPU_OFFS(RecompilerTimestamp);
+
+#ifdef _WIN32
+ CodeBase = (uint8*)VirtualAlloc(NULL, CodeSize, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+#else
+ CodeBase = (uint8*)mmap(NULL, CodeSize, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+ if(CodeBase == (uint8*)MAP_FAILED)
+  CodeBase = NULL;
+#endif
+
+ Table = new Block[TableSize];
+ Flush();
+}
+
+#undef CPU_OFFS
+
+PS_CPU_Recompiler::~PS_CPU_Recompiler()
+{
+ if(CodeBase)
+ {
+#ifdef _WIN32
+  VirtualFree(CodeBase, 0, MEM_RELEASE);
+#else
+  munmap(CodeBase, CodeSize);
+#endif
+ }
+
+ delete[] Table;
+}
+
+void PS_CPU_Recompiler::Flush(void)
+{
+ for(unsigned i = 0; i < TableSize; i++)
+ {
+  Table[i].PC = 1;
+  Table[i].Instr = 0;
+  Table[i].Func = NULL;
+ }
+
+ CodePtr = CodeBase;
+}
+
+//
+// Runs blocks back to back for as long as each one ends on a normal instruction boundary, and returns whether any progress was made.
+// Each block checks for events itself before its first instruction.
+//
+bool PS_CPU_Recompiler::Run(uint32 PC)
+{
+ bool ran = false;
+
+ while(!(PC & 0x3) && PC < 0xA0000000 && (CPU->BIU & 0x800))
+ {
+  Block* b = &Table[(PC >> 2) & (TableSize - 1)];
+  const PS_CPU::__ICache* ICI = &CPU->ICache[(PC & 0xFFC) >> 2];
+
+  if(b->PC != PC || (ICI->TV == PC && ICI->Data != b->Instr))
+   Compile(b, PC);
+
+  if(!b->Func || !b->Func(CPU))
+   break;
+
+  ran = true;
+
+  if(CPU->BACKED_new_PC_mask != ~0U)
+   break;
+
+  PC = CPU->BACKED_PC;
+ }
+
+ return ran;
+}
+
+void PS_CPU_Recompiler::CallOp(PS_CPU* cpu, uint32 instr)
+{
+ cpu->RecompilerOp(instr);
+}
+
+uint32 PS_CPU_Recompiler::FetchInstr(uint32 PC)
+{
+ const PS_CPU::__ICache* ICI = &CPU->ICache[(PC & 0xFFC) >> 2];
+
+ if(ICI->TV == PC)
+  return ICI->Data;
+
+ return MDFN_de32lsb<true>(&CPU->FastMap[PC >> PS_CPU::FAST_MAP_SHIFT][PC]);
+}
+
+unsigned PS_CPU_Recompiler::Classify(uint32 instr)
+{
+ const uint32 op = instr >> 26;
+
+ if(!op)
+ {
+  switch(instr & 0x3F)
+  {
+   case 0x00: case 0x02: case 0x03: case 0x04: case 0x06: case 0x07:		// SLL, SRL, SRA, SLLV, SRLV, SRAV
+   case 0x20: case 0x21: case 0x22: case 0x23: case 0x24: case 0x25: case 0x26: case 0x27:	// ADD, ADDU, SUB, SUBU, AND, OR, XOR, NOR
+   case 0x2A: case 0x2B:							// SLT, SLTU
+	return KindALU;
+
+   case 0x08: case 0x09:							// JR, JALR
+	return KindBranch;
+
+   case 0x10: case 0x11: case 0x12: case 0x13:					// MFHI, MTHI, MFLO, MTLO
+   case 0x18: case 0x19: case 0x1A: case 0x1B:					// MULT, MULTU, DIV, DIVU
+	return KindHelper;
+  }
+
+  return KindNone;
+ }
+
+ switch(op)
+ {
+  case 0x01: case 0x02: case 0x03: case 0x04: case 0x05: case 0x06: case 0x07:	// BCOND, J, JAL, BEQ, BNE, BLEZ, BGTZ
+	return KindBranch;
+
+  case 0x08: case 0x09: case 0x0A: case 0x0B: case 0x0C: case 0x0D: case 0x0E: case 0x0F:	// ADDI, ADDIU, SLTI, SLTIU, ANDI, ORI, XORI, LUI
+	return KindALU;
+
+  case 0x20: case 0x21: case 0x22: case 0x23: case 0x24: case 0x25: case 0x26:	// LB, LH, LWL, LW, LBU, LHU, LWR
+  case 0x28: case 0x29: case 0x2A: case 0x2B: case 0x2E:			// SB, SH, SWL, SW, SWR
+	return KindHelper;
+ }
+
+ return KindNone;
+}
+
+//
+// Code emission
+//
+void PS_CPU_Recompiler::EmitMem(unsigned reg, uint32 disp)
+{
+ Emit8(0x80 | ((reg & 7) << 3) | EBX);
+ Emit32(disp);
+}
+
+void PS_CPU_Recompiler::EmitMemIndex(unsigned reg, unsigned index, unsigned scale_shift, uint32 disp)
+{
+ Emit8(0x80 | ((reg & 7) << 3) | 0x4);
+ Emit8((scale_shift << 6) | (index << 3) | EBX);
+ Emit32(disp);
+}
+
+void PS_CPU_Recompiler::LoadReg(unsigned reg, uint32 disp)
+{
+ Emit8(0x8B);
+ EmitMem(reg, disp);
+}
+
+void PS_CPU_Recompiler::StoreReg(uint32 disp, unsigned reg)
+{
+ Emit8(0x89);
+ EmitMem(reg, disp);
+}
+
+void PS_CPU_Recompiler::StoreImm(uint32 disp, uint32 imm)
+{
+ Emit8(0xC7);
+ EmitMem(0, disp);
+ Emit32(imm);
+}
+
+void PS_CPU_Recompiler::StoreImm8(uint32 disp, uint8 imm)
+{
+ Emit8(0xC6);
+ EmitMem(0, disp);
+ Emit8(imm);
+}
+
+void PS_CPU_Recompiler::MovImm(unsigned reg, uint32 imm)
+{
+ Emit8(0xB8 | reg);
+ Emit32(imm);
+}
+
+void PS_CPU_Recompiler::AluRegMem(unsigned alu, unsigned reg, uint32 disp)
+{
+ Emit8((alu << 3) | 0x03);
+ EmitMem(reg, disp);
+}
+
+void PS_CPU_Recompiler::AluRegImm(unsigned alu, unsigned reg, uint32 imm)
+{
+ Emit8(0x81);
+ Emit8(0xC0 | (alu << 3) | reg);
+ Emit32(imm);
+}
+
+void PS_CPU_Recompiler::AluMemImm(unsigned alu, uint32 disp, uint32 imm)
+{
+ Emit8(0x81);
+ EmitMem(alu, disp);
+ Emit32(imm);
+}
+
+void PS_CPU_Recompiler::ShiftImm(unsigned sh, unsigned reg, unsigned count)
+{
+ if(!count)
+  return;
+
+ Emit8(0xC1);
+ Emit8(0xC0 | (sh << 3) | reg);
+ Emit8(count);
+}
+
+void PS_CPU_Recompiler::ShiftCL(unsigned sh, unsigned reg)
+{
+ Emit8(0xD3);
+ Emit8(0xC0 | (sh << 3) | reg);
+}
+
+// setcc reg8; movzx reg, reg8
+void PS_CPU_Recompiler::SetCC(unsigned cc, unsigned reg)
+{
+ Emit8(0x0F);
+ Emit8(0x90 | cc);
+ Emit8(0xC0 | reg);
+
+ Emit8(0x0F);
+ Emit8(0xB6);
+ Emit8(0xC0 | (reg << 3) | reg);
+}
+
+void PS_CPU_Recompiler::TestReg(unsigned reg)
+{
+ Emit8(0x85);
+ Emit8(0xC0 | (reg << 3) | reg);
+}
+
+uint8* PS_CPU_Recompiler::Jcc32(unsigned cc)
+{
+ Emit8(0x0F);
+ Emit8(0x80 | cc);
+ Emit32(0);
+
+ return CodePtr - 4;
+}
+
+uint8* PS_CPU_Recompiler::Jcc8(unsigned cc)
+{
+ Emit8(0x70 | cc);
+ Emit8(0);
+
+ return CodePtr - 1;
+}
+
+uint8* PS_CPU_Recompiler::Jmp32(void)
+{
+ Emit8(0xE9);
+ Emit32(0);
+
+ return CodePtr - 4;
+}
+
+uint8* PS_CPU_Recompiler::Jmp8(void)
+{
+ Emit8(0xEB);
+ Emit8(0);
+
+ return CodePtr - 1;
+}
+
+void PS_CPU_Recompiler::Patch32(uint8* at, const uint8* target)
+{
+ MDFN_en32lsb(at, (uint32)(target - (at + 4)));
+}
+
+void PS_CPU_Recompiler::Patch8(uint8* at, const uint8* target)
+{
+ assert((target - (at + 1)) >= -128 && (target - (at + 1)) <= 127);
+
+ *at = (uint8)(target - (at + 1));
+}
+
+// Leave the block, with PC pointing at instruction "index" of it.
+void PS_CPU_Recompiler::ExitIf(unsigned cc, unsigned index)
+{
+ assert(ExitCount < (sizeof(Exits) / sizeof(Exits[0])));
+
+ Exits[ExitCount].at = Jcc32(cc);
+ Exits[ExitCount].index = index;
+ ExitCount++;
+}
+
+//
+// GPR_DEPRES_BEGIN ... GPR_DEPRES_END; ReadAbsorb[0] always comes out unchanged, so only the other registers need doing.
+//
+void PS_CPU_Recompiler::EmitDepRes(unsigned a, unsigned b, unsigned c)
+{
+ if(a)
+  StoreImm8(OffsReadAbsorb + a, 0);
+
+ if(b && b != a)
+  StoreImm8(OffsReadAbsorb + b, 0);
+
+ if(c && c != a && c != b)
+  StoreImm8(OffsReadAbsorb + c, 0);
+}
+
+//
+// if(ReadAbsorb[ReadAbsorbWhich]) ReadAbsorb[ReadAbsorbWhich]--; else timestamp++;
+//
+void PS_CPU_Recompiler::EmitReadAbsorb(void)
+{
+ uint8* no_absorb;
+ uint8* done;
+
+ Emit8(0x0F); Emit8(0xB6); EmitMem(EAX, OffsReadAbsorbWhich);			// movzx eax, byte [ReadAbsorbWhich]
+ Emit8(0x0F); Emit8(0xB6); EmitMemIndex(ECX, EAX, 0, OffsReadAbsorb);		// movzx ecx, byte [ReadAbsorb + rax]
+ TestReg(ECX);
+ no_absorb = Jcc8(CC_E);
+ Emit8(0xFF); Emit8(0xC9);							// dec ecx
+ Emit8(0x88); EmitMemIndex(ECX, EAX, 0, OffsReadAbsorb);			// mov [ReadAbsorb + rax], cl
+ done = Jmp8();
+ Patch8(no_absorb, CodePtr);
+ Emit8(0xFF); EmitMem(0, OffsTimestamp);					// inc dword [timestamp]
+ Patch8(done, CodePtr);
+}
+
+//
+// DO_LDS(); clobbers eax and ecx.
+//
+void PS_CPU_Recompiler::EmitLDS(void)
+{
+ if(LDS == LDS_Idle)
+  return;
+
+ if(LDS == LDS_Settling)
+ {
+  LoadReg(ECX, OffsLDValue);
+  StoreReg(OffsGPR + 0x20 * 4, ECX);
+  LoadReg(ECX, OffsLDAbsorb);
+  Emit8(0x88); EmitMem(ECX, OffsReadAbsorb + 0x20);				// mov [ReadAbsorb + 0x20], cl
+  StoreImm8(OffsReadFudge, 0x20);
+  LDS = LDS_Idle;
+  return;
+ }
+
+ LDS = LDS_Settling;
+ GPR0Clean = false;
+
+ LoadReg(EAX, OffsLDWhich);
+ LoadReg(ECX, OffsLDValue);
+ Emit8(0x89); EmitMemIndex(ECX, EAX, 2, OffsGPR);				// mov [GPR + rax * 4], ecx
+ LoadReg(ECX, OffsLDAbsorb);
+ Emit8(0x88); EmitMemIndex(ECX, EAX, 0, OffsReadAbsorb);			// mov [ReadAbsorb + rax], cl
+ Emit8(0x88); EmitMem(EAX, OffsReadFudge);					// mov [ReadFudge], al
+ AluRegImm(ALU_AND, EAX, 0x1F);
+ Emit8(0x08); EmitMem(EAX, OffsReadAbsorbWhich);				// or [ReadAbsorbWhich], al
+ StoreImm(OffsLDWhich, 0x20);
+}
+
+void PS_CPU_Recompiler::CompileInstr(uint32 PC, uint32 instr, unsigned index)
+{
+ const uint32 op = instr >> 26;
+ const uint32 funct = instr & 0x3F;
+ const unsigned rs = (instr >> 21) & 0x1F;
+ const unsigned rt = (instr >> 16) & 0x1F;
+ const unsigned rd = (instr >> 11) & 0x1F;
+ const unsigned shamt = (instr >> 6) & 0x1F;
+ const uint32 immediate = (int32)(int16)(instr & 0xFFFF);
+ const uint32 immediate_ze = instr & 0xFFFF;
+ const uint32 GS = OffsGPR + rs * 4;
+ const uint32 GT = OffsGPR + rt * 4;
+ const uint32 GD = OffsGPR + rd * 4;
+ const unsigned kind = Classify(instr);
+
+ //
+ // while(timestamp < next_event_ts)
+ //
+ LoadReg(EAX, OffsTimestamp);
+ AluRegMem(ALU_CMP, EAX, OffsNextEventTS);
+ ExitIf(CC_GE, index);
+
+ if(!GPR0Clean)
+ {
+  StoreImm(OffsGPR, 0);
+  GPR0Clean = true;
+ }
+
+ //
+ // ICache hit on the word we compiled, and no interrupt pending.
+ //
+ AluMemImm(ALU_CMP, OffsICache + ((PC & 0xFFC) >> 2) * 8 + 0, PC);
+ ExitIf(CC_NE, index);
+ AluMemImm(ALU_CMP, OffsICache + ((PC & 0xFFC) >> 2) * 8 + 4, instr);
+ ExitIf(CC_NE, index);
+
+ if(!IPClean)
+ {
+  AluMemImm(ALU_CMP, OffsIPCache, 0);
+  ExitIf(CC_NE, index);
+  IPClean = true;
+ }
+
+ //
+ // Exceptions are the interpreter's business; check for them while we can still hand over the instruction untouched.
+ //
+ if(!op && (funct == 0x20 || funct == 0x22))	// ADD, SUB
+ {
+  LoadReg(EDX, GS);
+  AluRegMem((funct == 0x20) ? ALU_ADD : ALU_SUB, EDX, GT);
+  ExitIf(CC_O, index);
+ }
+ else if(op == 0x08)	// ADDI
+ {
+  LoadReg(EDX, GS);
+  AluRegImm(ALU_ADD, EDX, immediate);
+  ExitIf(CC_O, index);
+ }
+ else if(op == 0x21 || op == 0x25 || op == 0x29 || op == 0x23 || op == 0x2B)	// LH, LHU, SH, LW, SW
+ {
+  LoadReg(EDX, GS);
+  AluRegImm(ALU_ADD, EDX, immediate);
+  Emit8(0xF7); Emit8(0xC0 | EDX); Emit32((op == 0x23 || op == 0x2B) ? 0x3 : 0x1);	// test edx, imm32
+  ExitIf(CC_NE, index);
+ }
+
+ EmitReadAbsorb();
+
+ if(kind == KindHelper)
+ {
+#ifdef _WIN32
+  const unsigned arg0 = ECX, arg1 = EDX;
+#else
+  const unsigned arg0 = EDI, arg1 = ESI;
+#endif
+  Emit8(0x48); Emit8(0x89); Emit8(0xC0 | (EBX << 3) | arg0);		// mov arg0, rbx
+  MovImm(arg1, instr);
+  Emit8(0x48); Emit8(0xB8); MDFN_en64lsb(CodePtr, (uint64)(uintptr_t)&CallOp); CodePtr += 8;	// mov rax, imm64
+  Emit8(0xFF); Emit8(0xD0);						// call rax
+
+  // Anything goes after a memory access.
+  LDS = LDS_Unknown;
+  GPR0Clean = false;
+  IPClean = false;
+  return;
+ }
+
+ if(kind == KindBranch)
+ {
+  const uint32 DS = PC + 4;
+
+  // Condition(or register target) goes in edx, which EmitLDS() leaves alone.
+  if(!op)	// JR, JALR
+  {
+   EmitDepRes(rs, rd);
+   LoadReg(EDX, GS);
+   EmitLDS();
+
+   if(funct == 0x09)
+   {
+    StoreImm(GD, DS + 4);
+    GPR0Clean &= (rd != 0);
+   }
+
+   StoreReg(OffsNewPC, EDX);
+   StoreImm(OffsNewPCMask, 0);
+  }
+  else if(op == 0x02 || op == 0x03)	// J, JAL
+  {
+   if(op == 0x03)
+    StoreImm8(OffsReadAbsorb + 31, 0);
+
+   EmitLDS();
+
+   if(op == 0x03)
+    StoreImm(OffsGPR + 31 * 4, DS + 4);
+
+   StoreImm(OffsNewPC, (instr & ((1 << 26) - 1)) << 2);
+   StoreImm(OffsNewPCMask, 0xF0000000);
+  }
+  else
+  {
+   unsigned link = 0;
+   uint8* not_taken;
+   uint8* done;
+
+   switch(op)
+   {
+    case 0x01:	// BCOND
+	link = ((rt & 0x1E) == 0x10) ? 31 : 0;
+	LoadReg(EDX, GS);
+	TestReg(EDX);
+	SetCC((rt & 1) ? CC_NS : CC_S, EDX);
+	EmitDepRes(rs, link);
+	break;
+
+    case 0x04:	// BEQ
+    case 0x05:	// BNE
+	EmitDepRes(rs, rt);
+	LoadReg(EDX, GS);
+	AluRegMem(ALU_CMP, EDX, GT);
+	SetCC((op == 0x04) ? CC_E : CC_NE, EDX);
+	break;
+
+    case 0x06:	// BLEZ
+    case 0x07:	// BGTZ
+	EmitDepRes(rs);
+	LoadReg(EDX, GS);
+	TestReg(EDX);
+	SetCC((op == 0x06) ? CC_LE : CC_G, EDX);
+	break;
+   }
+
+   EmitLDS();
+
+   if(op == 0x01)
+   {
+    StoreImm(OffsGPR + link * 4, DS + 4);
+    GPR0Clean &= (link != 0);
+   }
+
+   TestReg(EDX);
+   not_taken = Jcc8(CC_E);
+   StoreImm(OffsNewPC, immediate << 2);
+   StoreImm(OffsNewPCMask, ~3U);
+   done = Jmp8();
+   Patch8(not_taken, CodePtr);
+   StoreImm(OffsNewPC, 4);
+   StoreImm(OffsNewPCMask, ~1U);
+   Patch8(done, CodePtr);
+  }
+  return;
+ }
+
+ //
+ // ALU; result in edx, stored after DO_LDS().
+ //
+ uint32 dest;
+
+ if(!op)
+ {
+  dest = GD;
+
+  switch(funct)
+  {
+   case 0x00:	// SLL
+   case 0x02:	// SRL
+   case 0x03:	// SRA
+	EmitDepRes(rt, rd);
+	LoadReg(EDX, GT);
+	ShiftImm((funct == 0x00) ? SH_SHL : ((funct == 0x02) ? SH_SHR : SH_SAR), EDX, shamt);
+	break;
+
+   case 0x04:	// SLLV
+   case 0x06:	// SRLV
+   case 0x07:	// SRAV
+	EmitDepRes(rs, rt, rd);
+	LoadReg(ECX, GS);
+	LoadReg(EDX, GT);
+	ShiftCL((funct == 0x04) ? SH_SHL : ((funct == 0x06) ? SH_SHR : SH_SAR), EDX);
+	break;
+
+   case 0x20:	// ADD
+   case 0x21:	// ADDU
+   case 0x22:	// SUB
+   case 0x23:	// SUBU
+   case 0x24:	// AND
+   case 0x25:	// OR
+   case 0x26:	// XOR
+   case 0x27:	// NOR
+	{
+	 static const uint8 alu_tab[8] = { ALU_ADD, ALU_ADD, ALU_SUB, ALU_SUB, ALU_AND, ALU_OR, ALU_XOR, ALU_OR };
+
+	 EmitDepRes(rs, rt, rd);
+	 LoadReg(EDX, GS);
+	 AluRegMem(alu_tab[funct & 0x7], EDX, GT);
+
+	 if(funct == 0x27)
+	 {
+	  Emit8(0xF7); Emit8(0xD0 | EDX);	// not edx
+	 }
+	}
+	break;
+
+   case 0x2A:	// SLT
+   case 0x2B:	// SLTU
+	EmitDepRes(rs, rt, rd);
+	LoadReg(EDX, GS);
+	AluRegMem(ALU_CMP, EDX, GT);
+	SetCC((funct == 0x2A) ? CC_L : CC_B, EDX);
+	break;
+  }
+ }
+ else
+ {
+  dest = GT;
+
+  if(op == 0x0F)	// LUI
+  {
+   EmitDepRes(rt);
+   EmitLDS();
+   StoreImm(dest, immediate_ze << 16);
+   GPR0Clean &= (rt != 0);
+   return;
+  }
+
+  EmitDepRes(rs, rt);
+  LoadReg(EDX, GS);
+
+  switch(op)
+  {
+   case 0x08:	// ADDI
+   case 0x09:	// ADDIU
+	AluRegImm(ALU_ADD, EDX, immediate);
+	break;
+
+   case 0x0A:	// SLTI
+   case 0x0B:	// SLTIU
+	AluRegImm(ALU_CMP, EDX, immediate);
+	SetCC((op == 0x0A) ? CC_L : CC_B, EDX);
+	break;
+
+   case 0x0C:	// ANDI
+	AluRegImm(ALU_AND, EDX, immediate_ze);
+	break;
+
+   case 0x0D:	// ORI
+	AluRegImm(ALU_OR, EDX, immediate_ze);
+	break;
+
+   case 0x0E:	// XORI
+	AluRegImm(ALU_XOR, EDX, immediate_ze);
+	break;
+  }
+ }
+
+ EmitLDS();
+ StoreReg(dest, EDX);
+ GPR0Clean &= (dest != OffsGPR);
+}
+
+void PS_CPU_Recompiler::Compile(Block* b, uint32 PC)
+{
+ b->PC = PC;
+ b->Instr = FetchInstr(PC);
+ b->Func = NULL;
+
+ //
+ // Find the extent of the block.
+ //
+ BlockPC = PC;
+ BlockLength = 0;
+ BlockBranches = false;
+
+ while(BlockLength < MaxBlockInstrs)
+ {
+  const uint32 instr = FetchInstr(PC + BlockLength * 4);
+  const unsigned kind = Classify(instr);
+
+  if(kind == KindNone)
+   break;
+
+  if(kind == KindBranch)
+  {
+   const unsigned ds_kind = Classify(FetchInstr(PC + BlockLength * 4 + 4));
+
+   // The interpreter can have branches in delay slots, and anything else we can't do.
+   if(ds_kind != KindNone && ds_kind != KindBranch)
+   {
+    BlockLength += 2;
+    BlockBranches = true;
+   }
+   break;
+  }
+
+  BlockLength++;
+ }
+
+ if(!BlockLength)
+  return;
+
+ if((size_t)(CodeBase + CodeSize - CodePtr) < MaxBlockBytes)
+ {
+  Flush();
+
+  b->PC = PC;
+  b->Instr = FetchInstr(PC);
+ }
+
+ //
+ // push rbx; sub rsp, 32; mov rbx, arg0
+ //
+ uint8* const start = CodePtr;
+
+ Emit8(0x53);
+ Emit8(0x48); Emit8(0x83); Emit8(0xEC); Emit8(0x20);
+#ifdef _WIN32
+ Emit8(0x48); Emit8(0x89); Emit8(0xC0 | (ECX << 3) | EBX);
+#else
+ Emit8(0x48); Emit8(0x89); Emit8(0xC0 | (EDI << 3) | EBX);
+#endif
+
+ ExitCount = 0;
+ LDS = LDS_Unknown;
+ GPR0Clean = false;
+ IPClean = false;
+
+ for(unsigned i = 0; i < BlockLength; i++)
+  CompileInstr(PC + i * 4, FetchInstr(PC + i * 4), i);
+
+ //
+ // Fell off the end; after a branch, PC = (PC & new_PC_mask) + new_PC from its delay slot as in OpDone.
+ //
+ if(BlockBranches)
+ {
+  MovImm(EAX, PC + (BlockLength - 1) * 4);
+  AluRegMem(ALU_AND, EAX, OffsNewPCMask);
+  AluRegMem(ALU_ADD, EAX, OffsNewPC);
+  StoreReg(OffsPC, EAX);
+  StoreImm(OffsNewPC, 4);
+  StoreImm(OffsNewPCMask, ~0U);
+ }
+ else
+  StoreImm(OffsPC, PC + BlockLength * 4);
+
+ MovImm(EAX, 1);
+
+ uint8* const epilogue = CodePtr;
+
+ Emit8(0x48); Emit8(0x83); Emit8(0xC4); Emit8(0x20);
+ Emit8(0x5B);
+ Emit8(0xC3);
+
+ //
+ // Early exits.  The first instruction of a block is never a delay slot, and new_PC/new_PC_mask are already in place for one
+ // that is, so only PC needs setting.
+ //
+ for(unsigned i = 0; i < BlockLength; i++)
+ {
+  uint8* stub = NULL;
+
+  for(unsigned j = 0; j < ExitCount; j++)
+  {
+   if(Exits[j].index != i)
+    continue;
+
+   if(!stub)
+   {
+    stub = CodePtr;
+    StoreImm(OffsPC, PC + i * 4);
+    MovImm(EAX, i != 0);
+    Patch32(Jmp32(), epilogue);
+   }
+
+   Patch32(Exits[j].at, stub);
+  }
+ }
+
+ assert((size_t)(CodePtr - start) <= MaxBlockBytes);
+
+ b->Func = (BlockFunc)start;
+}
+
+#endif
+
+void PS_CPU::SetRecompiler(bool enabled)
+{
+#ifdef PS_CPU_RECOMPILER_X64
+ if(enabled && !Recompiler)
+ {
+  Recompiler = new PS_CPU_Recompiler(this);
+
+  if(!Recompiler->IsUsable())
+  {
+   delete Recompiler;
+   Recompiler = NULL;
+  }
+ }
+ else if(!enabled && Recompiler)
+ {
+  delete Recompiler;
+  Recompiler = NULL;
+ }
+#endif
+}
+
+bool PS_CPU::RunRecompiled(void)
+{
+#ifdef PS_CPU_RECOMPILER_X64
+ return Recompiler->Run(BACKED_PC);
+#else
+ return false;
+#endif
+}
+
+}
@@ -44,8 +44,6 @@ enum
  CH_OT = 6,
 };
 
-extern bool GpuFrameForLag;
-
 // RunChannels(128 - whatevercounter);
 //
 // GPU next event, std::max<128, wait_time>, or something similar, for handling FIFO.
@@ -53,13 +51,6 @@ extern bool GpuFrameForLag;
 namespace MDFN_IEN_PSX
 {
 
-static int32 DMACycleCounter;
-
-static uint32 DMAControl;
-static uint32 DMAIntControl;
-static uint8 DMAIntStatus;
-static bool IRQOut;
-
 struct Channel
 {
  uint32 BaseAddr;
@@ -77,50 +68,65 @@ struct Channel
  int32 ClockCounter;
 };
 
-static Channel DMACH[7];
-static pscpu_timestamp_t lastts;
+struct DMA_State
+{
+ int32 DMACycleCounter;
+
+ uint32 DMAControl;
+ uint32 DMAIntControl;
+ uint8 DMAIntStatus;
+ bool IRQOut;
+
+ Channel DMACH[7];
+ pscpu_timestamp_t lastts;
+
+ template<bool isReader> void SyncState(EW::NewState *ns);
+};
+
+#define DMA_S (*PSX_I->dma)
 
 
 // static const char *PrettyChannelNames[7] = { "MDEC IN", "MDEC OUT", "GPU", "CDC", "SPU", "PIO", "OTC" };
 
 void DMA_Init(void)
 {
-
+ PSX_I->dma = new DMA_State();
 }
 
 void DMA_Kill(void)
 {
-
+ delete PSX_I->dma;
+ PSX_I->dma = NULL;
 }
 
 static INLINE void RecalcIRQOut(void)
 {
  bool irqo;
 
- irqo = (bool)DMAIntStatus;
- irqo &= (DMAIntControl >> 23) & 1;
- irqo |= (DMAIntControl >> 15) & 1;
+ irqo = (bool)DMA_S.DMAIntStatus;
+ irqo &= (DMA_S.DMAIntControl >> 23) & 1;
+ irqo |= (DMA_S.DMAIntControl >> 15) & 1;
 
- IRQOut = irqo;
+ DMA_S.IRQOut = irqo;
  IRQ_Assert(IRQ_DMA, irqo);
 }
 
 void DMA_ResetTS(void)
 {
- lastts = 0;
+ DMA_S.lastts = 0;
 }
 
 void DMA_Power(void)
 {
- lastts = 0;
+ DMA_S.lastts = 0;
 
- memset(DMACH, 0, sizeof(DMACH));
+ memset(DMA_S.DMACH, 0, sizeof(DMA_S.DMACH));
 
- DMACycleCounter = 128;
+ DMA_S.DMACycleCounter = 128;
 
- DMAControl = 0;
- DMAIntControl = 0;
- DMAIntStatus = 0;
+ DMA_S.DMAControl = 0;
+ DMA_S.DMAIntControl = 0;
+ DMA_S.DMAIntStatus = 0;
  RecalcIRQOut();
 }
 
@@ -139,7 +145,7 @@ static INLINE bool ChCan(const unsigned ch, const uint32 CRModeCache)
   
   case CH_GPU: 
 	if(CRModeCache & 0x1)
-	 return(GPU->DMACanWrite());
+	 return(PSX_I->GPU->DMACanWrite());
 	else
 	 return(true);
 
@@ -153,7 +159,7 @@ static INLINE bool ChCan(const unsigned ch, const uint32 CRModeCache)
 	return(false);
 
   case CH_OT:
-	 return((bool)(DMACH[ch].ChanControl & (1U << 28)));
+	 return((bool)(DMA_S.DMACH[ch].ChanControl & (1U << 28)));
  }
 }
 
@@ -164,11 +170,11 @@ static void RecalcHalt(void)
 
  for(ch = 0; ch < 7; ch++)
  {
-  if(DMACH[ch].ChanControl & (1U << 24))
+  if(DMA_S.DMACH[ch].ChanControl & (1U << 24))
   {
-   if(!(DMACH[ch].ChanControl & (7U << 8)))
+   if(!(DMA_S.DMACH[ch].ChanControl & (7U << 8)))
    {
-    if(DMACH[ch].WordCounter > 0)
+    if(DMA_S.DMACH[ch].WordCounter > 0)
     {
      Halt = true;
      break;
@@ -176,16 +182,16 @@ static void RecalcHalt(void)
    }
 
 #if 0
-   if(DMACH[ch].ChanControl & 0x100)	// DMA doesn't hog the bus when this bit is set, though the DMA takes longer.
+   if(DMA_S.DMACH[ch].ChanControl & 0x100)	// DMA doesn't hog the bus when this bit is set, though the DMA takes longer.
     continue;
 
    if(ch == 4 || ch == 5)	// Not sure if these channels will typically hog the bus or not...investigate.
     continue;
 
-   if(!(DMACH[ch].ChanControl & (1U << 10)))	// Not sure about HOGGERYNESS with linked-list mode, and it likely wouldn't work well either in regards
+   if(!(DMA_S.DMACH[ch].ChanControl & (1U << 10)))	// Not sure about HOGGERYNESS with linked-list mode, and it likely wouldn't work well either in regards
 						// to GPU commands due to the rather large DMA update granularity.
    {
-    if((DMACH[ch].WordCounter > 0) || ChCan(ch, DMACH[ch].ChanControl & 0x1))
+    if((DMA_S.DMACH[ch].WordCounter > 0) || ChCan(ch, DMA_S.DMACH[ch].ChanControl & 0x1))
     {
      Halt = true;
      break;
@@ -196,27 +202,27 @@ static void RecalcHalt(void)
  }
 
 #if 0
- if((DMACH[0].WordCounter || (DMACH[0].ChanControl & (1 << 24))) && (DMACH[0].ChanControl & 0x200) /*&& MDEC_DMACanWrite()*/)
+ if((DMA_S.DMACH[0].WordCounter || (DMA_S.DMACH[0].ChanControl & (1 << 24))) && (DMA_S.DMACH[0].ChanControl & 0x200) /*&& MDEC_DMACanWrite()*/)
   Halt = true;
 
- if((DMACH[1].WordCounter || (DMACH[1].ChanControl & (1 << 24))) && (DMACH[1].ChanControl & 0x200) && (DMACH[1].WordCounter || MDEC_DMACanRead()))
+ if((DMA_S.DMACH[1].WordCounter || (DMA_S.DMACH[1].ChanControl & (1 << 24))) && (DMA_S.DMACH[1].ChanControl & 0x200) && (DMA_S.DMACH[1].WordCounter || MDEC_DMACanRead()))
   Halt = true;
 
- if((DMACH[2].WordCounter || (DMACH[2].ChanControl & (1 << 24))) && (DMACH[2].ChanControl & 0x200) && ((DMACH[2].ChanControl & 0x1) && (DMACH[2].WordCounter || GPU->DMACanWrite())))
+ if((DMA_S.DMACH[2].WordCounter || (DMA_S.DMACH[2].ChanControl & (1 << 24))) && (DMA_S.DMACH[2].ChanControl & 0x200) && ((DMA_S.DMACH[2].ChanControl & 0x1) && (DMA_S.DMACH[2].WordCounter || PSX_I->GPU->DMACanWrite())))
   Halt = true;
 
- if((DMACH[3].WordCounter || (DMACH[3].ChanControl & (1 << 24))) && !(DMACH[3].ChanControl & 0x100))
+ if((DMA_S.DMACH[3].WordCounter || (DMA_S.DMACH[3].ChanControl & (1 << 24))) && !(DMA_S.DMACH[3].ChanControl & 0x100))
   Halt = true;
 
- if(DMACH[6].WordCounter || (DMACH[6].ChanControl & (1 << 24)))
+ if(DMA_S.DMACH[6].WordCounter || (DMA_S.DMACH[6].ChanControl & (1 << 24)))
   Halt = true;
 #endif
 
  //printf("Halt: %d\n", Halt);
 
- if(!Halt && (DMACH[2].ChanControl & (1U << 24)) && ((DMACH[2].ChanControl & 0x700) == 0x200) && ChCan(2, DMACH[2].ChanControl))
+ if(!Halt && (DMA_S.DMACH[2].ChanControl & (1U << 24)) && ((DMA_S.DMACH[2].ChanControl & 0x700) == 0x200) && ChCan(2, DMA_S.DMACH[2].ChanControl))
  {
-  unsigned tmp = DMACH[2].BlockControl & 0xFFFF;
+  unsigned tmp = DMA_S.DMACH[2].BlockControl & 0xFFFF;
 
   if(tmp > 0)
    tmp--;
@@ -226,7 +232,7 @@ static void RecalcHalt(void)
  else
   PSX_SetDMACycleSteal(0);
 
- CPU->SetHalt(Halt);
+ PSX_I->CPU->SetHalt(Halt);
 }
 
 
@@ -258,12 +264,12 @@ static INLINE void ChRW(const unsigned ch, const uint32 CRModeCache, uint32 *V,
   case CH_GPU:
 	  if(CRModeCache & 0x1)
 		{
-			if(DMACH[CH_GPU].ChanControl == 0x01000401)
-				GpuFrameForLag = true;
-	   GPU->WriteDMA(*V);
+			if(DMA_S.DMACH[CH_GPU].ChanControl == 0x01000401)
+				PSX_I->GpuFrameForLag = true;
+	   PSX_I->GPU->WriteDMA(*V);
 		}
 	  else
-	   *V = GPU->ReadDMA();
+	   *V = PSX_I->GPU->ReadDMA();
 	  break;
 
   case CH_CDC:
@@ -273,16 +279,16 @@ static INLINE void ChRW(const unsigned ch, const uint32 CRModeCache, uint32 *V,
 	  {
 	   if(CRModeCache & 0x00400000)	// For CDC DMA(at least): When this bit is set, DMA controller appears to get even less bus time(or has a lower priority??)
 	   {
-	    DMACH[ch].ClockCounter -= 44 * 20 / 12;
+	    DMA_S.DMACH[ch].ClockCounter -= 44 * 20 / 12;
 	   }
 	   else
 	   {
-	    DMACH[ch].ClockCounter -= 29 * 20 / 12;
+	    DMA_S.DMACH[ch].ClockCounter -= 29 * 20 / 12;
 	   }
 	  }
 	  else
 	  {
-	   DMACH[ch].ClockCounter -= 23 * 20 / 12; // (23 + 1) = 24.  (Though closer to 24.5 or 24.4 on average per tests on a PS1)
+	   DMA_S.DMACH[ch].ClockCounter -= 23 * 20 / 12; // (23 + 1) = 24.  (Though closer to 24.5 or 24.4 on average per tests on a PS1)
 	  }
 #endif
 	  if(CRModeCache & 0x1)
@@ -291,7 +297,7 @@ static INLINE void ChRW(const unsigned ch, const uint32 CRModeCache, uint32 *V,
 	  else
 	  {
 	   extra_cyc_overhead = 8;	// FIXME: Test.
-	   *V = CDC->DMARead();		// Note: Legend of Mana's opening movie is sensitive to DMA timing, including CDC.
+	   *V = PSX_I->CDC->DMARead();		// Note: Legend of Mana's opening movie is sensitive to DMA timing, including CDC.
 	  }
 	  break;
 
@@ -314,9 +320,9 @@ static INLINE void ChRW(const unsigned ch, const uint32 CRModeCache, uint32 *V,
 	  extra_cyc_overhead = 47;	// Should be closer to 69, average, but actual timing is...complicated.
 
 	  if(CRModeCache & 0x1)
-	   SPU->WriteDMA(*V);
+	   PSX_I->SPU->WriteDMA(*V);
 	  else
-	   *V = SPU->ReadDMA();
+	   *V = PSX_I->SPU->ReadDMA();
 	  break;
 
   case CH_FIVE:
@@ -330,15 +336,15 @@ static INLINE void ChRW(const unsigned ch, const uint32 CRModeCache, uint32 *V,
 	  break;
 
   case CH_OT:
-	  if(DMACH[ch].WordCounter == 1)
+	  if(DMA_S.DMACH[ch].WordCounter == 1)
 	   *V = 0xFFFFFF;
 	  else
-	   *V = (DMACH[ch].CurAddr - 4) & 0x1FFFFF;
+	   *V = (DMA_S.DMACH[ch].CurAddr - 4) & 0x1FFFFF;
 	  break;
  }
 
  // GROSS APPROXIMATION, shoehorning multiple effects together, TODO separate(especially SPU and CDC)
- DMACH[ch].ClockCounter -= std::max<int>(extra_cyc_overhead, (CRModeCache & 0x100) ? 7 : 0);
+ DMA_S.DMACH[ch].ClockCounter -= std::max<int>(extra_cyc_overhead, (CRModeCache & 0x100) ? 7 : 0);
 }
 
 //
@@ -349,61 +355,62 @@ static INLINE void ChRW(const unsigned ch, const uint32 CRModeCache, uint32 *V,
 static INLINE void RunChannelI(const unsigned ch, const uint32 CRModeCache, int32 clocks)
 {
  //const uint32 dc = (DMAControl >> (ch * 4)) & 0xF;
+ Channel& chan = DMA_S.DMACH[ch];
 
- DMACH[ch].ClockCounter += clocks;
+ chan.ClockCounter += clocks;
 
- while(MDFN_LIKELY(DMACH[ch].ClockCounter > 0))
+ while(MDFN_LIKELY(chan.ClockCounter > 0))
  {
-  if(DMACH[ch].WordCounter == 0)	// Begin WordCounter reload.
+  if(chan.WordCounter == 0)	// Begin WordCounter reload.
   {
-   if(!(DMACH[ch].ChanControl & (1 << 24)))	// Needed for the forced-DMA-stop kludge(see DMA_Write()).
+   if(!(chan.ChanControl & (1 << 24)))	// Needed for the forced-DMA-stop kludge(see DMA_Write()).
     break;
 
    if(!ChCan(ch, CRModeCache))
     break;
 
-   DMACH[ch].CurAddr = DMACH[ch].BaseAddr;
+   chan.CurAddr = chan.BaseAddr;
 
    if(CRModeCache & (1U << 10))
    {
     uint32 header;
 
-    if(MDFN_UNLIKELY(DMACH[ch].CurAddr & 0x800000))
+    if(MDFN_UNLIKELY(chan.CurAddr & 0x800000))
     {
-     DMACH[ch].ChanControl &= ~(0x11 << 24);
-     DMAIntControl |= 0x8000;
+     chan.ChanControl &= ~(0x11 << 24);
+     DMA_S.DMAIntControl |= 0x8000;
      RecalcIRQOut();
      break;
     }
 
-    header = MainRAM.ReadU32(DMACH[ch].CurAddr & 0x1FFFFC);
-    DMACH[ch].CurAddr = (DMACH[ch].CurAddr + 4) & 0xFFFFFF;
+    header = PSX_I->MainRAM->ReadU32(chan.CurAddr & 0x1FFFFC);
+    chan.CurAddr = (chan.CurAddr + 4) & 0xFFFFFF;
 
-    DMACH[ch].WordCounter = header >> 24;
-    DMACH[ch].BaseAddr = header & 0xFFFFFF;
+    chan.WordCounter = header >> 24;
+    chan.BaseAddr = header & 0xFFFFFF;
 
     // printf to debug Soul Reaver ;)
     //if(DMACH[ch].WordCounter > 0x10) 
     // printf("What the lala?  0x%02x @ 0x%08x\n", DMACH[ch].WordCounter, DMACH[ch].CurAddr - 4);
 
-    if(DMACH[ch].WordCounter)
-     DMACH[ch].ClockCounter -= 15;
+    if(chan.WordCounter)
+     chan.ClockCounter -= 15;
     else
-     DMACH[ch].ClockCounter -= 10;
+     chan.ClockCounter -= 10;
 
     goto SkipPayloadStuff;	// 3 cheers for gluten-free spaghetticode(necessary because the newly-loaded WordCounter might be 0, and we actually
 				// want 0 to mean 0 and not 65536 in this context)!
    }
    else
    {
-    DMACH[ch].WordCounter = DMACH[ch].BlockControl & 0xFFFF;
+    chan.WordCounter = chan.BlockControl & 0xFFFF;
 
     if(CRModeCache & (1U << 9))
     {
      if(ch == 2)	// Technically should apply to all channels, but since we don't implement CPU read penalties for channels other than 2 yet, it's like this to avoid making DMA longer than what games can handle.
-      DMACH[ch].ClockCounter -= 7;
+      chan.ClockCounter -= 7;
 
-     DMACH[ch].BlockControl = (DMACH[ch].BlockControl & 0xFFFF) | ((DMACH[ch].BlockControl - (1U << 16)) & 0xFFFF0000);
+     chan.BlockControl = (chan.BlockControl & 0xFFFF) | ((chan.BlockControl - (1U << 16)) & 0xFFFF0000);
     }
    }
   }	// End WordCounter reload.
@@ -411,8 +418,8 @@ static INLINE void RunChannelI(const unsigned ch, const uint32 CRModeCache, int3
   {
    //printf("LoadWC: %u(oldWC=%u)\n", DMACH[ch].BlockControl & 0xFFFF, DMACH[ch].WordCounter);
    //MDFN_DispMessage("SPOOOON\n");
-   DMACH[ch].CurAddr = DMACH[ch].BaseAddr;
-   DMACH[ch].WordCounter = DMACH[ch].BlockControl & 0xFFFF;
+   chan.CurAddr = chan.BaseAddr;
+   chan.WordCounter = chan.BlockControl & 0xFFFF;
   }
 
   //
@@ -422,48 +429,48 @@ static INLINE void RunChannelI(const unsigned ch, const uint32 CRModeCache, int3
    uint32 vtmp;
    uint32 voffs = 0;
 
-   if(MDFN_UNLIKELY(DMACH[ch].CurAddr & 0x800000))
+   if(MDFN_UNLIKELY(chan.CurAddr & 0x800000))
    {
-    DMACH[ch].ChanControl &= ~(0x11 << 24);
-    DMAIntControl |= 0x8000;
+    chan.ChanControl &= ~(0x11 << 24);
+    DMA_S.DMAIntControl |= 0x8000;
     RecalcIRQOut();
     break;
    }
 
    if(CRModeCache & 0x1)
-    vtmp = MainRAM.ReadU32(DMACH[ch].CurAddr & 0x1FFFFC);
+    vtmp = PSX_I->MainRAM->ReadU32(chan.CurAddr & 0x1FFFFC);
 
    ChRW(ch, CRModeCache, &vtmp, &voffs);
 
    if(!(CRModeCache & 0x1))
-    MainRAM.WriteU32((DMACH[ch].CurAddr + (voffs << 2)) & 0x1FFFFC, vtmp);
+    PSX_I->MainRAM->WriteU32((chan.CurAddr + (voffs << 2)) & 0x1FFFFC, vtmp);
   }
 
   if(CRModeCache & 0x2)
-   DMACH[ch].CurAddr = (DMACH[ch].CurAddr - 4) & 0xFFFFFF;
+   chan.CurAddr = (chan.CurAddr - 4) & 0xFFFFFF;
   else
-   DMACH[ch].CurAddr = (DMACH[ch].CurAddr + 4) & 0xFFFFFF;
+   chan.CurAddr = (chan.CurAddr + 4) & 0xFFFFFF;
 
-  DMACH[ch].WordCounter--;
-  DMACH[ch].ClockCounter--;
+  chan.WordCounter--;
+  chan.ClockCounter--;
 
   SkipPayloadStuff: ;
 
   if(CRModeCache & 0x100) // BLARGH BLARGH WHALEFISH
   {
-   DMACH[ch].BaseAddr = DMACH[ch].CurAddr;
-   DMACH[ch].BlockControl = (DMACH[ch].BlockControl & 0xFFFF0000) | DMACH[ch].WordCounter;
+   chan.BaseAddr = chan.CurAddr;
+   chan.BlockControl = (chan.BlockControl & 0xFFFF0000) | chan.WordCounter;
    //printf("SaveWC: %u\n", DMACH[ch].WordCounter);
   }
 
   //
   // Handle channel end condition:
   //
-  if(DMACH[ch].WordCounter == 0)
+  if(chan.WordCounter == 0)
   {
    bool ChannelEndTC = false;
 
-   if(!(DMACH[ch].ChanControl & (1 << 24)))	// Needed for the forced-DMA-stop kludge(see DMA_Write()).
+   if(!(chan.ChanControl & (1 << 24)))	// Needed for the forced-DMA-stop kludge(see DMA_Write()).
     break;
 
    switch((CRModeCache >> 9) & 0x3)
@@ -473,24 +480,24 @@ static INLINE void RunChannelI(const unsigned ch, const uint32 CRModeCache, int3
 	break;
 
     case 0x1:
-	DMACH[ch].BaseAddr = DMACH[ch].CurAddr;
-	if((DMACH[ch].BlockControl >> 16) == 0)
+	chan.BaseAddr = chan.CurAddr;
+	if((chan.BlockControl >> 16) == 0)
    	 ChannelEndTC = true;
 	break;
 
     case 0x2:
     case 0x3:	// Not sure about 0x3.
-	if(DMACH[ch].BaseAddr == 0xFFFFFF)
+	if(chan.BaseAddr == 0xFFFFFF)
 	 ChannelEndTC = true;
 	break;
    }
 
    if(ChannelEndTC)
    {
-    DMACH[ch].ChanControl &= ~(0x11 << 24);
-    if(DMAIntControl & (1U << (16 + ch)))
+    chan.ChanControl &= ~(0x11 << 24);
+    if(DMA_S.DMAIntControl & (1U << (16 + ch)))
     {
-     DMAIntStatus |= 1U << ch;
+     DMA_S.DMAIntStatus |= 1U << ch;
      RecalcIRQOut();
     }
     break;
@@ -498,14 +505,14 @@ static INLINE void RunChannelI(const unsigned ch, const uint32 CRModeCache, int3
   }
  }
 
- if(DMACH[ch].ClockCounter > 0)
-  DMACH[ch].ClockCounter = 0;
+ if(chan.ClockCounter > 0)
+  chan.ClockCounter = 0;
 }
 
 static INLINE void RunChannel(pscpu_timestamp_t timestamp, int32 clocks, int ch)
 {
  // Mask out the bits that the DMA controller will modify during the course of operation.
- const uint32 CRModeCache = DMACH[ch].ChanControl &~(0x11 << 24);
+ const uint32 CRModeCache = DMA_S.DMACH[ch].ChanControl &~(0x11 << 24);
 
  switch(ch)
  {
@@ -569,8 +576,8 @@ static INLINE void RunChannel(pscpu_timestamp_t timestamp, int32 clocks, int ch)
 
 static INLINE int32 CalcNextEvent(int32 next_event)
 {
- if(DMACycleCounter < next_event)
-  next_event = DMACycleCounter;
+ if(DMA_S.DMACycleCounter < next_event)
+  next_event = DMA_S.DMACycleCounter;
 
  return(next_event);
 }
@@ -578,10 +585,10 @@ static INLINE int32 CalcNextEvent(int32 next_event)
 pscpu_timestamp_t DMA_Update(const pscpu_timestamp_t timestamp)
 {
 //   uint32 dc = (DMAControl >> (ch * 4)) & 0xF;
- int32 clocks = timestamp - lastts;
- lastts = timestamp;
+ int32 clocks = timestamp - DMA_S.lastts;
+ DMA_S.lastts = timestamp;
 
- GPU->Update(timestamp);
+ PSX_I->GPU->Update(timestamp);
  MDEC_Run(clocks);
 
  RunChannel(timestamp, clocks, 0);
@@ -591,9 +598,9 @@ pscpu_timestamp_t DMA_Update(const pscpu_timestamp_t timestamp)
  RunChannel(timestamp, clocks, 4);
  RunChannel(timestamp, clocks, 6);
 
- DMACycleCounter -= clocks;
- while(DMACycleCounter <= 0)
-  DMACycleCounter += 128;
+ DMA_S.DMACycleCounter -= clocks;
+ while(DMA_S.DMACycleCounter <= 0)
+  DMA_S.DMACycleCounter += 128;
 
  RecalcHalt();
 
@@ -614,7 +621,7 @@ static void CheckLinkedList(uint32 addr)
   }
   zoom[addr] = 1;
 
-  uint32 header = MainRAM.ReadU32(addr & 0x1FFFFC);
+  uint32 header = PSX_I->MainRAM->ReadU32(addr & 0x1FFFFC);
 
   addr = header & 0xFFFFFF;
 
@@ -639,13 +646,13 @@ void DMA_Write(const pscpu_timestamp_t timestamp, uint32 A, uint32 V)
   switch(A & 0xC)
   {
    case 0x0: //fprintf(stderr, "Global DMA control: 0x%08x\n", V);
-	     DMAControl = V;
+	     DMA_S.DMAControl = V;
 	     RecalcHalt();
 	     break;
 
    case 0x4: 
-	     DMAIntControl = V & 0x00ff803f;
-	     DMAIntStatus &= ~(V >> 24);
+	     DMA_S.DMAIntControl = V & 0x00ff803f;
+	     DMA_S.DMAIntStatus &= ~(V >> 24);
      	     RecalcIRQOut();
 	     break;
 
@@ -656,49 +663,49 @@ void DMA_Write(const pscpu_timestamp_t timestamp, uint32 A, uint32 V)
  }
  switch(A & 0xC)
  {
-  case 0x0: DMACH[ch].BaseAddr = V & 0xFFFFFF;
+  case 0x0: DMA_S.DMACH[ch].BaseAddr = V & 0xFFFFFF;
 	    break;
 
-  case 0x4: DMACH[ch].BlockControl = V;
+  case 0x4: DMA_S.DMACH[ch].BlockControl = V;
 	    break;
 
   case 0xC:
   case 0x8: 
 	   {
-	    uint32 OldCC = DMACH[ch].ChanControl;
+	    uint32 OldCC = DMA_S.DMACH[ch].ChanControl;
 
 	    //printf("CHCR: %u, %08x --- 0x%08x\n", ch, V, DMACH[ch].BlockControl);
 	    //
             // Kludge for DMA timing granularity and other issues.  Needs to occur before setting all bits of ChanControl to the new value, to accommodate the
 	    // case of a game cancelling DMA and changing the type of DMA(read/write, etc.) at the same time.
             //
-	    if((DMACH[ch].ChanControl & (1 << 24)) && !(V & (1 << 24)))
+	    if((DMA_S.DMACH[ch].ChanControl & (1 << 24)) && !(V & (1 << 24)))
 	    {
-	     DMACH[ch].ChanControl &= ~(1 << 24);	// Clear bit before RunChannel(), so it will only finish the block it's on at most.
+	     DMA_S.DMACH[ch].ChanControl &= ~(1 << 24);	// Clear bit before RunChannel(), so it will only finish the block it's on at most.
 	     RunChannel(timestamp, 128 * 16, ch);
-	     DMACH[ch].WordCounter = 0;
+	     DMA_S.DMACH[ch].WordCounter = 0;
 
 #if 0	// TODO(maybe, need to work out worst-case performance for abnormally/brokenly large block sizes)
-	     DMACH[ch].ClockCounter = (1 << 30);
+	     DMA_S.DMACH[ch].ClockCounter = (1 << 30);
 	     RunChannel(timestamp, 1, ch);
-	     DMACH[ch].ClockCounter = 0;
+	     DMA_S.DMACH[ch].ClockCounter = 0;
 #endif
-	     PSX_WARNING("[DMA] Forced stop for channel %d -- scanline=%d", ch, GPU->GetScanlineNum());
+	     PSX_WARNING("[DMA] Forced stop for channel %d -- scanline=%d", ch, PSX_I->GPU->GetScanlineNum());
 	     //MDFN_DispMessage("[DMA] Forced stop for channel %d", ch);
 	    }
 
 	    if(ch == 6)
-	     DMACH[ch].ChanControl = (V & 0x51000000) | 0x2;
+	     DMA_S.DMACH[ch].ChanControl = (V & 0x51000000) | 0x2;
 	    else
-	     DMACH[ch].ChanControl = V & 0x71770703;
+	     DMA_S.DMACH[ch].ChanControl = V & 0x71770703;
 
 	    if(!(OldCC & (1 << 24)) && (V & (1 << 24)))
 	    {
 	     //if(ch == 0 || ch == 1)
 	     // PSX_WARNING("[DMA] Started DMA for channel=%d --- CHCR=0x%08x --- BCR=0x%08x --- scanline=%d", ch, DMACH[ch].ChanControl, DMACH[ch].BlockControl, GPU->GetScanlineNum());
 
-	     DMACH[ch].WordCounter = 0;
-	     DMACH[ch].ClockCounter = 0;
+	     DMA_S.DMACH[ch].WordCounter = 0;
+	     DMA_S.DMACH[ch].ClockCounter = 0;
 
 	     //
 	     // Viewpoint starts a short MEM->GPU LL DMA and apparently has race conditions that can cause a crash if it doesn't finish almost immediately(
@@ -731,23 +738,23 @@ uint32 DMA_Read(const pscpu_timestamp_t timestamp, uint32 A)
    default: PSX_WARNING("[DMA] Unknown read: %08x", A);
 	    break;
 
-   case 0x0: ret = DMAControl;
+   case 0x0: ret = DMA_S.DMAControl;
 	     break;
 
-   case 0x4: ret = DMAIntControl | (DMAIntStatus << 24) | (IRQOut << 31);
+   case 0x4: ret = DMA_S.DMAIntControl | (DMA_S.DMAIntStatus << 24) | (DMA_S.IRQOut << 31);
 	     break;
   }
  }
  else switch(A & 0xC)
  {
-  case 0x0: ret = DMACH[ch].BaseAddr;
+  case 0x0: ret = DMA_S.DMACH[ch].BaseAddr;
   	    break;
 
-  case 0x4: ret = DMACH[ch].BlockControl;
+  case 0x4: ret = DMA_S.DMACH[ch].BlockControl;
 	    break;
 
   case 0xC:
-  case 0x8: ret = DMACH[ch].ChanControl;
+  case 0x8: ret = DMA_S.DMACH[ch].ChanControl;
             break;
 
  }
@@ -760,7 +767,7 @@ uint32 DMA_Read(const pscpu_timestamp_t timestamp, uint32 A)
 }
 
 
-void DMA_SyncState(bool isReader, EW::NewState *ns)
+SYNCFUNC(DMA_State)
 {
   NSS(DMACycleCounter);
   NSS(DMAControl);
@@ -770,5 +777,11 @@ void DMA_SyncState(bool isReader, EW::NewState *ns)
 	NSS(DMACH);
 }
 
+void DMA_SyncState(bool isReader, EW::NewState *ns)
+{
+	if(isReader) DMA_S.SyncState<true>(ns);
+	else DMA_S.SyncState<false>(ns);
+}
+
 
 }
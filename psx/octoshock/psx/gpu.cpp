@@ -16,6 +16,7 @@
  */
 
 #include <assert.h>
+#include <mutex>
 #include "psx.h"
 #include "timer.h"
 #include "math_ops.h"
@@ -74,10 +75,10 @@ static const int8 dither_table[4][4] =
 
 void PS_GPU::StaticInitialize()
 {
-	static bool initialized = false;
-	if(initialized) return;
-
-	initialized = true;
+	//these tables are shared by every instance, and instances may be created on several threads at once
+	static std::once_flag initialized;
+	std::call_once(initialized, []()
+	{
 	for(int y = 0; y < 4; y++)
 	{
 		for(int x = 0; x < 4; x++)
@@ -104,13 +105,18 @@ void PS_GPU::StaticInitialize()
  memcpy(&Commands[0x40], Commands_40_5F, sizeof(Commands_40_5F));
  memcpy(&Commands[0x60], Commands_60_7F, sizeof(Commands_60_7F));
  memcpy(&Commands[0x80], Commands_80_FF, sizeof(Commands_80_FF));
+	});
 }
 
 PS_GPU::PS_GPU(bool pal_clock_and_tv)
 {
-	//todo - not thread safe
 	StaticInitialize();
 
+ GPURAM = new uint16[512][1024];
+ OwnsGPURAM = true;
+ Raster = NULL;
+ BandMask = ~0U;
+
  HardwarePALType = pal_clock_and_tv;
 
  if(HardwarePALType == false)	// NTSC clock
@@ -124,11 +130,18 @@ PS_GPU::PS_GPU(bool pal_clock_and_tv)
   hmc_to_visible = 560; 
  }
 
+ // Not touched by Power(), but saved in states; keep them from differing between otherwise identical runs.
+ InCmd_CC = 0;
+ memset(InQuad_F3Vertices, 0, sizeof(InQuad_F3Vertices));
+ memset(&InPLine_PrevPoint, 0, sizeof(InPLine_PrevPoint));
 }
 
 PS_GPU::~PS_GPU()
 {
+ SetRasterThreads(0);
 
+ if(OwnsGPURAM)
+  delete[] GPURAM;
 }
 
 void PS_GPU::FillVideoParams(MDFNGI* gi)
@@ -245,7 +258,9 @@ void PS_GPU::SoftReset(void) // Control command 0x00
 
 void PS_GPU::Power(void)
 {
- memset(GPURAM, 0, sizeof(GPURAM));
+ FlushRaster();
+
+ memset(GPURAM, 0, 512 * 1024 * sizeof(uint16));
 
  memset(CLUT_Cache, 0, sizeof(CLUT_Cache));
  CLUT_Cache_VB = ~0U;
@@ -376,6 +391,9 @@ INLINE void PS_GPU::Command_FBFill(const uint32 *cb)
 
   DrawTimeAvail -= (width >> 3) + 9;
 
+  if(!InBand(d_y))
+   continue;
+
   for(int32 x = 0; x < width; x++)
   {
    const int32 d_x = (x + destX) & 1023;
@@ -584,7 +602,7 @@ INLINE void PS_GPU::Command_MaskSetting(const uint32 *cb)
 
 INLINE void PS_GPU::InvalidateTexCache(void)
 {
- for(int i=0;i<ARRAY_SIZE(TexCache);i++)
+ for(unsigned i=0;i<ARRAY_SIZE(TexCache);i++)
   TexCache[i].Tag = ~0U;
 }
 
@@ -721,6 +739,8 @@ const CTEntry PS_GPU::Commands_80_FF[0x80] =
 
 void PS_GPU::ProcessFIFO(void)
 {
+ PSX_PERF_SCOPE(PSX_PERF_GPU);
+
  if(!BlitterFIFO.CanRead())
   return;
 
@@ -780,7 +800,7 @@ void PS_GPU::ProcessFIFO(void)
 	  CB[i] = BlitterFIFO.Read();
 	 }
 
-	 command->func[abr][TexMode | (MaskEvalAND ? 0x4 : 0x0)](this, CB);
+	 RunCommand(cc, command->func[abr][TexMode | (MaskEvalAND ? 0x4 : 0x0)], CB, vl);
 	}
 	return;
        }
@@ -810,7 +830,7 @@ void PS_GPU::ProcessFIFO(void)
 	  CB[i] = BlitterFIFO.Read();
 	 }
 
-	 command->func[abr][TexMode | (MaskEvalAND ? 0x4 : 0x0)](this, CB);
+	 RunCommand(cc, command->func[abr][TexMode | (MaskEvalAND ? 0x4 : 0x0)], CB, vl);
 	}
 	return;
        }
@@ -859,7 +879,7 @@ void PS_GPU::ProcessFIFO(void)
   }
   else
   {
-   command->func[abr][TexMode | (MaskEvalAND ? 0x4 : 0x0)](this, CB);
+   RunCommand(cc, command->func[abr][TexMode | (MaskEvalAND ? 0x4 : 0x0)], CB, command->len);
   }
  }
 }
@@ -1003,6 +1023,8 @@ INLINE uint32 PS_GPU::ReadData(void)
 {
  if(InCmd == INCMD_FBREAD)
  {
+  FlushRaster();
+
   DataReadBufferEx = 0;
   for(int i = 0; i < 2; i++)
   {
@@ -1457,6 +1479,9 @@ pscpu_timestamp_t PS_GPU::Update(const pscpu_timestamp_t sys_timestamp)
 		 }
 
      {
+      if(Raster)
+       WaitRasterLine(DisplayFB_CurLineYReadout);
+
       const uint16 *src = GPURAM[DisplayFB_CurLineYReadout];
       const uint32 black = surface->MakeColor(0, 0, 0);
 
@@ -1558,7 +1583,9 @@ void PS_GPU::StartFrame(EmulateSpecStruct *espec_arg)
 
 SYNCFUNC(PS_GPU)
 {
-	NSS(GPURAM);
+	FlushRaster();
+
+	PSS(GPURAM, 512 * 1024 * sizeof(uint16));
 
 	NSS(CLUT_Cache);
 	NSS(CLUT_Cache_VB);
@@ -1664,6 +1691,7 @@ void PS_GPU::SetRenderOptions(::ShockRenderOptions* opts)
 	dump_framebuffer = opts->renderType == eShockRenderType_Framebuffer;
 	LineVisFirst = opts->scanline_start;
 	LineVisLast = opts->scanline_end;
+	SetRasterThreads(opts->renderThreads);
 }
 
 }
@@ -31,6 +31,8 @@ struct tri_vertex
 struct i_group;
 struct i_deltas;
 
+class PS_GPU_Raster;
+
 struct line_point
 {
  int32 x, y;
@@ -39,6 +41,8 @@ struct line_point
 
 class PS_GPU
 {
+ friend class PS_GPU_Raster;
+
  public:
 
  void SetRenderOptions(ShockRenderOptions* opts);
@@ -95,16 +99,25 @@ class PS_GPU
 
  INLINE uint16 PeekRAM(uint32 A)
  {
+  FlushRaster();
   return(GPURAM[(A >> 10) & 0x1FF][A & 0x3FF]);
  }
 
  INLINE void PokeRAM(uint32 A, uint16 V)
  {
+  FlushRaster();
   GPURAM[(A >> 10) & 0x1FF][A & 0x3FF] = V;
  }
 
- // Y, X
- uint16 GPURAM[512][1024];
+ // Waits for the band workers(if any) to finish all queued drawing, so GPURAM can be accessed directly.
+ INLINE void FlushRaster(void)
+ {
+  if(Raster)
+   FinishRaster();
+ }
+
+ // Y, X; shared with the band workers' shadow contexts, so it's allocated rather than a member array.
+ uint16 (*GPURAM)[1024];
 
  private:
 
@@ -202,6 +215,57 @@ class PS_GPU
  template<bool goraud, int BlendMode, bool MaskEval_TA>
  void DrawLine(line_point *vertices);
 
+ //
+ // Band-parallel rasterization(see gpu_raster.cpp)
+ //
+ PS_GPU(PS_GPU* parent, uint32 band_mask) MDFN_COLD;	// Shadow context for a band worker.
+
+ // The drawing state a queued command reads besides its own words.
+ struct RasterState
+ {
+  int32 ClipX0;
+  int32 ClipY0;
+  int32 ClipX1;
+  int32 ClipY1;
+
+  int32 OffsX;
+  int32 OffsY;
+
+  bool dtd;
+  bool dfe;
+
+  uint32 MaskSetOR;
+  uint32 SpriteFlip;
+
+  uint32 DisplayMode;
+  uint32 DisplayFB_YStart;
+  bool field_ram_readout;
+
+  uint8 InCmd;
+  uint8 InCmd_CC;
+  tri_vertex InQuad_F3Vertices[3];
+  line_point InPLine_PrevPoint;
+ };
+
+ void SaveRasterState(RasterState* rs);
+ void LoadRasterState(const RasterState* rs);
+
+ void SetRasterThreads(int count) MDFN_COLD;
+ void FinishRaster(void);
+ void WaitRasterLine(uint32 y);
+ void RunCommand(const uint32 cc, void (*func)(PS_GPU* g, const uint32 *cb), const uint32 *cb, const unsigned len);
+
+ PS_GPU_Raster* Raster;
+ bool OwnsGPURAM;
+
+ // Bit n is set when this context draws to VRAM rows n * 16 through n * 16 + 15; ~0U normally, 0 while a command is only being timed.
+ uint32 BandMask;
+
+ INLINE bool InBand(uint32 y)
+ {
+  return (BandMask >> ((y >> 4) & 0x1F)) & 1;
+ }
+
 
  public:
  template<int numvertices, bool shaded, bool textured, int BlendMode, bool TexMult, uint32 TexMode_TA, bool MaskEval_TA>
@@ -188,7 +188,7 @@ void PS_GPU::DrawLine(line_point *points)
    }
 
    // FIXME: There has to be a faster way than checking for being inside the drawing area for each pixel.
-   if(x >= ClipX0 && x <= ClipX1 && y >= ClipY0 && y <= ClipY1)
+   if(x >= ClipX0 && x <= ClipX1 && y >= ClipY0 && y <= ClipY1 && InBand(y))
     PlotPixel<BlendMode, MaskEval_TA, false>(x, y, pix);
   }
 
@@ -176,6 +176,9 @@ INLINE void PS_GPU::DrawSpan(int y, const int32 x_start, const int32 x_bound, i_
   else
    DrawTimeAvail -= w;
 
+  if(!InBand(y))
+   return;
+
   do
   {
    const uint32 r = ig.r >> (COORD_FBS + COORD_POST_PADDING);
@@ -0,0 +1,361 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "psx.h"
+#include "gpu.h"
+
+/*
+ Band-parallel rasterization.
+
+ VRAM is split into 32 groups of 16 rows, dealt out round-robin to the worker threads.  Every queued command is replayed by every
+ worker on its own shadow PS_GPU context, which shares GPURAM with the real one but only plots into the rows it owns, so each pixel
+ still sees the commands that touch it in FIFO order.
+
+ Only draw commands that never read textures are queued(untextured polygons and sprites, lines, and FB fills); their result depends on
+ nothing but their own words, a handful of drawing registers(captured in a RasterState), and the VRAM rows being drawn to.  The emulation
+ thread still runs each of them itself, with an empty band, so DrawTimeAvail comes out exactly as before.
+
+ Textured primitives need the texture and CLUT caches to be filled in FIFO order, and the FB copy/write/read commands access arbitrary VRAM,
+ so those wait for the workers to finish everything queued and then run on the emulation thread as usual.  The same goes for anything else
+ that looks at GPURAM(scanline readout only waits for the one band it reads from).
+*/
+
+namespace MDFN_IEN_PSX
+{
+
+class PS_GPU_Raster
+{
+ public:
+
+ PS_GPU_Raster(PS_GPU* gpu, unsigned count) MDFN_COLD;
+ ~PS_GPU_Raster() MDFN_COLD;
+
+ INLINE unsigned GetCount(void) { return Count; }
+
+ void Queue(void (*func)(PS_GPU* g, const uint32 *cb), const uint32 *cb, const unsigned len);
+ void Finish(void);
+ void WaitLine(uint32 y);
+
+ enum { MaxWorkers = 8 };
+
+ private:
+
+ void WorkerMain(unsigned index);
+ void WaitWorker(unsigned index, uint32 pos);
+
+ struct Job
+ {
+  void (*func)(PS_GPU* g, const uint32 *cb);
+  uint32 cb[0x10];
+  PS_GPU::RasterState state;
+ };
+
+ enum { RingSize = 1024 };	// Power of 2
+ Job Ring[RingSize];
+
+ struct Worker
+ {
+  std::thread thread;
+  PS_GPU* context;
+  std::atomic<uint32> ReadPos;
+  uint8 pad[64];	// Keep each worker's ReadPos on its own cache line.
+ };
+
+ PS_GPU* Gpu;
+ unsigned Count;
+ Worker Workers[MaxWorkers];
+
+ std::atomic<uint32> WritePos;
+ uint32 MinReadPos;	// Cached lower bound of the workers' ReadPos, so the producer doesn't poll them for every job.
+
+ std::mutex WakeLock;
+ std::condition_variable WakeCond;
+ std::atomic<uint32> Sleepers;
+ bool Quit;
+};
+
+PS_GPU_Raster::PS_GPU_Raster(PS_GPU* gpu, unsigned count) : Gpu(gpu), Count(count), WritePos(0), MinReadPos(0), Sleepers(0), Quit(false)
+{
+ for(unsigned i = 0; i < Count; i++)
+ {
+  uint32 band_mask = 0;
+
+  for(unsigned group = i; group < 32; group += Count)
+   band_mask |= 1U << group;
+
+  Workers[i].context = new PS_GPU(Gpu, band_mask);
+  Workers[i].ReadPos = 0;
+ }
+
+ for(unsigned i = 0; i < Count; i++)
+  Workers[i].thread = std::thread(&PS_GPU_Raster::WorkerMain, this, i);
+}
+
+PS_GPU_Raster::~PS_GPU_Raster()
+{
+ {
+  std::lock_guard<std::mutex> lock(WakeLock);
+  Quit = true;
+ }
+ WakeCond.notify_all();
+
+ for(unsigned i = 0; i < Count; i++)
+ {
+  Workers[i].thread.join();
+  delete Workers[i].context;
+ }
+}
+
+void PS_GPU_Raster::WorkerMain(unsigned index)
+{
+ Worker* w = &Workers[index];
+ PS_GPU* g = w->context;
+ uint32 pos = w->ReadPos.load(std::memory_order_relaxed);
+
+ for(;;)
+ {
+  if(pos != WritePos.load(std::memory_order_acquire))
+  {
+   const Job* job = &Ring[pos & (RingSize - 1)];
+
+   g->LoadRasterState(&job->state);
+   job->func(g, job->cb);
+
+   pos++;
+   w->ReadPos.store(pos, std::memory_order_release);
+   continue;
+  }
+
+  // Games tend to send draw commands in bursts, so spin a little before going to sleep.
+  bool found = false;
+
+  for(unsigned spin = 0; spin < 64 && !found; spin++)
+  {
+   std::this_thread::yield();
+   found = (pos != WritePos.load(std::memory_order_acquire));
+  }
+
+  if(found)
+   continue;
+
+  std::unique_lock<std::mutex> lock(WakeLock);
+
+  if(Quit)
+   break;
+
+  Sleepers++;
+  WakeCond.wait(lock, [&]{ return Quit || pos != WritePos.load(); });
+  Sleepers--;
+
+  if(Quit && pos == WritePos.load())
+   break;
+ }
+}
+
+void PS_GPU_Raster::Queue(void (*func)(PS_GPU* g, const uint32 *cb), const uint32 *cb, const unsigned len)
+{
+ const uint32 pos = WritePos.load(std::memory_order_relaxed);
+
+ // Wait for the slowest worker to be done with the slot we're about to reuse.
+ while((pos - MinReadPos) >= RingSize)
+ {
+  uint32 min_pos = pos;
+
+  for(unsigned i = 0; i < Count; i++)
+  {
+   const uint32 rp = Workers[i].ReadPos.load(std::memory_order_acquire);
+
+   if((pos - rp) > (pos - min_pos))
+    min_pos = rp;
+  }
+
+  MinReadPos = min_pos;
+
+  if((pos - MinReadPos) >= RingSize)
+   std::this_thread::yield();
+ }
+
+ Job* job = &Ring[pos & (RingSize - 1)];
+
+ job->func = func;
+ memcpy(job->cb, cb, len * sizeof(uint32));
+ Gpu->SaveRasterState(&job->state);
+
+ WritePos.store(pos + 1);
+
+ if(Sleepers.load())
+ {
+  std::lock_guard<std::mutex> lock(WakeLock);
+  WakeCond.notify_all();
+ }
+}
+
+INLINE void PS_GPU_Raster::WaitWorker(unsigned index, uint32 pos)
+{
+ while(Workers[index].ReadPos.load(std::memory_order_acquire) != pos)
+  std::this_thread::yield();
+}
+
+void PS_GPU_Raster::Finish(void)
+{
+ const uint32 pos = WritePos.load(std::memory_order_relaxed);
+
+ for(unsigned i = 0; i < Count; i++)
+  WaitWorker(i, pos);
+
+ MinReadPos = pos;
+}
+
+void PS_GPU_Raster::WaitLine(uint32 y)
+{
+ WaitWorker(((y >> 4) & 0x1F) % Count, WritePos.load(std::memory_order_relaxed));
+}
+
+//
+//
+//
+
+PS_GPU::PS_GPU(PS_GPU* parent, uint32 band_mask)
+{
+ GPURAM = parent->GPURAM;
+ OwnsGPURAM = false;
+ Raster = NULL;
+ BandMask = band_mask;
+
+ HardwarePALType = parent->HardwarePALType;
+ DrawTimeAvail = 0;
+}
+
+void PS_GPU::SaveRasterState(RasterState* rs)
+{
+ rs->ClipX0 = ClipX0;
+ rs->ClipY0 = ClipY0;
+ rs->ClipX1 = ClipX1;
+ rs->ClipY1 = ClipY1;
+
+ rs->OffsX = OffsX;
+ rs->OffsY = OffsY;
+
+ rs->dtd = dtd;
+ rs->dfe = dfe;
+
+ rs->MaskSetOR = MaskSetOR;
+ rs->SpriteFlip = SpriteFlip;
+
+ rs->DisplayMode = DisplayMode;
+ rs->DisplayFB_YStart = DisplayFB_YStart;
+ rs->field_ram_readout = field_ram_readout;
+
+ rs->InCmd = InCmd;
+ rs->InCmd_CC = InCmd_CC;
+ memcpy(rs->InQuad_F3Vertices, InQuad_F3Vertices, sizeof(InQuad_F3Vertices));
+ rs->InPLine_PrevPoint = InPLine_PrevPoint;
+}
+
+void PS_GPU::LoadRasterState(const RasterState* rs)
+{
+ ClipX0 = rs->ClipX0;
+ ClipY0 = rs->ClipY0;
+ ClipX1 = rs->ClipX1;
+ ClipY1 = rs->ClipY1;
+
+ OffsX = rs->OffsX;
+ OffsY = rs->OffsY;
+
+ dtd = rs->dtd;
+ dfe = rs->dfe;
+
+ MaskSetOR = rs->MaskSetOR;
+ SpriteFlip = rs->SpriteFlip;
+
+ DisplayMode = rs->DisplayMode;
+ DisplayFB_YStart = rs->DisplayFB_YStart;
+ field_ram_readout = rs->field_ram_readout;
+
+ InCmd = rs->InCmd;
+ InCmd_CC = rs->InCmd_CC;
+ memcpy(InQuad_F3Vertices, rs->InQuad_F3Vertices, sizeof(InQuad_F3Vertices));
+ InPLine_PrevPoint = rs->InPLine_PrevPoint;
+
+ // Timing is the emulation thread's business; just keep the shadow's copy from drifting.
+ DrawTimeAvail = 0;
+}
+
+void PS_GPU::SetRasterThreads(int count)
+{
+ if(count < 0)
+  count = 0;
+
+ if(count > PS_GPU_Raster::MaxWorkers)
+  count = PS_GPU_Raster::MaxWorkers;
+
+ if((Raster ? (int)Raster->GetCount() : 0) == count)
+  return;
+
+ if(Raster)
+ {
+  Raster->Finish();
+  delete Raster;
+  Raster = NULL;
+ }
+
+ if(count)
+  Raster = new PS_GPU_Raster(this, count);
+}
+
+void PS_GPU::FinishRaster(void)
+{
+ Raster->Finish();
+}
+
+void PS_GPU::WaitRasterLine(uint32 y)
+{
+ Raster->WaitLine(y);
+}
+
+//
+// Called from ProcessFIFO() for every command it runs.
+//
+void PS_GPU::RunCommand(const uint32 cc, void (*func)(PS_GPU* g, const uint32 *cb), const uint32 *cb, const unsigned len)
+{
+ if(Raster)
+ {
+  const bool draw = (cc == 0x02) || (cc >= 0x20 && cc <= 0x7F);
+  const bool textured = ((cc >= 0x20 && cc <= 0x3F) || (cc >= 0x60 && cc <= 0x7F)) && (cc & 0x4);
+
+  if(draw && !textured)
+  {
+   Raster->Queue(func, cb, len);
+
+   BandMask = 0;
+   func(this, cb);
+   BandMask = ~0U;
+   return;
+  }
+
+  if(cc >= 0x20 && cc <= 0xDF)
+   Raster->Finish();
+ }
+
+ func(this, cb);
+}
+
+}
@@ -115,7 +115,9 @@ void PS_GPU::DrawSprite(int32 x_arg, int32 y_arg, int32 w, int32 h, uint8 u_arg,
     DrawTimeAvail -= suck_time;
    }
 
-   for(int32 x = x_start; MDFN_LIKELY(x < x_bound); x++)
+   const int32 row_bound = InBand(y) ? x_bound : x_start;
+
+   for(int32 x = x_start; MDFN_LIKELY(x < row_bound); x++)
    {
     if(textured)
     {
@@ -15,6 +15,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <mutex>
 #include "psx.h"
 #include "gte.h"
 
@@ -74,9 +75,6 @@ typedef struct
  int16 Y;
 } gtexy;
 
-static uint32 CR[32];
-static uint32 FLAGS;	// Temporary for instruction execution, copied into CR[31] at end of instruction execution.
-
 typedef union
 {
  gtematrix All[4];
@@ -92,52 +90,62 @@ typedef union
  };
 } Matrices_t;
 
-static Matrices_t Matrices;
-
-static union
+struct GTE_State
 {
- int32 All[4][4];	// Really only [4][3], but [4] to ease address calculation.
-  
- struct
+ uint32 CR[32];
+ uint32 FLAGS;	// Temporary for instruction execution, copied into CR[31] at end of instruction execution.
+
+ Matrices_t Matrices;
+
+ union
  {
-  int32 T[4];
-  int32 B[4];
-  int32 FC[4];
-  int32 Null[4];
- };
-} CRVectors;
+  int32 All[4][4];	// Really only [4][3], but [4] to ease address calculation.
+  
+  struct
+  {
+   int32 T[4];
+   int32 B[4];
+   int32 FC[4];
+   int32 Null[4];
+  };
+ } CRVectors;
 
-static int32 OFX;
-static int32 OFY;
-static uint16 H;
-static int16 DQA;
-static int32 DQB;
+ int32 OFX;
+ int32 OFY;
+ uint16 H;
+ int16 DQA;
+ int32 DQB;
  
-static int16 ZSF3;
-static int16 ZSF4;
+ int16 ZSF3;
+ int16 ZSF4;
 
 
-// Begin DR
-static int16 Vectors[3][4];
-static gtergb RGB;
-static uint16 OTZ;
+ // Begin DR
+ int16 Vectors[3][4];
+ gtergb RGB;
+ uint16 OTZ;
 
-static int16 IR[4];
+ int16 IR[4];
 
-#define IR0 IR[0]
-#define IR1 IR[1]
-#define IR2 IR[2]
-#define IR3 IR[3]
+ gtexy XY_FIFO[4];
+ uint16 Z_FIFO[4];
+ gtergb RGB_FIFO[3];
+ int32 MAC[4];
+ uint32 LZCS;
+ uint32 LZCR;
 
-static gtexy XY_FIFO[4];
-static uint16 Z_FIFO[4];
-static gtergb RGB_FIFO[3];
-static int32 MAC[4];
-static uint32 LZCS;
-static uint32 LZCR;
+ uint32 Reg23;
+ // end DR
 
-static uint32 Reg23;
-// end DR
+ template<bool isReader> void SyncState(EW::NewState *ns);
+};
+
+#define GTE_S (*PSX_I->gte)
+
+#define IR0 GTE_S.IR[0]
+#define IR1 GTE_S.IR[1]
+#define IR2 GTE_S.IR[2]
+#define IR3 GTE_S.IR[3]
 
 static INLINE uint8 Sat5(int16 cc)
 {
@@ -164,6 +172,10 @@ static INLINE uint32 CalcRecip(uint16 divisor)
 
 void GTE_Init(void)
 {
+ // The table is shared by every instance, and instances may be created on several threads at once.
+ static std::once_flag initialized;
+ std::call_once(initialized, []()
+ {
  for(uint32_t divisor = 0x8000; divisor < 0x10000; divisor += 0x80)
  {
   uint32_t xa = 512;
@@ -180,42 +192,51 @@ void GTE_Init(void)
  //
  // To avoid a bounds limiting if statement in the emulation code:
  DivTable[0x100] = DivTable[0xFF];
+ });
+
+ PSX_I->gte = new GTE_State();
+}
+
+void GTE_Kill(void)
+{
+ delete PSX_I->gte;
+ PSX_I->gte = NULL;
 }
 
 void GTE_Power(void)
 {
- memset(CR, 0, sizeof(CR));
+ memset(GTE_S.CR, 0, sizeof(GTE_S.CR));
  //memset(DR, 0, sizeof(DR));
  	const int x = 5;
 	char v[x];
 
- memset(Matrices.All, 0, sizeof(Matrices.All));
- memset(CRVectors.All, 0, sizeof(CRVectors.All));
- OFX = 0;
- OFY = 0;
- H = 0;
- DQA = 0;
- DQB = 0;
- ZSF3 = 0;
- ZSF4 = 0;
+ memset(GTE_S.Matrices.All, 0, sizeof(GTE_S.Matrices.All));
+ memset(GTE_S.CRVectors.All, 0, sizeof(GTE_S.CRVectors.All));
+ GTE_S.OFX = 0;
+ GTE_S.OFY = 0;
+ GTE_S.H = 0;
+ GTE_S.DQA = 0;
+ GTE_S.DQB = 0;
+ GTE_S.ZSF3 = 0;
+ GTE_S.ZSF4 = 0;
 
 
- memset(Vectors, 0, sizeof(Vectors));
- memset(&RGB, 0, sizeof(RGB));
- OTZ = 0;
+ memset(GTE_S.Vectors, 0, sizeof(GTE_S.Vectors));
+ memset(&GTE_S.RGB, 0, sizeof(GTE_S.RGB));
+ GTE_S.OTZ = 0;
  IR0 = 0;
  IR1 = 0;
  IR2 = 0;
  IR3 = 0;
 
- memset(XY_FIFO, 0, sizeof(XY_FIFO));
- memset(Z_FIFO, 0, sizeof(Z_FIFO));
- memset(RGB_FIFO, 0, sizeof(RGB_FIFO));
- memset(MAC, 0, sizeof(MAC));
- LZCS = 0;
- LZCR = 0;
+ memset(GTE_S.XY_FIFO, 0, sizeof(GTE_S.XY_FIFO));
+ memset(GTE_S.Z_FIFO, 0, sizeof(GTE_S.Z_FIFO));
+ memset(GTE_S.RGB_FIFO, 0, sizeof(GTE_S.RGB_FIFO));
+ memset(GTE_S.MAC, 0, sizeof(GTE_S.MAC));
+ GTE_S.LZCS = 0;
+ GTE_S.LZCR = 0;
 
- Reg23 = 0;
+ GTE_S.Reg23 = 0;
 }
 
 void GTE_WriteCR(unsigned int which, uint32 value)
@@ -238,7 +259,7 @@ void GTE_WriteCR(unsigned int which, uint32 value)
 
  value &= mask_table[which];
 
- CR[which] = value | (CR[which] & ~mask_table[which]);
+ GTE_S.CR[which] = value | (GTE_S.CR[which] & ~mask_table[which]);
 
  if(which < 24)
  {
@@ -246,13 +267,13 @@ void GTE_WriteCR(unsigned int which, uint32 value)
   which &= 0x7;
 
   if(which >= 5)
-   CRVectors.All[we][which - 5] = value;
+   GTE_S.CRVectors.All[we][which - 5] = value;
   else
   {
    #ifdef MSB_FIRST
-   Matrices.Raw[we][which] = (value << 16) | (value >> 16);
+   GTE_S.Matrices.Raw[we][which] = (value << 16) | (value >> 16);
    #else
-   Matrices.Raw[we][which] = value;
+   GTE_S.Matrices.Raw[we][which] = value;
    #endif
   }
   return;
@@ -261,35 +282,35 @@ void GTE_WriteCR(unsigned int which, uint32 value)
  switch(which)
  {
   case 24:
-	OFX = value;
+	GTE_S.OFX = value;
 	break;
 
   case 25:
-	OFY = value;
+	GTE_S.OFY = value;
 	break;
 
   case 26:
-	H = value;
+	GTE_S.H = value;
 	break;
 
   case 27:
-	DQA = value;
+	GTE_S.DQA = value;
 	break;
 
   case 28:
-	DQB = value;
+	GTE_S.DQB = value;
 	break;
 
   case 29:
-	ZSF3 = value;
+	GTE_S.ZSF3 = value;
 	break;
 
   case 30:
-	ZSF4 = value;
+	GTE_S.ZSF4 = value;
 	break;
 
   case 31:
-	CR[31] = (value & 0x7ffff000) | ((value & 0x7f87e000) ? (1 << 31) : 0);
+	GTE_S.CR[31] = (value & 0x7ffff000) | ((value & 0x7f87e000) ? (1 << 31) : 0);
 	break;
  }
 }
@@ -301,41 +322,41 @@ uint32 GTE_ReadCR(unsigned int which)
  switch(which)
  {
   default:
-	ret = CR[which];
+	ret = GTE_S.CR[which];
 	if(which == 4 || which == 12 || which == 20)
 	 ret = (int16)ret;
 	break;
 
   case 24:
-	ret = OFX;
+	ret = GTE_S.OFX;
 	break;
 
   case 25:
-	ret = OFY;
+	ret = GTE_S.OFY;
 	break;
 
   case 26:
-	ret = (int16)H;
+	ret = (int16)GTE_S.H;
 	break;
 
   case 27:
-	ret = (int16)DQA;
+	ret = (int16)GTE_S.DQA;
 	break;
 
   case 28:
-	ret = DQB;
+	ret = GTE_S.DQB;
 	break;
 
   case 29:
-	ret = (int16)ZSF3;
+	ret = (int16)GTE_S.ZSF3;
 	break;
 
   case 30:
-	ret = (int16)ZSF4;
+	ret = (int16)GTE_S.ZSF4;
 	break;
 
   case 31:
-	ret = CR[31];
+	ret = GTE_S.CR[31];
 	break;
  }
 
@@ -347,41 +368,41 @@ void GTE_WriteDR(unsigned int which, uint32 value)
  switch(which & 0x1F)
  {
   case 0:
-	Vectors[0][0] = value;
-	Vectors[0][1] = value >> 16;
+	GTE_S.Vectors[0][0] = value;
+	GTE_S.Vectors[0][1] = value >> 16;
 	break;
 
   case 1:
-	Vectors[0][2] = value;
+	GTE_S.Vectors[0][2] = value;
 	break;
 
   case 2:
-	Vectors[1][0] = value;
-	Vectors[1][1] = value >> 16;
+	GTE_S.Vectors[1][0] = value;
+	GTE_S.Vectors[1][1] = value >> 16;
 	break;
 
   case 3:
-	Vectors[1][2] = value;
+	GTE_S.Vectors[1][2] = value;
 	break;
 
   case 4:
-	Vectors[2][0] = value;
-	Vectors[2][1] = value >> 16;
+	GTE_S.Vectors[2][0] = value;
+	GTE_S.Vectors[2][1] = value >> 16;
 	break;
 
   case 5:
-	Vectors[2][2] = value;
+	GTE_S.Vectors[2][2] = value;
 	break;
 
   case 6:
-	RGB.R = value >> 0;
-	RGB.G = value >> 8;
-	RGB.B = value >> 16;
-	RGB.CD = value >> 24;
+	GTE_S.RGB.R = value >> 0;
+	GTE_S.RGB.G = value >> 8;
+	GTE_S.RGB.B = value >> 16;
+	GTE_S.RGB.CD = value >> 24;
 	break;
 
   case 7:
-	OTZ = value;
+	GTE_S.OTZ = value;
 	break;
 
   case 8:
@@ -401,86 +422,86 @@ void GTE_WriteDR(unsigned int which, uint32 value)
 	break;
 
   case 12:
-	XY_FIFO[0].X = value;
-	XY_FIFO[0].Y = value >> 16;
+	GTE_S.XY_FIFO[0].X = value;
+	GTE_S.XY_FIFO[0].Y = value >> 16;
 	break;
 
   case 13:
-	XY_FIFO[1].X = value;
-	XY_FIFO[1].Y = value >> 16;
+	GTE_S.XY_FIFO[1].X = value;
+	GTE_S.XY_FIFO[1].Y = value >> 16;
 	break;
 
   case 14:
-	XY_FIFO[2].X = value;
-	XY_FIFO[2].Y = value >> 16;
-	XY_FIFO[3].X = value;
-	XY_FIFO[3].Y = value >> 16;
+	GTE_S.XY_FIFO[2].X = value;
+	GTE_S.XY_FIFO[2].Y = value >> 16;
+	GTE_S.XY_FIFO[3].X = value;
+	GTE_S.XY_FIFO[3].Y = value >> 16;
 	break;
 
   case 15:
-	XY_FIFO[3].X = value;
-	XY_FIFO[3].Y = value >> 16;
+	GTE_S.XY_FIFO[3].X = value;
+	GTE_S.XY_FIFO[3].Y = value >> 16;
 
-	XY_FIFO[0] = XY_FIFO[1];
-	XY_FIFO[1] = XY_FIFO[2];
-	XY_FIFO[2] = XY_FIFO[3];
+	GTE_S.XY_FIFO[0] = GTE_S.XY_FIFO[1];
+	GTE_S.XY_FIFO[1] = GTE_S.XY_FIFO[2];
+	GTE_S.XY_FIFO[2] = GTE_S.XY_FIFO[3];
 	break;
 
   case 16:
-	Z_FIFO[0] = value;
+	GTE_S.Z_FIFO[0] = value;
 	break;
 
   case 17:
-	Z_FIFO[1] = value;
+	GTE_S.Z_FIFO[1] = value;
 	break;
 
   case 18:
-	Z_FIFO[2] = value;
+	GTE_S.Z_FIFO[2] = value;
 	break;
 
   case 19:
-	Z_FIFO[3] = value;
+	GTE_S.Z_FIFO[3] = value;
 	break;
 
   case 20:
-	RGB_FIFO[0].R = value;
-	RGB_FIFO[0].G = value >> 8;
-	RGB_FIFO[0].B = value >> 16;
-	RGB_FIFO[0].CD = value >> 24;
+	GTE_S.RGB_FIFO[0].R = value;
+	GTE_S.RGB_FIFO[0].G = value >> 8;
+	GTE_S.RGB_FIFO[0].B = value >> 16;
+	GTE_S.RGB_FIFO[0].CD = value >> 24;
 	break;
 
   case 21:
-	RGB_FIFO[1].R = value;
-	RGB_FIFO[1].G = value >> 8;
-	RGB_FIFO[1].B = value >> 16;
-	RGB_FIFO[1].CD = value >> 24;
+	GTE_S.RGB_FIFO[1].R = value;
+	GTE_S.RGB_FIFO[1].G = value >> 8;
+	GTE_S.RGB_FIFO[1].B = value >> 16;
+	GTE_S.RGB_FIFO[1].CD = value >> 24;
 	break;
 
   case 22:
-	RGB_FIFO[2].R = value;
-	RGB_FIFO[2].G = value >> 8;
-	RGB_FIFO[2].B = value >> 16;
-	RGB_FIFO[2].CD = value >> 24;
+	GTE_S.RGB_FIFO[2].R = value;
+	GTE_S.RGB_FIFO[2].G = value >> 8;
+	GTE_S.RGB_FIFO[2].B = value >> 16;
+	GTE_S.RGB_FIFO[2].CD = value >> 24;
 	break;
 
   case 23:
-	Reg23 = value;
+	GTE_S.Reg23 = value;
 	break;
 
   case 24:
-	MAC[0] = value;
+	GTE_S.MAC[0] = value;
 	break;
 
   case 25:
-	MAC[1] = value;
+	GTE_S.MAC[1] = value;
 	break;
 
   case 26:
-	MAC[2] = value;
+	GTE_S.MAC[2] = value;
 	break;
 
   case 27:
-	MAC[3] = value;
+	GTE_S.MAC[3] = value;
 	break;
 
   case 28:
@@ -493,14 +514,14 @@ void GTE_WriteDR(unsigned int which, uint32 value)
 	break;
 
   case 30:
-	LZCS = value;
+	GTE_S.LZCS = value;
 	{
 	 uint32 test = value & 0x80000000;
-	 LZCR = 0;
+	 GTE_S.LZCR = 0;
 
-	 while((value & 0x80000000) == test && LZCR < 32)
+	 while((value & 0x80000000) == test && GTE_S.LZCR < 32)
 	 {
-	  LZCR++;
+	  GTE_S.LZCR++;
 	  value <<= 1;
 	 }
 	}
@@ -518,35 +539,35 @@ uint32 GTE_ReadDR(unsigned int which)
  switch(which & 0x1F)
  {
   case 0:
-	ret = (uint16)Vectors[0][0] | ((uint16)Vectors[0][1] << 16);
+	ret = (uint16)GTE_S.Vectors[0][0] | ((uint16)GTE_S.Vectors[0][1] << 16);
 	break;
 
   case 1:
-	ret = (int16)Vectors[0][2];
+	ret = (int16)GTE_S.Vectors[0][2];
 	break;
 
   case 2:
-	ret = (uint16)Vectors[1][0] | ((uint16)Vectors[1][1] << 16);
+	ret = (uint16)GTE_S.Vectors[1][0] | ((uint16)GTE_S.Vectors[1][1] << 16);
 	break;
 
   case 3:
-	ret = (int16)Vectors[1][2];
+	ret = (int16)GTE_S.Vectors[1][2];
 	break;
 
   case 4:
-	ret = (uint16)Vectors[2][0] | ((uint16)Vectors[2][1] << 16);
+	ret = (uint16)GTE_S.Vectors[2][0] | ((uint16)GTE_S.Vectors[2][1] << 16);
 	break;
 
   case 5:
-	ret = (int16)Vectors[2][2];
+	ret = (int16)GTE_S.Vectors[2][2];
 	break;
 
   case 6:
-	ret = RGB.R | (RGB.G << 8) | (RGB.B << 16) | (RGB.CD << 24);
+	ret = GTE_S.RGB.R | (GTE_S.RGB.G << 8) | (GTE_S.RGB.B << 16) | (GTE_S.RGB.CD << 24);
 	break;
 
   case 7:
-	ret = (uint16)OTZ;
+	ret = (uint16)GTE_S.OTZ;
 	break;
 
   case 8:
@@ -566,67 +587,67 @@ uint32 GTE_ReadDR(unsigned int which)
 	break;
 
   case 12:
-	ret = (uint16)XY_FIFO[0].X | ((uint16)XY_FIFO[0].Y << 16);
+	ret = (uint16)GTE_S.XY_FIFO[0].X | ((uint16)GTE_S.XY_FIFO[0].Y << 16);
 	break;
 
   case 13:
-	ret = (uint16)XY_FIFO[1].X | ((uint16)XY_FIFO[1].Y << 16);
+	ret = (uint16)GTE_S.XY_FIFO[1].X | ((uint16)GTE_S.XY_FIFO[1].Y << 16);
 	break;
 
   case 14:
-	ret = (uint16)XY_FIFO[2].X | ((uint16)XY_FIFO[2].Y << 16);
+	ret = (uint16)GTE_S.XY_FIFO[2].X | ((uint16)GTE_S.XY_FIFO[2].Y << 16);
 	break;
 
   case 15:
-	ret = (uint16)XY_FIFO[3].X | ((uint16)XY_FIFO[3].Y << 16);
+	ret = (uint16)GTE_S.XY_FIFO[3].X | ((uint16)GTE_S.XY_FIFO[3].Y << 16);
 	break;
 
   case 16:
-	ret = (uint16)Z_FIFO[0];
+	ret = (uint16)GTE_S.Z_FIFO[0];
 	break;
 
   case 17:
-	ret = (uint16)Z_FIFO[1];
+	ret = (uint16)GTE_S.Z_FIFO[1];
 	break;
 
   case 18:
-	ret = (uint16)Z_FIFO[2];
+	ret = (uint16)GTE_S.Z_FIFO[2];
 	break;
 
   case 19:
-	ret = (uint16)Z_FIFO[3];
+	ret = (uint16)GTE_S.Z_FIFO[3];
 	break;
 
   case 20:
-	ret = RGB_FIFO[0].R | (RGB_FIFO[0].G << 8) | (RGB_FIFO[0].B << 16) | (RGB_FIFO[0].CD << 24);
+	ret = GTE_S.RGB_FIFO[0].R | (GTE_S.RGB_FIFO[0].G << 8) | (GTE_S.RGB_FIFO[0].B << 16) | (GTE_S.RGB_FIFO[0].CD << 24);
 	break;
 
   case 21:
-	ret = RGB_FIFO[1].R | (RGB_FIFO[1].G << 8) | (RGB_FIFO[1].B << 16) | (RGB_FIFO[1].CD << 24);
+	ret = GTE_S.RGB_FIFO[1].R | (GTE_S.RGB_FIFO[1].G << 8) | (GTE_S.RGB_FIFO[1].B << 16) | (GTE_S.RGB_FIFO[1].CD << 24);
 	break;
 
   case 22:
-	ret = RGB_FIFO[2].R | (RGB_FIFO[2].G << 8) | (RGB_FIFO[2].B << 16) | (RGB_FIFO[2].CD << 24);
+	ret = GTE_S.RGB_FIFO[2].R | (GTE_S.RGB_FIFO[2].G << 8) | (GTE_S.RGB_FIFO[2].B << 16) | (GTE_S.RGB_FIFO[2].CD << 24);
 	break;
 
   case 23:
-	ret = Reg23;
+	ret = GTE_S.Reg23;
 	break;
 
   case 24:
-	ret = MAC[0];
+	ret = GTE_S.MAC[0];
 	break;
 
   case 25:
-	ret = MAC[1];
+	ret = GTE_S.MAC[1];
 	break;
 
   case 26:
-	ret = MAC[2];
+	ret = GTE_S.MAC[2];
 	break;
 
   case 27:
-	ret = MAC[3];
+	ret = GTE_S.MAC[3];
 	break;
 
   case 28:
@@ -635,11 +656,11 @@ uint32 GTE_ReadDR(unsigned int which)
 	break;
 
   case 30:
-	ret = LZCS;
+	ret = GTE_S.LZCS;
 	break;
 
   case 31:
-	ret = LZCR;
+	ret = GTE_S.LZCR;
 	break;
  }
  return(ret);
@@ -649,10 +670,10 @@ uint32 GTE_ReadDR(unsigned int which)
 static INLINE int64 A_MV(unsigned which, int64 value)
 {
  if(value >= (1LL << 43))
-  FLAGS |= 1 << (30 - which);
+  GTE_S.FLAGS |= 1 << (30 - which);
 
  if(value < -(1LL << 43))
-  FLAGS |= 1 << (27 - which);
+  GTE_S.FLAGS |= 1 << (27 - which);
 
  return sign_x_to_s64(44, value);
 }
@@ -662,13 +683,13 @@ static INLINE int64 F(int64 value)
  if(value < -2147483648LL)
  {
   // flag set here
-  FLAGS |= 1 << 15;
+  GTE_S.FLAGS |= 1 << 15;
  }
 
  if(value > 2147483647LL)
  {
   // flag set here
-  FLAGS |= 1 << 16;
+  GTE_S.FLAGS |= 1 << 16;
  }
  return(value);
 }
@@ -681,14 +702,14 @@ static INLINE int16 Lm_B(unsigned int which, int32 value, int lm)
  if(value < (-32768 + tmp))
  {
   // set flag here
-  FLAGS |= 1 << (24 - which);
+  GTE_S.FLAGS |= 1 << (24 - which);
   value = -32768 + tmp;
  }
 
  if(value > 32767)
  {
   // Set flag here
-  FLAGS |= 1 << (24 - which);
+  GTE_S.FLAGS |= 1 << (24 - which);
   value = 32767;
  }
 
@@ -702,12 +723,12 @@ static INLINE int16 Lm_B_PTZ(unsigned int which, int32 value, int32 ftv_value, i
 
  if(ftv_value < -32768)
  {
-  FLAGS |= 1 << (24 - which);
+  GTE_S.FLAGS |= 1 << (24 - which);
  }
 
  if(ftv_value > 32767)
  {
-  FLAGS |= 1 << (24 - which);
+  GTE_S.FLAGS |= 1 << (24 - which);
  }
 
  if(value < (-32768 + tmp))
@@ -728,7 +749,7 @@ static INLINE uint8 Lm_C(unsigned int which, int32 value)
  if(value & ~0xFF)
  {
   // Set flag here
-  FLAGS |= 1 << (21 - which);	// Tested with GPF
+  GTE_S.FLAGS |= 1 << (21 - which);	// Tested with GPF
 
   if(value < 0)
    value = 0;
@@ -745,15 +766,15 @@ static INLINE int32 Lm_D(int32 value, int unchained)
  // Not sure if we should have it as int64, or just chain on to and special case when the F flags are set.
  if(!unchained)
  {
-  if(FLAGS & (1 << 15))
+  if(GTE_S.FLAGS & (1 << 15))
   {
-   FLAGS |= 1 << 18;
+   GTE_S.FLAGS |= 1 << 18;
    return(0);
   }
 
-  if(FLAGS & (1 << 16))
+  if(GTE_S.FLAGS & (1 << 16))
   {
-   FLAGS |= 1 << 18;
+   GTE_S.FLAGS |= 1 << 18;
    return(0xFFFF);
   }
  }
@@ -762,13 +783,13 @@ static INLINE int32 Lm_D(int32 value, int unchained)
  {
   // Set flag here
   value = 0;
-  FLAGS |= 1 << 18;	// Tested with AVSZ3
+  GTE_S.FLAGS |= 1 << 18;	// Tested with AVSZ3
  }
  else if(value > 65535)
  {
   // Set flag here.
   value = 65535;
-  FLAGS |= 1 << 18;	// Tested with AVSZ3
+  GTE_S.FLAGS |= 1 << 18;	// Tested with AVSZ3
  }
 
  return(value);
@@ -780,14 +801,14 @@ static INLINE int32 Lm_G(unsigned int which, int32 value)
  {
   // Set flag here
   value = -1024;
-  FLAGS |= 1 << (14 - which);
+  GTE_S.FLAGS |= 1 << (14 - which);
  }
 
  if(value > 1023)
  {
   // Set flag here.
   value = 1023;
-  FLAGS |= 1 << (14 - which);
+  GTE_S.FLAGS |= 1 << (14 - which);
  }
 
  return(value);
@@ -799,13 +820,13 @@ static INLINE int32 Lm_H(int32 value)
  if(value < 0)
  {
   value = 0;
-  FLAGS |= 1 << 12;
+  GTE_S.FLAGS |= 1 << 12;
  }
 
  if(value > 4096)
  {
   value = 4096;
-  FLAGS |= 1 << 12;
+  GTE_S.FLAGS |= 1 << 12;
  }
 
  return(value);
@@ -813,20 +834,20 @@ static INLINE int32 Lm_H(int32 value)
 
 static INLINE void MAC_to_RGB_FIFO(void)
 {
- RGB_FIFO[0] = RGB_FIFO[1];
- RGB_FIFO[1] = RGB_FIFO[2];
- RGB_FIFO[2].R = Lm_C(0, MAC[1] >> 4);
- RGB_FIFO[2].G = Lm_C(1, MAC[2] >> 4);
- RGB_FIFO[2].B = Lm_C(2, MAC[3] >> 4);
- RGB_FIFO[2].CD = RGB.CD;
+ GTE_S.RGB_FIFO[0] = GTE_S.RGB_FIFO[1];
+ GTE_S.RGB_FIFO[1] = GTE_S.RGB_FIFO[2];
+ GTE_S.RGB_FIFO[2].R = Lm_C(0, GTE_S.MAC[1] >> 4);
+ GTE_S.RGB_FIFO[2].G = Lm_C(1, GTE_S.MAC[2] >> 4);
+ GTE_S.RGB_FIFO[2].B = Lm_C(2, GTE_S.MAC[3] >> 4);
+ GTE_S.RGB_FIFO[2].CD = GTE_S.RGB.CD;
 }
 
 
 static INLINE void MAC_to_IR(int lm)
 {
- IR1 = Lm_B(0, MAC[1], lm);
- IR2 = Lm_B(1, MAC[2], lm);
- IR3 = Lm_B(2, MAC[3], lm);
+ IR1 = Lm_B(0, GTE_S.MAC[1], lm);
+ IR2 = Lm_B(1, GTE_S.MAC[2], lm);
+ IR3 = Lm_B(2, GTE_S.MAC[3], lm);
 }
 
 static INLINE void MultiplyMatrixByVector(const gtematrix *matrix, const int16 *v, const int32 *crv, uint32 sf, int lm)
@@ -840,19 +861,19 @@ static INLINE void MultiplyMatrixByVector(const gtematrix *matrix, const int16 *
 
   tmp = (uint64)(int64)crv[i] << 12;
 
-  if(matrix == &Matrices.AbbyNormal)
+  if(matrix == &GTE_S.Matrices.AbbyNormal)
   {
    if(i == 0)
    {
-    mulr[0] = -((RGB.R << 4) * v[0]);
-    mulr[1] = (RGB.R << 4) * v[1];
+    mulr[0] = -((GTE_S.RGB.R << 4) * v[0]);
+    mulr[1] = (GTE_S.RGB.R << 4) * v[1];
     mulr[2] = IR0 * v[2];
    }
    else
    {
-    mulr[0] = (int16)CR[i] * v[0];
-    mulr[1] = (int16)CR[i] * v[1];
-    mulr[2] = (int16)CR[i] * v[2];
+    mulr[0] = (int16)GTE_S.CR[i] * v[0];
+    mulr[1] = (int16)GTE_S.CR[i] * v[1];
+    mulr[2] = (int16)GTE_S.CR[i] * v[2];
    }
   }
   else
@@ -863,7 +884,7 @@ static INLINE void MultiplyMatrixByVector(const gtematrix *matrix, const int16 *
   }
 
   tmp = A_MV(i, tmp + mulr[0]);
-  if(crv == CRVectors.FC)
+  if(crv == GTE_S.CRVectors.FC)
   {
    Lm_B(i, tmp >> sf, FALSE);
    tmp = 0;
@@ -872,7 +893,7 @@ static INLINE void MultiplyMatrixByVector(const gtematrix *matrix, const int16 *
   tmp = A_MV(i, tmp + mulr[1]);
   tmp = A_MV(i, tmp + mulr[2]);
 
-  MAC[1 + i] = tmp >> sf;
+  GTE_S.MAC[1 + i] = tmp >> sf;
  }
 
 
@@ -899,18 +920,18 @@ static INLINE void MultiplyMatrixByVector_PT(const gtematrix *matrix, const int1
   tmp[i] = A_MV(i, tmp[i] + mulr[1]);
   tmp[i] = A_MV(i, tmp[i] + mulr[2]);
 
-  MAC[1 + i] = tmp[i] >> sf;
+  GTE_S.MAC[1 + i] = tmp[i] >> sf;
  }
 
- IR1 = Lm_B(0, MAC[1], lm);
- IR2 = Lm_B(1, MAC[2], lm);
+ IR1 = Lm_B(0, GTE_S.MAC[1], lm);
+ IR2 = Lm_B(1, GTE_S.MAC[2], lm);
  //printf("FTV: %08x %08x\n", crv[2], (uint32)(tmp[2] >> 12));
- IR3 = Lm_B_PTZ(2, MAC[3], tmp[2] >> 12, lm);
+ IR3 = Lm_B_PTZ(2, GTE_S.MAC[3], tmp[2] >> 12, lm);
 
- Z_FIFO[0] = Z_FIFO[1];
- Z_FIFO[1] = Z_FIFO[2];
- Z_FIFO[2] = Z_FIFO[3];
- Z_FIFO[3] = Lm_D(tmp[2] >> 12, TRUE);
+ GTE_S.Z_FIFO[0] = GTE_S.Z_FIFO[1];
+ GTE_S.Z_FIFO[1] = GTE_S.Z_FIFO[2];
+ GTE_S.Z_FIFO[2] = GTE_S.Z_FIFO[3];
+ GTE_S.Z_FIFO[3] = Lm_D(tmp[2] >> 12, TRUE);
 }
 
 
@@ -918,7 +939,7 @@ static INLINE void MultiplyMatrixByVector_PT(const gtematrix *matrix, const int1
  const uint32 sf MDFN_NOWARN_UNUSED = (instr & (1 << 19)) ? 12 : 0;		\
  const uint32 mx MDFN_NOWARN_UNUSED = (instr >> 17) & 0x3;			\
  const uint32 v_i = (instr >> 15) & 0x3;				\
- const int32* cv MDFN_NOWARN_UNUSED = CRVectors.All[(instr >> 13) & 0x3];	\
+ const int32* cv MDFN_NOWARN_UNUSED = GTE_S.CRVectors.All[(instr >> 13) & 0x3];	\
  const int lm MDFN_NOWARN_UNUSED = (instr >> 10) & 1;			\
  int16 v[3] MDFN_NOWARN_UNUSED;					\
  if(v_i == 3)							\
@@ -929,9 +950,9 @@ static INLINE void MultiplyMatrixByVector_PT(const gtematrix *matrix, const int1
  }								\
  else								\
  {								\
-  v[0] = Vectors[v_i][0];					\
-  v[1] = Vectors[v_i][1];					\
-  v[2] = Vectors[v_i][2];					\
+  v[0] = GTE_S.Vectors[v_i][0];					\
+  v[1] = GTE_S.Vectors[v_i][1];					\
+  v[2] = GTE_S.Vectors[v_i][2];					\
  }
 
 
@@ -939,9 +960,9 @@ static int32 SQR(uint32 instr)
 {
  DECODE_FIELDS;
 
- MAC[1] = ((IR1 * IR1) >> sf);
- MAC[2] = ((IR2 * IR2) >> sf);
- MAC[3] = ((IR3 * IR3) >> sf);
+ GTE_S.MAC[1] = ((IR1 * IR1) >> sf);
+ GTE_S.MAC[2] = ((IR2 * IR2) >> sf);
+ GTE_S.MAC[3] = ((IR3 * IR3) >> sf);
 
  MAC_to_IR(lm);
 
@@ -953,7 +974,7 @@ static int32 MVMVA(uint32 instr)
 {
  DECODE_FIELDS;
 
- MultiplyMatrixByVector(&Matrices.All[mx], v, cv, sf, lm);
+ MultiplyMatrixByVector(&GTE_S.Matrices.All[mx], v, cv, sf, lm);
 
  return(8);
 }
@@ -985,28 +1006,28 @@ static INLINE uint32 Divide(uint32 dividend, uint32 divisor)
  }
  else
  {
-  FLAGS |= 1 << 17;
+  GTE_S.FLAGS |= 1 << 17;
   return 0x1FFFF;
  }
 }
 
 static INLINE void TransformXY(int64 h_div_sz)
 {
- MAC[0] = F((int64)OFX + IR1 * h_div_sz) >> 16;
- XY_FIFO[3].X = Lm_G(0, MAC[0]);
+ GTE_S.MAC[0] = F((int64)GTE_S.OFX + IR1 * h_div_sz) >> 16;
+ GTE_S.XY_FIFO[3].X = Lm_G(0, GTE_S.MAC[0]);
 
- MAC[0] = F((int64)OFY + IR2 * h_div_sz) >> 16;
- XY_FIFO[3].Y = Lm_G(1, MAC[0]);
+ GTE_S.MAC[0] = F((int64)GTE_S.OFY + IR2 * h_div_sz) >> 16;
+ GTE_S.XY_FIFO[3].Y = Lm_G(1, GTE_S.MAC[0]);
 
- XY_FIFO[0] = XY_FIFO[1];
- XY_FIFO[1] = XY_FIFO[2];
- XY_FIFO[2] = XY_FIFO[3];
+ GTE_S.XY_FIFO[0] = GTE_S.XY_FIFO[1];
+ GTE_S.XY_FIFO[1] = GTE_S.XY_FIFO[2];
+ GTE_S.XY_FIFO[2] = GTE_S.XY_FIFO[3];
 }
 
 static INLINE void TransformDQ(int64 h_div_sz)
 {
- MAC[0] = F((int64)DQB + DQA * h_div_sz);
- IR0 = Lm_H(((int64)DQB + DQA * h_div_sz) >> 12);
+ GTE_S.MAC[0] = F((int64)GTE_S.DQB + GTE_S.DQA * h_div_sz);
+ IR0 = Lm_H(((int64)GTE_S.DQB + GTE_S.DQA * h_div_sz) >> 12);
 }
 
 static int32 RTPS(uint32 instr)
@@ -1014,8 +1035,8 @@ static int32 RTPS(uint32 instr)
  DECODE_FIELDS;
  int64 h_div_sz;
 
- MultiplyMatrixByVector_PT(&Matrices.Rot, Vectors[0], CRVectors.T, sf, lm);
- h_div_sz = Divide(H, Z_FIFO[3]);
+ MultiplyMatrixByVector_PT(&GTE_S.Matrices.Rot, GTE_S.Vectors[0], GTE_S.CRVectors.T, sf, lm);
+ h_div_sz = Divide(GTE_S.H, GTE_S.Z_FIFO[3]);
 
  TransformXY(h_div_sz);
  TransformDQ(h_div_sz);
@@ -1032,8 +1053,8 @@ static int32 RTPT(uint32 instr)
  {
   int64 h_div_sz;
 
-  MultiplyMatrixByVector_PT(&Matrices.Rot, Vectors[i], CRVectors.T, sf, lm);
-  h_div_sz = Divide(H, Z_FIFO[3]);
+  MultiplyMatrixByVector_PT(&GTE_S.Matrices.Rot, GTE_S.Vectors[i], GTE_S.CRVectors.T, sf, lm);
+  h_div_sz = Divide(GTE_S.H, GTE_S.Z_FIFO[3]);
 
   TransformXY(h_div_sz);
 
@@ -1048,10 +1069,10 @@ static INLINE void NormColor(uint32 sf, int lm, uint32 v)
 {
  int16 tmp_vector[3];
 
- MultiplyMatrixByVector(&Matrices.Light, Vectors[v], CRVectors.Null, sf, lm);
+ MultiplyMatrixByVector(&GTE_S.Matrices.Light, GTE_S.Vectors[v], GTE_S.CRVectors.Null, sf, lm);
 
  tmp_vector[0] = IR1; tmp_vector[1] = IR2; tmp_vector[2] = IR3;
- MultiplyMatrixByVector(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
+ MultiplyMatrixByVector(&GTE_S.Matrices.Color, tmp_vector, GTE_S.CRVectors.B, sf, lm);
 
  MAC_to_RGB_FIFO();
 }
@@ -1080,14 +1101,14 @@ static INLINE void NormColorColor(uint32 v, uint32 sf, int lm)
 {
  int16 tmp_vector[3];
 
- MultiplyMatrixByVector(&Matrices.Light, Vectors[v], CRVectors.Null, sf, lm);
+ MultiplyMatrixByVector(&GTE_S.Matrices.Light, GTE_S.Vectors[v], GTE_S.CRVectors.Null, sf, lm);
 
  tmp_vector[0] = IR1; tmp_vector[1] = IR2; tmp_vector[2] = IR3;
- MultiplyMatrixByVector(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
+ MultiplyMatrixByVector(&GTE_S.Matrices.Color, tmp_vector, GTE_S.CRVectors.B, sf, lm);
 
- MAC[1] = ((RGB.R << 4) * IR1) >> sf;
- MAC[2] = ((RGB.G << 4) * IR2) >> sf;
- MAC[3] = ((RGB.B << 4) * IR3) >> sf;
+ GTE_S.MAC[1] = ((GTE_S.RGB.R << 4) * IR1) >> sf;
+ GTE_S.MAC[2] = ((GTE_S.RGB.G << 4) * IR2) >> sf;
+ GTE_S.MAC[3] = ((GTE_S.RGB.B << 4) * IR3) >> sf;
 
  MAC_to_IR(lm);
 
@@ -1124,31 +1145,31 @@ static INLINE void DepthCue(int mult_IR123, int RGB_from_FIFO, uint32 sf, int lm
 
  if(RGB_from_FIFO)
  {
-  RGB_temp[0] = RGB_FIFO[0].R << 4;
-  RGB_temp[1] = RGB_FIFO[0].G << 4;
-  RGB_temp[2] = RGB_FIFO[0].B << 4;
+  RGB_temp[0] = GTE_S.RGB_FIFO[0].R << 4;
+  RGB_temp[1] = GTE_S.RGB_FIFO[0].G << 4;
+  RGB_temp[2] = GTE_S.RGB_FIFO[0].B << 4;
  }
  else
  {
-  RGB_temp[0] = RGB.R << 4;
-  RGB_temp[1] = RGB.G << 4;
-  RGB_temp[2] = RGB.B << 4;
+  RGB_temp[0] = GTE_S.RGB.R << 4;
+  RGB_temp[1] = GTE_S.RGB.G << 4;
+  RGB_temp[2] = GTE_S.RGB.B << 4;
  }
 
  if(mult_IR123)
  {
   for(i = 0; i < 3; i++)
   {
-   MAC[1 + i] = A_MV(i, ((int64)((uint64)(int64)CRVectors.FC[i] << 12) - RGB_temp[i] * IR_temp[i])) >> sf;
-   MAC[1 + i] = A_MV(i, (RGB_temp[i] * IR_temp[i] + IR0 * Lm_B(i, MAC[1 + i], FALSE))) >> sf;
+   GTE_S.MAC[1 + i] = A_MV(i, ((int64)((uint64)(int64)GTE_S.CRVectors.FC[i] << 12) - RGB_temp[i] * IR_temp[i])) >> sf;
+   GTE_S.MAC[1 + i] = A_MV(i, (RGB_temp[i] * IR_temp[i] + IR0 * Lm_B(i, GTE_S.MAC[1 + i], FALSE))) >> sf;
   }
  }
  else
  {
   for(i = 0; i < 3; i++)
   {
-   MAC[1 + i] = A_MV(i, ((int64)((uint64)(int64)CRVectors.FC[i] << 12) - (int32)((uint32)RGB_temp[i] << 12))) >> sf;
-   MAC[1 + i] = A_MV(i, ((int64)((uint64)(int64)RGB_temp[i] << 12) + IR0 * Lm_B(i, MAC[1 + i], FALSE))) >> sf;
+   GTE_S.MAC[1 + i] = A_MV(i, ((int64)((uint64)(int64)GTE_S.CRVectors.FC[i] << 12) - (int32)((uint32)RGB_temp[i] << 12))) >> sf;
+   GTE_S.MAC[1 + i] = A_MV(i, ((int64)((uint64)(int64)RGB_temp[i] << 12) + IR0 * Lm_B(i, GTE_S.MAC[1 + i], FALSE))) >> sf;
   }
  }
 
@@ -1194,13 +1215,13 @@ static int32 INTPL(uint32 instr)
 {
  DECODE_FIELDS;
 
- MAC[1] = A_MV(0, ((int64)((uint64)(int64)CRVectors.FC[0] << 12) - (int32)((uint32)(int32)IR1 << 12))) >> sf;
- MAC[2] = A_MV(1, ((int64)((uint64)(int64)CRVectors.FC[1] << 12) - (int32)((uint32)(int32)IR2 << 12))) >> sf;
- MAC[3] = A_MV(2, ((int64)((uint64)(int64)CRVectors.FC[2] << 12) - (int32)((uint32)(int32)IR3 << 12))) >> sf;
+ GTE_S.MAC[1] = A_MV(0, ((int64)((uint64)(int64)GTE_S.CRVectors.FC[0] << 12) - (int32)((uint32)(int32)IR1 << 12))) >> sf;
+ GTE_S.MAC[2] = A_MV(1, ((int64)((uint64)(int64)GTE_S.CRVectors.FC[1] << 12) - (int32)((uint32)(int32)IR2 << 12))) >> sf;
+ GTE_S.MAC[3] = A_MV(2, ((int64)((uint64)(int64)GTE_S.CRVectors.FC[2] << 12) - (int32)((uint32)(int32)IR3 << 12))) >> sf;
 
- MAC[1] = A_MV(0, ((int64)((uint64)(int64)IR1 << 12) + IR0 * Lm_B(0, MAC[1], FALSE)) >> sf);
- MAC[2] = A_MV(1, ((int64)((uint64)(int64)IR2 << 12) + IR0 * Lm_B(1, MAC[2], FALSE)) >> sf);
- MAC[3] = A_MV(2, ((int64)((uint64)(int64)IR3 << 12) + IR0 * Lm_B(2, MAC[3], FALSE)) >> sf);
+ GTE_S.MAC[1] = A_MV(0, ((int64)((uint64)(int64)IR1 << 12) + IR0 * Lm_B(0, GTE_S.MAC[1], FALSE)) >> sf);
+ GTE_S.MAC[2] = A_MV(1, ((int64)((uint64)(int64)IR2 << 12) + IR0 * Lm_B(1, GTE_S.MAC[2], FALSE)) >> sf);
+ GTE_S.MAC[3] = A_MV(2, ((int64)((uint64)(int64)IR3 << 12) + IR0 * Lm_B(2, GTE_S.MAC[3], FALSE)) >> sf);
 
  MAC_to_IR(lm);
 
@@ -1214,10 +1235,10 @@ static INLINE void NormColorDepthCue(uint32 v, uint32 sf, int lm)
 {
  int16 tmp_vector[3];
 
- MultiplyMatrixByVector(&Matrices.Light, Vectors[v], CRVectors.Null, sf, lm);
+ MultiplyMatrixByVector(&GTE_S.Matrices.Light, GTE_S.Vectors[v], GTE_S.CRVectors.Null, sf, lm);
 
  tmp_vector[0] = IR1; tmp_vector[1] = IR2; tmp_vector[2] = IR3;
- MultiplyMatrixByVector(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
+ MultiplyMatrixByVector(&GTE_S.Matrices.Color, tmp_vector, GTE_S.CRVectors.B, sf, lm);
 
  DepthCue(TRUE, FALSE, sf, lm);
 }
@@ -1250,11 +1271,11 @@ static int32 CC(uint32 instr)
  int16 tmp_vector[3];
 
  tmp_vector[0] = IR1; tmp_vector[1] = IR2; tmp_vector[2] = IR3;
- MultiplyMatrixByVector(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
+ MultiplyMatrixByVector(&GTE_S.Matrices.Color, tmp_vector, GTE_S.CRVectors.B, sf, lm);
 
- MAC[1] = ((RGB.R << 4) * IR1) >> sf;
- MAC[2] = ((RGB.G << 4) * IR2) >> sf;
- MAC[3] = ((RGB.B << 4) * IR3) >> sf;
+ GTE_S.MAC[1] = ((GTE_S.RGB.R << 4) * IR1) >> sf;
+ GTE_S.MAC[2] = ((GTE_S.RGB.G << 4) * IR2) >> sf;
+ GTE_S.MAC[3] = ((GTE_S.RGB.B << 4) * IR3) >> sf;
 
  MAC_to_IR(lm);
 
@@ -1269,7 +1290,7 @@ static int32 CDP(uint32 instr)
  int16 tmp_vector[3];
 
  tmp_vector[0] = IR1; tmp_vector[1] = IR2; tmp_vector[2] = IR3;
- MultiplyMatrixByVector(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
+ MultiplyMatrixByVector(&GTE_S.Matrices.Color, tmp_vector, GTE_S.CRVectors.B, sf, lm);
 
  DepthCue(TRUE, FALSE, sf, lm);
 
@@ -1280,7 +1301,7 @@ static int32 NCLIP(uint32 instr)
 {
  DECODE_FIELDS;
 
- MAC[0] = F( (int64)(XY_FIFO[0].X * (XY_FIFO[1].Y - XY_FIFO[2].Y)) + (XY_FIFO[1].X * (XY_FIFO[2].Y - XY_FIFO[0].Y)) + (XY_FIFO[2].X * (XY_FIFO[0].Y - XY_FIFO[1].Y))
+ GTE_S.MAC[0] = F( (int64)(GTE_S.XY_FIFO[0].X * (GTE_S.XY_FIFO[1].Y - GTE_S.XY_FIFO[2].Y)) + (GTE_S.XY_FIFO[1].X * (GTE_S.XY_FIFO[2].Y - GTE_S.XY_FIFO[0].Y)) + (GTE_S.XY_FIFO[2].X * (GTE_S.XY_FIFO[0].Y - GTE_S.XY_FIFO[1].Y))
 	  );
 
  return(8);
@@ -1290,9 +1311,9 @@ static int32 AVSZ3(uint32 instr)
 {
  DECODE_FIELDS;
 
- MAC[0] = F(((int64)ZSF3 * (Z_FIFO[1] + Z_FIFO[2] + Z_FIFO[3])));
+ GTE_S.MAC[0] = F(((int64)GTE_S.ZSF3 * (GTE_S.Z_FIFO[1] + GTE_S.Z_FIFO[2] + GTE_S.Z_FIFO[3])));
 
- OTZ = Lm_D(MAC[0] >> 12, FALSE);
+ GTE_S.OTZ = Lm_D(GTE_S.MAC[0] >> 12, FALSE);
 
  return(5);
 }
@@ -1301,9 +1322,9 @@ static int32 AVSZ4(uint32 instr)
 {
  DECODE_FIELDS;
 
- MAC[0] = F(((int64)ZSF4 * (Z_FIFO[0] + Z_FIFO[1] + Z_FIFO[2] + Z_FIFO[3])));
+ GTE_S.MAC[0] = F(((int64)GTE_S.ZSF4 * (GTE_S.Z_FIFO[0] + GTE_S.Z_FIFO[1] + GTE_S.Z_FIFO[2] + GTE_S.Z_FIFO[3])));
 
- OTZ = Lm_D(MAC[0] >> 12, FALSE);
+ GTE_S.OTZ = Lm_D(GTE_S.MAC[0] >> 12, FALSE);
 
  return(5);
 }
@@ -1315,9 +1336,9 @@ static int32 OP(uint32 instr)
 {
  DECODE_FIELDS;
 
- MAC[1] = ((Matrices.Rot.MX[1][1] * IR3) - (Matrices.Rot.MX[2][2] * IR2)) >> sf;
- MAC[2] = ((Matrices.Rot.MX[2][2] * IR1) - (Matrices.Rot.MX[0][0] * IR3)) >> sf;
- MAC[3] = ((Matrices.Rot.MX[0][0] * IR2) - (Matrices.Rot.MX[1][1] * IR1)) >> sf;
+ GTE_S.MAC[1] = ((GTE_S.Matrices.Rot.MX[1][1] * IR3) - (GTE_S.Matrices.Rot.MX[2][2] * IR2)) >> sf;
+ GTE_S.MAC[2] = ((GTE_S.Matrices.Rot.MX[2][2] * IR1) - (GTE_S.Matrices.Rot.MX[0][0] * IR3)) >> sf;
+ GTE_S.MAC[3] = ((GTE_S.Matrices.Rot.MX[0][0] * IR2) - (GTE_S.Matrices.Rot.MX[1][1] * IR1)) >> sf;
 
  MAC_to_IR(lm);
 
@@ -1328,9 +1349,9 @@ static int32 GPF(uint32 instr)
 {
  DECODE_FIELDS;
 
- MAC[1] = (IR0 * IR1) >> sf;
- MAC[2] = (IR0 * IR2) >> sf;
- MAC[3] = (IR0 * IR3) >> sf;
+ GTE_S.MAC[1] = (IR0 * IR1) >> sf;
+ GTE_S.MAC[2] = (IR0 * IR2) >> sf;
+ GTE_S.MAC[3] = (IR0 * IR3) >> sf;
 
  MAC_to_IR(lm);
 
@@ -1343,9 +1364,9 @@ static int32 GPL(uint32 instr)
 {
  DECODE_FIELDS;
 
- MAC[1] = A_MV(0, (int64)((uint64)(int64)MAC[1] << sf) + (IR0 * IR1)) >> sf;
- MAC[2] = A_MV(1, (int64)((uint64)(int64)MAC[2] << sf) + (IR0 * IR2)) >> sf;
- MAC[3] = A_MV(2, (int64)((uint64)(int64)MAC[3] << sf) + (IR0 * IR3)) >> sf;
+ GTE_S.MAC[1] = A_MV(0, (int64)((uint64)(int64)GTE_S.MAC[1] << sf) + (IR0 * IR1)) >> sf;
+ GTE_S.MAC[2] = A_MV(1, (int64)((uint64)(int64)GTE_S.MAC[2] << sf) + (IR0 * IR2)) >> sf;
+ GTE_S.MAC[3] = A_MV(2, (int64)((uint64)(int64)GTE_S.MAC[3] << sf) + (IR0 * IR3)) >> sf;
 
  MAC_to_IR(lm);
 
@@ -1385,7 +1406,7 @@ int32 GTE_Instruction(uint32 instr)
  const unsigned code = instr & 0x3F;
  int32 ret = 1;
 
- FLAGS = 0;
+ GTE_S.FLAGS = 0;
 
  switch(code)
  {
@@ -1632,15 +1653,15 @@ int32 GTE_Instruction(uint32 instr)
 	break;
  }
 
- if(FLAGS & 0x7f87e000)
-  FLAGS |= 1 << 31;
+ if(GTE_S.FLAGS & 0x7f87e000)
+  GTE_S.FLAGS |= 1 << 31;
 
- CR[31] = FLAGS;
+ GTE_S.CR[31] = GTE_S.FLAGS;
 
  return(ret - 1);
 }
 
-void GTE_SyncState(bool isReader, EW::NewState *ns)
+SYNCFUNC(GTE_State)
 {
 	NSS(CR);
 	NSS(FLAGS);
@@ -1676,6 +1697,12 @@ void GTE_SyncState(bool isReader, EW::NewState *ns)
 	NSS(Reg23);
 }
 
+void GTE_SyncState(bool isReader, EW::NewState *ns)
+{
+	if(isReader) GTE_S.SyncState<true>(ns);
+	else GTE_S.SyncState<false>(ns);
+}
+
 #ifndef PSXDEV_GTE_TESTING
 }
 #endif
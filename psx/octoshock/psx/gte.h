@@ -4,6 +4,7 @@ namespace MDFN_IEN_PSX
 {
 
 void GTE_Init(void) MDFN_COLD;
+void GTE_Kill(void) MDFN_COLD;
 void GTE_Power(void) MDFN_COLD;
 
 int32 GTE_Instruction(uint32 instr);
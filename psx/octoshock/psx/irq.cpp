@@ -20,20 +20,44 @@
 namespace MDFN_IEN_PSX
 {
 
-static uint16 Asserted;
-static uint16 Mask;
-static uint16 Status;
+struct IRQ_State
+{
+ uint16 Asserted;
+ uint16 Mask;
+ uint16 Status;
+
+ template<bool isReader> void SyncState(EW::NewState *ns);
+};
+
+#define IRQ_S (*PSX_I->irq)
+
+void IRQ_Init(void)
+{
+ PSX_I->irq = new IRQ_State();
+}
+
+void IRQ_Kill(void)
+{
+ delete PSX_I->irq;
+ PSX_I->irq = NULL;
+}
 
 static INLINE void Recalc(void)
 {
- CPU->AssertIRQ(0, (bool)(Status & Mask));
+ PSX_I->CPU->AssertIRQ(0, (bool)(IRQ_S.Status & IRQ_S.Mask));
 }
 
-void IRQ_SyncState(bool isReader, EW::NewState *ns)
+SYNCFUNC(IRQ_State)
 {
   NSS(Asserted);
   NSS(Mask);
   NSS(Status);
+}
+
+void IRQ_SyncState(bool isReader, EW::NewState *ns)
+{
+	if(isReader) IRQ_S.SyncState<true>(ns);
+	else IRQ_S.SyncState<false>(ns);
 
 	//as usual, not sure why this is necessary
 	if(isReader)
@@ -44,19 +68,19 @@ void IRQ_SyncState(bool isReader, EW::NewState *ns)
 
 void IRQ_Assert(int which, bool status)
 {
- uint32 old_Asserted = Asserted;
+ uint32 old_Asserted = IRQ_S.Asserted;
  //PSX_WARNING("[IRQ] Assert: %d %d", which, status);
 
  //if(which == IRQ_SPU && status && (Asserted & (1 << which)))
  // MDFN_DispMessage("SPU IRQ glitch??");
 
- Asserted &= ~(1 << which);
+ IRQ_S.Asserted &= ~(1 << which);
 
  if(status)
  {
-  Asserted |= 1 << which;
+  IRQ_S.Asserted |= 1 << which;
   //Status |= 1 << which;
-  Status |= (old_Asserted ^ Asserted) & Asserted;
+  IRQ_S.Status |= (old_Asserted ^ IRQ_S.Asserted) & IRQ_S.Asserted;
  }
 
  Recalc();
@@ -71,10 +95,10 @@ void IRQ_Write(uint32 A, uint32 V)
  //printf("[IRQ] Write: 0x%08x 0x%08x --- PAD TEMP\n", A, V);
 
  if(A & 4)
-  Mask = V;
+  IRQ_S.Mask = V;
  else
  {
-  Status &= V;
+  IRQ_S.Status &= V;
   //Status |= Asserted;
  }
 
@@ -87,9 +111,9 @@ uint32 IRQ_Read(uint32 A)
  uint32 ret = 0;
 
  if(A & 4)
-  ret = Mask;
+  ret = IRQ_S.Mask;
  else
-  ret = Status;
+  ret = IRQ_S.Status;
 
  // FIXME: Might want to move this out to psx.cpp eventually.
  ret |= 0x1F800000;
@@ -103,18 +127,18 @@ uint32 IRQ_Read(uint32 A)
 
 void IRQ_Power(void)
 {
- Asserted = 0;
- Status = 0;
- Mask = 0;
+ IRQ_S.Asserted = 0;
+ IRQ_S.Status = 0;
+ IRQ_S.Mask = 0;
 
  Recalc();
 }
 
 void IRQ_Reset(void)
 {
- Asserted = 0;
- Status = 0; 
- Mask = 0;
+ IRQ_S.Asserted = 0;
+ IRQ_S.Status = 0; 
+ IRQ_S.Mask = 0;
 
  Recalc();
 }
@@ -127,15 +151,15 @@ uint32 IRQ_GetRegister(unsigned int which, char *special, const uint32 special_l
  switch(which)
  {
   case IRQ_GSREG_ASSERTED:
-	ret = Asserted;
+	ret = IRQ_S.Asserted;
 	break;
 
   case IRQ_GSREG_STATUS:
-	ret = Status;
+	ret = IRQ_S.Status;
 	break;
 
   case IRQ_GSREG_MASK:
-	ret = Mask;
+	ret = IRQ_S.Mask;
 	break;
  }
  return(ret);
@@ -146,17 +170,17 @@ void IRQ_SetRegister(unsigned int which, uint32 value)
  switch(which)
  {
   case IRQ_GSREG_ASSERTED:
-	Asserted = value;
+	IRQ_S.Asserted = value;
 	Recalc();
 	break;
 
   case IRQ_GSREG_STATUS:
-	Status = value;
+	IRQ_S.Status = value;
 	Recalc();
 	break;
 
   case IRQ_GSREG_MASK:
-	Mask = value;
+	IRQ_S.Mask = value;
 	Recalc();
 	break;
  }
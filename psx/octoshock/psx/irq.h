@@ -19,6 +19,8 @@ enum
  IRQ_PIO		= 10,	// Probably
 };
 
+void IRQ_Init(void) MDFN_COLD;
+void IRQ_Kill(void) MDFN_COLD;
 void IRQ_Power(void) MDFN_COLD;
 void IRQ_Assert(int which, bool asserted);
 
@@ -78,45 +78,52 @@
 namespace MDFN_IEN_PSX
 {
 
-static int32 ClockCounter;
-static unsigned MDRPhase;
-static FastFIFO<uint32, 0x20> InFIFO;
-static FastFIFO<uint32, 0x20> OutFIFO;
+struct MDEC_State
+{
+ int32 ClockCounter;
+ unsigned MDRPhase;
+ FastFIFO<uint32, 0x20> InFIFO;
+ FastFIFO<uint32, 0x20> OutFIFO;
 
-static int8 block_y[8][8];
-static int8 block_cb[8][8];	// [y >> 1][x >> 1]
-static int8 block_cr[8][8];	// [y >> 1][x >> 1]
+ int8 block_y[8][8];
+ int8 block_cb[8][8];	// [y >> 1][x >> 1]
+ int8 block_cr[8][8];	// [y >> 1][x >> 1]
 
-static uint32 Control;
-static uint32 Command;
-static bool InCommand;
+ uint32 Control;
+ uint32 Command;
+ bool InCommand;
 
-static uint8 QMatrix[2][64];
-static uint32 QMIndex;
+ uint8 QMatrix[2][64];
+ uint32 QMIndex;
 
-static EW_VAR_ALIGN(16) int16 IDCTMatrix[64];
-static uint32 IDCTMIndex;
+ EW_VAR_ALIGN(16) int16 IDCTMatrix[64];
+ uint32 IDCTMIndex;
 
-static uint8 QScale;
+ uint8 QScale;
 
-static EW_VAR_ALIGN(16) int16 Coeff[64];
-static uint32 CoeffIndex;
-static uint32 DecodeWB;
+ EW_VAR_ALIGN(16) int16 Coeff[64];
+ uint32 CoeffIndex;
+ uint32 DecodeWB;
 
-static union
-{
- uint32 pix32[48];
- uint16 pix16[96];
- uint8   pix8[192];
-} PixelBuffer;
-static uint32 PixelBufferReadOffset;
-static uint32 PixelBufferCount32;
+ union
+ {
+  uint32 pix32[48];
+  uint16 pix16[96];
+  uint8   pix8[192];
+ } PixelBuffer;
+ uint32 PixelBufferReadOffset;
+ uint32 PixelBufferCount32;
+
+ uint16 InCounter;
 
-static uint16 InCounter;
+ uint8 RAMOffsetY;
+ uint8 RAMOffsetCounter;
+ uint8 RAMOffsetWWS;
 
-static uint8 RAMOffsetY;
-static uint8 RAMOffsetCounter;
-static uint8 RAMOffsetWWS;
+ template<bool isReader> void SyncState(EW::NewState *ns);
+};
+
+#define MDEC_S (*PSX_I->mdec)
 
 static const uint8 ZigZag[64] =
 {
@@ -130,46 +137,57 @@ static const uint8 ZigZag[64] =
  0x2e, 0x27, 0x2f, 0x36, 0x3d, 0x3e, 0x37, 0x3f, 
 };
 
+void MDEC_Init(void)
+{
+ PSX_I->mdec = new MDEC_State();
+}
+
+void MDEC_Kill(void)
+{
+ delete PSX_I->mdec;
+ PSX_I->mdec = NULL;
+}
+
 void MDEC_Power(void)
 {
- ClockCounter = 0;
- MDRPhase = 0;
+ MDEC_S.ClockCounter = 0;
+ MDEC_S.MDRPhase = 0;
 
- InFIFO.Flush();
- OutFIFO.Flush();
+ MDEC_S.InFIFO.Flush();
+ MDEC_S.OutFIFO.Flush();
 
- memset(block_y, 0, sizeof(block_y));
- memset(block_cb, 0, sizeof(block_cb));
- memset(block_cr, 0, sizeof(block_cr));
+ memset(MDEC_S.block_y, 0, sizeof(MDEC_S.block_y));
+ memset(MDEC_S.block_cb, 0, sizeof(MDEC_S.block_cb));
+ memset(MDEC_S.block_cr, 0, sizeof(MDEC_S.block_cr));
 
- Control = 0;
- Command = 0;
- InCommand = false;
+ MDEC_S.Control = 0;
+ MDEC_S.Command = 0;
+ MDEC_S.InCommand = false;
 
- memset(QMatrix, 0, sizeof(QMatrix));
- QMIndex = 0;
+ memset(MDEC_S.QMatrix, 0, sizeof(MDEC_S.QMatrix));
+ MDEC_S.QMIndex = 0;
 
- memset(IDCTMatrix, 0, sizeof(IDCTMatrix));
- IDCTMIndex = 0;
+ memset(MDEC_S.IDCTMatrix, 0, sizeof(MDEC_S.IDCTMatrix));
+ MDEC_S.IDCTMIndex = 0;
 
- QScale = 0;
+ MDEC_S.QScale = 0;
 
- memset(Coeff, 0, sizeof(Coeff));
- CoeffIndex = 0;
- DecodeWB = 0;
+ memset(MDEC_S.Coeff, 0, sizeof(MDEC_S.Coeff));
+ MDEC_S.CoeffIndex = 0;
+ MDEC_S.DecodeWB = 0;
 
- memset(PixelBuffer.pix32, 0, sizeof(PixelBuffer.pix32));
- PixelBufferReadOffset = 0;
- PixelBufferCount32 = 0;
+ memset(MDEC_S.PixelBuffer.pix32, 0, sizeof(MDEC_S.PixelBuffer.pix32));
+ MDEC_S.PixelBufferReadOffset = 0;
+ MDEC_S.PixelBufferCount32 = 0;
 
- InCounter = 0;
+ MDEC_S.InCounter = 0;
 
- RAMOffsetY = 0;
- RAMOffsetCounter = 0;
- RAMOffsetWWS = 0;
+ MDEC_S.RAMOffsetY = 0;
+ MDEC_S.RAMOffsetCounter = 0;
+ MDEC_S.RAMOffsetWWS = 0;
 }
 
-template<bool isReader> void MDEC_SyncState(EW::NewState *ns)
+SYNCFUNC(MDEC_State)
 {
 	NSS(ClockCounter);
 	NSS(MDRPhase);
@@ -211,8 +229,8 @@ template<bool isReader> void MDEC_SyncState(EW::NewState *ns)
 
 void MDEC_SyncState(bool isReader, EW::NewState *ns)
 {
-	if(isReader) MDEC_SyncState<true>(ns);
-	else MDEC_SyncState<false>(ns);
+	if(isReader) MDEC_S.SyncState<true>(ns);
+	else MDEC_S.SyncState<false>(ns);
 }
 
 static INLINE int8 Mask9ClampS8(int32 v)
@@ -243,7 +261,7 @@ static void IDCT_1D_Multi(int16 *in_coeff, T *out_coeff)
    __m128i m;
    int32 tmp[4] MDFN_ALIGN(16);
 
-   m = _mm_load_si128((__m128i *)&IDCTMatrix[(x * 8)]);
+   m = _mm_load_si128((__m128i *)&MDEC_S.IDCTMatrix[(x * 8)]);
    sum = _mm_madd_epi16(m, c);
    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, (3 << 0) | (2 << 2) | (1 << 4) | (0 << 6)));
    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, (1 << 0) | (0 << 2)));
@@ -267,7 +285,7 @@ static void IDCT_1D_Multi(int16 *in_coeff, T *out_coeff)
 
    for(unsigned u = 0; u < 8; u++)
    {
-    sum += (in_coeff[(col * 8) + u] * IDCTMatrix[(x * 8) + u]);
+    sum += (in_coeff[(col * 8) + u] * MDEC_S.IDCTMatrix[(x * 8) + u]);
    }
 
    if(sizeof(T) == 1)
@@ -326,58 +344,58 @@ static void EncodeImage(const unsigned ybn)
 {
  //printf("ENCODE, %d\n", (Command & 0x08000000) ? 256 : 384);
 
- PixelBufferCount32 = 0;
+ MDEC_S.PixelBufferCount32 = 0;
 
- switch((Command >> 27) & 0x3)
+ switch((MDEC_S.Command >> 27) & 0x3)
  {
   case 0:	// 4bpp
   {
-   const uint8 us_xor = (Command & (1U << 26)) ? 0x00 : 0x88;
-   uint8* pix_out = PixelBuffer.pix8;
+   const uint8 us_xor = (MDEC_S.Command & (1U << 26)) ? 0x00 : 0x88;
+   uint8* pix_out = MDEC_S.PixelBuffer.pix8;
 
    for(int y = 0; y < 8; y++)
    {
     for(int x = 0; x < 8; x += 2)
     {
-     uint8 p0 = std::min<int>(127, block_y[y][x + 0] + 8);
-     uint8 p1 = std::min<int>(127, block_y[y][x + 1] + 8);
+     uint8 p0 = std::min<int>(127, MDEC_S.block_y[y][x + 0] + 8);
+     uint8 p1 = std::min<int>(127, MDEC_S.block_y[y][x + 1] + 8);
 
      *pix_out = ((p0 >> 4) | (p1 & 0xF0)) ^ us_xor;
      pix_out++;
     }
    }
-   PixelBufferCount32 = 8;
+   MDEC_S.PixelBufferCount32 = 8;
   }
   break;
 
 
   case 1:	// 8bpp
   {
-   const uint8 us_xor = (Command & (1U << 26)) ? 0x00 : 0x80;
-   uint8* pix_out = PixelBuffer.pix8;
+   const uint8 us_xor = (MDEC_S.Command & (1U << 26)) ? 0x00 : 0x80;
+   uint8* pix_out = MDEC_S.PixelBuffer.pix8;
 
    for(int y = 0; y < 8; y++)
    {
     for(int x = 0; x < 8; x++)
     {
-     *pix_out = (uint8)block_y[y][x] ^ us_xor;
+     *pix_out = (uint8)MDEC_S.block_y[y][x] ^ us_xor;
      pix_out++;
     }
    }
-   PixelBufferCount32 = 16;
+   MDEC_S.PixelBufferCount32 = 16;
   }
   break;
 
   case 2:	// 24bpp
   {
-   const uint8 rgb_xor = (Command & (1U << 26)) ? 0x80 : 0x00;
-   uint8* pix_out = PixelBuffer.pix8;
+   const uint8 rgb_xor = (MDEC_S.Command & (1U << 26)) ? 0x80 : 0x00;
+   uint8* pix_out = MDEC_S.PixelBuffer.pix8;
 
    for(int y = 0; y < 8; y++)
    {
-    const int8* by = &block_y[y][0];
-    const int8* cb = &block_cb[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
-    const int8* cr = &block_cr[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
+    const int8* by = &MDEC_S.block_y[y][0];
+    const int8* cb = &MDEC_S.block_cb[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
+    const int8* cr = &MDEC_S.block_cr[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
     
     for(int x = 0; x < 8; x++)
     {
@@ -391,20 +409,20 @@ static void EncodeImage(const unsigned ybn)
      pix_out += 3;
     }
    }
-   PixelBufferCount32 = 48;
+   MDEC_S.PixelBufferCount32 = 48;
   }
   break;
 
   case 3:	// 16bpp
   {
-   uint16 pixel_xor = ((Command & 0x02000000) ? 0x8000 : 0x0000) | ((Command & (1U << 26)) ? 0x4210 : 0x0000);
-   uint16* pix_out = PixelBuffer.pix16;
+   uint16 pixel_xor = ((MDEC_S.Command & 0x02000000) ? 0x8000 : 0x0000) | ((MDEC_S.Command & (1U << 26)) ? 0x4210 : 0x0000);
+   uint16* pix_out = MDEC_S.PixelBuffer.pix16;
 
    for(int y = 0; y < 8; y++)
    {
-    const int8* by = &block_y[y][0];
-    const int8* cb = &block_cb[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
-    const int8* cr = &block_cr[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
+    const int8* by = &MDEC_S.block_y[y][0];
+    const int8* cb = &MDEC_S.block_cb[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
+    const int8* cr = &MDEC_S.block_cr[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
 
     for(int x = 0; x < 8; x++)
     {
@@ -416,7 +434,7 @@ static void EncodeImage(const unsigned ybn)
      pix_out++;
     }
    }
-   PixelBufferCount32 = 32;
+   MDEC_S.PixelBufferCount32 = 32;
   }
   break;
 
@@ -425,11 +443,11 @@ static void EncodeImage(const unsigned ybn)
 
 static INLINE void WriteImageData(uint16 V, int32* eat_cycles)
 {
- const uint32 qmw = (bool)(DecodeWB < 2);
+ const uint32 qmw = (bool)(MDEC_S.DecodeWB < 2);
 
   //printf("MDEC DMA SubWrite: %04x, %d\n", V, CoeffIndex);
 
-  if(!CoeffIndex)
+  if(!MDEC_S.CoeffIndex)
   {
    if(V == 0xFE00)
    {
@@ -437,10 +455,10 @@ static INLINE void WriteImageData(uint16 V, int32* eat_cycles)
     return;
    }
 
-   QScale = V >> 10;
+   MDEC_S.QScale = V >> 10;
 
    {
-    int q = QMatrix[qmw][0];	// No QScale here!
+    int q = MDEC_S.QMatrix[qmw][0];	// No QScale here!
     int ci = sign_10_to_s16(V & 0x3FF);
     int tmp;
 
@@ -450,30 +468,30 @@ static INLINE void WriteImageData(uint16 V, int32* eat_cycles)
      tmp = (uint32)(ci * 2) << 4;
 
     // Not sure if it should be 0x3FFF or 0x3FF0 or maybe 0x3FF8?
-    Coeff[ZigZag[0]] = std::min<int>(0x3FFF, std::max<int>(-0x4000, tmp));
-    CoeffIndex++;
+    MDEC_S.Coeff[ZigZag[0]] = std::min<int>(0x3FFF, std::max<int>(-0x4000, tmp));
+    MDEC_S.CoeffIndex++;
    }
   }
   else
   {
    if(V == 0xFE00)
    {
-    while(CoeffIndex < 64)
-     Coeff[ZigZag[CoeffIndex++]] = 0;
+    while(MDEC_S.CoeffIndex < 64)
+     MDEC_S.Coeff[ZigZag[MDEC_S.CoeffIndex++]] = 0;
    }
    else
    {
     uint32 rlcount = V >> 10;
 
-    for(uint32 i = 0; i < rlcount && CoeffIndex < 64; i++)
+    for(uint32 i = 0; i < rlcount && MDEC_S.CoeffIndex < 64; i++)
     {
-     Coeff[ZigZag[CoeffIndex]] = 0;
-     CoeffIndex++;
+     MDEC_S.Coeff[ZigZag[MDEC_S.CoeffIndex]] = 0;
+     MDEC_S.CoeffIndex++;
     }
 
-    if(CoeffIndex < 64)
+    if(MDEC_S.CoeffIndex < 64)
     {
-     int q = QScale * QMatrix[qmw][CoeffIndex];
+     int q = MDEC_S.QScale * MDEC_S.QMatrix[qmw][MDEC_S.CoeffIndex];
      int ci = sign_10_to_s16(V & 0x3FF);
      int tmp;
 
@@ -483,26 +501,26 @@ static INLINE void WriteImageData(uint16 V, int32* eat_cycles)
       tmp = (uint32)(ci * 2) << 4;
 
      // Not sure if it should be 0x3FFF or 0x3FF0 or maybe 0x3FF8?
-     Coeff[ZigZag[CoeffIndex]] = std::min<int>(0x3FFF, std::max<int>(-0x4000, tmp));
-     CoeffIndex++;
+     MDEC_S.Coeff[ZigZag[MDEC_S.CoeffIndex]] = std::min<int>(0x3FFF, std::max<int>(-0x4000, tmp));
+     MDEC_S.CoeffIndex++;
     }
    }
   }
 
-  if(CoeffIndex == 64)
+  if(MDEC_S.CoeffIndex == 64)
   {
-   CoeffIndex = 0;
+   MDEC_S.CoeffIndex = 0;
 
    //printf("Block %d finished\n", DecodeWB);
 
-   switch(DecodeWB)
+   switch(MDEC_S.DecodeWB)
    {
-    case 0: IDCT(Coeff, &block_cr[0][0]); break;
-    case 1: IDCT(Coeff, &block_cb[0][0]); break;
-    case 2: IDCT(Coeff, &block_y[0][0]); break;
-    case 3: IDCT(Coeff, &block_y[0][0]); break;
-    case 4: IDCT(Coeff, &block_y[0][0]); break;
-    case 5: IDCT(Coeff, &block_y[0][0]); break;
+    case 0: IDCT(MDEC_S.Coeff, &MDEC_S.block_cr[0][0]); break;
+    case 1: IDCT(MDEC_S.Coeff, &MDEC_S.block_cb[0][0]); break;
+    case 2: IDCT(MDEC_S.Coeff, &MDEC_S.block_y[0][0]); break;
+    case 3: IDCT(MDEC_S.Coeff, &MDEC_S.block_y[0][0]); break;
+    case 4: IDCT(MDEC_S.Coeff, &MDEC_S.block_y[0][0]); break;
+    case 5: IDCT(MDEC_S.Coeff, &MDEC_S.block_y[0][0]); break;
    }   
 
    //
@@ -512,15 +530,15 @@ static INLINE void WriteImageData(uint16 V, int32* eat_cycles)
    //
    *eat_cycles += 474;
 
-   if(DecodeWB >= 2)
+   if(MDEC_S.DecodeWB >= 2)
    {
-    EncodeImage((DecodeWB + 4) % 6);
+    EncodeImage((MDEC_S.DecodeWB + 4) % 6);
    }
 
-   DecodeWB++;
-   if(DecodeWB == (((Command >> 27) & 2) ? 6 : 3))
+   MDEC_S.DecodeWB++;
+   if(MDEC_S.DecodeWB == (((MDEC_S.Command >> 27) & 2) ? 6 : 3))
    {
-    DecodeWB = ((Command >> 27) & 2) ? 0 : 2;
+    MDEC_S.DecodeWB = ((MDEC_S.Command >> 27) & 2) ? 0 : 2;
    }
   }
 }
@@ -530,34 +548,35 @@ static INLINE void WriteImageData(uint16 V, int32* eat_cycles)
 //
 //
 //
-#define MDEC_WAIT_COND(n)  { case __COUNTER__: if(!(n)) { MDRPhase = __COUNTER__ - MDRPhaseBias - 1; return; } }
+#define MDEC_WAIT_COND(n)  { case __COUNTER__: if(!(n)) { MDEC_S.MDRPhase = __COUNTER__ - MDRPhaseBias - 1; return; } }
 
-#define MDEC_WRITE_FIFO(n) { MDEC_WAIT_COND(OutFIFO.CanWrite()); OutFIFO.Write(n);  }
-#define MDEC_READ_FIFO(n)  { MDEC_WAIT_COND(InFIFO.CanRead()); n = InFIFO.Read(); }
-#define MDEC_EAT_CLOCKS(n) { ClockCounter -= (n); MDEC_WAIT_COND(ClockCounter > 0); }
+#define MDEC_WRITE_FIFO(n) { MDEC_WAIT_COND(MDEC_S.OutFIFO.CanWrite()); MDEC_S.OutFIFO.Write(n);  }
+#define MDEC_READ_FIFO(n)  { MDEC_WAIT_COND(MDEC_S.InFIFO.CanRead()); n = MDEC_S.InFIFO.Read(); }
+#define MDEC_EAT_CLOCKS(n) { MDEC_S.ClockCounter -= (n); MDEC_WAIT_COND(MDEC_S.ClockCounter > 0); }
 
 void MDEC_Run(int32 clocks)
 {
  static const unsigned MDRPhaseBias = __COUNTER__ + 1;
+ PSX_PERF_SCOPE(PSX_PERF_MDEC);
 
  //MDFN_DispMessage("%u", OutFIFO.CanRead());
 
- ClockCounter += clocks;
+ MDEC_S.ClockCounter += clocks;
 
- if(ClockCounter > 128)
+ if(MDEC_S.ClockCounter > 128)
  {
   //if(MDRPhase != 0)
   // printf("SNORT: %d\n", ClockCounter);
-  ClockCounter = 128;
+  MDEC_S.ClockCounter = 128;
  }
 
- switch(MDRPhase + MDRPhaseBias)
+ switch(MDEC_S.MDRPhase + MDRPhaseBias)
  {
   for(;;)
   {
-   InCommand = false;
-   MDEC_READ_FIFO(Command);	// This must be the first MDEC_* macro used!
-   InCommand = true;
+   MDEC_S.InCommand = false;
+   MDEC_READ_FIFO(MDEC_S.Command);	// This must be the first MDEC_* macro used!
+   MDEC_S.InCommand = true;
    MDEC_EAT_CLOCKS(1);
 
    //printf("****************** Command: %08x, %02x\n", Command, Command >> 29);
@@ -565,109 +584,109 @@ void MDEC_Run(int32 clocks)
    //
    //
    //
-   if(((Command >> 29) & 0x7) == 1)
+   if(((MDEC_S.Command >> 29) & 0x7) == 1)
    {
-    InCounter = Command & 0xFFFF;
-    OutFIFO.Flush();
+    MDEC_S.InCounter = MDEC_S.Command & 0xFFFF;
+    MDEC_S.OutFIFO.Flush();
     //OutBuffer.Flush();
 
-    PixelBufferCount32 = 0;
-    CoeffIndex = 0;
+    MDEC_S.PixelBufferCount32 = 0;
+    MDEC_S.CoeffIndex = 0;
 
-    if((Command >> 27) & 2)
-     DecodeWB = 0;
+    if((MDEC_S.Command >> 27) & 2)
+     MDEC_S.DecodeWB = 0;
     else
-     DecodeWB = 2;
+     MDEC_S.DecodeWB = 2;
 
-    switch((Command >> 27) & 0x3)
+    switch((MDEC_S.Command >> 27) & 0x3)
     {
      case 0:
-     case 1: RAMOffsetWWS = 0; break;
-     case 2: RAMOffsetWWS = 6; break;
-     case 3: RAMOffsetWWS = 4; break;
+     case 1: MDEC_S.RAMOffsetWWS = 0; break;
+     case 2: MDEC_S.RAMOffsetWWS = 6; break;
+     case 3: MDEC_S.RAMOffsetWWS = 4; break;
     }
-    RAMOffsetY = 0;
-    RAMOffsetCounter = RAMOffsetWWS;
+    MDEC_S.RAMOffsetY = 0;
+    MDEC_S.RAMOffsetCounter = MDEC_S.RAMOffsetWWS;
 
-    InCounter--;
+    MDEC_S.InCounter--;
     do
     {
      uint32 tfr;
      int32 need_eat; // = 0;
 
      MDEC_READ_FIFO(tfr);
-     InCounter--;
+     MDEC_S.InCounter--;
 
 //     printf("KA: %04x %08x\n", InCounter, tfr);
 
      need_eat = 0;
-     PixelBufferCount32 = 0;
+     MDEC_S.PixelBufferCount32 = 0;
      WriteImageData(tfr, &need_eat);
      WriteImageData(tfr >> 16, &need_eat);
 
      MDEC_EAT_CLOCKS(need_eat);
 
-     PixelBufferReadOffset = 0;
-     while(PixelBufferReadOffset != PixelBufferCount32)
+     MDEC_S.PixelBufferReadOffset = 0;
+     while(MDEC_S.PixelBufferReadOffset != MDEC_S.PixelBufferCount32)
      {
-      MDEC_WRITE_FIFO(MDFN_de32lsb<true>(&PixelBuffer.pix32[PixelBufferReadOffset++]));
+      MDEC_WRITE_FIFO(MDFN_de32lsb<true>(&MDEC_S.PixelBuffer.pix32[MDEC_S.PixelBufferReadOffset++]));
      }
-    } while(InCounter != 0xFFFF);
+    } while(MDEC_S.InCounter != 0xFFFF);
    }
    //
    //
    //
-   else if(((Command >> 29) & 0x7) == 2)
+   else if(((MDEC_S.Command >> 29) & 0x7) == 2)
    {
-    QMIndex = 0;
-    InCounter = 0x10 + ((Command & 0x1) ? 0x10 : 0x00);
+    MDEC_S.QMIndex = 0;
+    MDEC_S.InCounter = 0x10 + ((MDEC_S.Command & 0x1) ? 0x10 : 0x00);
 
-    InCounter--;
+    MDEC_S.InCounter--;
     do
     {
 	uint32 tfr;
     
 	MDEC_READ_FIFO(tfr);
-	InCounter--;
+	MDEC_S.InCounter--;
 
 	//printf("KA: %04x %08x\n", InCounter, tfr);
 
 	for(int i = 0; i < 4; i++)
 	{
-         QMatrix[QMIndex >> 6][QMIndex & 0x3F] = (uint8)tfr;
-	 QMIndex = (QMIndex + 1) & 0x7F;
+         MDEC_S.QMatrix[MDEC_S.QMIndex >> 6][MDEC_S.QMIndex & 0x3F] = (uint8)tfr;
+	 MDEC_S.QMIndex = (MDEC_S.QMIndex + 1) & 0x7F;
 	 tfr >>= 8;
 	}
-    } while(InCounter != 0xFFFF);
+    } while(MDEC_S.InCounter != 0xFFFF);
    }
    //
    //
    //
-   else if(((Command >> 29) & 0x7) == 3)
+   else if(((MDEC_S.Command >> 29) & 0x7) == 3)
    {
-    IDCTMIndex = 0;
-    InCounter = 0x20;
+    MDEC_S.IDCTMIndex = 0;
+    MDEC_S.InCounter = 0x20;
 
-    InCounter--;
+    MDEC_S.InCounter--;
     do
     {
      uint32 tfr;
 
      MDEC_READ_FIFO(tfr);
-     InCounter--;
+     MDEC_S.InCounter--;
 
      for(unsigned i = 0; i < 2; i++)
      {
-      IDCTMatrix[((IDCTMIndex & 0x7) << 3) | ((IDCTMIndex >> 3) & 0x7)] = (int16)(tfr & 0xFFFF) >> 3;
-      IDCTMIndex = (IDCTMIndex + 1) & 0x3F;
+      MDEC_S.IDCTMatrix[((MDEC_S.IDCTMIndex & 0x7) << 3) | ((MDEC_S.IDCTMIndex >> 3) & 0x7)] = (int16)(tfr & 0xFFFF) >> 3;
+      MDEC_S.IDCTMIndex = (MDEC_S.IDCTMIndex + 1) & 0x3F;
 
       tfr >>= 16;
      }
-    } while(InCounter != 0xFFFF);
+    } while(MDEC_S.InCounter != 0xFFFF);
    }
    else
    {
-    InCounter = Command & 0xFFFF;
+    MDEC_S.InCounter = MDEC_S.Command & 0xFFFF;
    }
   } // end for(;;)
  }
@@ -677,9 +696,9 @@ void MDEC_Run(int32 clocks)
 
 void MDEC_DMAWrite(uint32 V)
 {
- if(InFIFO.CanWrite())
+ if(MDEC_S.InFIFO.CanWrite())
  {
-  InFIFO.Write(V);
+  MDEC_S.InFIFO.Write(V);
   MDEC_Run(0);
  }
  else
@@ -694,22 +713,22 @@ uint32 MDEC_DMARead(uint32* offs)
 
  *offs = 0;
 
- if(MDFN_LIKELY(OutFIFO.CanRead()))
+ if(MDFN_LIKELY(MDEC_S.OutFIFO.CanRead()))
  {
-  V = OutFIFO.Read();
+  V = MDEC_S.OutFIFO.Read();
 
-  *offs = (RAMOffsetY & 0x7) * RAMOffsetWWS;
+  *offs = (MDEC_S.RAMOffsetY & 0x7) * MDEC_S.RAMOffsetWWS;
 
-  if(RAMOffsetY & 0x08)
+  if(MDEC_S.RAMOffsetY & 0x08)
   {
-   *offs = (*offs - RAMOffsetWWS*7);
+   *offs = (*offs - MDEC_S.RAMOffsetWWS*7);
   }
 
-  RAMOffsetCounter--;
-  if(!RAMOffsetCounter)
+  MDEC_S.RAMOffsetCounter--;
+  if(!MDEC_S.RAMOffsetCounter)
   {
-   RAMOffsetCounter = RAMOffsetWWS;
-   RAMOffsetY++;
+   MDEC_S.RAMOffsetCounter = MDEC_S.RAMOffsetWWS;
+   MDEC_S.RAMOffsetY++;
   }
 
   MDEC_Run(0);
@@ -724,12 +743,12 @@ uint32 MDEC_DMARead(uint32* offs)
 
 bool MDEC_DMACanWrite(void)
 {
- return((InFIFO.CanWrite() >= 0x20) && (Control & (1U << 30)) && InCommand && InCounter != 0xFFFF);
+ return((MDEC_S.InFIFO.CanWrite() >= 0x20) && (MDEC_S.Control & (1U << 30)) && MDEC_S.InCommand && MDEC_S.InCounter != 0xFFFF);
 }
 
 bool MDEC_DMACanRead(void)
 {
- return((OutFIFO.CanRead() >= 0x20) && (Control & (1U << 29)));
+ return((MDEC_S.OutFIFO.CanRead() >= 0x20) && (MDEC_S.Control & (1U << 29)));
 }
 
 void MDEC_Write(const pscpu_timestamp_t timestamp, uint32 A, uint32 V)
@@ -739,37 +758,37 @@ void MDEC_Write(const pscpu_timestamp_t timestamp, uint32 A, uint32 V)
  {
   if(V & 0x80000000) // Reset?
   {
-   MDRPhase = 0;
-   InCounter = 0;
-   Command = 0;
-   InCommand = false;
+   MDEC_S.MDRPhase = 0;
+   MDEC_S.InCounter = 0;
+   MDEC_S.Command = 0;
+   MDEC_S.InCommand = false;
 
-   PixelBufferCount32 = 0;
-   ClockCounter = 0;
-   QMIndex = 0;
-   IDCTMIndex = 0;
+   MDEC_S.PixelBufferCount32 = 0;
+   MDEC_S.ClockCounter = 0;
+   MDEC_S.QMIndex = 0;
+   MDEC_S.IDCTMIndex = 0;
 
-   QScale = 0;
+   MDEC_S.QScale = 0;
 
-   memset(Coeff, 0, sizeof(Coeff));
-   CoeffIndex = 0;
-   DecodeWB = 0;
+   memset(MDEC_S.Coeff, 0, sizeof(MDEC_S.Coeff));
+   MDEC_S.CoeffIndex = 0;
+   MDEC_S.DecodeWB = 0;
 
-   InFIFO.Flush();
-   OutFIFO.Flush();
+   MDEC_S.InFIFO.Flush();
+   MDEC_S.OutFIFO.Flush();
   }
-  Control = V & 0x7FFFFFFF;
+  MDEC_S.Control = V & 0x7FFFFFFF;
  }
  else
  {
-  if(InFIFO.CanWrite())
+  if(MDEC_S.InFIFO.CanWrite())
   {
-   InFIFO.Write(V);
+   MDEC_S.InFIFO.Write(V);
 
-   if(!InCommand)
+   if(!MDEC_S.InCommand)
    {
-    if(ClockCounter < 1)
-     ClockCounter = 1;
+    if(MDEC_S.ClockCounter < 1)
+     MDEC_S.ClockCounter = 1;
    }
    MDEC_Run(0);
   }
@@ -788,23 +807,23 @@ uint32 MDEC_Read(const pscpu_timestamp_t timestamp, uint32 A)
  {
   ret = 0;
 
-  ret |= (OutFIFO.CanRead() == 0) << 31;
-  ret |= (InFIFO.CanWrite() == 0) << 30;
-  ret |= InCommand << 29;
+  ret |= (MDEC_S.OutFIFO.CanRead() == 0) << 31;
+  ret |= (MDEC_S.InFIFO.CanWrite() == 0) << 30;
+  ret |= MDEC_S.InCommand << 29;
 
   ret |= MDEC_DMACanWrite() << 28;
   ret |= MDEC_DMACanRead() << 27;
 
-  ret |= ((Command >> 25) & 0xF) << 23;
+  ret |= ((MDEC_S.Command >> 25) & 0xF) << 23;
 
   // Needs refactoring elsewhere to work right: ret |= ((DecodeWB + 4) % 6) << 16;
 
-  ret |= InCounter & 0xFFFF;
+  ret |= MDEC_S.InCounter & 0xFFFF;
  }
  else
  {
-  if(OutFIFO.CanRead())
-   ret = OutFIFO.Read();
+  if(MDEC_S.OutFIFO.CanRead())
+   ret = MDEC_S.OutFIFO.Read();
  }
 
  //PSX_WARNING("[MDEC] Read: 0x%08x 0x%08x -- %d %d", A, ret, InputBuffer.CanRead(), InCounter);
@@ -12,6 +12,8 @@ void MDEC_Write(const pscpu_timestamp_t timestamp, uint32 A, uint32 V);
 uint32 MDEC_Read(const pscpu_timestamp_t timestamp, uint32 A);
 
 
+void MDEC_Init(void) MDFN_COLD;
+void MDEC_Kill(void) MDFN_COLD;
 void MDEC_Power(void) MDFN_COLD;
 
 bool MDEC_DMACanWrite(void);
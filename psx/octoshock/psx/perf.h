@@ -0,0 +1,66 @@
+#ifndef __MDFN_PSX_PERF_H
+#define __MDFN_PSX_PERF_H
+
+#include <chrono>
+
+//
+// Opt-in profiling counters, for benchmarking the core(see test/bench).  Build with PSX_PERF_COUNTERS defined and the entry points
+// of the main subsystems tally the wall-clock time spent in them; without it, PSX_PERF_SCOPE() expands to nothing.
+//
+// Time is exclusive: the CPU calls into everything else through the event system, so entering a subsystem stops the clock of
+// whatever was running until it returns.
+//
+namespace MDFN_IEN_PSX
+{
+
+enum
+{
+ PSX_PERF_OTHER = 0,	// Frame setup, output, and anything else outside the subsystems below.
+ PSX_PERF_CPU,
+ PSX_PERF_GPU,
+ PSX_PERF_SPU,
+ PSX_PERF_CDC,
+ PSX_PERF_MDEC,
+
+ PSX_PERF_COUNT
+};
+
+#ifdef PSX_PERF_COUNTERS
+struct PSX_PerfCounters
+{
+ uint64 NS[PSX_PERF_COUNT];
+ unsigned Current = PSX_PERF_OTHER;
+ std::chrono::steady_clock::time_point Last = std::chrono::steady_clock::now();
+};
+
+static INLINE unsigned PSX_PerfSwitch(unsigned which)
+{
+ PSX_PerfCounters* const perf = PSX_I->perf;
+ const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+ const unsigned prev = perf->Current;
+
+ perf->NS[prev] += std::chrono::duration_cast<std::chrono::nanoseconds>(now - perf->Last).count();
+ perf->Last = now;
+ perf->Current = which;
+
+ return prev;
+}
+
+class PSX_PerfScope
+{
+ public:
+ INLINE PSX_PerfScope(unsigned which) : prev(PSX_PerfSwitch(which)) { }
+ INLINE ~PSX_PerfScope() { PSX_PerfSwitch(prev); }
+
+ private:
+ const unsigned prev;
+};
+
+ #define PSX_PERF_SCOPE(which) PSX_PerfScope psx_perf_scope(which)
+#else
+ #define PSX_PERF_SCOPE(which)
+#endif
+
+}
+
+#endif
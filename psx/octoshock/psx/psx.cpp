@@ -40,6 +40,11 @@
 #include <stdarg.h>
 #include <ctype.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SHOCK_NORMALIZE_SSE2
+#endif
+
 //I apologize for the absolute madness of the resolution management and framebuffer management and normalizing in here.
 //It's grown entirely out of control. The main justification for the original design was not wrecking mednafen internals too much.
 
@@ -51,14 +56,7 @@
 
 //extern MDFNGI EmulatedPSX;
 
-int16 soundbuf[1024 * 1024]; //how big? big enough.
-int VTBackBuffer = 0;
-bool GpuFrameForLag = false;
-static MDFN_Rect VTDisplayRects[2];
-#include	"video/Deinterlacer.h"
-static bool PrevInterlaced;
-static Deinterlacer deint;
-static EmulateSpecStruct espec;
+#include	"video/Deinterlacer.h"
 
 template<typename T> inline void reconstruct(T* t) {
 	t->~T();
@@ -164,32 +162,388 @@ struct MDFN_PseudoRNG	// Based off(but not the same as) public-domain "JKISS" PR
  uint64 lcgo;
 };
 
-static MDFN_PseudoRNG PSX_PRNG;
+struct event_list_entry
+{
+ uint32 which;
+ pscpu_timestamp_t event_time;
+ event_list_entry *prev;
+ event_list_entry *next;
+};
 
-uint32 PSX_GetRandU32(uint32 mina, uint32 maxa)
+struct ShockConfig
+{
+	//// multires is a hint that, if set, indicates that the system has fairly programmable video modes(particularly, the ability
+	//// to display multiple horizontal resolutions, such as the PCE, PC-FX, or Genesis).  In practice, it will cause the driver
+	//// code to set the linear interpolation on by default. (TRUE for psx)
+	//// lcm_width and lcm_height are the least common multiples of all possible
+	//// resolutions in the frame buffer as specified by DisplayRect/LineWidths(Ex for PCE: widths of 256, 341.333333, 512,
+	//// lcm = 1024)
+	//// nominal_width and nominal_height specify the resolution that Mednafen should display
+	//// the framebuffer image in at 1x scaling, scaled from the dimensions of DisplayRect, and optionally the LineWidths array
+	//// passed through espec to the Emulate() function.
+	//int lcm_width;
+	//int lcm_height;
+	//int nominal_width;
+	//int nominal_height;
+	int fb_width;		// Width of the framebuffer(not necessarily width of the image).  MDFN_Surface width should be >= this.
+	int fb_height;		// Height of the framebuffer passed to the Emulate() function(not necessarily height of the image)
+
+	//last used render options
+	ShockRenderOptions opts;
+};
+
+
+struct ShockState
 {
- return PSX_PRNG.RandU32(mina, maxa);
+	bool power;
+	bool eject;
+};
+
+struct ShockPeripheral
+{
+	ePeripheralType type;
+	u8 buffer[32]; //must be larger than 16+3+1 or thereabouts because the dualshock writes some rumble data into it. bleck, ill fix it later
+	//TODO: test for multitap. does it need to be as large as 4 of whatever the single largest port would be?
+	//well, it must manage its own stuff.. its not like we feed in external data, right?
+	InputDevice* device;
+};
+
+static int addressToPortNum(int address)
+{
+	int portnum = SHOCK_INVALID_ADDRESS;
+	//WHY did I choose 1 indexed? I dunno, let's roll with it
+	if (address == 0x01) portnum = 0;
+	else if (address == 0x02) portnum = 1;
+	else if (address == 0x11) portnum = 2;
+	else if (address == 0x21) portnum = 3;
+	else if (address == 0x31) portnum = 4;
+	else if (address == 0x41) portnum = 5;
+	else if (address == 0x12) portnum = 6;
+	else if (address == 0x22) portnum = 7;
+	else if (address == 0x32) portnum = 8;
+	else if (address == 0x42) portnum = 9;
+	return portnum;
 }
 
-static std::vector<CDIF*> *cdifs = NULL;
-static std::vector<const char *> cdifs_scex_ids;
+struct ShockPeripheralState
+{
 
-static uint64 Memcard_PrevDC[8];
-static int64 Memcard_SaveDelay[8];
+	//"This is kind of redundant with the frontIO code, and should be merged with it eventually, when the configurability gets more advanced"
+	//I dunno.
 
-PS_CPU *CPU = NULL;
-PS_SPU *SPU = NULL;
-PS_GPU *GPU = NULL;
-PS_CDC *CDC = NULL;
-FrontIO *FIO = NULL;
+	ShockPeripheral ports[10];
 
-static MultiAccessSizeMem<512 * 1024, false> *BIOSROM = NULL;
-static MultiAccessSizeMem<65536, false> *PIOMem = NULL;
+	void Initialize()
+	{
+		for(int i=0;i<10;i++)
+		{
+			ports[i].type = ePeripheralType_None;
+			memset(ports[i].buffer,0,sizeof(ports[i].buffer));
+		}
+		reconstruct(PSX_I->FIO);
+	}
+
+	//TODO: "Take care to call ->Power() only if the device actually changed."
+	//(like, is this about savestates? seems silly"
+	s32 Connect(s32 address, s32 type)
+	{
+		int portnum = addressToPortNum(address);
+		if(portnum == SHOCK_INVALID_ADDRESS) return SHOCK_INVALID_ADDRESS;
 
-MultiAccessSizeMem<2048 * 1024, false> MainRAM;
+		//check whats already there
+		if(ports[portnum].type == ePeripheralType_None && type == ePeripheralType_None) return SHOCK_OK; //NOP
+		if(ports[portnum].type != ePeripheralType_None && type != ePeripheralType_None) return SHOCK_NOCANDO; //cant re-connect something without disconnecting first
+
+		//disconnecting:
+		if(type == ePeripheralType_None) {
+			ports[portnum].type = ePeripheralType_None;
+			memset(ports[portnum].buffer,0,sizeof(ports[portnum].buffer));
+			
+			//fall through to setup a nonexistent `next` for disconnecting, instead of returning now
+		}
 
-static uint32 TextMem_Start;
-static std::vector<uint8> TextMem;
+		//connecting:
+		InputDevice* next = nullptr;
+		switch(type)
+		{
+		case ePeripheralType_Pad: next = Device_Gamepad_Create(); break;
+		case ePeripheralType_DualShock: next = Device_DualShock_Create(); break;
+		case ePeripheralType_DualAnalog: next = Device_DualAnalog_Create(false); break;
+		case ePeripheralType_Multitap: next = new InputDevice_Multitap(); break;
+		case ePeripheralType_NegCon: next = Device_neGcon_Create(); break;
+		case ePeripheralType_None: next = new InputDevice(); break; //dummy
+			break;
+		default:
+			return SHOCK_ERROR;
+		}
+		ports[portnum].type = (ePeripheralType)type;
+		ports[portnum].device = next;
+		memset(ports[portnum].buffer,0,sizeof(ports[portnum].buffer));
+
+		if (portnum == 0 || portnum == 1)
+		{
+			PSX_I->FIO->Ports[portnum] = next;
+			PSX_I->FIO->PortData[portnum] = ports[portnum].buffer;
+		}
+		else {
+			//must be multitap child device
+			int portidx = (address & 0xF) - 1;
+			int subidx = (address >> 4) - 1;
+			auto tap = (InputDevice_Multitap*)PSX_I->FIO->Ports[portidx];
+			auto mcdummy = new InputDevice();
+			//next->
+			tap->SetSubDevice(subidx, next, mcdummy);
+		}
+
+		return SHOCK_OK;
+	}
+
+	s32 PollActive(s32 address, bool clear)
+	{
+		int portnum = addressToPortNum(address);
+		if (portnum == SHOCK_INVALID_ADDRESS) return SHOCK_INVALID_ADDRESS;
+
+		s32 ret = SHOCK_FALSE;
+
+		u8* buf = ports[portnum].buffer;
+		switch(ports[portnum].type)
+		{
+		case ePeripheralType_DualShock:
+			{
+				IO_Dualshock* io_dualshock = (IO_Dualshock*)buf;
+				if(io_dualshock->active) ret = SHOCK_TRUE;
+				if(clear) io_dualshock->active = 0;
+				return ret;
+				break;
+			}
+		case ePeripheralType_DualAnalog:
+			{
+				IO_DualAnalog* io_dualanalog = (IO_DualAnalog*)buf;
+				if(io_dualanalog->active) ret = SHOCK_TRUE;
+				if(clear) io_dualanalog->active = 0;
+				return ret;
+				break;
+			}
+		case ePeripheralType_Pad:
+			{
+				IO_Gamepad* io_gamepad = (IO_Gamepad*)buf;
+				if(io_gamepad->active) ret = SHOCK_TRUE;
+				if(clear) io_gamepad->active = 0;
+				return ret;
+				break;
+			}
+		case ePeripheralType_NegCon:
+		{
+			IO_NegCon* io_negcon = (IO_NegCon*)buf;
+			if (io_negcon->active) ret = SHOCK_TRUE;
+			if (clear) io_negcon->active = 0;
+			return ret;
+			break;
+		}
+
+		case ePeripheralType_None:
+			return SHOCK_NOCANDO;
+
+		default:
+			return SHOCK_ERROR;
+		}
+	}
+
+	s32 SetPadInput(s32 address, u32 buttons, u8 left_x, u8 left_y, u8 right_x, u8 right_y)
+	{
+		int portnum = addressToPortNum(address);
+		if (portnum == SHOCK_INVALID_ADDRESS) return SHOCK_INVALID_ADDRESS;
+
+		u8* buf = ports[portnum].buffer;
+		switch(ports[portnum].type)
+		{
+		case ePeripheralType_DualShock:
+			{
+				IO_Dualshock* io_dualshock = (IO_Dualshock*)buf;
+				io_dualshock->buttons[0] = (buttons>>0)&0xFF;
+				io_dualshock->buttons[1] = (buttons>>8)&0xFF;
+				io_dualshock->buttons[2] = (buttons>>16)&0xFF; //this is only the analog mode button
+				io_dualshock->right_x = right_x;
+				io_dualshock->right_y = right_y;
+				io_dualshock->left_x = left_x;
+				io_dualshock->left_y = left_y;
+				return SHOCK_OK;
+			}
+		case ePeripheralType_Pad:
+			{
+				IO_Gamepad* io_gamepad = (IO_Gamepad*)buf;
+				io_gamepad->buttons[0] = (buttons>>0)&0xFF;
+				io_gamepad->buttons[1] = (buttons>>8)&0xFF;
+				return SHOCK_OK;
+			}
+		case ePeripheralType_DualAnalog:
+			{
+				IO_DualAnalog* io_dualanalog = (IO_DualAnalog*)buf;
+				io_dualanalog->buttons[0] = (buttons>>0)&0xFF;
+				io_dualanalog->buttons[1] = (buttons>>8)&0xFF;
+				io_dualanalog->right_x = right_x;
+				io_dualanalog->right_y = right_y;
+				io_dualanalog->left_x = left_x;
+				io_dualanalog->left_y = left_y;
+				return SHOCK_OK;
+			}
+		case ePeripheralType_NegCon:
+			{
+				IO_NegCon* io_negcon = (IO_NegCon*)buf;
+				io_negcon->buttons[0] = (buttons >> 0) & 0xFF;
+				io_negcon->buttons[1] = (buttons >> 8) & 0xFF;
+				io_negcon->twist = left_x;
+				io_negcon->anabuttons[0] = left_y;
+				io_negcon->anabuttons[1] = right_x;
+				io_negcon->anabuttons[2] = right_y;
+				return SHOCK_OK;
+			}
+		
+		default:
+			return SHOCK_ERROR;
+		}
+	}
+
+	s32 MemcardTransact(s32 address, ShockMemcardTransaction* transaction)
+	{
+		int portnum = addressToPortNum(address);
+		if (portnum == SHOCK_INVALID_ADDRESS) return SHOCK_INVALID_ADDRESS;
+
+		//TODO - once we get flexible here, do some extra condition checks.. whether memcards exist, etc. much like devices.
+		switch(transaction->transaction)
+		{
+			case eShockMemcardTransaction_Connect: 
+				//cant connect when a memcard is already connected
+				if(!strcmp(PSX_I->FIO->MCPorts[portnum]->GetName(),"InputDevice_Memcard"))
+					return SHOCK_NOCANDO;
+				delete PSX_I->FIO->MCPorts[portnum]; //delete dummy
+				PSX_I->FIO->MCPorts[portnum] = Device_Memcard_Create();
+			
+			case eShockMemcardTransaction_Disconnect: 
+				return SHOCK_ERROR; //not supported yet
+
+			case eShockMemcardTransaction_Write:
+				PSX_I->FIO->MCPorts[portnum]->WriteNV((uint8*)transaction->buffer128k,0,128*1024);
+				PSX_I->FIO->MCPorts[portnum]->ResetNVDirtyCount();
+				return SHOCK_OK;
+
+			case eShockMemcardTransaction_Read:
+			{
+				const u8* ptr = PSX_I->FIO->MCPorts[portnum]->ReadNV();
+				memcpy(transaction->buffer128k,ptr,128*1024);
+				PSX_I->FIO->MCPorts[portnum]->ResetNVDirtyCount();
+				return SHOCK_OK;
+			}
+
+			case eShockMemcardTransaction_CheckDirty:
+				if(PSX_I->FIO->GetMemcardDirtyCount(portnum))
+					return SHOCK_TRUE;
+				else return SHOCK_FALSE;
+
+			default:
+				return SHOCK_ERROR;
+		}
+	}
+
+	void UpdateInput()
+	{
+		for(int i=0;i<10;i++)
+		{
+			for(unsigned i=0;i<ARRAY_SIZE(ports);i++)
+			{
+				if(ports[i].device)
+					ports[i].device->UpdateInput(ports[i].buffer);
+			}
+		}
+	}
+
+};
+
+//
+// Everything the rest of this file keeps for an instance; shock_Create allocates one, and PSX_S is whichever is current.
+//
+struct PSX_State : public PSX_Instance
+{
+ int16 *soundbuf; //1024 * 1024 samples. how big? big enough.
+ int VTBackBuffer;
+ MDFN_Rect VTDisplayRects[2];
+ bool PrevInterlaced;
+ Deinterlacer deint;
+ EmulateSpecStruct espec;
+
+ MDFN_PseudoRNG PSX_PRNG;
+
+ std::vector<CDIF*> *cdifs;
+ std::vector<const char *> cdifs_scex_ids;
+
+ uint64 Memcard_PrevDC[8];
+ int64 Memcard_SaveDelay[8];
+
+ MultiAccessSizeMem<512 * 1024, false> *BIOSROM;
+ MultiAccessSizeMem<65536, false> *PIOMem;
+
+ uint32 TextMem_Start;
+ std::vector<uint8> TextMem;
+
+ struct
+ {
+  union
+  {
+   struct
+   {
+    uint32 PIO_Base;	// 0x1f801000	// BIOS Init: 0x1f000000, Writeable bits: 0x00ffffff(assumed, verify), FixedOR = 0x1f000000
+    uint32 Unknown0;	// 0x1f801004	// BIOS Init: 0x1f802000, Writeable bits: 0x00ffffff, FixedOR = 0x1f000000
+    uint32 Unknown1;	// 0x1f801008	// BIOS Init: 0x0013243f, ????
+    uint32 Unknown2;	// 0x1f80100c	// BIOS Init: 0x00003022, Writeable bits: 0x2f1fffff, FixedOR = 0x00000000
+   
+    uint32 BIOS_Mapping;	// 0x1f801010	// BIOS Init: 0x0013243f, ????
+    uint32 SPU_Delay;	// 0x1f801014	// BIOS Init: 0x200931e1, Writeable bits: 0x2f1fffff, FixedOR = 0x00000000 - Affects bus timing on access to SPU
+    uint32 CDC_Delay;	// 0x1f801018	// BIOS Init: 0x00020843, Writeable bits: 0x2f1fffff, FixedOR = 0x00000000
+    uint32 Unknown4;	// 0x1f80101c	// BIOS Init: 0x00070777, ????
+    uint32 Unknown5;	// 0x1f801020	// BIOS Init: 0x00031125(but rewritten with other values often), Writeable bits: 0x0003ffff, FixedOR = 0x00000000 -- Possibly CDC related
+   };
+   uint32 Regs[9];
+  };
+ } SysControl;
+
+ unsigned DMACycleSteal;	// Doesn't need to be saved in save states, since it's recalculated in the ForceEventUpdates() call chain.
+
+ pscpu_timestamp_t Running;	// Set to -1 when not desiring exit, and 0 when we are.
+ event_list_entry events[PSX_EVENT__COUNT];
+
+ ShockConfig s_ShockConfig;
+ ShockState s_ShockState;
+
+ //where everything in a binary savestate lives, cached so sizing and saving don't need a full SyncState pass.
+ //has to be invalidated whenever something that gets saved is replaced, like a peripheral
+ EW::NewStateLayout s_StateLayout;
+
+ ShockPeripheralState s_ShockPeripheralState;
+
+ MDFN_Surface *VTBuffer[2];
+ int *VTLineWidths[2];
+ bool s_FramebufferNormalized;
+ int s_FramebufferCurrent;
+ int s_FramebufferCurrentWidth;
+
+ ShockDiscRef* s_CurrDisc;
+ ShockDiscInfo s_CurrDiscInfo;
+
+#ifdef PSX_PERF_COUNTERS
+ PSX_PerfCounters perf_counters;
+#endif
+
+ template<bool isReader> void SyncState(EW::NewState *ns);
+};
+
+thread_local PSX_Instance *PSX_I = NULL;
+
+#define PSX_S (*static_cast<PSX_State*>(PSX_I))
+
+uint32 PSX_GetRandU32(uint32 mina, uint32 maxa)
+{
+ return PSX_S.PSX_PRNG.RandU32(mina, maxa);
+}
 
 static const uint32 SysControl_Mask[9] = { 0x00ffffff, 0x00ffffff, 0xffffffff, 0x2f1fffff,
 					   0xffffffff, 0x2f1fffff, 0x2f1fffff, 0xffffffff,
@@ -199,68 +553,35 @@ static const uint32 SysControl_OR[9] = { 0x1f000000, 0x1f000000, 0x00000000, 0x0
 					 0x00000000, 0x00000000, 0x00000000, 0x00000000,
 					 0x00000000 };
 
-static struct
-{
- union
- {
-  struct
-  {
-   uint32 PIO_Base;	// 0x1f801000	// BIOS Init: 0x1f000000, Writeable bits: 0x00ffffff(assumed, verify), FixedOR = 0x1f000000
-   uint32 Unknown0;	// 0x1f801004	// BIOS Init: 0x1f802000, Writeable bits: 0x00ffffff, FixedOR = 0x1f000000
-   uint32 Unknown1;	// 0x1f801008	// BIOS Init: 0x0013243f, ????
-   uint32 Unknown2;	// 0x1f80100c	// BIOS Init: 0x00003022, Writeable bits: 0x2f1fffff, FixedOR = 0x00000000
-   
-   uint32 BIOS_Mapping;	// 0x1f801010	// BIOS Init: 0x0013243f, ????
-   uint32 SPU_Delay;	// 0x1f801014	// BIOS Init: 0x200931e1, Writeable bits: 0x2f1fffff, FixedOR = 0x00000000 - Affects bus timing on access to SPU
-   uint32 CDC_Delay;	// 0x1f801018	// BIOS Init: 0x00020843, Writeable bits: 0x2f1fffff, FixedOR = 0x00000000
-   uint32 Unknown4;	// 0x1f80101c	// BIOS Init: 0x00070777, ????
-   uint32 Unknown5;	// 0x1f801020	// BIOS Init: 0x00031125(but rewritten with other values often), Writeable bits: 0x0003ffff, FixedOR = 0x00000000 -- Possibly CDC related
-  };
-  uint32 Regs[9];
- };
-} SysControl;
 
-static unsigned DMACycleSteal = 0;	// Doesn't need to be saved in save states, since it's recalculated in the ForceEventUpdates() call chain.
 
 void PSX_SetDMACycleSteal(unsigned stealage)
 {
  if(stealage > 200)	// Due to 8-bit limitations in the CPU core.
   stealage = 200;
 
- DMACycleSteal = stealage;
+ PSX_S.DMACycleSteal = stealage;
 }
 
 //
 // Event stuff
 //
 
-static pscpu_timestamp_t Running;	// Set to -1 when not desiring exit, and 0 when we are.
-
-struct event_list_entry
-{
- uint32 which;
- pscpu_timestamp_t event_time;
- event_list_entry *prev;
- event_list_entry *next;
-};
-
-static event_list_entry events[PSX_EVENT__COUNT];
-
 static void EventReset(void)
 {
  for(unsigned i = 0; i < PSX_EVENT__COUNT; i++)
  {
-  events[i].which = i;
+  PSX_S.events[i].which = i;
 
   if(i == PSX_EVENT__SYNFIRST)
-   events[i].event_time = 0;
+   PSX_S.events[i].event_time = 0;
   else if(i == PSX_EVENT__SYNLAST)
-   events[i].event_time = 0x7FFFFFFF;
+   PSX_S.events[i].event_time = 0x7FFFFFFF;
   else
-   events[i].event_time = PSX_EVENT_MAXTS;
+   PSX_S.events[i].event_time = PSX_EVENT_MAXTS;
 
-  events[i].prev = (i > 0) ? &events[i - 1] : NULL;
-  events[i].next = (i < (PSX_EVENT__COUNT - 1)) ? &events[i + 1] : NULL;
+  PSX_S.events[i].prev = (i > 0) ? &PSX_S.events[i - 1] : NULL;
+  PSX_S.events[i].next = (i < (PSX_EVENT__COUNT - 1)) ? &PSX_S.events[i + 1] : NULL;
  }
 }
 
@@ -277,16 +598,16 @@ static void RebaseTS(const pscpu_timestamp_t timestamp)
   if(i == PSX_EVENT__SYNFIRST || i == PSX_EVENT__SYNLAST)
    continue;
 
-  assert(events[i].event_time > timestamp);
-  events[i].event_time -= timestamp;
+  assert(PSX_S.events[i].event_time > timestamp);
+  PSX_S.events[i].event_time -= timestamp;
  }
 
- CPU->SetEventNT(events[PSX_EVENT__SYNFIRST].next->event_time);
+ PSX_I->CPU->SetEventNT(PSX_S.events[PSX_EVENT__SYNFIRST].next->event_time);
 }
 
 void PSX_SetEventNT(const int type, const pscpu_timestamp_t next_timestamp)
 {
- event_list_entry *e = &events[type];
+ event_list_entry *e = &PSX_S.events[type];
 
  if(next_timestamp < e->event_time)
  {
@@ -332,27 +653,27 @@ void PSX_SetEventNT(const int type, const pscpu_timestamp_t next_timestamp)
   e->event_time = next_timestamp;
  }
 
- CPU->SetEventNT(events[PSX_EVENT__SYNFIRST].next->event_time & Running);
+ PSX_I->CPU->SetEventNT(PSX_S.events[PSX_EVENT__SYNFIRST].next->event_time & PSX_S.Running);
 }
 
 // Called from debug.cpp too.
 void ForceEventUpdates(const pscpu_timestamp_t timestamp)
 {
- PSX_SetEventNT(PSX_EVENT_GPU, GPU->Update(timestamp));
- PSX_SetEventNT(PSX_EVENT_CDC, CDC->Update(timestamp));
+ PSX_SetEventNT(PSX_EVENT_GPU, PSX_I->GPU->Update(timestamp));
+ PSX_SetEventNT(PSX_EVENT_CDC, PSX_I->CDC->Update(timestamp));
 
  PSX_SetEventNT(PSX_EVENT_TIMER, TIMER_Update(timestamp));
 
  PSX_SetEventNT(PSX_EVENT_DMA, DMA_Update(timestamp));
 
- PSX_SetEventNT(PSX_EVENT_FIO, FIO->Update(timestamp));
+ PSX_SetEventNT(PSX_EVENT_FIO, PSX_I->FIO->Update(timestamp));
 
- CPU->SetEventNT(events[PSX_EVENT__SYNFIRST].next->event_time);
+ PSX_I->CPU->SetEventNT(PSX_S.events[PSX_EVENT__SYNFIRST].next->event_time);
 }
 
 bool PSX_EventHandler(const pscpu_timestamp_t timestamp)
 {
- event_list_entry *e = events[PSX_EVENT__SYNFIRST].next;
+ event_list_entry *e = PSX_S.events[PSX_EVENT__SYNFIRST].next;
 
  while(timestamp >= e->event_time)	// If Running = 0, PSX_EventHandler() may be called even if there isn't an event per-se, so while() instead of do { ... } while
  {
@@ -364,11 +685,11 @@ bool PSX_EventHandler(const pscpu_timestamp_t timestamp)
    default: abort();
 
    case PSX_EVENT_GPU:
-	nt = GPU->Update(e->event_time);
+	nt = PSX_I->GPU->Update(e->event_time);
 	break;
 
    case PSX_EVENT_CDC:
-	nt = CDC->Update(e->event_time);
+	nt = PSX_I->CDC->Update(e->event_time);
 	break;
 
    case PSX_EVENT_TIMER:
@@ -380,7 +701,7 @@ bool PSX_EventHandler(const pscpu_timestamp_t timestamp)
 	break;
 
    case PSX_EVENT_FIO:
-	nt = FIO->Update(e->event_time);
+	nt = PSX_I->FIO->Update(e->event_time);
 	break;
   }
 #if PSX_EVENT_SYSTEM_CHECKS
@@ -393,14 +714,14 @@ bool PSX_EventHandler(const pscpu_timestamp_t timestamp)
   e = prev->next;
  }
 
- return(Running);
+ return(PSX_S.Running);
 }
 
 
 void PSX_RequestMLExit(void)
 {
- Running = 0;
- CPU->SetEventNT(0);
+ PSX_S.Running = 0;
+ PSX_I->CPU->SetEventNT(0);
 }
 
 
@@ -420,7 +741,7 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
  #endif
 
  if(!IsWrite)
-  timestamp += DMACycleSteal;
+  timestamp += PSX_S.DMACycleSteal;
 
  if(A < 0x00800000)
  {
@@ -436,16 +757,16 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
   if(Access24)
   {
    if(IsWrite)
-    MainRAM.WriteU24(A & 0x1FFFFF, V);
+    PSX_I->MainRAM->WriteU24(A & 0x1FFFFF, V);
    else
-    V = MainRAM.ReadU24(A & 0x1FFFFF);
+    V = PSX_I->MainRAM->ReadU24(A & 0x1FFFFF);
   }
   else
   {
    if(IsWrite)
-    MainRAM.Write<T>(A & 0x1FFFFF, V);
+    PSX_I->MainRAM->Write<T>(A & 0x1FFFFF, V);
    else
-    V = MainRAM.Read<T>(A & 0x1FFFFF);
+    V = PSX_I->MainRAM->Read<T>(A & 0x1FFFFF);
   }
 
   return;
@@ -456,15 +777,15 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
   if(!IsWrite)
   {
    if(Access24)
-    V = BIOSROM->ReadU24(A & 0x7FFFF);
+    V = PSX_S.BIOSROM->ReadU24(A & 0x7FFFF);
    else
-    V = BIOSROM->Read<T>(A & 0x7FFFF);
+    V = PSX_S.BIOSROM->Read<T>(A & 0x7FFFF);
   }
 
   return;
  }
 
- if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
+ if(timestamp >= PSX_S.events[PSX_EVENT__SYNFIRST].next->event_time)
   PSX_EventHandler(timestamp);
 
  if(A >= 0x1F801000 && A <= 0x1F802FFF)
@@ -485,19 +806,19 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
      //if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
      // PSX_EventHandler(timestamp);
 
-     SPU->Write(timestamp, A | 0, V);
-     SPU->Write(timestamp, A | 2, V >> 16);
+     PSX_I->SPU->Write(timestamp, A | 0, V);
+     PSX_I->SPU->Write(timestamp, A | 2, V >> 16);
     }
     else
     {
      timestamp += 36;
 
-     if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
+     if(timestamp >= PSX_S.events[PSX_EVENT__SYNFIRST].next->event_time)
       PSX_EventHandler(timestamp);
 
 		 //0.9.36.5 - clarified read order by turning into two statements
-     V = SPU->Read(timestamp, A);
-     V |= SPU->Read(timestamp, A | 2) << 16;
+     V = PSX_I->SPU->Read(timestamp, A);
+     V |= PSX_I->SPU->Read(timestamp, A | 2) << 16;
     }
    }
    else
@@ -509,16 +830,16 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
      //if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
      // PSX_EventHandler(timestamp);
 
-     SPU->Write(timestamp, A & ~1, V);
+     PSX_I->SPU->Write(timestamp, A & ~1, V);
     }
     else
     {
      timestamp += 16; // Just a guess, need to test.
 
-     if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
+     if(timestamp >= PSX_S.events[PSX_EVENT__SYNFIRST].next->event_time)
       PSX_EventHandler(timestamp);
 
-     V = SPU->Read(timestamp, A & ~1);
+     V = PSX_I->SPU->Read(timestamp, A & ~1);
     }
    }
    return;
@@ -534,9 +855,9 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
    }
 
    if(IsWrite)
-    CDC->Write(timestamp, A & 0x3, V);
+    PSX_I->CDC->Write(timestamp, A & 0x3, V);
    else
-    V = CDC->Read(timestamp, A & 0x3);
+    V = PSX_I->CDC->Read(timestamp, A & 0x3);
 
    return;
   }
@@ -547,9 +868,9 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
     timestamp++;
 
    if(IsWrite)
-    GPU->Write(timestamp, A, V);
+    PSX_I->GPU->Write(timestamp, A, V);
    else
-    V = GPU->Read(timestamp, A);
+    V = PSX_I->GPU->Read(timestamp, A);
 
    return;
   }
@@ -564,7 +885,7 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
 		 if (A == 0x1F801820)
 		 {
 			 //per pcsx-rr:
-			 GpuFrameForLag = true;
+			 PSX_I->GpuFrameForLag = true;
 		 }
 		 MDEC_Write(timestamp, A, V);
 	 }
@@ -587,11 +908,11 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
    if(IsWrite)
    {
     V <<= (A & 3) * 8;
-    SysControl.Regs[index] = V & SysControl_Mask[index];
+    PSX_S.SysControl.Regs[index] = V & SysControl_Mask[index];
    }
    else
    {
-    V = SysControl.Regs[index] | SysControl_OR[index];
+    V = PSX_S.SysControl.Regs[index] | SysControl_OR[index];
     V >>= (A & 3) * 8;
    }
    return;
@@ -603,9 +924,9 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
     timestamp++;
 
    if(IsWrite)
-    FIO->Write(timestamp, A, V);
+    PSX_I->FIO->Write(timestamp, A, V);
    else
-    V = FIO->Read(timestamp, A);
+    V = PSX_I->FIO->Read(timestamp, A);
    return;
   }
 
@@ -697,24 +1018,24 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
 
    V = ~0U;	// A game this affects:  Tetris with Cardcaptor Sakura
 
-   if(PIOMem)
+   if(PSX_S.PIOMem)
    {
     if((A & 0x7FFFFF) < 65536)
     {
      if(Access24)
-      V = PIOMem->ReadU24(A & 0x7FFFFF);
+      V = PSX_S.PIOMem->ReadU24(A & 0x7FFFFF);
      else
-      V = PIOMem->Read<T>(A & 0x7FFFFF);
+      V = PSX_S.PIOMem->Read<T>(A & 0x7FFFFF);
     }
-    else if((A & 0x7FFFFF) < (65536 + TextMem.size()))
+    else if((A & 0x7FFFFF) < (65536 + PSX_S.TextMem.size()))
     {
      if(Access24)
-      V = MDFN_de24lsb(&TextMem[(A & 0x7FFFFF) - 65536]);
+      V = MDFN_de24lsb(&PSX_S.TextMem[(A & 0x7FFFFF) - 65536]);
      else switch(sizeof(T))
      {
-      case 1: V = TextMem[(A & 0x7FFFFF) - 65536]; break;
-      case 2: V = MDFN_de16lsb<false>(&TextMem[(A & 0x7FFFFF) - 65536]); break;
-      case 4: V = MDFN_de32lsb<false>(&TextMem[(A & 0x7FFFFF) - 65536]); break;
+      case 1: V = PSX_S.TextMem[(A & 0x7FFFFF) - 65536]; break;
+      case 2: V = MDFN_de16lsb<false>(&PSX_S.TextMem[(A & 0x7FFFFF) - 65536]); break;
+      case 4: V = MDFN_de32lsb<false>(&PSX_S.TextMem[(A & 0x7FFFFF) - 65536]); break;
      }
     }
    }
@@ -725,9 +1046,9 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
  if(A == 0xFFFE0130) // Per tests on PS1, ignores the access(sort of, on reads the value is forced to 0 if not aligned) if not aligned to 4-bytes.
  {
   if(!IsWrite)
-   V = CPU->GetBIU();
+   V = PSX_I->CPU->GetBIU();
   else
-   CPU->SetBIU(V);
+   PSX_I->CPU->SetBIU(V);
 
   return;
  }
@@ -804,17 +1125,17 @@ template<typename T, bool Access24> static INLINE uint32 MemPeek(pscpu_timestamp
  if(A < 0x00800000)
  {
   if(Access24)
-   return(MainRAM.ReadU24(A & 0x1FFFFF));
+   return(PSX_I->MainRAM->ReadU24(A & 0x1FFFFF));
   else
-   return(MainRAM.Read<T>(A & 0x1FFFFF));
+   return(PSX_I->MainRAM->Read<T>(A & 0x1FFFFF));
  }
 
  if(A >= 0x1FC00000 && A <= 0x1FC7FFFF)
  {
   if(Access24)
-   return(BIOSROM->ReadU24(A & 0x7FFFF));
+   return(PSX_S.BIOSROM->ReadU24(A & 0x7FFFF));
   else
-   return(BIOSROM->Read<T>(A & 0x7FFFF));
+   return(PSX_S.BIOSROM->Read<T>(A & 0x7FFFF));
  }
 
  if(A >= 0x1F801000 && A <= 0x1F802FFF)
@@ -848,7 +1169,7 @@ template<typename T, bool Access24> static INLINE uint32 MemPeek(pscpu_timestamp
   if(A >= 0x1F801000 && A <= 0x1F801023)
   {
    unsigned index = (A & 0x1F) >> 2;
-   return((SysControl.Regs[index] | SysControl_OR[index]) >> ((A & 3) * 8));
+   return((PSX_S.SysControl.Regs[index] | SysControl_OR[index]) >> ((A & 3) * 8));
   }
 
   if(A >= 0x1F801040 && A <= 0x1F80104F)
@@ -886,24 +1207,24 @@ template<typename T, bool Access24> static INLINE uint32 MemPeek(pscpu_timestamp
 
  if(A >= 0x1F000000 && A <= 0x1F7FFFFF)
  {
-  if(PIOMem)
+  if(PSX_S.PIOMem)
   {
    if((A & 0x7FFFFF) < 65536)
    {
     if(Access24)
-     return(PIOMem->ReadU24(A & 0x7FFFFF));
+     return(PSX_S.PIOMem->ReadU24(A & 0x7FFFFF));
     else
-     return(PIOMem->Read<T>(A & 0x7FFFFF));
+     return(PSX_S.PIOMem->Read<T>(A & 0x7FFFFF));
    }
-   else if((A & 0x7FFFFF) < (65536 + TextMem.size()))
+   else if((A & 0x7FFFFF) < (65536 + PSX_S.TextMem.size()))
    {
     if(Access24)
-     return(MDFN_de24lsb(&TextMem[(A & 0x7FFFFF) - 65536]));
+     return(MDFN_de24lsb(&PSX_S.TextMem[(A & 0x7FFFFF) - 65536]));
     else switch(sizeof(T))
     {
-     case 1: return(TextMem[(A & 0x7FFFFF) - 65536]); break;
-     case 2: return(MDFN_de16lsb<false>(&TextMem[(A & 0x7FFFFF) - 65536])); break;
-     case 4: return(MDFN_de32lsb<false>(&TextMem[(A & 0x7FFFFF) - 65536])); break;
+     case 1: return(PSX_S.TextMem[(A & 0x7FFFFF) - 65536]); break;
+     case 2: return(MDFN_de16lsb<false>(&PSX_S.TextMem[(A & 0x7FFFFF) - 65536])); break;
+     case 4: return(MDFN_de32lsb<false>(&PSX_S.TextMem[(A & 0x7FFFFF) - 65536])); break;
     }
    }
   }
@@ -911,7 +1232,7 @@ template<typename T, bool Access24> static INLINE uint32 MemPeek(pscpu_timestamp
  }
 
  if(A == 0xFFFE0130)
-  return CPU->GetBIU();
+  return PSX_I->CPU->GetBIU();
 
  return(0);
 }
@@ -936,9 +1257,9 @@ template<typename T, bool Access24> static INLINE void MemPoke(pscpu_timestamp_t
  if(A < 0x00800000)
  {
   if(Access24)
-   MainRAM.WriteU24(A & 0x1FFFFF, V);
+   PSX_I->MainRAM->WriteU24(A & 0x1FFFFF, V);
   else
-   MainRAM.Write<T>(A & 0x1FFFFF, V);
+   PSX_I->MainRAM->Write<T>(A & 0x1FFFFF, V);
 
   return;
  }
@@ -946,9 +1267,9 @@ template<typename T, bool Access24> static INLINE void MemPoke(pscpu_timestamp_t
  if(A >= 0x1FC00000 && A <= 0x1FC7FFFF)
  {
   if(Access24)
-   BIOSROM->WriteU24(A & 0x7FFFF, V);
+   PSX_S.BIOSROM->WriteU24(A & 0x7FFFF, V);
   else
-   BIOSROM->Write<T>(A & 0x7FFFF, V);
+   PSX_S.BIOSROM->Write<T>(A & 0x7FFFF, V);
 
   return;
  }
@@ -958,14 +1279,14 @@ template<typename T, bool Access24> static INLINE void MemPoke(pscpu_timestamp_t
   if(A >= 0x1F801000 && A <= 0x1F801023)
   {
    unsigned index = (A & 0x1F) >> 2;
-   SysControl.Regs[index] = (V << ((A & 3) * 8)) & SysControl_Mask[index];
+   PSX_S.SysControl.Regs[index] = (V << ((A & 3) * 8)) & SysControl_Mask[index];
    return;
   }
  }
 
  if(A == 0xFFFE0130)
  {
-  CPU->SetBIU(V);
+  PSX_I->CPU->SetBIU(V);
   return;
  }
 }
@@ -985,382 +1306,110 @@ void PSX_MemPoke32(uint32 A, uint32 V)
  MemPoke<uint32, false>(0, A, V);
 }
 
-static void PSX_Power(bool powering_up)
-{
- PSX_PRNG.ResetState();	// Should occur first!
-
- memset(MainRAM.data8, 0, 2048 * 1024);
-
- for(unsigned i = 0; i < 9; i++)
-  SysControl.Regs[i] = 0;
-
- CPU->Power();
-
- EventReset();
-
- TIMER_Power();
-
- DMA_Power();
-
- FIO->Reset(powering_up);
- SIO_Power();
-
- MDEC_Power();
- CDC->Power();
- GPU->Power();
- //SPU->Power();	// Called from CDC->Power()
- IRQ_Power();
-
- ForceEventUpdates(0);
-
- deint.ClearState();
-}
-
-
-void PSX_GPULineHook(const pscpu_timestamp_t timestamp, const pscpu_timestamp_t line_timestamp, bool vsync, uint32 *pixels, const MDFN_PixelFormat* const format, const unsigned width, const unsigned pix_clock_offset, const unsigned pix_clock, const unsigned pix_clock_divider)
-{
- FIO->GPULineHook(timestamp, line_timestamp, vsync, pixels, format, width, pix_clock_offset, pix_clock, pix_clock_divider);
-}
-
-}
-
-using namespace MDFN_IEN_PSX;
-
-struct ShockConfig
-{
-	//// multires is a hint that, if set, indicates that the system has fairly programmable video modes(particularly, the ability
-	//// to display multiple horizontal resolutions, such as the PCE, PC-FX, or Genesis).  In practice, it will cause the driver
-	//// code to set the linear interpolation on by default. (TRUE for psx)
-	//// lcm_width and lcm_height are the least common multiples of all possible
-	//// resolutions in the frame buffer as specified by DisplayRect/LineWidths(Ex for PCE: widths of 256, 341.333333, 512,
-	//// lcm = 1024)
-	//// nominal_width and nominal_height specify the resolution that Mednafen should display
-	//// the framebuffer image in at 1x scaling, scaled from the dimensions of DisplayRect, and optionally the LineWidths array
-	//// passed through espec to the Emulate() function.
-	//int lcm_width;
-	//int lcm_height;
-	//int nominal_width;
-	//int nominal_height;
-	int fb_width;		// Width of the framebuffer(not necessarily width of the image).  MDFN_Surface width should be >= this.
-	int fb_height;		// Height of the framebuffer passed to the Emulate() function(not necessarily height of the image)
-
-	//last used render options
-	ShockRenderOptions opts;
-} s_ShockConfig;
-
-
-struct ShockState
-{
-	bool power;
-	bool eject;
-} s_ShockState;
-
-
-struct ShockPeripheral
-{
-	ePeripheralType type;
-	u8 buffer[32]; //must be larger than 16+3+1 or thereabouts because the dualshock writes some rumble data into it. bleck, ill fix it later
-	//TODO: test for multitap. does it need to be as large as 4 of whatever the single largest port would be?
-	//well, it must manage its own stuff.. its not like we feed in external data, right?
-	InputDevice* device;
-};
-
-static int addressToPortNum(int address)
-{
-	int portnum = SHOCK_INVALID_ADDRESS;
-	//WHY did I choose 1 indexed? I dunno, let's roll with it
-	if (address == 0x01) portnum = 0;
-	else if (address == 0x02) portnum = 1;
-	else if (address == 0x11) portnum = 2;
-	else if (address == 0x21) portnum = 3;
-	else if (address == 0x31) portnum = 4;
-	else if (address == 0x41) portnum = 5;
-	else if (address == 0x12) portnum = 6;
-	else if (address == 0x22) portnum = 7;
-	else if (address == 0x32) portnum = 8;
-	else if (address == 0x42) portnum = 9;
-	return portnum;
-}
-
-struct {
-
-	//"This is kind of redundant with the frontIO code, and should be merged with it eventually, when the configurability gets more advanced"
-	//I dunno.
-
-	ShockPeripheral ports[10];
-
-	void Initialize()
-	{
-		for(int i=0;i<10;i++)
-		{
-			ports[i].type = ePeripheralType_None;
-			memset(ports[i].buffer,0,sizeof(ports[i].buffer));
-		}
-		reconstruct(FIO);
-	}
-
-	//TODO: "Take care to call ->Power() only if the device actually changed."
-	//(like, is this about savestates? seems silly"
-	s32 Connect(s32 address, s32 type)
-	{
-		int portnum = addressToPortNum(address);
-		if(portnum == SHOCK_INVALID_ADDRESS) return SHOCK_INVALID_ADDRESS;
-
-		//check whats already there
-		if(ports[portnum].type == ePeripheralType_None && type == ePeripheralType_None) return SHOCK_OK; //NOP
-		if(ports[portnum].type != ePeripheralType_None && type != ePeripheralType_None) return SHOCK_NOCANDO; //cant re-connect something without disconnecting first
-
-		//disconnecting:
-		if(type == ePeripheralType_None) {
-			ports[portnum].type = ePeripheralType_None;
-			memset(ports[portnum].buffer,0,sizeof(ports[portnum].buffer));
-			
-			//fall through to setup a nonexistent `next` for disconnecting, instead of returning now
-		}
-
-		//connecting:
-		InputDevice* next = nullptr;
-		switch(type)
-		{
-		case ePeripheralType_Pad: next = Device_Gamepad_Create(); break;
-		case ePeripheralType_DualShock: next = Device_DualShock_Create(); break;
-		case ePeripheralType_DualAnalog: next = Device_DualAnalog_Create(false); break;
-		case ePeripheralType_Multitap: next = new InputDevice_Multitap(); break;
-		case ePeripheralType_NegCon: next = Device_neGcon_Create(); break;
-		case ePeripheralType_None: next = new InputDevice(); break; //dummy
-			break;
-		default:
-			return SHOCK_ERROR;
-		}
-		ports[portnum].type = (ePeripheralType)type;
-		ports[portnum].device = next;
-		memset(ports[portnum].buffer,0,sizeof(ports[portnum].buffer));
-
-		if (portnum == 0 || portnum == 1)
-		{
-			FIO->Ports[portnum] = next;
-			FIO->PortData[portnum] = ports[portnum].buffer;
-		}
-		else {
-			//must be multitap child device
-			int portidx = (address & 0xF) - 1;
-			int subidx = (address >> 4) - 1;
-			auto tap = (InputDevice_Multitap*)FIO->Ports[portidx];
-			auto mcdummy = new InputDevice();
-			//next->
-			tap->SetSubDevice(subidx, next, mcdummy);
-		}
+static void PSX_Power(bool powering_up)
+{
+ PSX_S.PSX_PRNG.ResetState();	// Should occur first!
 
-		return SHOCK_OK;
-	}
+ memset(PSX_I->MainRAM->data8, 0, 2048 * 1024);
 
-	s32 PollActive(s32 address, bool clear)
-	{
-		int portnum = addressToPortNum(address);
-		if (portnum == SHOCK_INVALID_ADDRESS) return SHOCK_INVALID_ADDRESS;
+ for(unsigned i = 0; i < 9; i++)
+  PSX_S.SysControl.Regs[i] = 0;
 
-		s32 ret = SHOCK_FALSE;
+ PSX_I->CPU->Power();
 
-		u8* buf = ports[portnum].buffer;
-		switch(ports[portnum].type)
-		{
-		case ePeripheralType_DualShock:
-			{
-				IO_Dualshock* io_dualshock = (IO_Dualshock*)buf;
-				if(io_dualshock->active) ret = SHOCK_TRUE;
-				if(clear) io_dualshock->active = 0;
-				return ret;
-				break;
-			}
-		case ePeripheralType_DualAnalog:
-			{
-				IO_DualAnalog* io_dualanalog = (IO_DualAnalog*)buf;
-				if(io_dualanalog->active) ret = SHOCK_TRUE;
-				if(clear) io_dualanalog->active = 0;
-				return ret;
-				break;
-			}
-		case ePeripheralType_Pad:
-			{
-				IO_Gamepad* io_gamepad = (IO_Gamepad*)buf;
-				if(io_gamepad->active) ret = SHOCK_TRUE;
-				if(clear) io_gamepad->active = 0;
-				return ret;
-				break;
-			}
-		case ePeripheralType_NegCon:
-		{
-			IO_NegCon* io_negcon = (IO_NegCon*)buf;
-			if (io_negcon->active) ret = SHOCK_TRUE;
-			if (clear) io_negcon->active = 0;
-			return ret;
-			break;
-		}
+ EventReset();
 
-		case ePeripheralType_None:
-			return SHOCK_NOCANDO;
+ TIMER_Power();
 
-		default:
-			return SHOCK_ERROR;
-		}
-	}
+ DMA_Power();
 
-	s32 SetPadInput(s32 address, u32 buttons, u8 left_x, u8 left_y, u8 right_x, u8 right_y)
-	{
-		int portnum = addressToPortNum(address);
-		if (portnum == SHOCK_INVALID_ADDRESS) return SHOCK_INVALID_ADDRESS;
+ PSX_I->FIO->Reset(powering_up);
+ SIO_Power();
 
-		u8* buf = ports[portnum].buffer;
-		switch(ports[portnum].type)
-		{
-		case ePeripheralType_DualShock:
-			{
-				IO_Dualshock* io_dualshock = (IO_Dualshock*)buf;
-				io_dualshock->buttons[0] = (buttons>>0)&0xFF;
-				io_dualshock->buttons[1] = (buttons>>8)&0xFF;
-				io_dualshock->buttons[2] = (buttons>>16)&0xFF; //this is only the analog mode button
-				io_dualshock->right_x = right_x;
-				io_dualshock->right_y = right_y;
-				io_dualshock->left_x = left_x;
-				io_dualshock->left_y = left_y;
-				return SHOCK_OK;
-			}
-		case ePeripheralType_Pad:
-			{
-				IO_Gamepad* io_gamepad = (IO_Gamepad*)buf;
-				io_gamepad->buttons[0] = (buttons>>0)&0xFF;
-				io_gamepad->buttons[1] = (buttons>>8)&0xFF;
-				return SHOCK_OK;
-			}
-		case ePeripheralType_DualAnalog:
-			{
-				IO_DualAnalog* io_dualanalog = (IO_DualAnalog*)buf;
-				io_dualanalog->buttons[0] = (buttons>>0)&0xFF;
-				io_dualanalog->buttons[1] = (buttons>>8)&0xFF;
-				io_dualanalog->right_x = right_x;
-				io_dualanalog->right_y = right_y;
-				io_dualanalog->left_x = left_x;
-				io_dualanalog->left_y = left_y;
-				return SHOCK_OK;
-			}
-		case ePeripheralType_NegCon:
-			{
-				IO_NegCon* io_negcon = (IO_NegCon*)buf;
-				io_negcon->buttons[0] = (buttons >> 0) & 0xFF;
-				io_negcon->buttons[1] = (buttons >> 8) & 0xFF;
-				io_negcon->twist = left_x;
-				io_negcon->anabuttons[0] = left_y;
-				io_negcon->anabuttons[1] = right_x;
-				io_negcon->anabuttons[2] = right_y;
-				return SHOCK_OK;
-			}
-		
-		default:
-			return SHOCK_ERROR;
-		}
-	}
+ MDEC_Power();
+ PSX_I->CDC->Power();
+ PSX_I->GPU->Power();
+ //SPU->Power();	// Called from CDC->Power()
+ IRQ_Power();
 
-	s32 MemcardTransact(s32 address, ShockMemcardTransaction* transaction)
-	{
-		int portnum = addressToPortNum(address);
-		if (portnum == SHOCK_INVALID_ADDRESS) return SHOCK_INVALID_ADDRESS;
+ ForceEventUpdates(0);
 
-		//TODO - once we get flexible here, do some extra condition checks.. whether memcards exist, etc. much like devices.
-		switch(transaction->transaction)
-		{
-			case eShockMemcardTransaction_Connect: 
-				//cant connect when a memcard is already connected
-				if(!strcmp(FIO->MCPorts[portnum]->GetName(),"InputDevice_Memcard"))
-					return SHOCK_NOCANDO;
-				delete FIO->MCPorts[portnum]; //delete dummy
-				FIO->MCPorts[portnum] = Device_Memcard_Create();
-			
-			case eShockMemcardTransaction_Disconnect: 
-				return SHOCK_ERROR; //not supported yet
-
-			case eShockMemcardTransaction_Write:
-				FIO->MCPorts[portnum]->WriteNV((uint8*)transaction->buffer128k,0,128*1024);
-				FIO->MCPorts[portnum]->ResetNVDirtyCount();
-				return SHOCK_OK;
-
-			case eShockMemcardTransaction_Read:
-			{
-				const u8* ptr = FIO->MCPorts[portnum]->ReadNV();
-				memcpy(transaction->buffer128k,ptr,128*1024);
-				FIO->MCPorts[portnum]->ResetNVDirtyCount();
-				return SHOCK_OK;
-			}
-
-			case eShockMemcardTransaction_CheckDirty:
-				if(FIO->GetMemcardDirtyCount(portnum))
-					return SHOCK_TRUE;
-				else return SHOCK_FALSE;
+ PSX_S.deint.ClearState();
+}
 
-			default:
-				return SHOCK_ERROR;
-		}
-	}
 
-	void UpdateInput()
-	{
-		for(int i=0;i<10;i++)
-		{
-			for(int i=0;i<ARRAY_SIZE(ports);i++)
-			{
-				if(ports[i].device)
-					ports[i].device->UpdateInput(ports[i].buffer);
-			}
-		}
-	}
+void PSX_GPULineHook(const pscpu_timestamp_t timestamp, const pscpu_timestamp_t line_timestamp, bool vsync, uint32 *pixels, const MDFN_PixelFormat* const format, const unsigned width, const unsigned pix_clock_offset, const unsigned pix_clock, const unsigned pix_clock_divider)
+{
+ PSX_I->FIO->GPULineHook(timestamp, line_timestamp, vsync, pixels, format, width, pix_clock_offset, pix_clock, pix_clock_divider);
+}
+
+}
+
+using namespace MDFN_IEN_PSX;
+
+//the handle given out by shock_Create is the instance itself.  every export starts by making it the calling thread's current instance,
+//and puts back whatever was current before on the way out, in case a frontend callback re-entered the core with another instance
+class ShockBinding
+{
+public:
+	ShockBinding(PSX_Instance* instance) : prev(PSX_I) { PSX_I = instance; }
+	~ShockBinding() { PSX_I = prev; }
+
+private:
+	PSX_Instance* const prev;
+};
+
+#define SHOCK_CHECK_HANDLE(psx) if(!(psx) || !((PSX_Instance*)(psx))->CPU) return SHOCK_NOCANDO; ShockBinding shock_binding((PSX_Instance*)(psx))
+
 
-} s_ShockPeripheralState;
 
 EW_EXPORT s32 shock_Peripheral_Connect(void* psx, s32 address, s32 type)
 {
-	return s_ShockPeripheralState.Connect(address, type);
+	SHOCK_CHECK_HANDLE(psx);
+	PSX_S.s_StateLayout.Invalidate();
+	return PSX_S.s_ShockPeripheralState.Connect(address, type);
 }
 
 EW_EXPORT s32 shock_Peripheral_SetPadInput(void* psx, s32 address, u32 buttons, u8 left_x, u8 left_y, u8 right_x, u8 right_y)
 {
-	return s_ShockPeripheralState.SetPadInput(address, buttons, left_x, left_y, right_x, right_y);
+	SHOCK_CHECK_HANDLE(psx);
+	return PSX_S.s_ShockPeripheralState.SetPadInput(address, buttons, left_x, left_y, right_x, right_y);
 }
 
 EW_EXPORT s32 shock_Peripheral_PollActive(void* psx, s32 address, s32 clear)
 {
-	return s_ShockPeripheralState.PollActive(address, clear!=SHOCK_FALSE);
+	SHOCK_CHECK_HANDLE(psx);
+	return PSX_S.s_ShockPeripheralState.PollActive(address, clear!=SHOCK_FALSE);
 }
 
 EW_EXPORT s32 shock_Peripheral_MemcardTransact(void* psx, s32 address, ShockMemcardTransaction* transaction)
 {
-	return s_ShockPeripheralState.MemcardTransact(address, transaction);
+	SHOCK_CHECK_HANDLE(psx);
+	return PSX_S.s_ShockPeripheralState.MemcardTransact(address, transaction);
 }
 
 static void MountCPUAddressSpace()
 {
 	for(uint32 ma = 0x00000000; ma < 0x00800000; ma += 2048 * 1024)
 	{
-		CPU->SetFastMap(MainRAM.data8, 0x00000000 + ma, 2048 * 1024);
-		CPU->SetFastMap(MainRAM.data8, 0x80000000 + ma, 2048 * 1024);
-		CPU->SetFastMap(MainRAM.data8, 0xA0000000 + ma, 2048 * 1024);
+		PSX_I->CPU->SetFastMap(PSX_I->MainRAM->data8, 0x00000000 + ma, 2048 * 1024);
+		PSX_I->CPU->SetFastMap(PSX_I->MainRAM->data8, 0x80000000 + ma, 2048 * 1024);
+		PSX_I->CPU->SetFastMap(PSX_I->MainRAM->data8, 0xA0000000 + ma, 2048 * 1024);
 	}
 
-	CPU->SetFastMap(BIOSROM->data8, 0x1FC00000, 512 * 1024);
-	CPU->SetFastMap(BIOSROM->data8, 0x9FC00000, 512 * 1024);
-	CPU->SetFastMap(BIOSROM->data8, 0xBFC00000, 512 * 1024);
+	PSX_I->CPU->SetFastMap(PSX_S.BIOSROM->data8, 0x1FC00000, 512 * 1024);
+	PSX_I->CPU->SetFastMap(PSX_S.BIOSROM->data8, 0x9FC00000, 512 * 1024);
+	PSX_I->CPU->SetFastMap(PSX_S.BIOSROM->data8, 0xBFC00000, 512 * 1024);
 
-	if(PIOMem)
+	if(PSX_S.PIOMem)
 	{
-		CPU->SetFastMap(PIOMem->data8, 0x1F000000, 65536);
-		CPU->SetFastMap(PIOMem->data8, 0x9F000000, 65536);
-		CPU->SetFastMap(PIOMem->data8, 0xBF000000, 65536);
+		PSX_I->CPU->SetFastMap(PSX_S.PIOMem->data8, 0x1F000000, 65536);
+		PSX_I->CPU->SetFastMap(PSX_S.PIOMem->data8, 0x9F000000, 65536);
+		PSX_I->CPU->SetFastMap(PSX_S.PIOMem->data8, 0xBF000000, 65536);
 	}
 }
 
-static MDFN_Surface *VTBuffer[2] = { NULL, NULL };
-static int *VTLineWidths[2] = { NULL, NULL };
-static bool s_FramebufferNormalized;
-static int s_FramebufferCurrent;
-static int s_FramebufferCurrentWidth;
+static void Cleanup(void);
 
 EW_EXPORT s32 shock_Create(void** psx, s32 region, void* firmware512k)
 {
@@ -1370,56 +1419,88 @@ EW_EXPORT s32 shock_Create(void** psx, s32 region, void* firmware512k)
 	
 	*psx = NULL;
 
+	PSX_State* const instance = new PSX_State();
+	ShockBinding binding(instance);
+
+#ifdef PSX_PERF_COUNTERS
+	PSX_I->perf = &PSX_S.perf_counters;
+#endif
+
 	//PIO Mem: why wouldn't we want this?
 	static const bool WantPIOMem = true;
 
-	BIOSROM = new MultiAccessSizeMem<512 * 1024, false>();
-	memcpy(BIOSROM->data8, firmware512k, 512 * 1024);
+	PSX_I->MainRAM = new MultiAccessSizeMem<2048 * 1024, false>();
+	PSX_S.soundbuf = new int16[1024 * 1024];
+
+	PSX_S.BIOSROM = new MultiAccessSizeMem<512 * 1024, false>();
+	memcpy(PSX_S.BIOSROM->data8, firmware512k, 512 * 1024);
 
-	if(WantPIOMem) PIOMem = new MultiAccessSizeMem<65536, false>();
-	else PIOMem = NULL;
+	if(WantPIOMem) PSX_S.PIOMem = new MultiAccessSizeMem<65536, false>();
+	else PSX_S.PIOMem = NULL;
 
-	CPU = new PS_CPU();
-	SPU = new PS_SPU();
-	CDC = new PS_CDC();
 	DMA_Init();
+	IRQ_Init();
+	MDEC_Init();
+	SIO_Init();
+	TIMER_Init();
+
+	PSX_I->CPU = new PS_CPU();
+	PSX_I->SPU = new PS_SPU();
+	PSX_I->CDC = new PS_CDC();
 
 	//these steps can't be done without more information
-	GPU = new PS_GPU(region == REGION_EU);
+	PSX_I->GPU = new PS_GPU(region == REGION_EU);
 
 	//setup gpu output surfaces
 	MDFN_PixelFormat nf(MDFN_COLORSPACE_RGB, 16, 8, 0, 24);
 	for(int i=0;i<2;i++)
 	{
-		VTBuffer[i] = new MDFN_Surface(NULL, FB_WIDTH, FB_HEIGHT, FB_WIDTH, nf);
-		VTLineWidths[i] = (int *)calloc(FB_HEIGHT, sizeof(int));
+		PSX_S.VTBuffer[i] = new MDFN_Surface(NULL, FB_WIDTH, FB_HEIGHT, FB_WIDTH, nf);
+		PSX_S.VTLineWidths[i] = (int *)calloc(FB_HEIGHT, sizeof(int));
 	}
 
-	FIO = new FrontIO();
-	s_ShockPeripheralState.Initialize();
+	PSX_I->FIO = new FrontIO();
+	PSX_S.s_ShockPeripheralState.Initialize();
 
 	MountCPUAddressSpace();
 
-	s_ShockState.power = false;
-	s_ShockState.eject = false;
+	PSX_S.s_ShockState.power = false;
+	PSX_S.s_ShockState.eject = false;
 
 	//do we need to do anything particualr with the CDC disc/tray state? survey says... no.
 
+	*psx = instance;
+
 	return SHOCK_OK;
 }
 
 EW_EXPORT s32 shock_Destroy(void* psx)
 {
-	//TODO
+	SHOCK_CHECK_HANDLE(psx);
+
+	Cleanup();
+	PSX_S.s_StateLayout.Invalidate();
+
+	for(int i=0;i<2;i++)
+	{
+		delete PSX_S.VTBuffer[i];
+		PSX_S.VTBuffer[i] = NULL;
+		free(PSX_S.VTLineWidths[i]);
+		PSX_S.VTLineWidths[i] = NULL;
+	}
+
+	delete &PSX_S;
+
 	return SHOCK_OK;
 }
 
 //Sets the power to ON. It is an error to turn an already-on console ON again
 EW_EXPORT s32 shock_PowerOn(void* psx)
 {
-	if(s_ShockState.power) return SHOCK_NOCANDO;
+	SHOCK_CHECK_HANDLE(psx);
+	if(PSX_S.s_ShockState.power) return SHOCK_NOCANDO;
 
-	s_ShockState.power = true;
+	PSX_S.s_ShockState.power = true;
 	PSX_Power(true);
 
 	return SHOCK_OK;
@@ -1428,7 +1509,8 @@ EW_EXPORT s32 shock_PowerOn(void* psx)
 //Triggers a soft reset immediately. Returns SHOCK_NOCANDO if console is powered off.
 EW_EXPORT s32 shock_SoftReset(void *psx)
 {
-	if (!s_ShockState.power) return SHOCK_NOCANDO;
+	SHOCK_CHECK_HANDLE(psx);
+	if (!PSX_S.s_ShockState.power) return SHOCK_NOCANDO;
 
 	PSX_Power(false);
 
@@ -1438,7 +1520,8 @@ EW_EXPORT s32 shock_SoftReset(void *psx)
 //Sets the power to OFF. It is an error to turn an already-off console OFF again
 EW_EXPORT s32 shock_PowerOff(void* psx)
 {
-	if(!s_ShockState.power) return SHOCK_NOCANDO;
+	SHOCK_CHECK_HANDLE(psx);
+	if(!PSX_S.s_ShockState.power) return SHOCK_NOCANDO;
 
 	//not supported yet
 	return SHOCK_ERROR;
@@ -1446,94 +1529,98 @@ EW_EXPORT s32 shock_PowerOff(void* psx)
 
 EW_EXPORT s32 shock_Step(void* psx, eShockStep step)
 {
+	SHOCK_CHECK_HANDLE(psx);
 	//only eShockStep_Frame is supported
 
 	pscpu_timestamp_t timestamp = 0;
 
-	memset(&espec, 0, sizeof(EmulateSpecStruct));
+	memset(&PSX_S.espec, 0, sizeof(EmulateSpecStruct));
 
-	espec.VideoFormatChanged = true; //shouldnt do this every frame..
-	espec.surface = (MDFN_Surface *)VTBuffer[VTBackBuffer];
-	espec.LineWidths = (int *)VTLineWidths[VTBackBuffer];
-	espec.skip = false;
-	espec.soundmultiplier = 1.0;
-	espec.NeedRewind = false;
+	PSX_S.espec.VideoFormatChanged = true; //shouldnt do this every frame..
+	PSX_S.espec.surface = (MDFN_Surface *)PSX_S.VTBuffer[PSX_S.VTBackBuffer];
+	PSX_S.espec.LineWidths = (int *)PSX_S.VTLineWidths[PSX_S.VTBackBuffer];
+	PSX_S.espec.skip = false;
+	PSX_S.espec.soundmultiplier = 1.0;
+	PSX_S.espec.NeedRewind = false;
 
-	espec.MasterCycles = 0;
+	PSX_S.espec.MasterCycles = 0;
 
-	espec.SoundBufMaxSize = 1024*1024;
-	espec.SoundRate = 44100;
-	espec.SoundBuf = soundbuf;
-	espec.SoundBufSize = 0;
-	espec.SoundVolume = 1.0;
+	PSX_S.espec.SoundBufMaxSize = 1024*1024;
+	PSX_S.espec.SoundRate = 44100;
+	PSX_S.espec.SoundBuf = PSX_S.soundbuf;
+	PSX_S.espec.SoundBufSize = 0;
+	PSX_S.espec.SoundVolume = 1.0;
 
 	//not sure about this
-	espec.skip = s_ShockConfig.opts.skip;
+	PSX_S.espec.skip = PSX_S.s_ShockConfig.opts.skip;
 
-	if (s_ShockConfig.opts.deinterlaceMode == eShockDeinterlaceMode_Weave)
-		deint.SetType(Deinterlacer::DEINT_WEAVE);
-	if (s_ShockConfig.opts.deinterlaceMode == eShockDeinterlaceMode_Bob)
-		deint.SetType(Deinterlacer::DEINT_BOB);
-	if (s_ShockConfig.opts.deinterlaceMode == eShockDeinterlaceMode_BobOffset)
-		deint.SetType(Deinterlacer::DEINT_BOB_OFFSET);
+	if (PSX_S.s_ShockConfig.opts.deinterlaceMode == eShockDeinterlaceMode_Weave)
+		PSX_S.deint.SetType(Deinterlacer::DEINT_WEAVE);
+	if (PSX_S.s_ShockConfig.opts.deinterlaceMode == eShockDeinterlaceMode_Bob)
+		PSX_S.deint.SetType(Deinterlacer::DEINT_BOB);
+	if (PSX_S.s_ShockConfig.opts.deinterlaceMode == eShockDeinterlaceMode_BobOffset)
+		PSX_S.deint.SetType(Deinterlacer::DEINT_BOB_OFFSET);
 
 	//-------------------------
 
-	s_ShockPeripheralState.UpdateInput();
+	PSX_S.s_ShockPeripheralState.UpdateInput();
 	
 	//GPU->StartFrame(psf_loader ? NULL : espec); //a reminder that when we do psf, we will be telling the gpu not to draw
-	GPU->StartFrame(&espec);
+	PSX_I->GPU->StartFrame(&PSX_S.espec);
 	
 	//not that it matters, but we may need to control this at some point
 	static const int ResampleQuality = 5;
-	SPU->StartFrame(espec.SoundRate, ResampleQuality); 
+	PSX_I->SPU->StartFrame(PSX_S.espec.SoundRate, ResampleQuality); 
 
-	GpuFrameForLag = false;
+	PSX_I->GpuFrameForLag = false;
 
-	Running = -1;
-	timestamp = CPU->Run(timestamp, psx_dbg_level >= PSX_DBG_BIOS_PRINT, /*psf_loader != NULL*/ false); //huh?
+	PSX_S.Running = -1;
+	timestamp = PSX_I->CPU->Run(timestamp, psx_dbg_level >= PSX_DBG_BIOS_PRINT, /*psf_loader != NULL*/ false); //huh?
 	assert(timestamp);
 
 	ForceEventUpdates(timestamp);
-	if(GPU->GetScanlineNum() < 100)
-		printf("[BUUUUUUUG] Frame timing end glitch; scanline=%u, st=%u\n", GPU->GetScanlineNum(), timestamp);
+	if(PSX_I->GPU->GetScanlineNum() < 100)
+		printf("[BUUUUUUUG] Frame timing end glitch; scanline=%u, st=%u\n", PSX_I->GPU->GetScanlineNum(), timestamp);
 
-	espec.SoundBufSize = SPU->EndFrame(espec.SoundBuf);
+	PSX_S.espec.SoundBufSize = PSX_I->SPU->EndFrame(PSX_S.espec.SoundBuf);
+
+	//the frontend may look at VRAM between frames, so don't leave any drawing queued
+	PSX_I->GPU->FlushRaster();
 
-	CDC->ResetTS();
+	PSX_I->CDC->ResetTS();
 	TIMER_ResetTS();
 	DMA_ResetTS();
-	GPU->ResetTS();
-	FIO->ResetTS();
+	PSX_I->GPU->ResetTS();
+	PSX_I->FIO->ResetTS();
 
 	RebaseTS(timestamp);
 
-	espec.MasterCycles = timestamp;
+	PSX_S.espec.MasterCycles = timestamp;
 
 	//(memcard saving happened here)
 
 	//----------------------
 
-	VTDisplayRects[VTBackBuffer] = espec.DisplayRect;
+	PSX_S.VTDisplayRects[PSX_S.VTBackBuffer] = PSX_S.espec.DisplayRect;
 
 	//if interlacing is active, do that processing now
-	if(espec.InterlaceOn)
+	if(PSX_S.espec.InterlaceOn)
 	{
-		if(!PrevInterlaced)
-			deint.ClearState();
+		if(!PSX_S.PrevInterlaced)
+			PSX_S.deint.ClearState();
 
-		deint.Process(espec.surface, espec.DisplayRect, espec.LineWidths, espec.InterlaceField);
+		PSX_S.deint.Process(PSX_S.espec.surface, PSX_S.espec.DisplayRect, PSX_S.espec.LineWidths, PSX_S.espec.InterlaceField);
 
-		PrevInterlaced = true;
+		PSX_S.PrevInterlaced = true;
 
-		espec.InterlaceOn = false;
-		espec.InterlaceField = 0;
+		PSX_S.espec.InterlaceOn = false;
+		PSX_S.espec.InterlaceField = 0;
 	}
 
 	//new frame, hasnt been normalized
-	s_FramebufferNormalized = false;
-	s_FramebufferCurrent = 0;
-	s_FramebufferCurrentWidth = FB_WIDTH;
+	PSX_S.s_FramebufferNormalized = false;
+	PSX_S.s_FramebufferCurrent = 0;
+	PSX_S.s_FramebufferCurrentWidth = FB_WIDTH;
 
 	//just in case we debug printed or something like that
 	fflush(stdout);
@@ -1553,22 +1640,22 @@ static void _shock_AnalyzeFramebufferCropInfo(int fbIndex, FramebufferCropInfo*
 	//presently, except for contrived test programs, it is safe to assume this is the same for the entire frame (no known use by games)
 	//however, due to the dump_framebuffer, it may be incorrect at scanline 0. so lets use another one for the heuristic here
 	//you'd think we could use FirstLine instead of kScanlineWidthHeuristicIndex, but sometimes it hasnt been set (screen off) so it's confusing
-	int width = VTLineWidths[fbIndex][kScanlineWidthHeuristicIndex];
-	int height = espec.DisplayRect.h;
-	int yo = espec.DisplayRect.y;
+	int width = PSX_S.VTLineWidths[fbIndex][kScanlineWidthHeuristicIndex];
+	int height = PSX_S.espec.DisplayRect.h;
+	int yo = PSX_S.espec.DisplayRect.y;
 
 	//fix a common error here from disabled screens (?)
 	//I think we're lucky in selecting these lines kind of randomly. need a better plan.
-	if (width <= 0) width = VTLineWidths[fbIndex][0];
+	if (width <= 0) width = PSX_S.VTLineWidths[fbIndex][0];
 
-	if (s_ShockConfig.opts.renderType == eShockRenderType_Framebuffer)
+	if (PSX_S.s_ShockConfig.opts.renderType == eShockRenderType_Framebuffer)
 	{
 		//printf("%d %d %d %d | %d | %d\n",yo,height, GPU->GetVertStart(), GPU->GetVertEnd(), espec.DisplayRect.y, GPU->FirstLine);
 
-		height = GPU->GetVertEnd() - GPU->GetVertStart();
-		yo = GPU->FirstLine;
+		height = PSX_I->GPU->GetVertEnd() - PSX_I->GPU->GetVertStart();
+		yo = PSX_I->GPU->FirstLine;
 
-		if (espec.DisplayRect.h == 288 || espec.DisplayRect.h == 240)
+		if (PSX_S.espec.DisplayRect.h == 288 || PSX_S.espec.DisplayRect.h == 240)
 		{
 		}
 		else
@@ -1580,8 +1667,8 @@ static void _shock_AnalyzeFramebufferCropInfo(int fbIndex, FramebufferCropInfo*
 
 		//this can happen when the display turns on mid-frame
 		//maybe an off by one error here..?
-		if (yo + height >= espec.DisplayRect.h)
-			yo = espec.DisplayRect.h - height;
+		if (yo + height >= PSX_S.espec.DisplayRect.h)
+			yo = PSX_S.espec.DisplayRect.h - height;
 
 		//sometimes when changing modes we have trouble..?
 		if (yo<0) yo = 0;
@@ -1594,8 +1681,20 @@ static void _shock_AnalyzeFramebufferCropInfo(int fbIndex, FramebufferCropInfo*
 }
 
 
-//`normalizes` the framebuffer to 700x480 (or 800x576 for PAL) by pixel doubling and wrecking the AR a little bit as needed
-void NormalizeFramebuffer()
+struct FramebufferNormalizeInfo
+{
+	const uint32* src; //first pixel of the content in VTBuffer[0]
+	int src_pitch;
+	int width, height; //size of the content, before doubling
+	int xs, ys; //doubling factors
+	int xm, ym; //left and top margins
+	int out_width, out_height; //size of the normalized image
+	bool floatX, floatY; //whether anything needs doing in each direction
+};
+
+//works out how the framebuffer gets `normalized` to 700x480 (or 800x576 for PAL) by pixel doubling and wrecking the AR a little bit as needed.
+//only valid before NormalizeFramebuffer() has run on the current frame
+static void _shock_AnalyzeNormalizedFramebuffer(FramebufferNormalizeInfo* ni)
 {
 	//mednafen's advised solution for smooth gaming: "scale the output width to z * nominal_width, and the output height to z * nominal_height, where nominal_width and nominal_height are members of the MDFNGI struct"
 	//IOW, mednafen's strategy is to put everything in a 320x240 and scale it up 3x to 960x720 by default (which is adequate to contain the largest PSX framebuffer of 700x480)
@@ -1630,12 +1729,12 @@ void NormalizeFramebuffer()
 
 	int virtual_width = 800;
 	int virtual_height = 480;
-	if (GPU->HardwarePALType)
+	if (PSX_I->GPU->HardwarePALType)
 		virtual_height = 576;
 
-	if (s_ShockConfig.opts.renderType == eShockRenderType_ClipOverscan)
+	if (PSX_S.s_ShockConfig.opts.renderType == eShockRenderType_ClipOverscan)
 		virtual_width = 756;
-	if (s_ShockConfig.opts.renderType == eShockRenderType_Framebuffer)
+	if (PSX_S.s_ShockConfig.opts.renderType == eShockRenderType_Framebuffer)
 	{
 		//not quite sure what to here yet
 		//virtual_width = width * 2; ?
@@ -1670,132 +1769,159 @@ void NormalizeFramebuffer()
 	int xm = (virtual_width - width*xs) / 2;
 	int ym = (virtual_height - height*ys) / 2;
 
-	int curr = 0;
+	//content that already has the virtual height isn't cropped or floated vertically, and content that already has the virtual width isn't floated horizontally
+	bool floatY = ni->floatY = height != virtual_height;
+	bool floatX = ni->floatX = width != virtual_width;
+
+	ni->src_pitch = PSX_S.s_FramebufferCurrentWidth;
+	if(floatY)
+		ni->src = PSX_S.VTBuffer[0]->pixels + (PSX_S.s_FramebufferCurrentWidth * (PSX_S.espec.DisplayRect.y + cropInfo.yo)) + PSX_S.espec.DisplayRect.x;
+	else
+		ni->src = PSX_S.VTBuffer[0]->pixels + (PSX_S.s_ShockConfig.fb_width*PSX_S.espec.DisplayRect.y) + PSX_S.espec.DisplayRect.x;
+	ni->width = width;
+	ni->height = height;
+	ni->xs = floatX ? xs : 1;
+	ni->ys = floatY ? ys : 1;
+	ni->xm = floatX ? xm : 0;
+	ni->ym = floatY ? ym : 0;
+	ni->out_width = floatX ? virtual_width : width;
+	ni->out_height = floatY ? virtual_height : PSX_S.espec.DisplayRect.h;
+
+	//never let content that's too big run off the edges
+	if(ni->xm < 0) ni->xm = 0;
+	if(ni->ym < 0) ni->ym = 0;
+	if(ni->xm + ni->width*ni->xs > ni->out_width) ni->width = (ni->out_width - ni->xm) / ni->xs;
+}
 
-	//1. double the height, while cropping down
-	if(height != virtual_height)
-	{
-		uint32* src = VTBuffer[curr]->pixels + (s_FramebufferCurrentWidth * (espec.DisplayRect.y + cropInfo.yo)) + espec.DisplayRect.x; //?
-		uint32* dst = VTBuffer[curr^1]->pixels;
-		int tocopy = width*4;
+//emits one row of normalized content: left margin, pixels (doubled if needed), right margin
+static void _shock_EmitNormalizedRow(const FramebufferNormalizeInfo* ni, const uint32* src, uint32* dst)
+{
+	int width = ni->width;
 
-		//float from top as needed
-		memset(dst, 0, ym*tocopy);
-		dst += width * ym;
+	memset(dst, 0, ni->xm*4);
+	dst += ni->xm;
 
-		if(ys==2)
-		{
-			for(int y=0;y<height;y++)
-			{
-				memcpy(dst,src,tocopy);
-				dst += width;
-				memcpy(dst,src,tocopy);
-				dst += width;
-				src += s_FramebufferCurrentWidth;
-			}
-		}
-		else
+	if(ni->xs == 2)
+	{
+		int x = 0;
+#ifdef SHOCK_NORMALIZE_SSE2
+		for(; x + 4 <= width; x += 4)
 		{
-			for(int y=0;y<height;y++)
-			{
-				memcpy(dst, src, tocopy);
-				dst += width;
-				src += s_FramebufferCurrentWidth;
-			}
+			__m128i p = _mm_loadu_si128((const __m128i*)(src + x));
+			_mm_storeu_si128((__m128i*)(dst + x*2), _mm_unpacklo_epi32(p, p));
+			_mm_storeu_si128((__m128i*)(dst + x*2 + 4), _mm_unpackhi_epi32(p, p));
 		}
+#endif
+		for(; x < width; x++)
+			dst[x*2] = dst[x*2+1] = src[x];
+	}
+	else
+		memcpy(dst, src, width*4);
+	dst += width*ni->xs;
 
+	memset(dst, 0, (ni->out_width - ni->xm - width*ni->xs)*4);
+}
 
-		//fill bottom
-		int remaining_lines = virtual_height - ym - height*ys;
-		memset(dst, 0, remaining_lines*tocopy);
+//emits the whole normalized image in a single pass, straight from the emulated framebuffer
+static void _shock_EmitNormalizedFramebuffer(const FramebufferNormalizeInfo* ni, uint32* dst)
+{
+	int pitch = ni->out_width;
+	int y = 0;
 
-		//patch up the metrics
-		height = virtual_height; //we floated the content vertically, so this becomes the new height
-		espec.DisplayRect.x = 0;
-		espec.DisplayRect.y = 0;
-		espec.DisplayRect.h = height;
-		s_FramebufferCurrentWidth = width;
-		VTLineWidths[curr^1][0] = VTLineWidths[curr][0];
-		VTLineWidths[curr^1][kScanlineWidthHeuristicIndex] = VTLineWidths[curr][kScanlineWidthHeuristicIndex];
-
-		curr ^= 1;
-	}
+	//float from top as needed
+	for(; y < ni->ym; y++, dst += pitch)
+		memset(dst, 0, pitch*4);
 
-	//2. double the width as needed. but always float it.
-	//note, theres nothing to be done here if the framebuffer is already wide enough
-	if(width != virtual_width)
+	const uint32* src = ni->src;
+	for(int i = 0; i < ni->height && y < ni->out_height; i++)
 	{
-		uint32* src = VTBuffer[curr]->pixels + (s_ShockConfig.fb_width*espec.DisplayRect.y) + espec.DisplayRect.x;
-		uint32* dst = VTBuffer[curr^1]->pixels;
+		_shock_EmitNormalizedRow(ni, src, dst);
+		dst += pitch;
+		y++;
 
-		for(int y=0;y<height;y++)
+		//doubled rows are just copied from the one we made, while it's still in cache
+		if(ni->ys == 2 && y < ni->out_height)
 		{
-			//float the content horizontally
-			for(int x=0;x<xm;x++)
-				*dst++ = 0;
+			memcpy(dst, dst - pitch, pitch*4);
+			dst += pitch;
+			y++;
+		}
 
-			if(xs==2)
-			{
-				for(int x=0;x<width;x++)
-				{
-					*dst++ = *src;
-					*dst++ = *src++;
-				}
-				src += s_FramebufferCurrentWidth - width;
-			}
-			else
-			{
-				memcpy(dst,src,width*4);
-				dst += width;
-				src += s_FramebufferCurrentWidth;
-			}
+		src += ni->src_pitch;
+	}
 
-			//float the content horizontally
-			int remaining_pixels = virtual_width - xm - width*xs;
-			for(int x=0;x<remaining_pixels;x++)
-				*dst++ = 0;
-		}
+	//fill bottom
+	for(; y < ni->out_height; y++, dst += pitch)
+		memset(dst, 0, pitch*4);
+}
 
-		//patch up the metrics
-		width = virtual_width; //we floated the content horizontally, so this becomes the new width
-		espec.DisplayRect.x = 0;
-		espec.DisplayRect.y = 0;
-		VTLineWidths[curr^1][0] = width;
-		VTLineWidths[curr ^ 1][kScanlineWidthHeuristicIndex] = width;
-		s_FramebufferCurrentWidth = width;
+//`normalizes` the framebuffer into VTBuffer[1], where shock_GetFramebuffer will find it for the rest of the frame
+void NormalizeFramebuffer()
+{
+	FramebufferNormalizeInfo ni;
+	_shock_AnalyzeNormalizedFramebuffer(&ni);
 
-		curr ^= 1;
+	//nothing to do if the framebuffer already has the virtual size
+	if(!ni.floatX && !ni.floatY)
+	{
+		PSX_S.s_FramebufferCurrent = 0;
+		return;
 	}
 
-	s_FramebufferCurrent = curr;
+	_shock_EmitNormalizedFramebuffer(&ni, PSX_S.VTBuffer[1]->pixels);
+
+	//patch up the metrics
+	PSX_S.espec.DisplayRect.x = 0;
+	PSX_S.espec.DisplayRect.y = 0;
+	PSX_S.espec.DisplayRect.h = ni.out_height;
+	PSX_S.VTLineWidths[1][0] = ni.floatX ? ni.out_width : PSX_S.VTLineWidths[0][0];
+	PSX_S.VTLineWidths[1][kScanlineWidthHeuristicIndex] = ni.out_width;
+	PSX_S.s_FramebufferCurrentWidth = ni.out_width;
+	PSX_S.s_FramebufferCurrent = 1;
 }
 
 EW_EXPORT s32 shock_GetSamples(void* psx, void* buffer)
 {
+	SHOCK_CHECK_HANDLE(psx);
 	//if buffer is NULL, user just wants to know how many samples, so dont do any copying
 	if(buffer != NULL)
 	{
-		memcpy(buffer,espec.SoundBuf,espec.SoundBufSize*4);
+		memcpy(buffer,PSX_S.espec.SoundBuf,PSX_S.espec.SoundBufSize*4);
 	}
 
-	return espec.SoundBufSize;
+	return PSX_S.espec.SoundBufSize;
 }
 
 
 EW_EXPORT s32 shock_GetFramebuffer(void* psx, ShockFramebufferInfo* fb)
 {
-	//TODO - fastpath for emitting to the final framebuffer, although if we did that, we'd have to regenerate it every time
+	SHOCK_CHECK_HANDLE(psx);
 	//TODO - let the frontend do this, anyway. need a new filter for it. this was in the plans from the beginning, i just havent done it yet
 
+	//fastpath: emit the normalized framebuffer straight to the user's buffer. this is regenerated every time, and leaves the core's buffers alone
+	if((fb->flags & eShockFramebufferFlags_Normalize) && (fb->flags & eShockFramebufferFlags_Direct) && !PSX_S.s_FramebufferNormalized)
+	{
+		FramebufferNormalizeInfo ni;
+		_shock_AnalyzeNormalizedFramebuffer(&ni);
+
+		fb->width = ni.out_width;
+		fb->height = ni.out_height;
+
+		if(fb->ptr != NULL)
+			_shock_EmitNormalizedFramebuffer(&ni, (uint32*)fb->ptr);
+
+		return SHOCK_OK;
+	}
+
 	//if user requires normalization, do it now
 	if(fb->flags & eShockFramebufferFlags_Normalize)
-		if(!s_FramebufferNormalized)
+		if(!PSX_S.s_FramebufferNormalized)
 		{
 			NormalizeFramebuffer();
-			s_FramebufferNormalized = true;
+			PSX_S.s_FramebufferNormalized = true;
 		}
 
-	int fbIndex = s_FramebufferCurrent;
+	int fbIndex = PSX_S.s_FramebufferCurrent;
 
 	//always fetch description
 	FramebufferCropInfo cropInfo;
@@ -1807,7 +1933,7 @@ EW_EXPORT s32 shock_GetFramebuffer(void* psx, ShockFramebufferInfo* fb)
 	//sloppy, but the above AnalyzeFramebufferCropInfo() will give us too short of a buffer
 	if(fb->flags & eShockFramebufferFlags_Normalize)
 	{
-		height = espec.DisplayRect.h;
+		height = PSX_S.espec.DisplayRect.h;
 		yo = 0;
 	}
 
@@ -1822,13 +1948,13 @@ EW_EXPORT s32 shock_GetFramebuffer(void* psx, ShockFramebufferInfo* fb)
 
 	//maybe we need to output the framebuffer
 	//do a raster loop and copy it to the target
-	uint32* src = VTBuffer[fbIndex]->pixels + (s_FramebufferCurrentWidth*yo) + espec.DisplayRect.x;
+	uint32* src = PSX_S.VTBuffer[fbIndex]->pixels + (PSX_S.s_FramebufferCurrentWidth*yo) + PSX_S.espec.DisplayRect.x;
 	uint32* dst = (u32*)fb->ptr;
 	int tocopy = width*4;
 	for(int y=0;y<height;y++)
 	{
 		memcpy(dst,src,tocopy);
-		src += s_FramebufferCurrentWidth;
+		src += PSX_S.s_FramebufferCurrentWidth;
 		dst += width;
 	}
 
@@ -1871,28 +1997,28 @@ static void LoadEXE(const uint8 *data, const uint32 size, bool ignore_pcsp = fal
  if(TextSize < (size - 0x800))
   throw(MDFN_Error(0, "Text section recorded size is smaller than data available in file.  Header=0x%08x, Available=0x%08x", TextSize, size - 0x800));*/
 
- if(!TextMem.size())
+ if(!PSX_S.TextMem.size())
  {
-  TextMem_Start = TextStart;
-  TextMem.resize(TextSize);
+  PSX_S.TextMem_Start = TextStart;
+  PSX_S.TextMem.resize(TextSize);
  }
 
- if(TextStart < TextMem_Start)
+ if(TextStart < PSX_S.TextMem_Start)
  {
-  uint32 old_size = TextMem.size();
+  uint32 old_size = PSX_S.TextMem.size();
 
   //printf("RESIZE: 0x%08x\n", TextMem_Start - TextStart);
 
-  TextMem.resize(old_size + TextMem_Start - TextStart);
-  memmove(&TextMem[TextMem_Start - TextStart], &TextMem[0], old_size);
+  PSX_S.TextMem.resize(old_size + PSX_S.TextMem_Start - TextStart);
+  memmove(&PSX_S.TextMem[PSX_S.TextMem_Start - TextStart], &PSX_S.TextMem[0], old_size);
 
-  TextMem_Start = TextStart;
+  PSX_S.TextMem_Start = TextStart;
  }
 
- if(TextMem.size() < (TextStart - TextMem_Start + TextSize))
-  TextMem.resize(TextStart - TextMem_Start + TextSize);
+ if(PSX_S.TextMem.size() < (TextStart - PSX_S.TextMem_Start + TextSize))
+  PSX_S.TextMem.resize(TextStart - PSX_S.TextMem_Start + TextSize);
 
- memcpy(&TextMem[TextStart - TextMem_Start], data + 0x800, TextSize);
+ memcpy(&PSX_S.TextMem[TextStart - PSX_S.TextMem_Start], data + 0x800, TextSize);
 
 
  //
@@ -1900,21 +2026,21 @@ static void LoadEXE(const uint8 *data, const uint32 size, bool ignore_pcsp = fal
  //
 
  // BIOS patch
- BIOSROM->WriteU32(0x6990, (3 << 26) | ((0xBF001000 >> 2) & ((1 << 26) - 1)));
+ PSX_S.BIOSROM->WriteU32(0x6990, (3 << 26) | ((0xBF001000 >> 2) & ((1 << 26) - 1)));
 // BIOSROM->WriteU32(0x691C, (3 << 26) | ((0xBF001000 >> 2) & ((1 << 26) - 1)));
 
 // printf("INSN: 0x%08x\n", BIOSROM->ReadU32(0x6990));
 // exit(1);
  uint8 *po;
 
- po = &PIOMem->data8[0x0800];
+ po = &PSX_S.PIOMem->data8[0x0800];
 
  MDFN_en32lsb<false>(po, (0x0 << 26) | (31 << 21) | (0x8 << 0));	// JR
  po += 4;
  MDFN_en32lsb<false>(po, 0);	// NOP(kinda)
  po += 4;
 
- po = &PIOMem->data8[0x1000];
+ po = &PSX_S.PIOMem->data8[0x1000];
 
  // Load cacheable-region target PC into r2
  MDFN_en32lsb<false>(po, (0xF << 26) | (0 << 21) | (1 << 16) | (0x9F001010 >> 16));      // LUI
@@ -1940,15 +2066,15 @@ static void LoadEXE(const uint8 *data, const uint32 size, bool ignore_pcsp = fal
  po += 4;
 
  // Load dest address into r9
- MDFN_en32lsb<false>(po, (0xF << 26) | (0 << 21) | (1 << 16)  | (TextMem_Start >> 16));	// LUI
+ MDFN_en32lsb<false>(po, (0xF << 26) | (0 << 21) | (1 << 16)  | (PSX_S.TextMem_Start >> 16));	// LUI
  po += 4;
- MDFN_en32lsb<false>(po, (0xD << 26) | (1 << 21) | (9 << 16) | (TextMem_Start & 0xFFFF)); 	// ORI
+ MDFN_en32lsb<false>(po, (0xD << 26) | (1 << 21) | (9 << 16) | (PSX_S.TextMem_Start & 0xFFFF)); 	// ORI
  po += 4;
 
  // Load size into r10
- MDFN_en32lsb<false>(po, (0xF << 26) | (0 << 21) | (1 << 16)  | (TextMem.size() >> 16));	// LUI
+ MDFN_en32lsb<false>(po, (0xF << 26) | (0 << 21) | (1 << 16)  | (PSX_S.TextMem.size() >> 16));	// LUI
  po += 4;
- MDFN_en32lsb<false>(po, (0xD << 26) | (1 << 21) | (10 << 16) | (TextMem.size() & 0xFFFF)); 	// ORI
+ MDFN_en32lsb<false>(po, (0xD << 26) | (1 << 21) | (10 << 16) | (PSX_S.TextMem.size() & 0xFFFF)); 	// ORI
  po += 4;
 
  //
@@ -2013,59 +2139,70 @@ static void LoadEXE(const uint8 *data, const uint32 size, bool ignore_pcsp = fal
 
 EW_EXPORT s32 shock_MountEXE(void* psx, void* exebuf, s32 size, s32 ignore_pcsp)
 {
+	SHOCK_CHECK_HANDLE(psx);
 	LoadEXE((uint8*)exebuf, (uint32)size, !!ignore_pcsp);
 	return SHOCK_OK;
 }
 
 static void Cleanup(void)
 {
- TextMem.resize(0);
+ PSX_S.TextMem.resize(0);
 
- if(CDC)
+ if(PSX_I->CDC)
  {
-  delete CDC;
-  CDC = NULL;
+  delete PSX_I->CDC;
+  PSX_I->CDC = NULL;
  }
 
- if(SPU)
+ if(PSX_I->SPU)
  {
-  delete SPU;
-  SPU = NULL;
+  delete PSX_I->SPU;
+  PSX_I->SPU = NULL;
  }
 
- if(GPU)
+ if(PSX_I->GPU)
  {
-  delete GPU;
-  GPU = NULL;
+  delete PSX_I->GPU;
+  PSX_I->GPU = NULL;
  }
 
- if(CPU)
+ if(PSX_I->CPU)
  {
-  delete CPU;
-  CPU = NULL;
+  delete PSX_I->CPU;
+  PSX_I->CPU = NULL;
  }
 
- if(FIO)
+ if(PSX_I->FIO)
  {
-  delete FIO;
-  FIO = NULL;
+  delete PSX_I->FIO;
+  PSX_I->FIO = NULL;
  }
 
  DMA_Kill();
+ IRQ_Kill();
+ MDEC_Kill();
+ SIO_Kill();
+ TIMER_Kill();
 
- if(BIOSROM)
+ if(PSX_S.BIOSROM)
  {
-  delete BIOSROM;
-  BIOSROM = NULL;
+  delete PSX_S.BIOSROM;
+  PSX_S.BIOSROM = NULL;
  }
 
- if(PIOMem)
+ if(PSX_S.PIOMem)
  {
-  delete PIOMem;
-  PIOMem = NULL;
+  delete PSX_S.PIOMem;
+  PSX_S.PIOMem = NULL;
  }
 
- cdifs = NULL;
+ delete PSX_I->MainRAM;
+ PSX_I->MainRAM = NULL;
+
+ delete[] PSX_S.soundbuf;
+ PSX_S.soundbuf = NULL;
+
+ PSX_S.cdifs = NULL;
 }
 
 static void CloseGame(void)
@@ -2079,9 +2216,6 @@ EW_EXPORT s32 shock_CreateDisc(ShockDiscRef** outDisc, void *Opaque, s32 lbaCoun
 	return SHOCK_OK;
 }
 
-ShockDiscRef* s_CurrDisc = NULL;
-ShockDiscInfo s_CurrDiscInfo;
-
 static s32 _shock_SetOrPokeDisc(void* psx, ShockDiscRef* disc, bool poke)
 {
 	ShockDiscInfo info;
@@ -2092,10 +2226,10 @@ static s32 _shock_SetOrPokeDisc(void* psx, ShockDiscRef* disc, bool poke)
 		shock_AnalyzeDisc(disc,&info);
 	}
 
-	s_CurrDiscInfo = info;
-	s_CurrDisc = disc;
+	PSX_S.s_CurrDiscInfo = info;
+	PSX_S.s_CurrDisc = disc;
 
-	CDC->SetDisc(s_CurrDisc,s_CurrDiscInfo.id, poke);
+	PSX_I->CDC->SetDisc(PSX_S.s_CurrDisc,PSX_S.s_CurrDiscInfo.id, poke);
 
 	return SHOCK_OK;
 }
@@ -2103,11 +2237,13 @@ static s32 _shock_SetOrPokeDisc(void* psx, ShockDiscRef* disc, bool poke)
 //Sets the disc in the tray. Returns SHOCK_NOCANDO if it's closed (TODO). You can pass NULL to remove a disc from the tray
 EW_EXPORT s32 shock_SetDisc(void* psx, ShockDiscRef* disc)
 {
+	SHOCK_CHECK_HANDLE(psx);
 	return _shock_SetOrPokeDisc(psx,disc,false);
 }
 
 EW_EXPORT s32 shock_PokeDisc(void* psx, ShockDiscRef* disc)
 {
+	SHOCK_CHECK_HANDLE(psx);
 	//let's talk about why this function is needed. well, let's paste an old comment on the subject:
 	//heres a comment from some old savestating code. something to keep in mind (maybe or maybe not a surprise depending on your point of view)
 	//"Call SetDisc() BEFORE we load CDC state, since SetDisc() has emulation side effects.  We might want to clean this up in the future."
@@ -2118,17 +2254,19 @@ EW_EXPORT s32 shock_PokeDisc(void* psx, ShockDiscRef* disc)
 
 EW_EXPORT s32 shock_OpenTray(void* psx)
 {
-	if(s_ShockState.eject) return SHOCK_NOCANDO;
-	s_ShockState.eject = true;
-	CDC->OpenTray();
+	SHOCK_CHECK_HANDLE(psx);
+	if(PSX_S.s_ShockState.eject) return SHOCK_NOCANDO;
+	PSX_S.s_ShockState.eject = true;
+	PSX_I->CDC->OpenTray();
 	return SHOCK_OK;
 }
 
 EW_EXPORT s32 shock_CloseTray(void* psx)
 {
-	if(!s_ShockState.eject) return SHOCK_NOCANDO;
-	s_ShockState.eject = false;
-	CDC->CloseTray(false);
+	SHOCK_CHECK_HANDLE(psx);
+	if(!PSX_S.s_ShockState.eject) return SHOCK_NOCANDO;
+	PSX_S.s_ShockState.eject = false;
+	PSX_I->CDC->CloseTray(false);
 	return SHOCK_OK;
 }
 
@@ -2262,7 +2400,7 @@ void ShockDiscRef_Stream_Thing::write(const void *data, uint64 count)
 
 void ShockDiscRef_Stream_Thing::seek(int64 offset, int whence)
 {
- int64 new_position;
+ int64 new_position = position;
 
  switch(whence)
  {
@@ -2579,14 +2717,10 @@ s32 ShockDiscRef::ReadLBA2048(s32 lba, void* dst2048)
 		u8 buf[2352];
 	};
 
-	static union {
-		struct {
-			union {
-				XASector xasector;
-				Sector sector;
-			};
-			u8 subcode[96];
-		};
+	//room for the 96 subcode bytes after the 2352 byte sector
+	union {
+		XASector xasector;
+		Sector sector;
 		u8 buf2448[2448];
 	};
 
@@ -2605,26 +2739,21 @@ s32 ShockDiscRef::ReadLBA2048(s32 lba, void* dst2048)
 //Returns information about a memory buffer for peeking (main memory, spu memory, etc.)
 EW_EXPORT s32 shock_GetMemData(void* psx, void** ptr, s32* size, s32 memType)
 {
+	SHOCK_CHECK_HANDLE(psx);
 	switch(memType)
 	{
-	case eMemType_MainRAM: *ptr = MainRAM.data8; *size = 2048*1024; break;
-	case eMemType_BiosROM: *ptr = BIOSROM->data8; *size = 512*1024; break;
-	case eMemType_PIOMem: *ptr = PIOMem->data8; *size = 64*1024; break;
-	case eMemType_GPURAM: *ptr = GPU->GPURAM; *size = 2*512*1024; break;
-	case eMemType_SPURAM: *ptr = SPU->SPURAM; *size = 512*1024; break;
-	case eMemType_DCache: *ptr = CPU->debug_GetScratchRAMPtr(); *size = 1024; break;
+	case eMemType_MainRAM: *ptr = PSX_I->MainRAM->data8; *size = 2048*1024; break;
+	case eMemType_BiosROM: *ptr = PSX_S.BIOSROM->data8; *size = 512*1024; break;
+	case eMemType_PIOMem: *ptr = PSX_S.PIOMem->data8; *size = 64*1024; break;
+	case eMemType_GPURAM: *ptr = PSX_I->GPU->GPURAM; *size = 2*512*1024; break;
+	case eMemType_SPURAM: *ptr = PSX_I->SPU->SPURAM; *size = 512*1024; break;
+	case eMemType_DCache: *ptr = PSX_I->CPU->debug_GetScratchRAMPtr(); *size = 1024; break;
 	default:
 		return SHOCK_ERROR;
 	}
 	return SHOCK_OK;
 }
 
-class PSX
-{
-public:
-	template<bool isReader>void SyncState(EW::NewState *ns);
-} s_PSX;
-
 namespace MDFN_IEN_PSX {
 void DMA_SyncState(bool isReader, EW::NewState *ns);
 void GTE_SyncState(bool isReader, EW::NewState *ns);
@@ -2634,10 +2763,10 @@ void MDEC_SyncState(bool isReader, EW::NewState *ns);
 void IRQ_SyncState(bool isReader, EW::NewState *ns);
 }
 
-SYNCFUNC(PSX)
+SYNCFUNC(PSX_State)
 {
   NSS(s_ShockState);
-  PSS(MainRAM.data8, 2*1024*1024);
+  PSS(MainRAM->data8, 2*1024*1024);
   NSS(SysControl.Regs);
 	NSS(PSX_PRNG.lcgo);
 	NSS(PSX_PRNG.x);
@@ -2705,19 +2834,20 @@ SYNCFUNC(PSX)
 
 EW_EXPORT s32 shock_StateTransaction(void *psx, ShockStateTransaction* transaction)
 {
+	SHOCK_CHECK_HANDLE(psx);
 	switch(transaction->transaction)
 	{
 	case eShockStateTransaction_BinarySize:
 		{
-			EW::NewStateDummy dummy;
-			s_PSX.SyncState<false>(&dummy);
-			return dummy.GetLength();
+			if(!PSX_S.s_StateLayout.IsValid())
+				PSX_S.s_StateLayout.Build(&PSX_S);
+			return PSX_S.s_StateLayout.GetLength();
 		}
 	case eShockStateTransaction_BinaryLoad:
 		{
 			if(transaction->buffer == NULL) return SHOCK_ERROR;
 			EW::NewStateExternalBuffer loader((char*)transaction->buffer, transaction->bufferLength);
-			s_PSX.SyncState<true>(&loader);
+			PSX_S.SyncState<true>(&loader);
 			if(!loader.Overflow() && loader.GetLength() == transaction->bufferLength)
 				return SHOCK_OK;
 			else return SHOCK_ERROR;
@@ -2725,8 +2855,16 @@ EW_EXPORT s32 shock_StateTransaction(void *psx, ShockStateTransaction* transacti
 	case eShockStateTransaction_BinarySave:
 		{
 			if(transaction->buffer == NULL) return SHOCK_ERROR;
+			if(!PSX_S.s_StateLayout.IsValid())
+				PSX_S.s_StateLayout.Build(&PSX_S);
+			if(PSX_S.s_StateLayout.IsReplayable())
+			{
+				//the one side effect of PS_GPU::SyncState that a save needs
+				PSX_I->GPU->FlushRaster();
+				return PSX_S.s_StateLayout.SaveTo((char*)transaction->buffer, transaction->bufferLength) ? SHOCK_OK : SHOCK_ERROR;
+			}
 			EW::NewStateExternalBuffer saver((char*)transaction->buffer, transaction->bufferLength);
-			s_PSX.SyncState<false>(&saver);
+			PSX_S.SyncState<false>(&saver);
 			if(!saver.Overflow() && saver.GetLength() == transaction->bufferLength)
 				return SHOCK_OK;
 			else return SHOCK_ERROR;
@@ -2734,13 +2872,13 @@ EW_EXPORT s32 shock_StateTransaction(void *psx, ShockStateTransaction* transacti
 	case eShockStateTransaction_TextLoad:
 		{
 			EW::NewStateExternalFunctions saver(&transaction->ff);
-			s_PSX.SyncState<true>(&saver);
+			PSX_S.SyncState<true>(&saver);
 			return SHOCK_OK;
 		}
 	case eShockStateTransaction_TextSave:
 		{
 			EW::NewStateExternalFunctions loader(&transaction->ff);
-			s_PSX.SyncState<false>(&loader);
+			PSX_S.SyncState<false>(&loader);
 			return SHOCK_OK;
 		}
 		return SHOCK_ERROR;
@@ -2752,15 +2890,16 @@ EW_EXPORT s32 shock_StateTransaction(void *psx, ShockStateTransaction* transacti
 
 EW_EXPORT s32 shock_GetRegisters_CPU(void* psx, ShockRegisters_CPU* buffer)
 {
-	memcpy(buffer->GPR,CPU->debug_GetGPRPtr(),32*4);
-	buffer->PC = CPU->GetRegister(PS_CPU::GSREG_PC_NEXT,NULL,0);
-	buffer->PC_NEXT = CPU->GetRegister(PS_CPU::GSREG_PC_NEXT,NULL,0);
-	buffer->IN_BD_SLOT = CPU->GetRegister(PS_CPU::GSREG_IN_BD_SLOT,NULL,0);
-	buffer->LO  = CPU->GetRegister(PS_CPU::GSREG_LO,NULL,0);
-	buffer->HI = CPU->GetRegister(PS_CPU::GSREG_HI,NULL,0);
-	buffer->SR = CPU->GetRegister(PS_CPU::GSREG_SR,NULL,0);
-	buffer->CAUSE = CPU->GetRegister(PS_CPU::GSREG_CAUSE,NULL,0);
-	buffer->EPC = CPU->GetRegister(PS_CPU::GSREG_EPC,NULL,0);
+	SHOCK_CHECK_HANDLE(psx);
+	memcpy(buffer->GPR,PSX_I->CPU->debug_GetGPRPtr(),32*4);
+	buffer->PC = PSX_I->CPU->GetRegister(PS_CPU::GSREG_PC_NEXT,NULL,0);
+	buffer->PC_NEXT = PSX_I->CPU->GetRegister(PS_CPU::GSREG_PC_NEXT,NULL,0);
+	buffer->IN_BD_SLOT = PSX_I->CPU->GetRegister(PS_CPU::GSREG_IN_BD_SLOT,NULL,0);
+	buffer->LO  = PSX_I->CPU->GetRegister(PS_CPU::GSREG_LO,NULL,0);
+	buffer->HI = PSX_I->CPU->GetRegister(PS_CPU::GSREG_HI,NULL,0);
+	buffer->SR = PSX_I->CPU->GetRegister(PS_CPU::GSREG_SR,NULL,0);
+	buffer->CAUSE = PSX_I->CPU->GetRegister(PS_CPU::GSREG_CAUSE,NULL,0);
+	buffer->EPC = PSX_I->CPU->GetRegister(PS_CPU::GSREG_EPC,NULL,0);
 	
 	return SHOCK_OK;
 }
@@ -2768,29 +2907,26 @@ EW_EXPORT s32 shock_GetRegisters_CPU(void* psx, ShockRegisters_CPU* buffer)
 //Sets a CPU register. Rather than have an enum for the registers, lets just use the index (not offset) within the struct
 EW_EXPORT s32 shock_SetRegister_CPU(void* psx, s32 index, u32 value)
 {
+	SHOCK_CHECK_HANDLE(psx);
 	//takes advantage of layout of GSREG_ matchign our struct (not an accident!)
-	CPU->SetRegister((u32)index,value);
+	PSX_I->CPU->SetRegister((u32)index,value);
 	
 	return SHOCK_OK;
 }
 
 EW_EXPORT s32 shock_SetRenderOptions(void* pxs, ShockRenderOptions* opts)
 {
-	GPU->SetRenderOptions(opts);
-	s_ShockConfig.opts = *opts;
+	SHOCK_CHECK_HANDLE(pxs);
+	PSX_I->GPU->SetRenderOptions(opts);
+	PSX_S.s_ShockConfig.opts = *opts;
 	return SHOCK_OK;
 }
 
-extern void* g_ShockTraceCallbackOpaque;
-extern ShockCallback_Trace g_ShockTraceCallback;
-extern ShockCallback_Mem g_ShockMemCallback;
-extern eShockMemCb g_ShockMemCbType;
-
 //Sets the callback to be used for CPU tracing
 EW_EXPORT s32 shock_SetTraceCallback(void* psx, void* opaque, ShockCallback_Trace callback)
 {
-	g_ShockTraceCallbackOpaque = opaque;
-	g_ShockTraceCallback = callback;
+	SHOCK_CHECK_HANDLE(psx);
+	PSX_I->CPU->SetTraceCallback(opaque, callback);
 
 	return SHOCK_OK;
 }
@@ -2798,21 +2934,57 @@ EW_EXPORT s32 shock_SetTraceCallback(void* psx, void* opaque, ShockCallback_Trac
 //Sets the callback to be used for memory hook events
 EW_EXPORT s32 shock_SetMemCb(void* psx, ShockCallback_Mem callback, eShockMemCb cbMask)
 {
-	g_ShockMemCallback = callback;
-	g_ShockMemCbType = cbMask;
+	SHOCK_CHECK_HANDLE(psx);
+	PSX_I->CPU->SetMemCallback(callback, cbMask);
 	return SHOCK_OK;
 }
 
 //Sets whether LEC is enabled (sector level error correction). Defaults to FALSE (disabled)
 EW_EXPORT s32 shock_SetLEC(void* psx, bool enabled)
 {
-	CDC->SetLEC(enabled);
+	SHOCK_CHECK_HANDLE(psx);
+	PSX_I->CDC->SetLEC(enabled);
+	return SHOCK_OK;
+}
+
+//Sets whether the CPU uses its dynamic recompiler, on hosts that have one (x86-64). Doesn't affect sync. Defaults to FALSE (disabled)
+EW_EXPORT s32 shock_SetRecompiler(void* psx, bool enabled)
+{
+	SHOCK_CHECK_HANDLE(psx);
+	PSX_I->CPU->SetRecompiler(enabled);
+	return SHOCK_OK;
+}
+
+//Reads the profiling counters, and resets them if requested. Returns SHOCK_NOCANDO if the core was built without PSX_PERF_COUNTERS
+EW_EXPORT s32 shock_GetPerfCounters(void* psx, ShockPerfCounters* counters, bool reset)
+{
+	SHOCK_CHECK_HANDLE(psx);
+#ifdef PSX_PERF_COUNTERS
+	PSX_PerfCounters* const perf = PSX_I->perf;
+
+	//bring the running subsystem's count up to date
+	PSX_PerfSwitch(perf->Current);
+
+	counters->other = perf->NS[PSX_PERF_OTHER];
+	counters->cpu = perf->NS[PSX_PERF_CPU];
+	counters->gpu = perf->NS[PSX_PERF_GPU];
+	counters->spu = perf->NS[PSX_PERF_SPU];
+	counters->cdc = perf->NS[PSX_PERF_CDC];
+	counters->mdec = perf->NS[PSX_PERF_MDEC];
+
+	if(reset)
+		memset(perf->NS, 0, sizeof(perf->NS));
+
 	return SHOCK_OK;
+#else
+	return SHOCK_NOCANDO;
+#endif
 }
 
 //whether "determine lag from GPU frames" signal is set (GPU did something considered non-lag)
 //returns SHOCK_TRUE or SHOCK_FALSE
 EW_EXPORT s32 shock_GetGPUUnlagged(void* psx)
 {
-	return GpuFrameForLag ? SHOCK_TRUE : SHOCK_FALSE;
+	SHOCK_CHECK_HANDLE(psx);
+	return PSX_I->GpuFrameForLag ? SHOCK_TRUE : SHOCK_FALSE;
 }
\ No newline at end of file
@@ -24,6 +24,52 @@
 //
 //
 
+namespace MDFN_IEN_PSX
+{
+ class PS_CPU;
+ class PS_GPU;
+ class PS_CDC;
+ class PS_SPU;
+ class FrontIO;
+
+ struct PSX_PerfCounters;
+ struct DMA_State;
+ struct GTE_State;
+ struct IRQ_State;
+ struct MDEC_State;
+ struct SIO_State;
+ struct TIMER_State;
+
+ //
+ // Everything mutable about an emulated console hangs off one of these.  shock_Create allocates it and hands it out as the
+ // handle, and every export makes the handle's instance current for the calling thread(PSX_I) before touching anything, so
+ // any number of instances can run at once, each on whatever thread is driving it at the time.  Each subsystem keeps its
+ // own state in a private struct reached through here; read-only tables shared between instances stay plain statics.
+ //
+ struct PSX_Instance
+ {
+  PS_CPU *CPU;
+  PS_GPU *GPU;
+  PS_CDC *CDC;
+  PS_SPU *SPU;
+  FrontIO *FIO;
+  MultiAccessSizeMem<2048 * 1024, false> *MainRAM;
+
+  bool GpuFrameForLag;	// Set when the game sends the GPU a frame's worth of anything; reset every frame.
+
+  DMA_State *dma;
+  GTE_State *gte;
+  IRQ_State *irq;
+  MDEC_State *mdec;
+  SIO_State *sio;
+  TIMER_State *timer;
+
+  PSX_PerfCounters *perf;
+ };
+
+ extern thread_local PSX_Instance *PSX_I;
+}
+
 namespace MDFN_IEN_PSX
 {
  #define PSX_DBG_ERROR		0	// Emulator-level error.
@@ -95,26 +141,6 @@ namespace MDFN_IEN_PSX
 };
 
 
-#include "dis.h"
-#include "cpu.h"
-#include "irq.h"
-#include "gpu.h"
-#include "dma.h"
-//#include "sio.h"
-#include "debug.h"
-
-namespace MDFN_IEN_PSX
-{
- class PS_CDC;
- class PS_SPU;
-
- extern PS_CPU *CPU;
- extern PS_GPU *GPU;
- extern PS_CDC *CDC;
- extern PS_SPU *SPU;
- extern MultiAccessSizeMem<2048 * 1024, false> MainRAM;
-};
-
 enum eRegion
 {
  REGION_JP = 0,
@@ -138,7 +164,10 @@ enum eShockStep
 enum eShockFramebufferFlags
 {
 	eShockFramebufferFlags_None = 0,
-	eShockFramebufferFlags_Normalize = 1
+	eShockFramebufferFlags_Normalize = 1,
+
+	//with Normalize: write the normalized framebuffer straight into the provided buffer in a single pass, instead of normalizing into the core's buffers and copying that
+	eShockFramebufferFlags_Direct = 2
 };
 
 enum eShockRenderType
@@ -236,7 +265,19 @@ struct ShockRegisters_CPU
   u32 IN_BD_SLOT;
   u32 LO, HI;
 	u32 SR, CAUSE, EPC;
-};
+};
+
+//Nanoseconds spent in each part of the emulator (exclusive of the others it calls into) since the counters were last reset.
+//Only available in builds with PSX_PERF_COUNTERS defined
+struct ShockPerfCounters
+{
+	u64 other;
+	u64 cpu;
+	u64 gpu;
+	u64 spu;
+	u64 cdc;
+	u64 mdec;
+};
 
 // [0] is unused, [100] is for the leadout track.
 // Also, for convenience, tracks[last_track + 1] will always refer
@@ -252,6 +293,15 @@ typedef void (*ShockCallback_Trace)(void* opaque, u32 PC, u32 inst, const char*
 //there isnt one callback per type.
 typedef void (*ShockCallback_Mem)(u32 address, eShockMemCb type, u32 size, u32 value);
 
+#include "dis.h"
+#include "perf.h"
+#include "cpu.h"
+#include "irq.h"
+#include "gpu.h"
+#include "dma.h"
+//#include "sio.h"
+#include "debug.h"
+
 class ShockDiscRef
 {
 public:
@@ -310,6 +360,10 @@ struct ShockRenderOptions
 	eShockRenderType renderType;
 	eShockDeinterlaceMode deinterlaceMode;
 	bool skip;
+
+	//number of worker threads rasterizing the GPU's untextured draw commands in horizontal VRAM bands; 0 draws everything on the emulation thread.
+	//output is identical either way.
+	s32 renderThreads;
 };
 
 struct ShockMemcardTransaction
@@ -342,10 +396,11 @@ EW_EXPORT s32 shock_AnalyzeDisc(ShockDiscRef* disc, ShockDiscInfo* info);
 
 //Creates the psx instance as a console of the specified region.
 //Additionally mounts the firmware from the provided buffer (the contents are copied)
+//Any number of instances can exist at once, and each can be driven from any thread, as long as only one call at a time is made on it.
 //TODO - receive a model number parameter instead
 EW_EXPORT s32 shock_Create(void** psx, s32 region, void* firmware512k);
 
-//Frees the psx instance created with shock_Create
+//Frees the psx instance created with shock_Create.
 EW_EXPORT s32 shock_Destroy(void* psx);
 
 //Attaches (or detaches) a peripheral at the given address. 
@@ -416,7 +471,7 @@ EW_EXPORT s32 shock_GetSamples(void* psx, void* buffer);
 //Returns information about a memory buffer for peeking (main memory, spu memory, etc.)
 EW_EXPORT s32 shock_GetMemData(void* psx, void** ptr, s32* size, s32 memType);
 
-//Savestate work. Returns the size if that's what was requested, otherwise error codes
+//Savestate work. Returns the size if that's what was requested, otherwise error codes
 EW_EXPORT s32 shock_StateTransaction(void *psx, ShockStateTransaction* transaction);
 
 //Retrieves the CPU registers in a compact struct
@@ -431,6 +486,12 @@ EW_EXPORT s32 shock_SetTraceCallback(void* psx, void* opaque, ShockCallback_Trac
 //Sets whether LEC is enabled (sector level error correction). Defaults to FALSE (disabled)
 EW_EXPORT s32 shock_SetLEC(void* psx, bool enabled);
 
+//Sets whether the CPU uses its dynamic recompiler, on hosts that have one (x86-64). Doesn't affect sync. Defaults to FALSE (disabled)
+EW_EXPORT s32 shock_SetRecompiler(void* psx, bool enabled);
+
+//Reads the profiling counters, and resets them if requested. Returns SHOCK_NOCANDO if the core was built without PSX_PERF_COUNTERS
+EW_EXPORT s32 shock_GetPerfCounters(void* psx, ShockPerfCounters* counters, bool reset);
+
 //whether "determine lag from GPU frames" signal is set (GPU did something considered non-lag)
 //returns SHOCK_TRUE or SHOCK_FALSE
 EW_EXPORT s32 shock_GetGPUUnlagged(void* psx);
\ No newline at end of file
@@ -23,19 +23,37 @@ namespace MDFN_IEN_PSX
 
 // Dummy implementation.
 
-static uint16 Status;
-static uint16 Mode;
-static uint16 Control;
-static uint16 BaudRate;
-static uint32 DataBuffer;
+struct SIO_State
+{
+ uint16 Status;
+ uint16 Mode;
+ uint16 Control;
+ uint16 BaudRate;
+ uint32 DataBuffer;
+
+ template<bool isReader> void SyncState(EW::NewState *ns);
+};
+
+#define SIO_S (*PSX_I->sio)
+
+void SIO_Init(void)
+{
+ PSX_I->sio = new SIO_State();
+}
+
+void SIO_Kill(void)
+{
+ delete PSX_I->sio;
+ PSX_I->sio = NULL;
+}
 
 void SIO_Power(void)
 {
- Status = 0;
- Mode = 0;
- Control = 0;
- BaudRate = 0;
- DataBuffer = 0;
+ SIO_S.Status = 0;
+ SIO_S.Mode = 0;
+ SIO_S.Control = 0;
+ SIO_S.BaudRate = 0;
+ SIO_S.DataBuffer = 0;
 }
 
 uint32 SIO_Read(pscpu_timestamp_t timestamp, uint32 A)
@@ -50,23 +68,23 @@ uint32 SIO_Read(pscpu_timestamp_t timestamp, uint32 A)
 
   case 0x0:
   //case 0x2:
-	ret = DataBuffer >> ((A & 2) * 8);
+	ret = SIO_S.DataBuffer >> ((A & 2) * 8);
 	break;
 
   case 0x4:
-	ret = Status;
+	ret = SIO_S.Status;
 	break;
 
   case 0x8:
-	ret = Mode;
+	ret = SIO_S.Mode;
 	break;
 
   case 0xA:
-	ret = Control;
+	ret = SIO_S.Control;
 	break;
 
   case 0xE:
-	ret = BaudRate;
+	ret = SIO_S.BaudRate;
 	break;
  }
 
@@ -86,25 +104,25 @@ void SIO_Write(pscpu_timestamp_t timestamp, uint32 A, uint32 V)
   case 0x0:
   //case 0x2:
 	V <<= (A & 2) * 8;
-	DataBuffer = V;
+	SIO_S.DataBuffer = V;
         break;
 
   case 0x8:
-        Mode = V;
+        SIO_S.Mode = V;
         break;
 
   case 0xA:
-        Control = V;
+        SIO_S.Control = V;
         break;
 
   case 0xE:
-        BaudRate = V;
+        SIO_S.BaudRate = V;
         break;
  }
 }
 
 
-void SIO_SyncState(bool isReader, EW::NewState *ns)
+SYNCFUNC(SIO_State)
 {
   NSS(Status);
   NSS(Mode);
@@ -113,4 +131,10 @@ void SIO_SyncState(bool isReader, EW::NewState *ns)
   NSS(DataBuffer);
 }
 
+void SIO_SyncState(bool isReader, EW::NewState *ns)
+{
+	if(isReader) SIO_S.SyncState<true>(ns);
+	else SIO_S.SyncState<false>(ns);
+}
+
 }
@@ -6,6 +6,8 @@ namespace MDFN_IEN_PSX
 
 void SIO_Write(pscpu_timestamp_t timestamp, uint32 A, uint32 V);
 uint32 SIO_Read(pscpu_timestamp_t timestamp, uint32 A);
+void SIO_Init(void) MDFN_COLD;
+void SIO_Kill(void) MDFN_COLD;
 void SIO_Power(void);
 
 }
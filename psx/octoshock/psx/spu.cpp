@@ -71,6 +71,15 @@
 #include "cdc.h"
 #include "spu.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPU_SIMD_SSE2
+#endif
+
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
 namespace MDFN_IEN_PSX
 {
 
@@ -79,6 +88,113 @@ static const int16 FIR_Table[256][4] =
  #include "spu_fir_table.inc"
 };
 
+//
+// Per-sample voice mixing inputs, gathered from the voices in structure-of-arrays form so all 24 can be interpolated and mixed at once.
+//
+struct SPU_VoiceMix
+{
+ int16 Taps[24][4];	// Decoded samples at the current read position.
+ int16 Coeffs[24][4];	// FIR_Table row for the current phase.
+ int32 Env[24];
+ int32 Volume[2][24];
+
+ int32 PVS[24];		// Output; after enveloping, but before L/R volume.
+};
+
+static INLINE int32 MixVoice(const SPU_VoiceMix* mix, const unsigned v)
+{
+ int32 pvs;
+
+ pvs = ((mix->Taps[v][0] * mix->Coeffs[v][0]) +
+        (mix->Taps[v][1] * mix->Coeffs[v][1]) +
+        (mix->Taps[v][2] * mix->Coeffs[v][2]) +
+        (mix->Taps[v][3] * mix->Coeffs[v][3])) >> 15;
+
+ return (pvs * mix->Env[v]) >> 15;
+}
+
+#ifdef SPU_SIMD_SSE2
+static INLINE __m128i MulLo32(const __m128i a, const __m128i b)
+{
+#if defined(__SSE4_1__)
+ return _mm_mullo_epi32(a, b);
+#else
+ // The low 32 bits of a product don't depend on signedness.
+ const __m128i even = _mm_mul_epu32(a, b);
+ const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+
+ return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+
+static INLINE int32 HorizontalSum32(__m128i v)
+{
+ v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+ v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+
+ return _mm_cvtsi128_si32(v);
+}
+#endif
+
+//
+// Same integer math as MixVoice() and the L/R volume stage; sums are exact, so the order they're added up in doesn't matter.
+//
+static void MixVoices(SPU_VoiceMix* mix, const uint32 reverb_mode, int32* accum, int32* accum_fv)
+{
+#ifdef SPU_SIMD_SSE2
+ const __m128i voice_bits = _mm_setr_epi32(1, 2, 4, 8);
+ __m128i sum_l = _mm_setzero_si128();
+ __m128i sum_r = _mm_setzero_si128();
+ __m128i sum_fv_l = _mm_setzero_si128();
+ __m128i sum_fv_r = _mm_setzero_si128();
+
+ for(unsigned v = 0; v < 24; v += 4)
+ {
+  // Two voices' worth of taps per register; pairwise sums of the products land in adjacent lanes.
+  const __m128 prod_a = _mm_castsi128_ps(_mm_madd_epi16(_mm_loadu_si128((const __m128i*)mix->Taps[v + 0]), _mm_loadu_si128((const __m128i*)mix->Coeffs[v + 0])));
+  const __m128 prod_b = _mm_castsi128_ps(_mm_madd_epi16(_mm_loadu_si128((const __m128i*)mix->Taps[v + 2]), _mm_loadu_si128((const __m128i*)mix->Coeffs[v + 2])));
+  __m128i pvs;
+
+  pvs = _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(prod_a, prod_b, _MM_SHUFFLE(2, 0, 2, 0))), _mm_castps_si128(_mm_shuffle_ps(prod_a, prod_b, _MM_SHUFFLE(3, 1, 3, 1))));
+  pvs = _mm_srai_epi32(pvs, 15);
+  pvs = _mm_srai_epi32(MulLo32(pvs, _mm_loadu_si128((const __m128i*)&mix->Env[v])), 15);
+  _mm_storeu_si128((__m128i*)&mix->PVS[v], pvs);
+
+  const __m128i l = _mm_srai_epi32(MulLo32(pvs, _mm_loadu_si128((const __m128i*)&mix->Volume[0][v])), 15);
+  const __m128i r = _mm_srai_epi32(MulLo32(pvs, _mm_loadu_si128((const __m128i*)&mix->Volume[1][v])), 15);
+  const __m128i rvb = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(reverb_mode >> v), voice_bits), voice_bits);
+
+  sum_l = _mm_add_epi32(sum_l, l);
+  sum_r = _mm_add_epi32(sum_r, r);
+  sum_fv_l = _mm_add_epi32(sum_fv_l, _mm_and_si128(l, rvb));
+  sum_fv_r = _mm_add_epi32(sum_fv_r, _mm_and_si128(r, rvb));
+ }
+
+ accum[0] += HorizontalSum32(sum_l);
+ accum[1] += HorizontalSum32(sum_r);
+ accum_fv[0] += HorizontalSum32(sum_fv_l);
+ accum_fv[1] += HorizontalSum32(sum_fv_r);
+#else
+ for(unsigned v = 0; v < 24; v++)
+ {
+  const int32 pvs = MixVoice(mix, v);
+  const int32 l = (pvs * mix->Volume[0][v]) >> 15;
+  const int32 r = (pvs * mix->Volume[1][v]) >> 15;
+
+  mix->PVS[v] = pvs;
+
+  accum[0] += l;
+  accum[1] += r;
+
+  if(reverb_mode & (1U << v))
+  {
+   accum_fv[0] += l;
+   accum_fv[1] += r;
+  }
+ }
+#endif
+}
+
 PS_SPU::PS_SPU()
 {
  last_rate = -1;
@@ -86,6 +202,10 @@ PS_SPU::PS_SPU()
 
  IntermediateBufferPos = 0;
  memset(IntermediateBuffer, 0, sizeof(IntermediateBuffer));
+
+ // Voices is saved whole, padding included, and Power() doesn't touch AuxRegs; keep states from differing between otherwise identical runs.
+ memset(Voices, 0, sizeof(Voices));
+ memset(AuxRegs, 0, sizeof(AuxRegs));
 }
 
 PS_SPU::~PS_SPU()
@@ -599,6 +719,8 @@ INLINE void PS_SPU::RunNoise(void)
 int32 PS_SPU::UpdateFromCDC(int32 clocks)
 //pscpu_timestamp_t PS_SPU::Update(const pscpu_timestamp_t timestamp)
 {
+ PSX_PERF_SCOPE(PSX_PERF_SPU);
+
  //int32 clocks = timestamp - lastts;
  int32 sample_clocks = 0;
  //lastts = timestamp;
@@ -660,12 +782,16 @@ while(sample_clocks > 0)
   if(Regs[0xD6] == 0x4)	// TODO: Investigate more(case 0x2C in global regs r/w handler)
    SPUStatus |= (CWA & 0x100) ? 0x800 : 0x000;
 
+  //
+  // Voices are handled in three passes.  The first runs the decoders in voice order(they can raise the SPU IRQ, and can read back
+  // what voices 1 and 3 write to SPU RAM), gathering what interpolation needs into VoiceMix; the second interpolates, envelopes, and mixes
+  // all 24 voices at once; and the third runs sweep, enveloping, and phase for each voice in order, as before.
+  //
+  SPU_VoiceMix VoiceMix;
+
   for(int voice_num = 0; voice_num < 24; voice_num++)
   {
    SPU_Voice *voice = &Voices[voice_num];
-   int32 voice_pvs;
-
-   voice->PreLRSample = 0;
 
    //PSX_WARNING("[SPU] Voice %d CurPhase=%08x, pitch=%04x, CurAddr=%08x", voice_num, voice->CurPhase, voice->Pitch, voice->CurAddr);
 
@@ -678,43 +804,48 @@ while(sample_clocks > 0)
    //
    //
    //
-   int l, r;
+   int16* taps = VoiceMix.Taps[voice_num];
+   int16* coeffs = VoiceMix.Coeffs[voice_num];
 
    if(Noise_Mode & (1 << voice_num))
-    voice_pvs = (int16)LFSR;
+   {
+    // (LFSR * 0x4000 + LFSR * 0x4000) >> 15 is exactly (int16)LFSR.
+    taps[0] = taps[1] = (int16)LFSR;
+    taps[2] = taps[3] = 0;
+    coeffs[0] = coeffs[1] = 0x4000;
+    coeffs[2] = coeffs[3] = 0;
+   }
    else
    {
     const int si = voice->DecodeReadPos;
     const int pi = ((voice->CurPhase & 0xFFF) >> 4);
 
-    voice_pvs = ((voice->DecodeBuffer[(si + 0) & 0x1F] * FIR_Table[pi][0]) +
-	         (voice->DecodeBuffer[(si + 1) & 0x1F] * FIR_Table[pi][1]) +
-	         (voice->DecodeBuffer[(si + 2) & 0x1F] * FIR_Table[pi][2]) +   
- 	         (voice->DecodeBuffer[(si + 3) & 0x1F] * FIR_Table[pi][3])) >> 15;
+    for(unsigned i = 0; i < 4; i++)
+    {
+     taps[i] = voice->DecodeBuffer[(si + i) & 0x1F];
+     coeffs[i] = FIR_Table[pi][i];
+    }
    }
 
-   voice_pvs = (voice_pvs * (int16)voice->ADSR.EnvLevel) >> 15;
-   voice->PreLRSample = voice_pvs;
+   VoiceMix.Env[voice_num] = (int16)voice->ADSR.EnvLevel;
+   VoiceMix.Volume[0][voice_num] = voice->Sweep[0].ReadVolume();
+   VoiceMix.Volume[1][voice_num] = voice->Sweep[1].ReadVolume();
 
    if(voice_num == 1 || voice_num == 3)
    {
     int index = voice_num >> 1;
 
-    WriteSPURAM(0x400 | (index * 0x200) | CWA, voice_pvs);
+    WriteSPURAM(0x400 | (index * 0x200) | CWA, MixVoice(&VoiceMix, voice_num));
    }
+  }
 
+  MixVoices(&VoiceMix, Reverb_Mode, accum, accum_fv);
 
-   l = (voice_pvs * voice->Sweep[0].ReadVolume()) >> 15;
-   r = (voice_pvs * voice->Sweep[1].ReadVolume()) >> 15;
+  for(int voice_num = 0; voice_num < 24; voice_num++)
+  {
+   SPU_Voice *voice = &Voices[voice_num];
 
-   accum[0] += l;
-   accum[1] += r;
-
-   if(Reverb_Mode & (1 << voice_num))
-   {
-    accum_fv[0] += l;
-    accum_fv[1] += r;
-	 }
+   voice->PreLRSample = VoiceMix.PVS[voice_num];
 
    // Run sweep
    for(int lr = 0; lr < 2; lr++)
@@ -810,7 +941,7 @@ while(sample_clocks > 0)
    int32 cda_raw[2];
    int32 cdav[2];
 
-   CDC->GetCDAudio(cda_raw);	// PS_CDC::GetCDAudio() guarantees the variables passed by reference will be set to 0,
+   PSX_I->CDC->GetCDAudio(cda_raw);	// PS_CDC::GetCDAudio() guarantees the variables passed by reference will be set to 0,
 				// and that their range shall be -32768 through 32767.
 
    WriteSPURAM(CWA | 0x000, cda_raw[0]);
@@ -1189,6 +1320,7 @@ SYNCFUNC(PS_SPU)
 {
 	NSS(Voices);
 
+  NSS(NoiseDivider);
   NSS(NoiseCounter);
   NSS(LFSR);
 
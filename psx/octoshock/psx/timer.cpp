@@ -91,10 +91,28 @@ struct Timer
  int32 DoZeCounting;
 };
 
-static bool vblank;
-static bool hretrace;
-static Timer Timers[3];
-static pscpu_timestamp_t lastts;
+struct TIMER_State
+{
+ bool vblank;
+ bool hretrace;
+ Timer Timers[3];
+ pscpu_timestamp_t lastts;
+
+ template<bool isReader> void SyncState(EW::NewState *ns);
+};
+
+#define TIMER_S (*PSX_I->timer)
+
+void TIMER_Init(void)
+{
+ PSX_I->timer = new TIMER_State();
+}
+
+void TIMER_Kill(void)
+{
+ delete PSX_I->timer;
+ PSX_I->timer = NULL;
+}
 
 static uint32 CalcNextEvent(void)
 {
@@ -102,10 +120,10 @@ static uint32 CalcNextEvent(void)
 
  for(unsigned i = 0; i < 3; i++)
  {
-  if(!(Timers[i].Mode & 0x30))	// If IRQ is disabled, abort for this timer(don't look at IRQDone for this test, or things will break since its resetting is deferred!).
+  if(!(TIMER_S.Timers[i].Mode & 0x30))	// If IRQ is disabled, abort for this timer(don't look at IRQDone for this test, or things will break since its resetting is deferred!).
    continue;
 
-  if((Timers[i].Mode & 0x8) && (Timers[i].Counter == 0) && (Timers[i].Target == 0) && !Timers[i].IRQDone)
+  if((TIMER_S.Timers[i].Mode & 0x8) && (TIMER_S.Timers[i].Counter == 0) && (TIMER_S.Timers[i].Target == 0) && !TIMER_S.Timers[i].IRQDone)
   {
    next_event = 1;
    continue;
@@ -113,24 +131,24 @@ static uint32 CalcNextEvent(void)
 
   //
   //
-  if((i == 0 || i == 1) && (Timers[i].Mode & 0x100))	// If clocked by GPU, abort for this timer(will result in poor granularity for pixel-clock-derived timer IRQs, but whatever).
+  if((i == 0 || i == 1) && (TIMER_S.Timers[i].Mode & 0x100))	// If clocked by GPU, abort for this timer(will result in poor granularity for pixel-clock-derived timer IRQs, but whatever).
    continue;
 
-  if(Timers[i].DoZeCounting <= 0)
+  if(TIMER_S.Timers[i].DoZeCounting <= 0)
    continue;
 
-  if((i == 0x2) && (Timers[i].Mode & 0x1))
+  if((i == 0x2) && (TIMER_S.Timers[i].Mode & 0x1))
    continue;
 
   //
   //
   //
-  const uint32 target = ((Timers[i].Mode & 0x18) && (Timers[i].Counter < Timers[i].Target)) ? Timers[i].Target : 0x10000;
-  const uint32 count_delta = target - Timers[i].Counter;
+  const uint32 target = ((TIMER_S.Timers[i].Mode & 0x18) && (TIMER_S.Timers[i].Counter < TIMER_S.Timers[i].Target)) ? TIMER_S.Timers[i].Target : 0x10000;
+  const uint32 count_delta = target - TIMER_S.Timers[i].Counter;
   uint32 tmp_clocks;
 
-  if((i == 0x2) && (Timers[i].Mode & 0x200))
-   tmp_clocks = (count_delta * 8) - Timers[i].Div8Counter;
+  if((i == 0x2) && (TIMER_S.Timers[i].Mode & 0x200))
+   tmp_clocks = (count_delta * 8) - TIMER_S.Timers[i].Div8Counter;
   else
    tmp_clocks = count_delta;
 
@@ -145,26 +163,26 @@ static bool TimerMatch(unsigned i)
 {
  bool irq_exact = false;
 
- Timers[i].Mode |= 0x0800;
+ TIMER_S.Timers[i].Mode |= 0x0800;
 
- if(Timers[i].Mode & 0x008)
-  Timers[i].Counter %= std::max<uint32>(1, Timers[i].Target);
+ if(TIMER_S.Timers[i].Mode & 0x008)
+  TIMER_S.Timers[i].Counter %= std::max<uint32>(1, TIMER_S.Timers[i].Target);
 
- if((Timers[i].Mode & 0x10) && !Timers[i].IRQDone)
+ if((TIMER_S.Timers[i].Mode & 0x10) && !TIMER_S.Timers[i].IRQDone)
  {
-  if(Timers[i].Counter == 0 || Timers[i].Counter == Timers[i].Target)
+  if(TIMER_S.Timers[i].Counter == 0 || TIMER_S.Timers[i].Counter == TIMER_S.Timers[i].Target)
    irq_exact = true;
 
 #if 1
   {
-   const uint16 lateness = (Timers[i].Mode & 0x008) ? Timers[i].Counter : (Timers[i].Counter - Timers[i].Target);
+   const uint16 lateness = (TIMER_S.Timers[i].Mode & 0x008) ? TIMER_S.Timers[i].Counter : (TIMER_S.Timers[i].Counter - TIMER_S.Timers[i].Target);
 
-   if(lateness > ((i == 1 && (Timers[i].Mode & 0x100)) ? 0 : 3))
+   if(lateness > ((i == 1 && (TIMER_S.Timers[i].Mode & 0x100)) ? 0 : 3))
     PSX_DBG(PSX_DBG_WARNING, "[TIMER] Timer %d match IRQ trigger late: %u\n", i, lateness);
   }
 #endif
 
-  Timers[i].IRQDone = true;
+  TIMER_S.Timers[i].IRQDone = true;
   IRQ_Assert(IRQ_TIMER_0 + i, true);
   IRQ_Assert(IRQ_TIMER_0 + i, false);
  }
@@ -176,20 +194,20 @@ static bool TimerOverflow(unsigned i)
 {
  bool irq_exact = false;
 
- Timers[i].Mode |= 0x1000;
- Timers[i].Counter &= 0xFFFF;
+ TIMER_S.Timers[i].Mode |= 0x1000;
+ TIMER_S.Timers[i].Counter &= 0xFFFF;
 
- if((Timers[i].Mode & 0x20) && !Timers[i].IRQDone)
+ if((TIMER_S.Timers[i].Mode & 0x20) && !TIMER_S.Timers[i].IRQDone)
  {
-  if(Timers[i].Counter == 0)
+  if(TIMER_S.Timers[i].Counter == 0)
    irq_exact = true;
 
 #if 1
-  if(Timers[i].Counter > ((i == 1 && (Timers[i].Mode & 0x100)) ? 0 : 3))
-   PSX_DBG(PSX_DBG_WARNING, "[TIMER] Timer %d overflow IRQ trigger late: %u\n", i, Timers[i].Counter);
+  if(TIMER_S.Timers[i].Counter > ((i == 1 && (TIMER_S.Timers[i].Mode & 0x100)) ? 0 : 3))
+   PSX_DBG(PSX_DBG_WARNING, "[TIMER] Timer %d overflow IRQ trigger late: %u\n", i, TIMER_S.Timers[i].Counter);
 #endif
 
-  Timers[i].IRQDone = true;
+  TIMER_S.Timers[i].IRQDone = true;
   IRQ_Assert(IRQ_TIMER_0 + i, true);
   IRQ_Assert(IRQ_TIMER_0 + i, false);
  }
@@ -199,164 +217,164 @@ static bool TimerOverflow(unsigned i)
 
 static void ClockTimer(int i, uint32 clocks)
 {
- if(Timers[i].DoZeCounting <= 0)
+ if(TIMER_S.Timers[i].DoZeCounting <= 0)
   clocks = 0;
 
  if(i == 0x2)
  {
   uint32 d8_clocks;
 
-  Timers[i].Div8Counter += clocks;
-  d8_clocks = Timers[i].Div8Counter >> 3;
-  Timers[i].Div8Counter &= 0x7;
+  TIMER_S.Timers[i].Div8Counter += clocks;
+  d8_clocks = TIMER_S.Timers[i].Div8Counter >> 3;
+  TIMER_S.Timers[i].Div8Counter &= 0x7;
 
-  if(Timers[i].Mode & 0x200)	// Divide by 8, at least for timer 0x2
+  if(TIMER_S.Timers[i].Mode & 0x200)	// Divide by 8, at least for timer 0x2
    clocks = d8_clocks;
 
-  if(Timers[i].Mode & 1)
+  if(TIMER_S.Timers[i].Mode & 1)
    clocks = 0;
  }
 
- if((Timers[i].Mode & 0x008) && Timers[i].Target == 0 && Timers[i].Counter == 0)
+ if((TIMER_S.Timers[i].Mode & 0x008) && TIMER_S.Timers[i].Target == 0 && TIMER_S.Timers[i].Counter == 0)
   TimerMatch(i);
  else if(clocks)
  {
-  uint32 before = Timers[i].Counter;
+  uint32 before = TIMER_S.Timers[i].Counter;
 
-  Timers[i].Counter += clocks;
+  TIMER_S.Timers[i].Counter += clocks;
 
-  if(Timers[i].Mode & 0x40)
-   Timers[i].IRQDone = false;
+  if(TIMER_S.Timers[i].Mode & 0x40)
+   TIMER_S.Timers[i].IRQDone = false;
 
   bool irq_exact = false;
 
   //
   // Target match handling
   //
-  if((before < Timers[i].Target && Timers[i].Counter >= Timers[i].Target) || (Timers[i].Counter >= Timers[i].Target + 0x10000))
+  if((before < TIMER_S.Timers[i].Target && TIMER_S.Timers[i].Counter >= TIMER_S.Timers[i].Target) || (TIMER_S.Timers[i].Counter >= TIMER_S.Timers[i].Target + 0x10000))
    irq_exact |= TimerMatch(i);
 
   //
   // Overflow handling
   //
-  if(Timers[i].Counter >= 0x10000)
+  if(TIMER_S.Timers[i].Counter >= 0x10000)
    irq_exact |= TimerOverflow(i);
 
   //
-  if((Timers[i].Mode & 0x40) && !irq_exact)
-   Timers[i].IRQDone = false;
+  if((TIMER_S.Timers[i].Mode & 0x40) && !irq_exact)
+   TIMER_S.Timers[i].IRQDone = false;
  }
 }
 
 void TIMER_SetVBlank(bool status)
 {
- switch(Timers[1].Mode & 0x7)
+ switch(TIMER_S.Timers[1].Mode & 0x7)
  {
   case 0x1:
-	Timers[1].DoZeCounting = !status;
+	TIMER_S.Timers[1].DoZeCounting = !status;
 	break;
 
   case 0x3:
-	if(vblank && !status)
+	if(TIMER_S.vblank && !status)
 	{
-	 Timers[1].Counter = 0;
-	 if(Timers[1].Counter == Timers[1].Target)
+	 TIMER_S.Timers[1].Counter = 0;
+	 if(TIMER_S.Timers[1].Counter == TIMER_S.Timers[1].Target)
 	  TimerMatch(1);
 	}
 	break;
 
   case 0x5:
-	Timers[1].DoZeCounting = status;
-	if(vblank && !status)
+	TIMER_S.Timers[1].DoZeCounting = status;
+	if(TIMER_S.vblank && !status)
 	{
-	 Timers[1].Counter = 0;
-	 if(Timers[1].Counter == Timers[1].Target)
+	 TIMER_S.Timers[1].Counter = 0;
+	 if(TIMER_S.Timers[1].Counter == TIMER_S.Timers[1].Target)
 	  TimerMatch(1);
 	}
 	break;
 
   case 0x7:
-	if(Timers[1].DoZeCounting == -1)
+	if(TIMER_S.Timers[1].DoZeCounting == -1)
 	{
-	 if(!vblank && status)
-	  Timers[1].DoZeCounting = 0;
+	 if(!TIMER_S.vblank && status)
+	  TIMER_S.Timers[1].DoZeCounting = 0;
 	}
-	else if(Timers[1].DoZeCounting == 0)
+	else if(TIMER_S.Timers[1].DoZeCounting == 0)
 	{
-	 if(vblank && !status)
-	  Timers[1].DoZeCounting = 1;
+	 if(TIMER_S.vblank && !status)
+	  TIMER_S.Timers[1].DoZeCounting = 1;
 	}
 	break;
  }
- vblank = status;
+ TIMER_S.vblank = status;
 }
 
 void TIMER_SetHRetrace(bool status)
 {
- if(hretrace && !status)
+ if(TIMER_S.hretrace && !status)
  {
-  if((Timers[0].Mode & 0x7) == 0x3)
+  if((TIMER_S.Timers[0].Mode & 0x7) == 0x3)
   {
-   Timers[0].Counter = 0;
+   TIMER_S.Timers[0].Counter = 0;
 
-   if(Timers[0].Counter == Timers[0].Target)
+   if(TIMER_S.Timers[0].Counter == TIMER_S.Timers[0].Target)
     TimerMatch(0);
   }
  }
 
- hretrace = status;
+ TIMER_S.hretrace = status;
 }
 
 void TIMER_AddDotClocks(uint32 count)
 {
- if(Timers[0].Mode & 0x100)
+ if(TIMER_S.Timers[0].Mode & 0x100)
   ClockTimer(0, count);
 }
 
 void TIMER_ClockHRetrace(void)
 {
- if(Timers[1].Mode & 0x100)
+ if(TIMER_S.Timers[1].Mode & 0x100)
   ClockTimer(1, 1);
 }
 
 pscpu_timestamp_t TIMER_Update(const pscpu_timestamp_t timestamp)
 {
- int32 cpu_clocks = timestamp - lastts;
+ int32 cpu_clocks = timestamp - TIMER_S.lastts;
 
  for(int i = 0; i < 3; i++)
  {
   uint32 timer_clocks = cpu_clocks;
 
-  if(Timers[i].Mode & 0x100)
+  if(TIMER_S.Timers[i].Mode & 0x100)
    continue;
 
   ClockTimer(i, timer_clocks);
  }
 
- lastts = timestamp;
+ TIMER_S.lastts = timestamp;
 
  return(timestamp + CalcNextEvent());
 }
 
 static void CalcCountingStart(unsigned which)
 {
- Timers[which].DoZeCounting = true;
+ TIMER_S.Timers[which].DoZeCounting = true;
 
  switch(which)
  {
   case 1:
-	switch(Timers[which].Mode & 0x07)
+	switch(TIMER_S.Timers[which].Mode & 0x07)
 	{
 	 case 0x1:
-		Timers[which].DoZeCounting = !vblank;
+		TIMER_S.Timers[which].DoZeCounting = !TIMER_S.vblank;
 		break;
 
 	 case 0x5:
-		Timers[which].DoZeCounting = vblank;
+		TIMER_S.Timers[which].DoZeCounting = TIMER_S.vblank;
 		break;
 
 	 case 0x7:
-		Timers[which].DoZeCounting = -1;
+		TIMER_S.Timers[which].DoZeCounting = -1;
 		break;
 	}
 	break;
@@ -380,25 +398,25 @@ void TIMER_Write(const pscpu_timestamp_t timestamp, uint32 A, uint16 V)
 
  switch(A & 0xC)
  {
-  case 0x0: Timers[which].IRQDone = false;
-	    Timers[which].Counter = V & 0xFFFF;
+  case 0x0: TIMER_S.Timers[which].IRQDone = false;
+	    TIMER_S.Timers[which].Counter = V & 0xFFFF;
 	    break;
 
-  case 0x4: Timers[which].Mode = (V & 0x3FF) | (Timers[which].Mode & 0x1C00);
-	    Timers[which].IRQDone = false;
-	    Timers[which].Counter = 0;
+  case 0x4: TIMER_S.Timers[which].Mode = (V & 0x3FF) | (TIMER_S.Timers[which].Mode & 0x1C00);
+	    TIMER_S.Timers[which].IRQDone = false;
+	    TIMER_S.Timers[which].Counter = 0;
 
 	    CalcCountingStart(which);	// Call after setting .Mode
 	    break;
 
-  case 0x8: Timers[which].Target = V & 0xFFFF;
+  case 0x8: TIMER_S.Timers[which].Target = V & 0xFFFF;
 	    break;
 
   case 0xC: // Open bus
 	    break;
  }
 
- if(Timers[which].Counter == Timers[which].Target)
+ if(TIMER_S.Timers[which].Counter == TIMER_S.Timers[which].Target)
   TimerMatch(which);
 
  PSX_SetEventNT(PSX_EVENT_TIMER, timestamp + CalcNextEvent());
@@ -420,16 +438,16 @@ uint16 TIMER_Read(const pscpu_timestamp_t timestamp, uint32 A)
 
  switch(A & 0xC)
  {
-  case 0x0: ret = Timers[which].Counter;
+  case 0x0: ret = TIMER_S.Timers[which].Counter;
 	    break;
 
-  case 0x4: ret = Timers[which].Mode;
-	    Timers[which].Mode &= ~0x1000;
-	    if(Timers[which].Counter != Timers[which].Target)
-	     Timers[which].Mode &= ~0x0800;
+  case 0x4: ret = TIMER_S.Timers[which].Mode;
+	    TIMER_S.Timers[which].Mode &= ~0x1000;
+	    if(TIMER_S.Timers[which].Counter != TIMER_S.Timers[which].Target)
+	     TIMER_S.Timers[which].Mode &= ~0x0800;
 	    break;
 
-  case 0x8: ret = Timers[which].Target;
+  case 0x8: ret = TIMER_S.Timers[which].Target;
 	    break;
 
   case 0xC: PSX_WARNING("[TIMER] Open Bus Read: 0x%08x", A);
@@ -442,26 +460,32 @@ uint16 TIMER_Read(const pscpu_timestamp_t timestamp, uint32 A)
 
 void TIMER_ResetTS(void)
 {
- lastts = 0;
+ TIMER_S.lastts = 0;
 }
 
 
 void TIMER_Power(void)
 {
- lastts = 0;
+ TIMER_S.lastts = 0;
 
- hretrace = false;
- vblank = false;
- memset(Timers, 0, sizeof(Timers));
+ TIMER_S.hretrace = false;
+ TIMER_S.vblank = false;
+ memset(TIMER_S.Timers, 0, sizeof(TIMER_S.Timers));
 }
 
-void TIMER_SyncState(bool isReader, EW::NewState *ns)
+SYNCFUNC(TIMER_State)
 {
 	NSS(Timers);
   NSS(vblank);
   NSS(hretrace);
 }
 
+void TIMER_SyncState(bool isReader, EW::NewState *ns)
+{
+	if(isReader) TIMER_S.SyncState<true>(ns);
+	else TIMER_S.SyncState<false>(ns);
+}
+
 uint32 TIMER_GetRegister(unsigned int which, char *special, const uint32 special_len)
 {
  int tw = (which >> 4) & 0x3;
@@ -470,15 +494,15 @@ uint32 TIMER_GetRegister(unsigned int which, char *special, const uint32 special
  switch(which & 0xF)
  {
   case TIMER_GSREG_COUNTER0:
-	ret = Timers[tw].Counter;
+	ret = TIMER_S.Timers[tw].Counter;
 	break;
 
   case TIMER_GSREG_MODE0:
-	ret = Timers[tw].Mode;
+	ret = TIMER_S.Timers[tw].Mode;
 	break;
 
   case TIMER_GSREG_TARGET0:
-	ret = Timers[tw].Target;
+	ret = TIMER_S.Timers[tw].Target;
 	break;
  }
 
@@ -492,19 +516,19 @@ void TIMER_SetRegister(unsigned int which, uint32 value)
  switch(which & 0xF)
  {
   case TIMER_GSREG_COUNTER0:
-	Timers[tw].Counter = value & 0xFFFF;
+	TIMER_S.Timers[tw].Counter = value & 0xFFFF;
 	break;
 
   case TIMER_GSREG_MODE0:
-	Timers[tw].Mode = value & 0xFFFF;
+	TIMER_S.Timers[tw].Mode = value & 0xFFFF;
 	break;
 
   case TIMER_GSREG_TARGET0:
-	Timers[tw].Target = value & 0xFFFF;
+	TIMER_S.Timers[tw].Target = value & 0xFFFF;
 	break;
  }
 
- if (Timers[tw].Counter == Timers[tw].Target)
+ if (TIMER_S.Timers[tw].Counter == TIMER_S.Timers[tw].Target)
 	 TimerMatch(tw);
 
 }
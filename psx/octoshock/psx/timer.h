@@ -34,6 +34,8 @@ void TIMER_SetVBlank(bool status);
 pscpu_timestamp_t TIMER_Update(const pscpu_timestamp_t);
 void TIMER_ResetTS(void);
 
+void TIMER_Init(void) MDFN_COLD;
+void TIMER_Kill(void) MDFN_COLD;
 void TIMER_Power(void) MDFN_COLD;
 
 }
@@ -0,0 +1,294 @@
+//headless benchmark for the octoshock core.
+//boots a disc image (.bin, single raw 2352 byte data track) or a PS-EXE, runs it for a number of frames and reports the speed,
+//the time spent in each subsystem (when built with PERF=1) and a hash of the final savestate, so runs can be checked against each other.
+//
+//usage: octoshock-bench <bios> <disc.bin|game.exe> <frames> [-i script] [-r] [-t threads]
+//  -i script   scripted input for the dualshock on port 1: one "frame buttons" pair per line (buttons in hex), held from that frame on
+//  -r          use the dynamic recompiler
+//  -t threads  number of GPU raster threads
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "octoshock.h"
+#include "psx/psx.h"
+
+struct InputEvent
+{
+	int frame;
+	u32 buttons;
+};
+
+static bool ReadFile(const char* path, std::vector<u8>& out)
+{
+	FILE* inf = fopen(path,"rb");
+	if(!inf) return false;
+	fseek(inf,0,SEEK_END);
+	long sz = ftell(inf);
+	fseek(inf,0,SEEK_SET);
+	out.resize(sz);
+	bool ok = sz == 0 || fread(&out[0],1,sz,inf) == (size_t)sz;
+	fclose(inf);
+	return ok;
+}
+
+static bool ReadScript(const char* path, std::vector<InputEvent>& out)
+{
+	FILE* inf = fopen(path,"r");
+	if(!inf) return false;
+	char line[256];
+	while(fgets(line,sizeof(line),inf))
+	{
+		InputEvent ev;
+		if(line[0] == '#') continue;
+		if(sscanf(line,"%d %x",&ev.frame,&ev.buttons) == 2)
+			out.push_back(ev);
+	}
+	fclose(inf);
+	return true;
+}
+
+//FNV-1a
+static u64 Hash(const u8* data, size_t len)
+{
+	u64 hash = 0xcbf29ce484222325ULL;
+	for(size_t i=0;i<len;i++)
+	{
+		hash ^= data[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+//same as the miniclient's reader, minus the lookup table for the subchannel Q crc
+class BinReader2352
+{
+public:
+	BinReader2352(FILE* inf)
+		: inf(inf)
+	{
+		fseek(inf,0,SEEK_END);
+		lbaCount = (int)(ftell(inf)/2352);
+		fseek(inf,0,SEEK_SET);
+
+		shock_CreateDisc(&disc,this,lbaCount,s_ReadTOC,s_ReadLBA2448,false);
+	}
+
+	~BinReader2352()
+	{
+		shock_DestroyDisc(disc);
+		fclose(inf);
+	}
+
+	ShockDiscRef* disc;
+
+private:
+	FILE* inf;
+	int lbaCount;
+
+	static s32 s_ReadTOC(void* opaque, ShockTOC *read_target, ShockTOCTrack tracks[100 + 1]) { return ((BinReader2352*)opaque)->ReadTOC(read_target, tracks); }
+	static s32 s_ReadLBA2448(void* opaque, s32 lba, void* dst) { return ((BinReader2352*)opaque)->ReadLBA2448(lba,dst); }
+
+	s32 ReadTOC(ShockTOC *read_target, ShockTOCTrack tracks[100 + 1])
+	{
+		memset(read_target,0,sizeof(*read_target));
+		read_target->disc_type = 0;
+		read_target->first_track = 1;
+		read_target->last_track = 1;
+		tracks[1].adr = 1;
+		tracks[1].lba = 0;
+		tracks[1].control = 4;
+		tracks[2].adr = 1;
+		tracks[2].lba = lbaCount;
+		tracks[2].control = 0;
+		tracks[100].adr = 1;
+		tracks[100].lba = lbaCount;
+		tracks[100].control = 0;
+		return SHOCK_OK;
+	}
+
+	s32 ReadLBA2448(s32 lba, void* dst)
+	{
+		memset(dst,0,2448);
+		fseek(inf,lba*2352,SEEK_SET);
+		if(fread(dst,1,2352,inf) != 2352)
+			return SHOCK_ERROR;
+		MakeSubPQ(lba,(u8*)dst+2352);
+		return SHOCK_OK;
+	}
+
+	static u8 U8_to_BCD(u8 num) { return ((num / 10) << 4) + (num % 10); }
+
+	static void MakeSubPQ(int lba, u8* SubPWBuf)
+	{
+		u8 buf[0xC];
+		const u32 abs_lba = lba + 150;
+
+		memset(buf, 0, 0xC);
+		buf[0] = 0x01 | (0x04 << 4);
+		buf[1] = U8_to_BCD(1);
+		buf[2] = U8_to_BCD(1);
+		buf[3] = U8_to_BCD(lba / 75 / 60);
+		buf[4] = U8_to_BCD((lba / 75) % 60);
+		buf[5] = U8_to_BCD(lba % 75);
+		buf[7] = U8_to_BCD(abs_lba / 75 / 60);
+		buf[8] = U8_to_BCD((abs_lba / 75) % 60);
+		buf[9] = U8_to_BCD(abs_lba % 75);
+
+		u16 crc = 0;
+		for(int i = 0; i < 0xA; i++)
+		{
+			crc ^= buf[i] << 8;
+			for(int b = 0; b < 8; b++)
+				crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+		}
+		buf[0xA] = ~(crc >> 8);
+		buf[0xB] = ~crc;
+
+		for(int i = 0; i < 96; i++)
+			SubPWBuf[i] |= ((buf[i >> 3] >> (7 - (i & 0x7))) & 1) ? 0x40 : 0x00;
+	}
+};
+
+static int Usage()
+{
+	printf("usage: octoshock-bench <bios> <disc.bin|game.exe> <frames> [-i script] [-r] [-t threads]\n");
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	if(argc < 4)
+		return Usage();
+
+	const char* fwpath = argv[1];
+	const char* gamepath = argv[2];
+	const int frames = atoi(argv[3]);
+	const char* scriptpath = NULL;
+	bool recompiler = false;
+	int threads = 0;
+
+	for(int i=4;i<argc;i++)
+	{
+		if(!strcmp(argv[i],"-i") && i+1 < argc) scriptpath = argv[++i];
+		else if(!strcmp(argv[i],"-r")) recompiler = true;
+		else if(!strcmp(argv[i],"-t") && i+1 < argc) threads = atoi(argv[++i]);
+		else return Usage();
+	}
+
+	std::vector<u8> firmware;
+	if(!ReadFile(fwpath,firmware) || firmware.size() < 512*1024)
+	{
+		printf("couldn't read the 512KB bios from %s\n",fwpath);
+		return 1;
+	}
+
+	std::vector<InputEvent> script;
+	if(scriptpath && !ReadScript(scriptpath,script))
+	{
+		printf("couldn't read the input script %s\n",scriptpath);
+		return 1;
+	}
+
+	const size_t namelen = strlen(gamepath);
+	const bool isexe = namelen > 4 && (!strcmp(gamepath+namelen-4,".exe") || !strcmp(gamepath+namelen-4,".EXE"));
+
+	std::vector<u8> exe;
+	BinReader2352* bin = NULL;
+	if(isexe)
+	{
+		if(!ReadFile(gamepath,exe) || exe.size() < 0x800)
+		{
+			printf("couldn't read the PS-EXE %s\n",gamepath);
+			return 1;
+		}
+	}
+	else
+	{
+		FILE* inf = fopen(gamepath,"rb");
+		if(!inf)
+		{
+			printf("couldn't open the disc image %s\n",gamepath);
+			return 1;
+		}
+		bin = new BinReader2352(inf);
+	}
+
+	//same setup sequence as the frontend
+	void* psx = NULL;
+	shock_Create(&psx, REGION_NA, &firmware[0]);
+	if(isexe)
+	{
+		shock_MountEXE(psx, &exe[0], (s32)exe.size(), 0);
+		shock_CloseTray(psx);
+	}
+	else
+	{
+		shock_OpenTray(psx);
+		shock_SetDisc(psx,bin->disc);
+		shock_CloseTray(psx);
+	}
+	shock_Peripheral_Connect(psx,0x01,ePeripheralType_DualShock);
+
+	ShockRenderOptions opts;
+	memset(&opts,0,sizeof(opts));
+	opts.scanline_start = 0;
+	opts.scanline_end = 239;
+	opts.renderType = eShockRenderType_Normal;
+	opts.deinterlaceMode = eShockDeinterlaceMode_Weave;
+	opts.renderThreads = threads;
+	shock_SetRenderOptions(psx,&opts);
+	shock_SetRecompiler(psx,recompiler);
+
+	shock_PowerOn(psx);
+
+	ShockPerfCounters perf;
+	const bool haveperf = shock_GetPerfCounters(psx,&perf,true) == SHOCK_OK;
+
+	size_t scriptpos = 0;
+	u32 buttons = 0;
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for(int frame=0;frame<frames;frame++)
+	{
+		while(scriptpos < script.size() && script[scriptpos].frame <= frame)
+			buttons = script[scriptpos++].buttons;
+		shock_Peripheral_SetPadInput(psx,0x01,buttons,0x80,0x80,0x80,0x80);
+		shock_Step(psx,eShockStep_Frame);
+		shock_GetSamples(psx,NULL);
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printf("%d frames in %.3f s: %.2f fps\n",frames,seconds,seconds > 0 ? frames / seconds : 0.0);
+
+	if(haveperf)
+	{
+		shock_GetPerfCounters(psx,&perf,false);
+		const u64 ns[] = { perf.cpu, perf.gpu, perf.spu, perf.cdc, perf.mdec, perf.other };
+		const char* names[] = { "cpu", "gpu", "spu", "cdc", "mdec", "other" };
+		u64 total = 0;
+		for(int i=0;i<6;i++) total += ns[i];
+		for(int i=0;i<6;i++)
+			printf("  %-6s %10.2f ms %6.2f%%\n",names[i],ns[i] / 1000000.0,total ? ns[i] * 100.0 / total : 0.0);
+	}
+	else printf("  (subsystem timers not compiled in; rebuild with PERF=1)\n");
+
+	ShockStateTransaction transaction;
+	memset(&transaction,0,sizeof(transaction));
+	transaction.transaction = eShockStateTransaction_BinarySize;
+	const s32 size = shock_StateTransaction(psx,&transaction);
+	std::vector<u8> state(size);
+	transaction.transaction = eShockStateTransaction_BinarySave;
+	transaction.buffer = &state[0];
+	transaction.bufferLength = size;
+	shock_StateTransaction(psx,&transaction);
+	printf("state hash: %016llx (%d bytes)\n",(unsigned long long)Hash(&state[0],state.size()),size);
+
+	shock_Destroy(psx);
+	delete bin;
+
+	return 0;
+}
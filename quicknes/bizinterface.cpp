@@ -1,6 +1,9 @@
 #include <cstdlib>
 #include <cstring>
+#include <atomic>
+#include <immintrin.h>
 #include "nes_emu/Nes_Emu.h"
+#include "../corebatch/corebatch.h"
 
 // simulate the write so we'll know how long the buffer needs to be
 class Sim_Writer : public Data_Writer
@@ -52,6 +55,24 @@ EXPORT void qn_delete(Nes_Emu *e)
 	delete e;
 }
 
+// makes a new context that's a copy of e.  the cartridge and its tile cache are shared with e and freed with the last context using them
+EXPORT Nes_Emu *qn_fork(Nes_Emu *e)
+{
+	Nes_Emu *ret = new Nes_Emu();
+	if (ret->fork_from(*e))
+	{
+		delete ret;
+		return NULL;
+	}
+	return ret;
+}
+
+// copies e's current state into a context previously forked from it.  much cheaper than qn_fork()
+EXPORT const char *qn_fork_sync(Nes_Emu *dest, Nes_Emu *e)
+{
+	return dest->fork_from(*e);
+}
+
 EXPORT const char *qn_loadines(Nes_Emu *e, const void *data, int length)
 {
 	Mem_File_Reader r(data, length);
@@ -72,29 +93,105 @@ EXPORT const char *qn_emulate_frame(Nes_Emu *e, int pad1, int pad2)
 	return e->emulate_frame(pad1, pad2);
 }
 
+// runs one frame on each of a list of contexts, spread over a CoreBatch.  the contexts don't share
+// anything that changes while emulating, not even when forked from each other, so they need no locking
+class Qn_Batch
+{
+public:
+	Qn_Batch(int threads)
+		:pool(threads)
+	{
+	}
+
+	const char *EmulateFrame(Nes_Emu **emus, const int *pad1, const int *pad2, int count)
+	{
+		std::atomic<const char *> error(NULL);
+		pool.Run(count, [&](int i, int)
+		{
+			const char *err = emus[i]->emulate_frame(pad1[i], pad2[i]);
+			const char *none = NULL;
+			if (err)
+				error.compare_exchange_strong(none, err);
+		});
+		return error;
+	}
+
+private:
+	CoreBatch pool;
+};
+
+// threads <= 0 means one per hardware thread
+EXPORT Qn_Batch *qn_batch_new(int threads)
+{
+	return new Qn_Batch(threads);
+}
+
+EXPORT void qn_batch_delete(Qn_Batch *b)
+{
+	delete b;
+}
+
+// runs emus[i] for one frame with pad1[i] and pad2[i], for each i < count.  the contexts must all be different
+EXPORT const char *qn_batch_emulate_frame(Qn_Batch *b, Nes_Emu **emus, const int *pad1, const int *pad2, int count)
+{
+	return b->EmulateFrame(emus, pad1, pad2, count);
+}
+
+static void blit_rows(int32_t *dest, const unsigned char *src, const unsigned char *srcend, int srcpitch, int rowlen, const int32_t *table)
+{
+	for (; src < srcend; src += srcpitch)
+	{
+		for (int i = 0; i < rowlen; i++)
+		{
+			*dest++ = table[src[i]];
+		}
+	}
+}
+
+__attribute__((target("avx2")))
+static void blit_rows_avx2(int32_t *dest, const unsigned char *src, const unsigned char *srcend, int srcpitch, int rowlen, const int32_t *table)
+{
+	for (; src < srcend; src += srcpitch)
+	{
+		int i = 0;
+		for (; i + 8 <= rowlen; i += 8)
+		{
+			__m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(src + i)));
+			_mm256_storeu_si256((__m256i *)dest, _mm256_i32gather_epi32((const int *)table, idx, 4));
+			dest += 8;
+		}
+		for (; i < rowlen; i++)
+		{
+			*dest++ = table[src[i]];
+		}
+	}
+}
+
 EXPORT void qn_blit(Nes_Emu *e, int32_t *dest, const int32_t *colors, int cropleft, int croptop, int cropright, int cropbottom)
 {
-	// what is the point of the 256 color bitmap and the dynamic color allocation to it?
-	// why not just render directly to a 512 color bitmap with static palette positions?
+	// the frame holds 8 bit indexes into the host palette, whose entries are in turn 9 bit indexes
+	// (6 bit color plus 3 emphasis bits) into the static 512 color table.  fold both lookups into one
+	// 256 entry table, so each pixel is a single load (or a gather of 8).
+	static const bool avx2 = __builtin_cpu_supports("avx2");
 
 	const int srcpitch = e->frame().pitch;
 	const unsigned char *src = e->frame().pixels;
 	const unsigned char *const srcend = src + (e->image_height - cropbottom) * srcpitch;
 
 	const short *lut = e->frame().palette;
+	int32_t table[Nes_Emu::max_palette_size];
+	for (int i = 0; i < Nes_Emu::max_palette_size; i++)
+		table[i] = colors[lut[i] & (Nes_Emu::color_table_size - 1)];
 
 	const int rowlen = 256 - cropleft - cropright;
 
 	src += cropleft;
 	src += croptop * srcpitch;
 
-	for (; src < srcend; src += srcpitch)
-	{
-		for (int i = 0; i < rowlen; i++)
-		{
-			*dest++ = colors[lut[src[i]]];
-		}
-	}
+	if (avx2)
+		blit_rows_avx2(dest, src, srcend, srcpitch, rowlen, table);
+	else
+		blit_rows(dest, src, srcend, srcpitch, rowlen, table);
 }
 
 EXPORT const Nes_Emu::rgb_t *qn_get_default_colors()
@@ -152,6 +249,26 @@ EXPORT const char *qn_state_load(Nes_Emu *e, const void *src, int size)
 	return e->load_state(a);
 }
 
+// raw in-memory snapshot: fixed size, and much faster than qn_state_save/qn_state_load,
+// but only loadable by the same build of this library
+EXPORT int qn_flat_state_size(Nes_Emu *e)
+{
+	return Nes_Emu::flat_state_size;
+}
+
+EXPORT const char *qn_flat_state_save(Nes_Emu *e, void *dest, int size)
+{
+	if (size != Nes_Emu::flat_state_size)
+		return "Wrong flat state size!";
+	e->save_flat_state(dest);
+	return 0;
+}
+
+EXPORT const char *qn_flat_state_load(Nes_Emu *e, const void *src, int size)
+{
+	return e->load_flat_state(src, size);
+}
+
 EXPORT int qn_has_battery_ram(Nes_Emu *e)
 {
 	return e->has_battery_ram();
@@ -69,7 +69,7 @@ void Nes_Core::close()
 	disable_rendering();
 }
 
-blargg_err_t Nes_Core::open( Nes_Cart const* new_cart )
+blargg_err_t Nes_Core::open( Nes_Cart const* new_cart, Nes_Core const* chr_cache_source )
 {
 	close();
 	
@@ -79,7 +79,8 @@ blargg_err_t Nes_Core::open( Nes_Cart const* new_cart )
 	if ( !mapper ) 
 		return unsupported_mapper;
 	
-	RETURN_ERR( ppu.open_chr( new_cart->chr(), new_cart->chr_size() ) );
+	RETURN_ERR( ppu.open_chr( new_cart->chr(), new_cart->chr_size(),
+			chr_cache_source ? &chr_cache_source->ppu : 0 ) );
 	
 	cart = new_cart;
 	memset( impl->unmapped_page, unmapped_fill, sizeof impl->unmapped_page );
@@ -21,7 +21,7 @@ public:
 	~Nes_Core();
 	
 	blargg_err_t init();
-	blargg_err_t open( Nes_Cart const* );
+	blargg_err_t open( Nes_Cart const*, Nes_Core const* chr_cache_source = 0 );
 	void reset( bool full_reset = true, bool erase_battery_ram = false );
 	blip_time_t emulate_frame();
 	void close();
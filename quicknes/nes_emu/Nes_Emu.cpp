@@ -86,15 +86,20 @@ void Nes_Emu::close()
 	if ( cart() )
 	{
 		emu.close();
-		private_cart.clear();
+		private_cart.reset();
 	}
 }
 
 blargg_err_t Nes_Emu::set_cart( Nes_Cart const* new_cart )
+{
+	return open_cart( new_cart, NULL );
+}
+
+blargg_err_t Nes_Emu::open_cart( Nes_Cart const* new_cart, Nes_Emu const* chr_cache_source )
 {
 	close();
 	RETURN_ERR( auto_init() );
-	RETURN_ERR( emu.open( new_cart ) );
+	RETURN_ERR( emu.open( new_cart, chr_cache_source ? &chr_cache_source->emu : NULL ) );
 	
 	channel_count_ = Nes_Apu::osc_count + emu.mapper->channel_count();
 	RETURN_ERR( sound_buf->set_channel_count( channel_count() ) );
@@ -106,6 +111,31 @@ blargg_err_t Nes_Emu::set_cart( Nes_Cart const* new_cart )
 	return 0;
 }
 
+blargg_err_t Nes_Emu::fork_from( Nes_Emu const& src )
+{
+	require( src.cart() );
+	
+	if ( cart() != src.cart() )
+	{
+		if ( src.default_sound_buf && !default_sound_buf )
+			RETURN_ERR( set_sample_rate( src.sound_buf->sample_rate() ) );
+		equalizer_ = src.equalizer_;
+		close();
+		private_cart = src.private_cart;
+		RETURN_ERR( open_cart( src.cart(), &src ) );
+	}
+	
+	set_sprite_mode( (sprite_mode_t) src.emu.ppu.sprite_limit );
+	set_palette_range( src.emu.ppu.palette_begin, src.emu.ppu.palette_begin + src.host_palette_size );
+	
+	Nes_State* state = BLARGG_NEW Nes_State;
+	CHECK_ALLOC( state );
+	src.save_state( state );
+	load_state( *state );
+	delete state;
+	return 0;
+}
+
 void Nes_Emu::reset( bool full_reset, bool erase_battery_ram )
 {
 	require( cart() );
@@ -184,8 +214,11 @@ blargg_err_t Nes_Emu::emulate_frame( const uint32_t joypad1, const uint32_t joyp
 blargg_err_t Nes_Emu::load_ines( Auto_File_Reader in )
 {
 	close();
-	RETURN_ERR( private_cart.load_ines( in ) );
-	return set_cart( &private_cart );
+	Nes_Cart* new_cart = BLARGG_NEW Nes_Cart;
+	CHECK_ALLOC( new_cart );
+	private_cart.reset( new_cart );
+	RETURN_ERR( new_cart->load_ines( in ) );
+	return set_cart( new_cart );
 }
 
 blargg_err_t Nes_Emu::save_battery_ram( Auto_File_Writer out )
@@ -234,6 +267,73 @@ blargg_err_t Nes_Emu::save_state( Auto_File_Writer out ) const
 	return err;
 }
 
+long const Nes_Emu::flat_state_size = sizeof (Nes_Flat_State);
+
+// Nes_State_ that reads and writes a Nes_Flat_State in place
+static void point_at( Nes_State_* s, Nes_Flat_State* f )
+{
+	s->cpu       = &f->cpu;
+	s->joypad    = &f->joypad;
+	s->apu       = &f->apu;
+	s->ppu       = &f->ppu;
+	s->mapper    = &f->mapper;
+	s->ram       = f->ram;
+	s->sram      = f->sram;
+	s->spr_ram   = f->spr_ram;
+	s->nametable = f->nametable;
+	s->chr       = f->chr;
+}
+
+void Nes_Emu::save_flat_state( void* out ) const
+{
+	Nes_Flat_State* f = (Nes_Flat_State*) out;
+	memset( f, 0, sizeof *f ); // unused parts of chr/sram stay identical between saves
+	Nes_State_ s;
+	point_at( &s, f );
+	save_state( &s );
+	
+	f->tag_           = Nes_Flat_State::tag;
+	f->version        = Nes_Flat_State::current_version;
+	f->size           = sizeof *f;
+	f->nes            = s.nes;
+	f->nes_valid      = s.nes_valid;
+	f->cpu_valid      = s.cpu_valid;
+	f->joypad_valid   = s.joypad_valid;
+	f->apu_valid      = s.apu_valid;
+	f->ppu_valid      = s.ppu_valid;
+	f->mapper_valid   = s.mapper_valid;
+	f->ram_valid      = s.ram_valid;
+	f->spr_ram_valid  = s.spr_ram_valid;
+	f->sram_size      = s.sram_size;
+	f->nametable_size = s.nametable_size;
+	f->chr_size       = s.chr_size;
+}
+
+blargg_err_t Nes_Emu::load_flat_state( void const* in, long size )
+{
+	Nes_Flat_State* f = (Nes_Flat_State*) in;
+	if ( size != (long) sizeof *f || f->tag_ != (BOOST::uint32_t) Nes_Flat_State::tag ||
+			f->version != Nes_Flat_State::current_version || f->size != sizeof *f )
+		return "Not a flat state from this version";
+	
+	Nes_State_ s;
+	point_at( &s, f );
+	s.nes            = f->nes;
+	s.nes_valid      = f->nes_valid;
+	s.cpu_valid      = f->cpu_valid;
+	s.joypad_valid   = f->joypad_valid;
+	s.apu_valid      = f->apu_valid;
+	s.ppu_valid      = f->ppu_valid;
+	s.mapper_valid   = f->mapper_valid;
+	s.ram_valid      = f->ram_valid;
+	s.spr_ram_valid  = f->spr_ram_valid;
+	s.sram_size      = f->sram_size;
+	s.nametable_size = f->nametable_size;
+	s.chr_size       = f->chr_size;
+	load_state( s );
+	return 0;
+}
+
 void Nes_Emu::write_chr( void const* p, long count, long offset )
 {
 	require( (unsigned long) offset <= (unsigned long) chr_size() );
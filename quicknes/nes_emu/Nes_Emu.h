@@ -10,6 +10,7 @@
 #include "Multi_Buffer.h"
 #include "Nes_Cart.h"
 #include "Nes_Core.h"
+#include <memory>
 class Nes_State;
 
 // Register optional mappers included with Nes_Emu
@@ -91,6 +92,14 @@ public:
 	// cartridge's CHR data shouldn't be modified since a copy is cached internally.
 	blargg_err_t set_cart( Nes_Cart const* );
 	
+	// Make this emulator a copy of src, which must have a cartridge loaded. The cartridge
+	// and its CHR cache are shared rather than copied, and stay alive until the last
+	// emulator using them is closed, so src can go away first. Only the emulator's own
+	// memory and registers are copied, directly instead of through the state file format,
+	// so this is much faster than saving and loading a state. Forking from the same source
+	// again just copies its current state.
+	blargg_err_t fork_from( Nes_Emu const& src );
+	
 	// Pointer to current cartridge, or NULL if none is loaded
 	Nes_Cart const* cart() const { return emu.cart; }
 	
@@ -148,6 +157,12 @@ public:
 	void load_state( Nes_State const& );
 	blargg_err_t load_state( Auto_File_Reader );
 	
+	// Save/load state as a Nes_Flat_State, a fixed-size block of flat_state_size bytes that
+	// is much faster to save and load than the file format, but only valid for the same build.
+	static long const flat_state_size;
+	void save_flat_state( void* out ) const;
+	blargg_err_t load_flat_state( void const* in, long size );
+	
 	// True if current cartridge claims it uses battery-backed memory
 	bool has_battery_ram() const { return cart()->has_battery_ram(); }
 	
@@ -229,6 +244,7 @@ private:
 	bool fade_sound_in;
 	bool fade_sound_out;
 	virtual blargg_err_t init_();
+	blargg_err_t open_cart( Nes_Cart const*, Nes_Emu const* chr_cache_source );
 	
 	virtual void loading_state( Nes_State const& ) { }
 	void load_state( Nes_State_ const& );
@@ -258,7 +274,7 @@ private:
 	char* host_pixels;
 	int host_palette_size;
 	frame_t single_frame;
-	Nes_Cart private_cart;
+	std::shared_ptr<Nes_Cart> private_cart; // cartridge from load_ines(), shared with emulators forked from this one
 	Nes_Core emu; // large; keep at end
 	
 	bool init_called;
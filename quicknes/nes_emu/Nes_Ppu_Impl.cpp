@@ -31,7 +31,6 @@ Nes_Ppu_Impl::Nes_Ppu_Impl()
 	tile_cache = NULL;
 	host_palette = NULL;
 	max_palette_size = 0;
-	tile_cache_mem = NULL;
 	ppu_state_t::unused = 0;
 
 	mmc24_enabled = false;
@@ -70,7 +69,7 @@ void Nes_Ppu_Impl::all_tiles_modified()
 	memset( modified_tiles, ~0, sizeof modified_tiles );
 }
 
-blargg_err_t Nes_Ppu_Impl::open_chr( byte const* new_chr, long chr_data_size )
+blargg_err_t Nes_Ppu_Impl::open_chr( byte const* new_chr, long chr_data_size, Nes_Ppu_Impl const* cache_source )
 {
 	close_chr();
 	
@@ -93,13 +92,25 @@ blargg_err_t Nes_Ppu_Impl::open_chr( byte const* new_chr, long chr_data_size )
 		chr_is_writable = true;
 	}
 	
+	// cache of read-only CHR never changes once built
+	if ( !chr_is_writable && cache_source && cache_source->chr_data == chr_data &&
+			cache_source->chr_size == chr_size && cache_source->tile_cache )
+	{
+		tile_cache_mem = cache_source->tile_cache_mem;
+		tile_cache = cache_source->tile_cache;
+		flipped_tiles = cache_source->flipped_tiles;
+		all_tiles_modified();
+		any_tiles_modified = false;
+		return 0;
+	}
+	
 	// allocate aligned memory for cache
 	assert( chr_size % chr_addr_size == 0 );
 	long tile_count = chr_size / bytes_per_tile;
-	tile_cache_mem = BLARGG_NEW byte [tile_count * sizeof (cached_tile_t) * 2 + cache_line_size];
-	CHECK_ALLOC( tile_cache_mem );
-	tile_cache = (cached_tile_t*) (tile_cache_mem + cache_line_size -
-			(uintptr_t) tile_cache_mem % cache_line_size);
+	byte* mem = BLARGG_NEW byte [tile_count * sizeof (cached_tile_t) * 2 + cache_line_size];
+	CHECK_ALLOC( mem );
+	tile_cache_mem.reset( mem, std::default_delete<byte []>() );
+	tile_cache = (cached_tile_t*) (mem + cache_line_size - (uintptr_t) mem % cache_line_size);
 	flipped_tiles = tile_cache + tile_count;
 	
 	// rebuild cache
@@ -115,8 +126,7 @@ blargg_err_t Nes_Ppu_Impl::open_chr( byte const* new_chr, long chr_data_size )
 
 void Nes_Ppu_Impl::close_chr()
 {
-	delete [] tile_cache_mem;
-	tile_cache_mem = NULL;
+	tile_cache_mem.reset();
 }
 
 void Nes_Ppu_Impl::set_chr_bank( int addr, int size, long data )
@@ -6,6 +6,7 @@
 #define NES_PPU_IMPL_H
 
 #include "nes_data.h"
+#include <memory>
 class Nes_State_;
 
 class Nes_Ppu_Impl : public ppu_state_t {
@@ -19,7 +20,9 @@ public:
 	void reset( bool full_reset );
 	
 	// Setup
-	blargg_err_t open_chr( const byte*, long size );
+	// If cache_source has the same read-only CHR open, its tile cache is shared instead
+	// of being rebuilt, so it must stay open at least as long as this one.
+	blargg_err_t open_chr( const byte*, long size, Nes_Ppu_Impl const* cache_source = 0 );
 	void rebuild_chr( unsigned long begin, unsigned long end );
 	void close_chr();
 	void save_state( Nes_State_* out ) const;
@@ -147,7 +150,7 @@ private:
 	// CHR cache
 	cached_tile_t* tile_cache;
 	cached_tile_t* flipped_tiles;
-	byte* tile_cache_mem;
+	std::shared_ptr<byte> tile_cache_mem; // shared with any PPU that opened the same read-only CHR from this one
 	union {
 		byte modified_tiles [chr_tile_count / 8];
 		uint32_t align_;
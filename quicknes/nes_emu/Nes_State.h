@@ -119,6 +119,36 @@ public:
 	blargg_err_t read_sta_file( Auto_File_Reader );
 };
 
+// Snapshot as one fixed-size block of the emulator's own structures, copied without any
+// encoding. Much faster than the file format, but its layout depends on the build, so
+// it's only for keeping in memory (rewind, branches) and is checked by tag, version and
+// size on load.
+struct Nes_Flat_State {
+	enum { tag = FOUR_CHAR('NESF') };
+	enum { current_version = 1 };
+	
+	BOOST::uint32_t tag_;
+	BOOST::uint32_t version;
+	BOOST::uint32_t size;
+	
+	nes_state_t             nes;
+	Nes_Cpu::registers_t    cpu;
+	joypad_state_t          joypad;
+	apu_state_t             apu;
+	ppu_state_t             ppu;
+	mapper_state_t          mapper;
+	
+	bool nes_valid, cpu_valid, joypad_valid, apu_valid, ppu_valid;
+	bool mapper_valid, ram_valid, spr_ram_valid;
+	short sram_size, nametable_size, chr_size;
+	
+	BOOST::uint8_t ram [Nes_State_::ram_size];
+	BOOST::uint8_t sram [Nes_State_::sram_max];
+	BOOST::uint8_t spr_ram [Nes_State_::spr_ram_size];
+	BOOST::uint8_t nametable [Nes_State_::nametable_max];
+	BOOST::uint8_t chr [Nes_State_::chr_max];
+};
+
 frame_count_t const invalid_frame_count = LONG_MAX / 2 + 1; // a large positive value
 
 int mem_differs( void const* in, int compare, unsigned long count );
@@ -3,11 +3,18 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <vector>
 
 #include <stdint.h>
 #include <limits.h>
 #include <math.h>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GFX_SSE2
+#endif
+
 #define LSB_FIRST
 #ifdef SPEEDHAX
 #error NO SPEEDHAX
@@ -23,6 +30,7 @@
 #include "constarrays.h"
 
 #include "newstate.h"
+#include "../corebatch/corebatch.h"
 
 #define INLINE
 
@@ -2899,6 +2907,186 @@ INLINE int codeTicksAccessSeq32(u32 address) // ARM SEQ
 #define CPUReadHalfWordQuick(addr)	READ16LE(((u16*)&map[(addr)>>24].address[(addr) & map[(addr)>>24].mask]))
 #define CPUReadMemoryQuick(addr)	READ32LE(((u32*)&map[(addr)>>24].address[(addr) & map[(addr)>>24].mask]))
 
+/*============================================================
+	GBA CODE CACHE
+============================================================ */
+
+// Code in the BIOS, EWRAM, IWRAM and the ROM is run from pages of decoded instructions, holding each opcode along with its
+// handler, so that stepping through a page needs neither a memory map lookup for the prefetch nor an opcode table lookup.
+// An instruction only runs from a page while the pipeline holds the same opcode as the page, so code that writes over
+// instructions it has already prefetched still runs the old ones.  Writes to EWRAM and IWRAM update the pages they hit,
+// and all pages are dropped on reset, on state load and at the start of each frame (the frontend may have poked memory).
+//
+// Runs of plain ALU instructions (no memory access, no r15, and no cycles beyond their own fetch) are counted when a page
+// is decoded.  A run that ends before the next event has its cycles added up front and its handlers called back to back,
+// instead of doing the pipeline and cycle bookkeeping after each one.
+
+#define CODE_PAGE_SHIFT 7
+#define CODE_PAGE_MASK ((1 << CODE_PAGE_SHIFT) - 1)
+#define CODE_PAGE_ARM_INSNS ((1 << CODE_PAGE_SHIFT) >> 2)
+#define CODE_PAGE_THUMB_INSNS ((1 << CODE_PAGE_SHIFT) >> 1)
+#define CODE_PAGE_NONE 0xFFFFFFFF
+#define CODE_CACHE_BITS 10
+// bios, ewram, iwram, and the rom mirrors at 0x08, 0x09, 0x0A and 0x0C.  0x0B and 0x0D have no map[] entry(0x0D is
+// where eeprom lives), so the Quick reads the cache decodes through can't fetch from them; they stay uncached.
+#define CODE_CACHE_REGIONS 0x170D
+
+struct CodeInsn
+{
+	u32 opcode;
+	u32 run;	// number of plain instructions starting with this one, 0 if it isn't plain
+	void (Gigazoid::*func)(u32 opcode);
+};
+
+struct CodePage
+{
+	u32 tag;	// address of the page, with bit 0 set for THUMB code
+	CodeInsn insn[CODE_PAGE_THUMB_INSNS];
+};
+
+CodePage codePages[1 << CODE_CACHE_BITS];
+uint8_t ewramCodePages[0x40000 >> CODE_PAGE_SHIFT];
+uint8_t iwramCodePages[0x8000 >> CODE_PAGE_SHIFT];
+
+INLINE u32 CodePageSlot(u32 tag)
+{
+	return ((tag >> (CODE_PAGE_SHIFT - 1) | (tag & 1)) * 0x9E3779B1u) >> (32 - CODE_CACHE_BITS);
+}
+
+INLINE bool CodeCacheRegion(u32 address)
+{
+	const u32 region = address >> 24;
+	return region <= 15 && ((CODE_CACHE_REGIONS >> region) & 1);
+}
+
+INLINE void DecodeArmInsn(CodeInsn &insn, u32 address)
+{
+	insn.opcode = CPUReadMemoryQuick(address);
+	insn.func = armInsnTable[((insn.opcode >> 16) & 0xFF0) | ((insn.opcode >> 4) & 0x0F)];
+}
+
+INLINE void DecodeThumbInsn(CodeInsn &insn, u32 address)
+{
+	insn.opcode = CPUReadHalfWordQuick(address);
+	insn.func = thumbInsnTable[insn.opcode >> 6];
+}
+
+// Data processing with an immediate or immediate shifted operand, with none of Rd, Rn and Rm being r15.  Its handler
+// only adds the fetch of the next instruction to the cycle count, same as when the condition fails.
+static bool ArmInsnPlain(u32 opcode)
+{
+	if (opcode & 0x0C000000)
+		return false;
+	// register shifts, multiplies, swaps and halfword transfers
+	if (!(opcode & 0x02000000) && (opcode & 0x10))
+		return false;
+	// TST/TEQ/CMP/CMN without S are MRS, MSR and BX
+	if ((opcode & 0x01900000) == 0x01000000)
+		return false;
+	if ((opcode & 0xF000) == 0xF000 || (opcode & 0xF0000) == 0xF0000)
+		return false;
+	return (opcode & 0x02000000) || (opcode & 0x0F) != 0x0F;
+}
+
+// Shifts by an immediate, ADD/SUB, MOV/CMP/ADD/SUB immediate and the ALU operations, except for the register shifts and MUL
+static bool ThumbInsnPlain(u32 opcode)
+{
+	if (opcode < 0x4000)
+		return true;
+	if (opcode < 0x4400)
+		return (0xDF63 >> ((opcode >> 6) & 0x0F)) & 1;
+	return false;
+}
+
+// Brings the run lengths of a page's instructions up to date, from the one at index back to the start of the page, or
+// only as far back as they change when the rest of the page's are already right.  The last instruction of a page is
+// never in a run, so the one after a run can always be prefetched from the page.
+void UpdateCodeRuns(CodePage &page, int index, bool thumb, bool partial)
+{
+	const int last = (thumb ? CODE_PAGE_THUMB_INSNS : CODE_PAGE_ARM_INSNS) - 1;
+	for (int i = index; i >= 0; i--)
+	{
+		CodeInsn &insn = page.insn[i];
+		const bool plain = i < last && (thumb ? ThumbInsnPlain(insn.opcode) : ArmInsnPlain(insn.opcode));
+		const u32 run = plain ? page.insn[i + 1].run + 1 : 0;
+		if (partial && i < index && insn.run == run)
+			break;
+		insn.run = run;
+	}
+}
+
+void FlushCodeCache (void)
+{
+	for (int i = 0; i < (1 << CODE_CACHE_BITS); i++)
+		codePages[i].tag = CODE_PAGE_NONE;
+	memset(ewramCodePages, 0, sizeof(ewramCodePages));
+	memset(iwramCodePages, 0, sizeof(iwramCodePages));
+}
+
+// Returns the decoded page holding address, or NULL if code there isn't cached
+CodePage *GetCodePage(u32 address, bool thumb)
+{
+	if (!CodeCacheRegion(address))
+		return NULL;
+	const u32 region = address >> 24;
+
+	// mirrors share their pages
+	const u32 base = (address & 0xFF000000) | (address & map[region].mask & ~CODE_PAGE_MASK);
+	const u32 tag = base | thumb;
+	CodePage &page = codePages[CodePageSlot(tag)];
+	if (page.tag != tag)
+	{
+		page.tag = tag;
+		if (thumb)
+		{
+			for (int i = 0; i < CODE_PAGE_THUMB_INSNS; i++)
+				DecodeThumbInsn(page.insn[i], base + (i << 1));
+		}
+		else
+		{
+			for (int i = 0; i < CODE_PAGE_ARM_INSNS; i++)
+				DecodeArmInsn(page.insn[i], base + (i << 2));
+		}
+		UpdateCodeRuns(page, (thumb ? CODE_PAGE_THUMB_INSNS : CODE_PAGE_ARM_INSNS) - 1, thumb, false);
+
+		if (region == 0x02)
+			ewramCodePages[(base & 0x3FFFF) >> CODE_PAGE_SHIFT] = 1;
+		else if (region == 0x03)
+			iwramCodePages[(base & 0x7FFF) >> CODE_PAGE_SHIFT] = 1;
+	}
+	return &page;
+}
+
+// Brings the pages holding the word at address (in EWRAM or IWRAM, without mirroring) up to date after a write
+void CodeCacheWritten(u32 address)
+{
+	const u32 base = address & ~CODE_PAGE_MASK;
+	const u32 offset = address & CODE_PAGE_MASK;
+
+	CodePage &arm = codePages[CodePageSlot(base)];
+	if (arm.tag == base)
+	{
+		DecodeArmInsn(arm.insn[offset >> 2], address);
+		UpdateCodeRuns(arm, offset >> 2, false, true);
+	}
+
+	CodePage &thumb = codePages[CodePageSlot(base | 1)];
+	if (thumb.tag == (base | 1))
+	{
+		DecodeThumbInsn(thumb.insn[offset >> 1], address);
+		DecodeThumbInsn(thumb.insn[(offset >> 1) + 1], address + 2);
+		UpdateCodeRuns(thumb, (offset >> 1) + 1, true, true);
+	}
+}
+
+#define EWRAM_CODE_WRITTEN(address) \
+	if (ewramCodePages[((address) & 0x3FFFF) >> CODE_PAGE_SHIFT]) \
+		CodeCacheWritten(0x02000000 | ((address) & 0x3FFFC));
+
+#define IWRAM_CODE_WRITTEN(address) \
+	if (iwramCodePages[((address) & 0x7FFF) >> CODE_PAGE_SHIFT]) \
+		CodeCacheWritten(0x03000000 | ((address) & 0x7FFC));
+
 bool stopState;
 #ifdef USE_MOTION_SENSOR
 extern bool cpuEEPROMSensorEnabled;
@@ -3215,9 +3403,11 @@ INLINE void CPUWriteMemory(u32 address, u32 value)
 	{
 		case 0x02:
 			WRITE32LE(((u32 *)&workRAM[address & 0x3FFFC]), value);
+			EWRAM_CODE_WRITTEN(address);
 			break;
 		case 0x03:
 			WRITE32LE(((u32 *)&internalRAM[address & 0x7ffC]), value);
+			IWRAM_CODE_WRITTEN(address);
 			break;
 		case 0x04:
 			if(address < 0x4000400)
@@ -3263,9 +3453,11 @@ INLINE void CPUWriteHalfWord(u32 address, u16 value)
 	{
 		case 2:
 			WRITE16LE(((u16 *)&workRAM[address & 0x3FFFE]),value);
+			EWRAM_CODE_WRITTEN(address);
 			break;
 		case 3:
 			WRITE16LE(((u16 *)&internalRAM[address & 0x7ffe]), value);
+			IWRAM_CODE_WRITTEN(address);
 			break;
 		case 4:
 			if(address < 0x4000400)
@@ -3312,9 +3504,11 @@ INLINE void CPUWriteByte(u32 address, u8 b)
 	{
 		case 2:
 			workRAM[address & 0x3FFFF] = b;
+			EWRAM_CODE_WRITTEN(address);
 			break;
 		case 3:
 			internalRAM[address & 0x7fff] = b;
+			IWRAM_CODE_WRITTEN(address);
 			break;
 		case 4:
 			if(address < 0x4000400)
@@ -3449,6 +3643,9 @@ void BIOS_RegisterRamReset(u32 flags)
 		if(flags & 0x10)
 			memset(oam, 0, 0x400);			// clean OAM
 
+		if(flags & 0x03)
+			FlushCodeCache();
+
 		if(flags & 0x80) {
 			int i;
 			for(i = 0; i < 0x10; i++)
@@ -3514,6 +3711,7 @@ void BIOS_SoftReset (void)
 	u8 b = internalRAM[0x7ffa];
 
 	memset(&internalRAM[0x7e00], 0, 0x200);
+	FlushCodeCache();
 
 	if(b) {
 		bus.armNextPC = 0x02000000;
@@ -5576,6 +5774,146 @@ DEFINE_ALU_INSN_C (1F, 3F, MVNS, YES)
 static void (Gigazoid::*const armInsnTable[4096])(u32 opcode);
 
 // Wrapper routine (execution loop) ///////////////////////////////////////
+INLINE bool armConditionPassed(u32 opcode)
+{
+	switch(opcode >> 28) {
+		case 0x00: // EQ
+			return Z_FLAG;
+		case 0x01: // NE
+			return !Z_FLAG;
+		case 0x02: // CS
+			return C_FLAG;
+		case 0x03: // CC
+			return !C_FLAG;
+		case 0x04: // MI
+			return N_FLAG;
+		case 0x05: // PL
+			return !N_FLAG;
+		case 0x06: // VS
+			return V_FLAG;
+		case 0x07: // VC
+			return !V_FLAG;
+		case 0x08: // HI
+			return C_FLAG && !Z_FLAG;
+		case 0x09: // LS
+			return !C_FLAG || Z_FLAG;
+		case 0x0A: // GE
+			return N_FLAG == V_FLAG;
+		case 0x0B: // LT
+			return N_FLAG != V_FLAG;
+		case 0x0C: // GT
+			return !Z_FLAG &&(N_FLAG == V_FLAG);
+		case 0x0D: // LE
+			return Z_FLAG || (N_FLAG != V_FLAG);
+		case 0x0E: // AL
+			return true;
+		case 0x0F:
+		default:
+			// ???
+			return false;
+	}
+}
+
+// Runs instructions from the decoded page holding the next one, until leaving the page or the end of the loop.  The
+// opcode in the pipeline must match the page's, so code changed since it was fetched runs the slow way.  Returns the
+// number run, 0 if none, or -1 to stop the CPU loop.
+int armExecuteCodePage (void)
+{
+	const u32 pc = bus.reg[15].I - 4;
+	if (pc & 3)
+		return 0;
+	const CodePage *page = GetCodePage(pc, false);
+	if (!page)
+		return 0;
+
+	// the page is dropped if the bios clears ram
+	const u32 tag = page->tag;
+	const CodeInsn *const end = &page->insn[CODE_PAGE_ARM_INSNS];
+	const CodeInsn *insn = &page->insn[(pc & CODE_PAGE_MASK) >> 2];
+
+	int count = 0;
+
+	while (cpuPrefetch[0] == insn->opcode)
+	{
+		const u32 address = bus.reg[15].I - 4;
+		const int region = (address >> 24) & 15;
+
+		// outside the rom every instruction of a plain run costs the same, and the handlers' own look at the wait states
+		// leaves the prefetch buffer alone
+		if (insn->run > 1 && bus.armNextPC == address && cpuPrefetch[1] == insn[1].opcode && unsigned(region - 0x08) > 5)
+		{
+			const int n = insn->run;
+			const int ticks = n * (1 + memoryWaitSeq32[region]);
+			if (cpuTotalTicks + ticks < cpuNextEvent)
+			{
+				for (int i = 0; i < n; i++)
+				{
+					const u32 opcode = insn[i].opcode;
+					if ((opcode >> 28) == 0x0E || armConditionPassed(opcode))
+						(this->*insn[i].func)(opcode);
+				}
+
+				bus.busPrefetch = false;
+				int32_t busprefetch_mask = ((bus.busPrefetchCount & 0xFFFFFE00) | -(bus.busPrefetchCount & 0xFFFFFE00)) >> 31;
+				bus.busPrefetchCount = (0x100 | (bus.busPrefetchCount & 0xFF) & busprefetch_mask) | (bus.busPrefetchCount & ~busprefetch_mask);
+
+				insn += n;
+				bus.armNextPC = address + (n << 2);
+				bus.reg[15].I = bus.armNextPC + 4;
+				cpuPrefetch[0] = insn->opcode;
+				cpuPrefetch[1] = insn + 1 < end ? insn[1].opcode : CPUReadMemoryQuick(bus.armNextPC+4);
+
+				cpuTotalTicks += ticks;
+				count += n;
+				continue;
+			}
+		}
+
+		clockTicks = 0;
+
+		if ((bus.armNextPC & 0x0803FFFF) == 0x08020000)
+			bus.busPrefetchCount = 0x100;
+
+		u32 opcode = cpuPrefetch[0];
+		cpuPrefetch[0] = cpuPrefetch[1];
+
+		bus.busPrefetch = false;
+		int32_t busprefetch_mask = ((bus.busPrefetchCount & 0xFFFFFE00) | -(bus.busPrefetchCount & 0xFFFFFE00)) >> 31;
+		bus.busPrefetchCount = (0x100 | (bus.busPrefetchCount & 0xFF) & busprefetch_mask) | (bus.busPrefetchCount & ~busprefetch_mask);
+
+		int oldArmNextPC = bus.armNextPC;
+
+		bus.armNextPC = bus.reg[15].I;
+		bus.reg[15].I += 4;
+		cpuPrefetch[1] = insn + 2 < end ? insn[2].opcode : CPUReadMemoryQuick(bus.armNextPC+4);
+
+		if ((opcode >> 28) == 0x0E || armConditionPassed(opcode))
+			(this->*insn->func)(opcode);
+
+		int ct = clockTicks;
+
+		if (ct < 0)
+			return -1;
+
+		if (ct == 0)
+			clockTicks = 1 + codeTicksAccessSeq32(oldArmNextPC);
+
+		cpuTotalTicks += clockTicks;
+		count++;
+
+		if (!((cpuTotalTicks < cpuNextEvent) & armState & ~holdState))
+			break;
+
+		// follow branches that stay in the page
+		const u32 next = bus.reg[15].I - 4;
+		if (((next ^ pc) & ~CODE_PAGE_MASK) || (next & 3) || page->tag != tag)
+			break;
+		insn = &page->insn[(next & CODE_PAGE_MASK) >> 2];
+	}
+
+	return count;
+}
+
 int armExecute (void)
 {
 	CACHE_PREFETCH(clockTicks);
@@ -5587,6 +5925,14 @@ int armExecute (void)
 
 	do
 	{
+		if (!traceCallback && !fetchCallback && CodeCacheRegion(bus.reg[15].I - 4))
+		{
+			const int count = armExecuteCodePage();
+			if (count < 0)
+				return 0;
+			if (count > 0)
+				continue;
+		}
 
 		clockTicks = 0;
 
@@ -5615,64 +5961,7 @@ int armExecute (void)
 		bus.reg[15].I += 4;
 		ARM_PREFETCH_NEXT;
 
-		int cond = opcode >> 28;
-		bool cond_res = true;
-		if (cond != 0x0E) {  // most opcodes are AL (always)
-			switch(cond) {
-				case 0x00: // EQ
-					cond_res = Z_FLAG;
-					break;
-				case 0x01: // NE
-					cond_res = !Z_FLAG;
-					break;
-				case 0x02: // CS
-					cond_res = C_FLAG;
-					break;
-				case 0x03: // CC
-					cond_res = !C_FLAG;
-					break;
-				case 0x04: // MI
-					cond_res = N_FLAG;
-					break;
-				case 0x05: // PL
-					cond_res = !N_FLAG;
-					break;
-				case 0x06: // VS
-					cond_res = V_FLAG;
-					break;
-				case 0x07: // VC
-					cond_res = !V_FLAG;
-					break;
-				case 0x08: // HI
-					cond_res = C_FLAG && !Z_FLAG;
-					break;
-				case 0x09: // LS
-					cond_res = !C_FLAG || Z_FLAG;
-					break;
-				case 0x0A: // GE
-					cond_res = N_FLAG == V_FLAG;
-					break;
-				case 0x0B: // LT
-					cond_res = N_FLAG != V_FLAG;
-					break;
-				case 0x0C: // GT
-					cond_res = !Z_FLAG &&(N_FLAG == V_FLAG);
-					break;
-				case 0x0D: // LE
-					cond_res = Z_FLAG || (N_FLAG != V_FLAG);
-					break;
-				case 0x0E: // AL (impossible, checked above)
-					cond_res = true;
-					break;
-				case 0x0F:
-				default:
-					// ???
-					cond_res = false;
-					break;
-			}
-		}
-
-		if (cond_res)
+		if ((opcode >> 28) == 0x0E || armConditionPassed(opcode))  // most opcodes are AL (always)
 		{
 			cond1 = (opcode>>16)&0xFF0;
 			cond2 = (opcode>>4)&0x0F;
@@ -7182,6 +7471,93 @@ static void (Gigazoid::*const thumbInsnTable[1024])(u32 opcode);
 // Wrapper routine (execution loop) ///////////////////////////////////////
 
 
+// Same as armExecuteCodePage, for THUMB code
+int thumbExecuteCodePage (void)
+{
+	const u32 pc = bus.reg[15].I - 2;
+	if (pc & 1)
+		return 0;
+	const CodePage *page = GetCodePage(pc, true);
+	if (!page)
+		return 0;
+
+	const u32 tag = page->tag;
+	const CodeInsn *const end = &page->insn[CODE_PAGE_THUMB_INSNS];
+	const CodeInsn *insn = &page->insn[(pc & CODE_PAGE_MASK) >> 1];
+
+	int count = 0;
+
+	while (cpuPrefetch[0] == insn->opcode)
+	{
+		const u32 address = bus.reg[15].I - 2;
+
+		// the handlers of a plain run leave the prefetch buffer alone, so the cycles the run takes can be counted first,
+		// and the buffer put back if it doesn't end before the next event
+		if (insn->run > 1 && bus.armNextPC == address && cpuPrefetch[1] == insn[1].opcode)
+		{
+			const int n = insn->run;
+			const u32 busPrefetchCount = bus.busPrefetchCount;
+			int ticks = 0;
+			for (int i = 0; i < n; i++)
+				ticks += codeTicksAccessSeq16(address) + 1;
+			if (cpuTotalTicks + ticks < cpuNextEvent)
+			{
+				for (int i = 0; i < n; i++)
+					(this->*insn[i].func)(insn[i].opcode);
+
+				bus.busPrefetch = false;
+
+				insn += n;
+				bus.armNextPC = address + (n << 1);
+				bus.reg[15].I = bus.armNextPC + 2;
+				cpuPrefetch[0] = insn->opcode;
+				cpuPrefetch[1] = insn + 1 < end ? insn[1].opcode : CPUReadHalfWordQuick(bus.armNextPC+2);
+
+				cpuTotalTicks += ticks;
+				count += n;
+				continue;
+			}
+			bus.busPrefetchCount = busPrefetchCount;
+		}
+
+		clockTicks = 0;
+
+		u32 opcode = cpuPrefetch[0];
+		cpuPrefetch[0] = cpuPrefetch[1];
+
+		bus.busPrefetch = false;
+
+		u32 oldArmNextPC = bus.armNextPC;
+
+		bus.armNextPC = bus.reg[15].I;
+		bus.reg[15].I += 2;
+		cpuPrefetch[1] = insn + 2 < end ? insn[2].opcode : CPUReadHalfWordQuick(bus.armNextPC+2);
+
+		(this->*insn->func)(opcode);
+
+		int ct = clockTicks;
+
+		if (ct < 0)
+			return -1;
+
+		if (ct == 0)
+			clockTicks = codeTicksAccessSeq16(oldArmNextPC) + 1;
+
+		cpuTotalTicks += clockTicks;
+		count++;
+
+		if (!((cpuTotalTicks < cpuNextEvent) & ~armState & ~holdState))
+			break;
+
+		const u32 next = bus.reg[15].I - 2;
+		if (((next ^ pc) & ~CODE_PAGE_MASK) || (next & 1) || page->tag != tag)
+			break;
+		insn = &page->insn[(next & CODE_PAGE_MASK) >> 1];
+	}
+
+	return count;
+}
+
 int thumbExecute (void)
 {
 	CACHE_PREFETCH(clockTicks);
@@ -7189,6 +7565,14 @@ int thumbExecute (void)
 	int ct = 0;
 
 	do {
+		if (!traceCallback && !fetchCallback && CodeCacheRegion(bus.reg[15].I - 2))
+		{
+			const int count = thumbExecuteCodePage();
+			if (count < 0)
+				return 0;
+			if (count > 0)
+				continue;
+		}
 
 		clockTicks = 0;
 
@@ -9090,239 +9474,310 @@ void doMirroring (bool b)
 /* we only use 16bit color depth */
 #define INIT_COLOR_DEPTH_LINE_MIX() uint16_t * lineMix = (pix + PIX_BUFFER_SCREEN_WIDTH * io_registers[REG_VCOUNT])
 
-void mode0RenderLine (void)
-{
-#ifdef REPORT_VIDEO_MODES
-	fprintf(stderr, "MODE 0: Render Line\n");
-#endif
-	INIT_COLOR_DEPTH_LINE_MIX();
-
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
-
-  if(graphics.layerEnable & 0x0100) {
-    gfxDrawTextScreen(io_registers[REG_BG0CNT], io_registers[REG_BG0HOFS], io_registers[REG_BG0VOFS], line[0]);
-  }
-
-  if(graphics.layerEnable & 0x0200) {
-    gfxDrawTextScreen(io_registers[REG_BG1CNT], io_registers[REG_BG1HOFS], io_registers[REG_BG1VOFS], line[1]);
-  }
-
-  if(graphics.layerEnable & 0x0400) {
-    gfxDrawTextScreen(io_registers[REG_BG2CNT], io_registers[REG_BG2HOFS], io_registers[REG_BG2VOFS], line[2]);
-  }
-
-  if(graphics.layerEnable & 0x0800) {
-    gfxDrawTextScreen(io_registers[REG_BG3CNT], io_registers[REG_BG3HOFS], io_registers[REG_BG3VOFS], line[3]);
-  }
-
+// BG lines composited in each mode: bits 0-3 are BG0-BG3, and the OBJ line (0x10) is always composited
+#define GFX_MODE0_LAYERS 0x1F
+#define GFX_MODE1_LAYERS 0x17
+#define GFX_MODE2_LAYERS 0x1C
+#define GFX_MODE345_LAYERS 0x14
 
-	uint32_t backdrop = (READ16LE(&palette[0]) | 0x30000000);
+// Layers and effects enabled at each pixel of the line, from WININ/WINOUT
+void gfxWindowMask(uint8_t *mask, bool inWindow0, bool inWindow1)
+{
+	uint8_t inWin0Mask = io_registers[REG_WININ] & 0xFF;
+	uint8_t inWin1Mask = io_registers[REG_WININ] >> 8;
+	uint8_t outMask = io_registers[REG_WINOUT] & 0xFF;
+	uint8_t objMask = io_registers[REG_WINOUT] >> 8;
 
 	for(int x = 0; x < 240; x++)
 	{
-		uint32_t color = backdrop;
-		uint8_t top = 0x20;
+		uint8_t m = (line[5][x] & 0x80000000) ? outMask : objMask;
+		if(inWindow1 && gfxInWin[1][x])
+			m = inWin1Mask;
+		if(inWindow0 && gfxInWin[0][x])
+			m = inWin0Mask;
+		mask[x] = m;
+	}
+}
 
-		if(line[0][x] < color) {
-			color = line[0][x];
-			top = 0x01;
-		}
+#ifdef GFX_SSE2
+#define SSE2_SELECT(m, a, b) _mm_or_si128(_mm_and_si128((m), (a)), _mm_andnot_si128((m), (b)))
 
-		if((uint8_t)(line[1][x]>>24) < (uint8_t)(color >> 24)) {
-			color = line[1][x];
-			top = 0x02;
-		}
+// 15 bit color from 5 bit channels
+INLINE __m128i gfxPackRGB8(__m128i r, __m128i g, __m128i b)
+{
+	return _mm_or_si128(_mm_or_si128(r, _mm_slli_epi16(g, 5)), _mm_slli_epi16(b, 10));
+}
 
-		if((uint8_t)(line[2][x]>>24) < (uint8_t)(color >> 24)) {
-			color = line[2][x];
-			top = 0x04;
-		}
+INLINE __m128i gfxConvertColor8(__m128i color)
+{
+	const __m128i c5 = _mm_set1_epi16(0x1F);
+#ifdef FRONTEND_SUPPORTS_RGB565
+	__m128i out = _mm_slli_epi16(_mm_and_si128(color, c5), 11);
+	out = _mm_or_si128(out, _mm_slli_epi16(_mm_and_si128(color, _mm_set1_epi16(0x3E0)), 1));
+	out = _mm_or_si128(out, _mm_srli_epi16(_mm_and_si128(color, _mm_set1_epi16(0x200)), 4));
+#else
+	__m128i out = _mm_slli_epi16(_mm_and_si128(color, c5), 10);
+	out = _mm_or_si128(out, _mm_and_si128(color, _mm_set1_epi16(0x3E0)));
+#endif
+	return _mm_or_si128(out, _mm_and_si128(_mm_srli_epi16(color, 10), c5));
+}
+#endif
 
-		if((uint8_t)(line[3][x]>>24) < (uint8_t)(color >> 24)) {
-			color = line[3][x];
-			top = 0x08;
+// Composites the BG lines in layers and the OBJ line over the backdrop into lineMix, the same as the RenderLine loops
+// did one pixel at a time.  Semi-transparent OBJ are always blended; with fx, so are the BLDMOD effects.  winMask holds
+// the layers and effects enabled at each pixel, or NULL for all of them.
+template<int layers>
+void gfxCompositeLine(uint16_t *lineMix, const bool fx, const uint8_t *winMask)
+{
+	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
+	const uint32_t backdrop = (READ16LE(&palette[0]) | 0x30000000);
+	const int bldEffect = (BLDMOD >> 6) & 3;
+	const int effect = fx ? bldEffect : 0;
+
+#ifdef GFX_SSE2
+	// 8 pixels at a time, with the line entries split in 16 bit halves: the color, and the priority over the flags
+	// (bit 0 is semi-transparent OBJ, bit 15 transparent)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i c5 = _mm_set1_epi16(0x1F);
+	const __m128i vbackdrop = _mm_set1_epi16(backdrop & 0xFFFF);
+	const __m128i vbackhi = _mm_set1_epi16(backdrop >> 16);
+	const __m128i target1 = _mm_set1_epi16(BLDMOD & 0x3F);
+	const __m128i target2 = _mm_set1_epi16((BLDMOD >> 8) & 0x3F);
+	const __m128i ca = _mm_set1_epi16(coeff[COLEV & 0x1F]);
+	const __m128i cb = _mm_set1_epi16(coeff[(COLEV >> 8) & 0x1F]);
+	const __m128i cy = _mm_set1_epi16(coeff[COLY & 0x1F]);
+
+	for(int x = 0; x < 240; x += 8)
+	{
+		__m128i mask = _mm_set1_epi16(0x3F);
+		if(winMask)
+			mask = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&winMask[x]), zero);
+
+		// topmost layer
+		__m128i color = vbackdrop;
+		__m128i hi = vbackhi;
+		__m128i top = _mm_set1_epi16(0x20);
+		__m128i lc[5], lh[5];
+		for(int i = 0; i < 5; i++)
+		{
+			if(!(layers & (1 << i)))
+				continue;
+			const __m128i bit = _mm_set1_epi16(1 << i);
+			const __m128i l0 = _mm_loadu_si128((const __m128i *)&line[i][x]);
+			const __m128i l1 = _mm_loadu_si128((const __m128i *)&line[i][x + 4]);
+			// sign extended, so the signed pack keeps all 16 bits
+			lc[i] = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(l0, 16), 16), _mm_srai_epi32(_mm_slli_epi32(l1, 16), 16));
+			lh[i] = _mm_packs_epi32(_mm_srai_epi32(l0, 16), _mm_srai_epi32(l1, 16));
+			const __m128i sel = _mm_and_si128(_mm_cmpeq_epi16(_mm_and_si128(mask, bit), bit), _mm_cmplt_epi16(_mm_srli_epi16(lh[i], 8), _mm_srli_epi16(hi, 8)));
+			color = SSE2_SELECT(sel, lc[i], color);
+			hi = SSE2_SELECT(sel, lh[i], hi);
+			top = SSE2_SELECT(sel, bit, top);
 		}
 
-		if((uint8_t)(line[4][x]>>24) < (uint8_t)(color >> 24)) {
-			color = line[4][x];
-			top = 0x10;
-
-			if(color & 0x00010000) {
-				// semi-transparent OBJ
-				uint32_t back = backdrop;
-				uint8_t top2 = 0x20;
+		// semi-transparent OBJ are blended with the layer below them, unless it isn't a second target, and the effects
+		// apply to first target pixels
+		const __m128i semi = _mm_cmpeq_epi16(_mm_and_si128(hi, _mm_set1_epi16(1)), _mm_set1_epi16(1));
+		__m128i special = zero;
+		if(effect)
+		{
+			special = _mm_or_si128(semi, _mm_cmpeq_epi16(_mm_and_si128(mask, _mm_set1_epi16(0x20)), zero));
+			special = _mm_andnot_si128(_mm_or_si128(special, _mm_cmpeq_epi16(_mm_and_si128(top, target1), zero)), _mm_cmpeq_epi16(zero, zero));
+		}
 
-				if((uint8_t)(line[0][x]>>24) < (uint8_t)(back >> 24)) {
-					back = line[0][x];
-					top2 = 0x01;
-				}
+		if(_mm_movemask_epi8(_mm_or_si128(semi, special)))
+		{
+			const __m128i opaque = _mm_cmpgt_epi16(hi, _mm_set1_epi16(-1));
+			__m128i back = vbackdrop;
+			__m128i blend = zero;
+			__m128i bright = effect >= 2 ? special : zero;
 
-				if((uint8_t)(line[1][x]>>24) < (uint8_t)(back >> 24)) {
-					back = line[1][x];
-					top2 = 0x02;
+			if(_mm_movemask_epi8(semi) || effect == 1)
+			{
+				// the layer below skips the OBJ line for semi-transparent OBJ, and the top layer for the effects
+				const __m128i skip = SSE2_SELECT(semi, _mm_set1_epi16(0x10), top);
+				__m128i backhi = vbackhi;
+				__m128i top2 = _mm_set1_epi16(0x20);
+				for(int i = 0; i < 5; i++)
+				{
+					if(!(layers & (1 << i)))
+						continue;
+					const __m128i bit = _mm_set1_epi16(1 << i);
+					__m128i sel = _mm_and_si128(_mm_cmpeq_epi16(_mm_and_si128(mask, bit), bit), _mm_cmplt_epi16(_mm_srli_epi16(lh[i], 8), _mm_srli_epi16(backhi, 8)));
+					sel = _mm_andnot_si128(_mm_cmpeq_epi16(skip, bit), sel);
+					back = SSE2_SELECT(sel, lc[i], back);
+					backhi = SSE2_SELECT(sel, lh[i], backhi);
+					top2 = SSE2_SELECT(sel, bit, top2);
 				}
 
-				if((uint8_t)(line[2][x]>>24) < (uint8_t)(back >> 24)) {
-					back = line[2][x];
-					top2 = 0x04;
-				}
+				const __m128i second = _mm_andnot_si128(_mm_cmpeq_epi16(_mm_and_si128(top2, target2), zero), effect == 1 ? _mm_or_si128(semi, special) : semi);
+				blend = _mm_and_si128(second, opaque);
+				// semi-transparent OBJ over a second target that can't be blended get the brightness effect instead
+				if(bldEffect >= 2)
+					bright = _mm_or_si128(bright, _mm_andnot_si128(_mm_or_si128(opaque, _mm_cmpeq_epi16(_mm_and_si128(top, target1), zero)), _mm_and_si128(second, semi)));
+			}
 
-				if((uint8_t)(line[3][x]>>24) < (uint8_t)(back >> 24)) {
-					back = line[3][x];
-					top2 = 0x08;
-				}
+			const __m128i r = _mm_and_si128(color, c5);
+			const __m128i g = _mm_and_si128(_mm_srli_epi16(color, 5), c5);
+			const __m128i b = _mm_and_si128(_mm_srli_epi16(color, 10), c5);
 
-				alpha_blend_brightness_switch();
+			if(_mm_movemask_epi8(blend))
+			{
+				const __m128i br = _mm_and_si128(back, c5);
+				const __m128i bg = _mm_and_si128(_mm_srli_epi16(back, 5), c5);
+				const __m128i bb = _mm_and_si128(_mm_srli_epi16(back, 10), c5);
+				__m128i ar = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(r, ca), 4), _mm_srli_epi16(_mm_mullo_epi16(br, cb), 4));
+				__m128i ag = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(g, ca), 4), _mm_srli_epi16(_mm_mullo_epi16(bg, cb), 4));
+				__m128i ab = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(b, ca), 4), _mm_srli_epi16(_mm_mullo_epi16(bb, cb), 4));
+				// clamped like AlphaClampLUT
+				ar = _mm_min_epi16(ar, c5);
+				ag = _mm_min_epi16(ag, c5);
+				ab = _mm_min_epi16(ab, c5);
+				color = SSE2_SELECT(blend, gfxPackRGB8(ar, ag, ab), color);
 			}
-		}
 
+			if(_mm_movemask_epi8(bright))
+			{
+				// gfxIncreaseBrightness/gfxDecreaseBrightness, one channel at a time
+				__m128i yr, yg, yb;
+				if(bldEffect == 2)
+				{
+					yr = _mm_add_epi16(r, _mm_srli_epi16(_mm_mullo_epi16(_mm_sub_epi16(c5, r), cy), 4));
+					yg = _mm_add_epi16(g, _mm_srli_epi16(_mm_mullo_epi16(_mm_sub_epi16(c5, g), cy), 4));
+					yb = _mm_add_epi16(b, _mm_srli_epi16(_mm_mullo_epi16(_mm_sub_epi16(c5, b), cy), 4));
+				}
+				else
+				{
+					yr = _mm_sub_epi16(r, _mm_srli_epi16(_mm_mullo_epi16(r, cy), 4));
+					yg = _mm_sub_epi16(g, _mm_srli_epi16(_mm_mullo_epi16(g, cy), 4));
+					yb = _mm_sub_epi16(b, _mm_srli_epi16(_mm_mullo_epi16(b, cy), 4));
+				}
+				color = SSE2_SELECT(bright, gfxPackRGB8(yr, yg, yb), color);
+			}
+		}
 
-		lineMix[x] = CONVERT_COLOR(color);
+		_mm_storeu_si128((__m128i *)&lineMix[x], gfxConvertColor8(color));
 	}
-}
-
-void mode0RenderLineNoWindow (void)
-{
-#ifdef REPORT_VIDEO_MODES
-	fprintf(stderr, "MODE 0: Render Line No Window\n");
-#endif
-	INIT_COLOR_DEPTH_LINE_MIX();
-
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
-	uint32_t backdrop = (READ16LE(&palette[0]) | 0x30000000);
-
-   if(graphics.layerEnable & 0x0100) {
-      gfxDrawTextScreen(io_registers[REG_BG0CNT], io_registers[REG_BG0HOFS], io_registers[REG_BG0VOFS], line[0]);
-   }
-
-   if(graphics.layerEnable & 0x0200) {
-      gfxDrawTextScreen(io_registers[REG_BG1CNT], io_registers[REG_BG1HOFS], io_registers[REG_BG1VOFS], line[1]);
-   }
-
-   if(graphics.layerEnable & 0x0400) {
-      gfxDrawTextScreen(io_registers[REG_BG2CNT], io_registers[REG_BG2HOFS], io_registers[REG_BG2VOFS], line[2]);
-   }
-
-   if(graphics.layerEnable & 0x0800) {
-      gfxDrawTextScreen(io_registers[REG_BG3CNT], io_registers[REG_BG3HOFS], io_registers[REG_BG3VOFS], line[3]);
-   }
-
-	int effect = (BLDMOD >> 6) & 3;
-
-	for(int x = 0; x < 240; x++) {
+#else
+	for(int x = 0; x < 240; x++)
+	{
+		const uint8_t mask = winMask ? winMask[x] : 0x3F;
 		uint32_t color = backdrop;
 		uint8_t top = 0x20;
 
-		if(line[0][x] < color) {
-			color = line[0][x];
-			top = 0x01;
-		}
-
-		if(line[1][x] < (color & 0xFF000000)) {
-			color = line[1][x];
-			top = 0x02;
+		for(int i = 0; i < 5; i++)
+		{
+			if((layers & mask & (1 << i)) && (uint8_t)(line[i][x]>>24) < (uint8_t)(color >> 24))
+			{
+				color = line[i][x];
+				top = 1 << i;
+			}
 		}
 
-		if(line[2][x] < (color & 0xFF000000)) {
-			color = line[2][x];
-			top = 0x04;
-		}
+		if(color & 0x00010000)
+		{
+			// semi-transparent OBJ
+			uint32_t back = backdrop;
+			uint8_t top2 = 0x20;
 
-		if(line[3][x] < (color & 0xFF000000)) {
-			color = line[3][x];
-			top = 0x08;
-		}
+			for(int i = 0; i < 4; i++)
+			{
+				if((layers & mask & (1 << i)) && (uint8_t)(line[i][x]>>24) < (uint8_t)(back >> 24))
+				{
+					back = line[i][x];
+					top2 = 1 << i;
+				}
+			}
 
-		if(line[4][x] < (color & 0xFF000000)) {
-			color = line[4][x];
-			top = 0x10;
+			alpha_blend_brightness_switch();
 		}
-
-		if(!(color & 0x00010000)) {
-			switch(effect) {
-				case 0:
-					break;
+		else if(effect && (mask & 0x20) && (top & BLDMOD))
+		{
+			switch(effect)
+			{
 				case 1:
-					if(top & BLDMOD)
 					{
 						uint32_t back = backdrop;
 						uint8_t top2 = 0x20;
-						if((line[0][x] < back) && (top != 0x01))
-						{
-							back = line[0][x];
-							top2 = 0x01;
-						}
-
-						if((line[1][x] < (back & 0xFF000000)) && (top != 0x02))
-						{
-							back = line[1][x];
-							top2 = 0x02;
-						}
-
-						if((line[2][x] < (back & 0xFF000000)) && (top != 0x04))
-						{
-							back = line[2][x];
-							top2 = 0x04;
-						}
-
-						if((line[3][x] < (back & 0xFF000000)) && (top != 0x08))
-						{
-							back = line[3][x];
-							top2 = 0x08;
-						}
 
-						if((line[4][x] < (back & 0xFF000000)) && (top != 0x10))
+						for(int i = 0; i < 5; i++)
 						{
-							back = line[4][x];
-							top2 = 0x10;
+							if((layers & mask & (1 << i)) && top != (1 << i) && (uint8_t)(line[i][x]>>24) < (uint8_t)(back >> 24))
+							{
+								back = line[i][x];
+								top2 = 1 << i;
+							}
 						}
 
 						if(top2 & (BLDMOD>>8) && color < 0x80000000)
 						{
 							GFX_ALPHA_BLEND(color, back, coeff[COLEV & 0x1F], coeff[(COLEV >> 8) & 0x1F]);
 						}
-
 					}
 					break;
 				case 2:
-					if(BLDMOD & top)
-						color = gfxIncreaseBrightness(color, coeff[COLY & 0x1F]);
+					color = gfxIncreaseBrightness(color, coeff[COLY & 0x1F]);
 					break;
 				case 3:
-					if(BLDMOD & top)
-						color = gfxDecreaseBrightness(color, coeff[COLY & 0x1F]);
+					color = gfxDecreaseBrightness(color, coeff[COLY & 0x1F]);
 					break;
 			}
-		} else {
-			// semi-transparent OBJ
-			uint32_t back = backdrop;
-			uint8_t top2 = 0x20;
+		}
 
-			if(line[0][x] < back) {
-				back = line[0][x];
-				top2 = 0x01;
-			}
+		lineMix[x] = CONVERT_COLOR(color);
+	}
+#endif
+}
 
-			if(line[1][x] < (back & 0xFF000000)) {
-				back = line[1][x];
-				top2 = 0x02;
-			}
+void mode0RenderLine (void)
+{
+#ifdef REPORT_VIDEO_MODES
+	fprintf(stderr, "MODE 0: Render Line\n");
+#endif
+	INIT_COLOR_DEPTH_LINE_MIX();
 
-			if(line[2][x] < (back & 0xFF000000)) {
-				back = line[2][x];
-				top2 = 0x04;
-			}
+  if(graphics.layerEnable & 0x0100) {
+    gfxDrawTextScreen(io_registers[REG_BG0CNT], io_registers[REG_BG0HOFS], io_registers[REG_BG0VOFS], line[0]);
+  }
 
-			if(line[3][x] < (back & 0xFF000000)) {
-				back = line[3][x];
-				top2 = 0x08;
-			}
+  if(graphics.layerEnable & 0x0200) {
+    gfxDrawTextScreen(io_registers[REG_BG1CNT], io_registers[REG_BG1HOFS], io_registers[REG_BG1VOFS], line[1]);
+  }
 
-			alpha_blend_brightness_switch();
-		}
+  if(graphics.layerEnable & 0x0400) {
+    gfxDrawTextScreen(io_registers[REG_BG2CNT], io_registers[REG_BG2HOFS], io_registers[REG_BG2VOFS], line[2]);
+  }
 
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+  if(graphics.layerEnable & 0x0800) {
+    gfxDrawTextScreen(io_registers[REG_BG3CNT], io_registers[REG_BG3HOFS], io_registers[REG_BG3VOFS], line[3]);
+  }
+
+	gfxCompositeLine<GFX_MODE0_LAYERS>(lineMix, false, NULL);
+}
+
+void mode0RenderLineNoWindow (void)
+{
+#ifdef REPORT_VIDEO_MODES
+	fprintf(stderr, "MODE 0: Render Line No Window\n");
+#endif
+	INIT_COLOR_DEPTH_LINE_MIX();
+
+   if(graphics.layerEnable & 0x0100) {
+      gfxDrawTextScreen(io_registers[REG_BG0CNT], io_registers[REG_BG0HOFS], io_registers[REG_BG0VOFS], line[0]);
+   }
+
+   if(graphics.layerEnable & 0x0200) {
+      gfxDrawTextScreen(io_registers[REG_BG1CNT], io_registers[REG_BG1HOFS], io_registers[REG_BG1VOFS], line[1]);
+   }
+
+   if(graphics.layerEnable & 0x0400) {
+      gfxDrawTextScreen(io_registers[REG_BG2CNT], io_registers[REG_BG2HOFS], io_registers[REG_BG2VOFS], line[2]);
+   }
+
+   if(graphics.layerEnable & 0x0800) {
+      gfxDrawTextScreen(io_registers[REG_BG3CNT], io_registers[REG_BG3HOFS], io_registers[REG_BG3VOFS], line[3]);
+   }
+
+	gfxCompositeLine<GFX_MODE0_LAYERS>(lineMix, true, NULL);
 }
 
 void mode0RenderLineAll (void)
@@ -9332,8 +9787,6 @@ void mode0RenderLineAll (void)
 #endif
 	INIT_COLOR_DEPTH_LINE_MIX();
 
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
-
 	bool inWindow0 = false;
 	bool inWindow1 = false;
 
@@ -9372,136 +9825,9 @@ void mode0RenderLineAll (void)
     gfxDrawTextScreen(io_registers[REG_BG3CNT], io_registers[REG_BG3HOFS], io_registers[REG_BG3VOFS], line[3]);
   }
 
-	uint32_t backdrop = (READ16LE(&palette[0]) | 0x30000000);
-
-	uint8_t inWin0Mask = io_registers[REG_WININ] & 0xFF;
-	uint8_t inWin1Mask = io_registers[REG_WININ] >> 8;
-	uint8_t outMask = io_registers[REG_WINOUT] & 0xFF;
-
-	for(int x = 0; x < 240; x++) {
-		uint32_t color = backdrop;
-		uint8_t top = 0x20;
-		uint8_t mask = outMask;
-
-		if(!(line[5][x] & 0x80000000)) {
-			mask = io_registers[REG_WINOUT] >> 8;
-		}
-
-		int32_t window1_mask = ((inWindow1 & gfxInWin[1][x]) | -(inWindow1 & gfxInWin[1][x])) >> 31;
-		int32_t window0_mask = ((inWindow0 & gfxInWin[0][x]) | -(inWindow0 & gfxInWin[0][x])) >> 31;
-		mask = (inWin1Mask & window1_mask) | (mask & ~window1_mask);
-		mask = (inWin0Mask & window0_mask) | (mask & ~window0_mask);
-
-		if((mask & 1) && (line[0][x] < color)) {
-			color = line[0][x];
-			top = 0x01;
-		}
-
-		if((mask & 2) && ((uint8_t)(line[1][x]>>24) < (uint8_t)(color >> 24))) {
-			color = line[1][x];
-			top = 0x02;
-		}
-
-		if((mask & 4) && ((uint8_t)(line[2][x]>>24) < (uint8_t)(color >> 24))) {
-			color = line[2][x];
-			top = 0x04;
-		}
-
-		if((mask & 8) && ((uint8_t)(line[3][x]>>24) < (uint8_t)(color >> 24))) {
-			color = line[3][x];
-			top = 0x08;
-		}
-
-		if((mask & 16) && ((uint8_t)(line[4][x]>>24) < (uint8_t)(color >> 24))) {
-			color = line[4][x];
-			top = 0x10;
-		}
-
-		if(color & 0x00010000)
-		{
-			// semi-transparent OBJ
-			uint32_t back = backdrop;
-			uint8_t top2 = 0x20;
-
-			if((mask & 1) && ((uint8_t)(line[0][x]>>24) < (uint8_t)(back >> 24))) {
-				back = line[0][x];
-				top2 = 0x01;
-			}
-
-			if((mask & 2) && ((uint8_t)(line[1][x]>>24) < (uint8_t)(back >> 24))) {
-				back = line[1][x];
-				top2 = 0x02;
-			}
-
-			if((mask & 4) && ((uint8_t)(line[2][x]>>24) < (uint8_t)(back >> 24))) {
-				back = line[2][x];
-				top2 = 0x04;
-			}
-
-			if((mask & 8) && ((uint8_t)(line[3][x]>>24) < (uint8_t)(back >> 24))) {
-				back = line[3][x];
-				top2 = 0x08;
-			}
-
-			alpha_blend_brightness_switch();
-		}
-		else if((mask & 32) && (top & BLDMOD))
-		{
-			// special FX on in the window
-			switch((BLDMOD >> 6) & 3)
-			{
-				case 0:
-					break;
-				case 1:
-					{
-						uint32_t back = backdrop;
-						uint8_t top2 = 0x20;
-						if(((mask & 1) && (uint8_t)(line[0][x]>>24) < (uint8_t)(back >> 24)) && top != 0x01)
-						{
-							back = line[0][x];
-							top2 = 0x01;
-						}
-
-						if(((mask & 2) && (uint8_t)(line[1][x]>>24) < (uint8_t)(back >> 24)) && top != 0x02)
-						{
-							back = line[1][x];
-							top2 = 0x02;
-						}
-
-						if(((mask & 4) && (uint8_t)(line[2][x]>>24) < (uint8_t)(back >> 24)) && top != 0x04)
-						{
-							back = line[2][x];
-							top2 = 0x04;
-						}
-
-						if(((mask & 8) && (uint8_t)(line[3][x]>>24) < (uint8_t)(back >> 24)) && top != 0x08)
-						{
-							back = line[3][x];
-							top2 = 0x08;
-						}
-
-						if(((mask & 16) && (uint8_t)(line[4][x]>>24) < (uint8_t)(back >> 24)) && top != 0x10) {
-							back = line[4][x];
-							top2 = 0x10;
-						}
-
-						if(top2 & (BLDMOD>>8) && color < 0x80000000)
-						{
-							GFX_ALPHA_BLEND(color, back, coeff[COLEV & 0x1F], coeff[(COLEV >> 8) & 0x1F]);
-						}
-					}
-					break;
-				case 2:
-					color = gfxIncreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-				case 3:
-					color = gfxDecreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-			}
-		}
-
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+	uint8_t mask[240];
+	gfxWindowMask(mask, inWindow0, inWindow1);
+	gfxCompositeLine<GFX_MODE0_LAYERS>(lineMix, true, mask);
 }
 
 /*
@@ -9521,8 +9847,6 @@ void mode1RenderLine (void)
 #endif
 	INIT_COLOR_DEPTH_LINE_MIX();
 
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
-
   if(graphics.layerEnable & 0x0100) {
     gfxDrawTextScreen(io_registers[REG_BG0CNT], io_registers[REG_BG0HOFS], io_registers[REG_BG0VOFS], line[0]);
   }
@@ -9542,73 +9866,7 @@ void mode1RenderLine (void)
 				gfxBG2X, gfxBG2Y, changed, line[2]);
 	}
 
-	uint32_t backdrop = (READ16LE(&palette[0]) | 0x30000000);
-
-	for(uint32_t x = 0; x < 240u; ++x) {
-		uint32_t color = backdrop;
-		uint8_t top = 0x20;
-
-		uint8_t li1 = (uint8_t)(line[1][x]>>24);
-		uint8_t li2 = (uint8_t)(line[2][x]>>24);
-		uint8_t li4 = (uint8_t)(line[4][x]>>24);	
-
-		uint8_t r = 	(li2 < li1) ? (li2) : (li1);
-
-		if(li4 < r){
-			r = 	(li4);
-		}
-
-		if(line[0][x] < backdrop) {
-			color = line[0][x];
-			top = 0x01;
-		}
-
-		if(r < (uint8_t)(color >> 24)) {
-			if(r == li1){
-				color = line[1][x];
-				top = 0x02;
-			}else if(r == li2){
-				color = line[2][x];
-				top = 0x04;
-			}else if(r == li4){
-				color = line[4][x];
-				top = 0x10;
-				if((color & 0x00010000))
-				{
-					// semi-transparent OBJ
-					uint32_t back = backdrop;
-					uint8_t top2 = 0x20;
-
-					uint8_t li0 = (uint8_t)(line[0][x]>>24);
-					uint8_t li1 = (uint8_t)(line[1][x]>>24);
-					uint8_t li2 = (uint8_t)(line[2][x]>>24);
-					uint8_t r = 	(li1 < li0) ? (li1) : (li0);
-
-					if(li2 < r) {
-						r =  (li2);
-					}
-
-					if(r < (uint8_t)(back >> 24)) {
-						if(r == li0){
-							back = line[0][x];
-							top2 = 0x01;
-						}else if(r == li1){
-							back = line[1][x];
-							top2 = 0x02;
-						}else if(r == li2){
-							back = line[2][x];
-							top2 = 0x04;
-						}
-					}
-
-					alpha_blend_brightness_switch();
-				}
-			}
-		}
-
-
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+	gfxCompositeLine<GFX_MODE1_LAYERS>(lineMix, false, NULL);
 	gfxBG2Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
 }
@@ -9620,13 +9878,10 @@ void mode1RenderLineNoWindow (void)
 #endif
 	INIT_COLOR_DEPTH_LINE_MIX();
 
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
-
   if(graphics.layerEnable & 0x0100) {
     gfxDrawTextScreen(io_registers[REG_BG0CNT], io_registers[REG_BG0HOFS], io_registers[REG_BG0VOFS], line[0]);
   }
 
-
   if(graphics.layerEnable & 0x0200) {
     gfxDrawTextScreen(io_registers[REG_BG1CNT], io_registers[REG_BG1HOFS], io_registers[REG_BG1VOFS], line[1]);
   }
@@ -9642,124 +9897,7 @@ void mode1RenderLineNoWindow (void)
 				gfxBG2X, gfxBG2Y, changed, line[2]);
 	}
 
-	uint32_t backdrop = (READ16LE(&palette[0]) | 0x30000000);
-
-	for(int x = 0; x < 240; ++x) {
-		uint32_t color = backdrop;
-		uint8_t top = 0x20;
-
-		uint8_t li1 = (uint8_t)(line[1][x]>>24);
-		uint8_t li2 = (uint8_t)(line[2][x]>>24);
-		uint8_t li4 = (uint8_t)(line[4][x]>>24);	
-
-		uint8_t r = 	(li2 < li1) ? (li2) : (li1);
-
-		if(li4 < r){
-			r = 	(li4);
-		}
-
-		if(line[0][x] < backdrop) {
-			color = line[0][x];
-			top = 0x01;
-		}
-
-		if(r < (uint8_t)(color >> 24)) {
-			if(r == li1){
-				color = line[1][x];
-				top = 0x02;
-			}else if(r == li2){
-				color = line[2][x];
-				top = 0x04;
-			}else if(r == li4){
-				color = line[4][x];
-				top = 0x10;
-			}
-		}
-
-		if(!(color & 0x00010000)) {
-			switch((BLDMOD >> 6) & 3) {
-				case 0:
-					break;
-				case 1:
-					if(top & BLDMOD)
-					{
-						uint32_t back = backdrop;
-						uint8_t top2 = 0x20;
-
-						if((top != 0x01) && (uint8_t)(line[0][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[0][x];
-							top2 = 0x01;
-						}
-
-						if((top != 0x02) && (uint8_t)(line[1][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[1][x];
-							top2 = 0x02;
-						}
-
-						if((top != 0x04) && (uint8_t)(line[2][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[2][x];
-							top2 = 0x04;
-						}
-
-						if((top != 0x10) && (uint8_t)(line[4][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[4][x];
-							top2 = 0x10;
-						}
-
-						if(top2 & (BLDMOD>>8) && color < 0x80000000)
-						{
-							GFX_ALPHA_BLEND(color, back, coeff[COLEV & 0x1F], coeff[(COLEV >> 8) & 0x1F]);
-						}
-					}
-					break;
-				case 2:
-					if(BLDMOD & top)
-						color = gfxIncreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-				case 3:
-					if(BLDMOD & top)
-						color = gfxDecreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-			}
-		} else {
-			// semi-transparent OBJ
-			uint32_t back = backdrop;
-			uint8_t top2 = 0x20;
-
-			uint8_t li0 = (uint8_t)(line[0][x]>>24);
-			uint8_t li1 = (uint8_t)(line[1][x]>>24);
-			uint8_t li2 = (uint8_t)(line[2][x]>>24);	
-
-			uint8_t r = 	(li1 < li0) ? (li1) : (li0);
-
-			if(li2 < r) {
-				r =  (li2);
-			}
-
-			if(r < (uint8_t)(back >> 24))
-			{
-				if(r == li0)
-				{
-					back = line[0][x];
-					top2 = 0x01;
-				}
-				else if(r == li1)
-				{
-					back = line[1][x];
-					top2 = 0x02;
-				}
-				else if(r == li2)
-				{
-					back = line[2][x];
-					top2 = 0x04;
-				}
-			}
-
-			alpha_blend_brightness_switch();
-		}
-
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+	gfxCompositeLine<GFX_MODE1_LAYERS>(lineMix, true, NULL);
 	gfxBG2Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
 }
@@ -9771,8 +9909,6 @@ void mode1RenderLineAll (void)
 #endif
 	INIT_COLOR_DEPTH_LINE_MIX();
 
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
-
 	bool inWindow0 = false;
 	bool inWindow1 = false;
 
@@ -9809,137 +9945,28 @@ void mode1RenderLineAll (void)
 #endif
 	}
 
-  if(graphics.layerEnable & 0x0100) {
-    gfxDrawTextScreen(io_registers[REG_BG0CNT], io_registers[REG_BG0HOFS], io_registers[REG_BG0VOFS], line[0]);
-  }
-
-  if(graphics.layerEnable & 0x0200) {
-    gfxDrawTextScreen(io_registers[REG_BG1CNT], io_registers[REG_BG1HOFS], io_registers[REG_BG1VOFS], line[1]);
-  }
-
-	if(graphics.layerEnable & 0x0400) {
-		int changed = gfxBG2Changed;
-#if 0
-		if(gfxLastVCOUNT > io_registers[REG_VCOUNT])
-			changed = 3;
-#endif
-		gfxDrawRotScreen(io_registers[REG_BG2CNT], BG2X_L, BG2X_H, BG2Y_L, BG2Y_H,
-				io_registers[REG_BG2PA], io_registers[REG_BG2PB], io_registers[REG_BG2PC], io_registers[REG_BG2PD],
-				gfxBG2X, gfxBG2Y, changed, line[2]);
-	}
-
-	uint32_t backdrop = (READ16LE(&palette[0]) | 0x30000000);
-
-	uint8_t inWin0Mask = io_registers[REG_WININ] & 0xFF;
-	uint8_t inWin1Mask = io_registers[REG_WININ] >> 8;
-	uint8_t outMask = io_registers[REG_WINOUT] & 0xFF;
-
-	for(int x = 0; x < 240; ++x) {
-		uint32_t color = backdrop;
-		uint8_t top = 0x20;
-		uint8_t mask = outMask;
-
-		if(!(line[5][x] & 0x80000000)) {
-			mask = io_registers[REG_WINOUT] >> 8;
-		}
-
-		int32_t window1_mask = ((inWindow1 & gfxInWin[1][x]) | -(inWindow1 & gfxInWin[1][x])) >> 31;
-		int32_t window0_mask = ((inWindow0 & gfxInWin[0][x]) | -(inWindow0 & gfxInWin[0][x])) >> 31;
-		mask = (inWin1Mask & window1_mask) | (mask & ~window1_mask);
-		mask = (inWin0Mask & window0_mask) | (mask & ~window0_mask);
-
-		// At the very least, move the inexpensive 'mask' operation up front
-		if((mask & 1) && line[0][x] < backdrop) {
-			color = line[0][x];
-			top = 0x01;
-		}
-
-		if((mask & 2) && (uint8_t)(line[1][x]>>24) < (uint8_t)(color >> 24)) {
-			color = line[1][x];
-			top = 0x02;
-		}
-
-		if((mask & 4) && (uint8_t)(line[2][x]>>24) < (uint8_t)(color >> 24)) {
-			color = line[2][x];
-			top = 0x04;
-		}
-
-		if((mask & 16) && (uint8_t)(line[4][x]>>24) < (uint8_t)(color >> 24)) {
-			color = line[4][x];
-			top = 0x10;
-		}
-
-		if(color & 0x00010000) {
-			// semi-transparent OBJ
-			uint32_t back = backdrop;
-			uint8_t top2 = 0x20;
-
-			if((mask & 1) && (uint8_t)(line[0][x]>>24) < (uint8_t)(backdrop >> 24)) {
-				back = line[0][x];
-				top2 = 0x01;
-			}
-
-			if((mask & 2) && (uint8_t)(line[1][x]>>24) < (uint8_t)(back >> 24)) {
-				back = line[1][x];
-				top2 = 0x02;
-			}
-
-			if((mask & 4) && (uint8_t)(line[2][x]>>24) < (uint8_t)(back >> 24)) {
-				back = line[2][x];
-				top2 = 0x04;
-			}
-
-			alpha_blend_brightness_switch();
-		} else if(mask & 32) {
-			// special FX on the window
-			switch((BLDMOD >> 6) & 3) {
-				case 0:
-					break;
-				case 1:
-					if(top & BLDMOD)
-					{
-						uint32_t back = backdrop;
-						uint8_t top2 = 0x20;
-
-						if((mask & 1) && (top != 0x01) && (uint8_t)(line[0][x]>>24) < (uint8_t)(backdrop >> 24)) {
-							back = line[0][x];
-							top2 = 0x01;
-						}
-
-						if((mask & 2) && (top != 0x02) && (uint8_t)(line[1][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[1][x];
-							top2 = 0x02;
-						}
-
-						if((mask & 4) && (top != 0x04) && (uint8_t)(line[2][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[2][x];
-							top2 = 0x04;
-						}
-
-						if((mask & 16) && (top != 0x10) && (uint8_t)(line[4][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[4][x];
-							top2 = 0x10;
-						}
-
-						if(top2 & (BLDMOD>>8) && color < 0x80000000)
-						{
-							GFX_ALPHA_BLEND(color, back, coeff[COLEV & 0x1F], coeff[(COLEV >> 8) & 0x1F]);
-						}
-					}
-					break;
-				case 2:
-					if(BLDMOD & top)
-						color = gfxIncreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-				case 3:
-					if(BLDMOD & top)
-						color = gfxDecreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-			}
-		}
-
-		lineMix[x] = CONVERT_COLOR(color);
+  if(graphics.layerEnable & 0x0100) {
+    gfxDrawTextScreen(io_registers[REG_BG0CNT], io_registers[REG_BG0HOFS], io_registers[REG_BG0VOFS], line[0]);
+  }
+
+  if(graphics.layerEnable & 0x0200) {
+    gfxDrawTextScreen(io_registers[REG_BG1CNT], io_registers[REG_BG1HOFS], io_registers[REG_BG1VOFS], line[1]);
+  }
+
+	if(graphics.layerEnable & 0x0400) {
+		int changed = gfxBG2Changed;
+#if 0
+		if(gfxLastVCOUNT > io_registers[REG_VCOUNT])
+			changed = 3;
+#endif
+		gfxDrawRotScreen(io_registers[REG_BG2CNT], BG2X_L, BG2X_H, BG2Y_L, BG2Y_H,
+				io_registers[REG_BG2PA], io_registers[REG_BG2PB], io_registers[REG_BG2PC], io_registers[REG_BG2PD],
+				gfxBG2X, gfxBG2Y, changed, line[2]);
 	}
+
+	uint8_t mask[240];
+	gfxWindowMask(mask, inWindow0, inWindow1);
+	gfxCompositeLine<GFX_MODE1_LAYERS>(lineMix, true, mask);
 	gfxBG2Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
 }
@@ -9960,8 +9987,6 @@ void mode2RenderLine (void)
 #endif
 	INIT_COLOR_DEPTH_LINE_MIX();
 
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
-
 	if(graphics.layerEnable & 0x0400) {
 		int changed = gfxBG2Changed;
 #if 0
@@ -9986,60 +10011,7 @@ void mode2RenderLine (void)
 				changed, line[3]);
 	}
 
-	uint32_t backdrop = (READ16LE(&palette[0]) | 0x30000000);
-
-	for(int x = 0; x < 240; ++x) {
-		uint32_t color = backdrop;
-		uint8_t top = 0x20;
-
-		uint8_t li2 = (uint8_t)(line[2][x]>>24);
-		uint8_t li3 = (uint8_t)(line[3][x]>>24);
-		uint8_t li4 = (uint8_t)(line[4][x]>>24);	
-
-		uint8_t r = 	(li3 < li2) ? (li3) : (li2);
-
-		if(li4 < r){
-			r = 	(li4);
-		}
-
-		if(r < (uint8_t)(color >> 24)) {
-			if(r == li2){
-				color = line[2][x];
-				top = 0x04;
-			}else if(r == li3){
-				color = line[3][x];
-				top = 0x08;
-			}else if(r == li4){
-				color = line[4][x];
-				top = 0x10;
-
-				if(color & 0x00010000) {
-					// semi-transparent OBJ
-					uint32_t back = backdrop;
-					uint8_t top2 = 0x20;
-
-					uint8_t li2 = (uint8_t)(line[2][x]>>24);
-					uint8_t li3 = (uint8_t)(line[3][x]>>24);
-					uint8_t r = 	(li3 < li2) ? (li3) : (li2);
-
-					if(r < (uint8_t)(back >> 24)) {
-						if(r == li2){
-							back = line[2][x];
-							top2 = 0x04;
-						}else if(r == li3){
-							back = line[3][x];
-							top2 = 0x08;
-						}
-					}
-
-					alpha_blend_brightness_switch();
-				}
-			}
-		}
-
-
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+	gfxCompositeLine<GFX_MODE2_LAYERS>(lineMix, false, NULL);
 	gfxBG2Changed = 0;
 	gfxBG3Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
@@ -10052,8 +10024,6 @@ void mode2RenderLineNoWindow (void)
 #endif
 	INIT_COLOR_DEPTH_LINE_MIX();
 
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
-
 	if(graphics.layerEnable & 0x0400) {
 		int changed = gfxBG2Changed;
 #if 0
@@ -10078,99 +10048,7 @@ void mode2RenderLineNoWindow (void)
 				changed, line[3]);
 	}
 
-	uint32_t backdrop = (READ16LE(&palette[0]) | 0x30000000);
-
-	for(int x = 0; x < 240; ++x) {
-		uint32_t color = backdrop;
-		uint8_t top = 0x20;
-
-		uint8_t li2 = (uint8_t)(line[2][x]>>24);
-		uint8_t li3 = (uint8_t)(line[3][x]>>24);
-		uint8_t li4 = (uint8_t)(line[4][x]>>24);	
-
-		uint8_t r = 	(li3 < li2) ? (li3) : (li2);
-
-		if(li4 < r){
-			r = 	(li4);
-		}
-
-		if(r < (uint8_t)(color >> 24)) {
-			if(r == li2){
-				color = line[2][x];
-				top = 0x04;
-			}else if(r == li3){
-				color = line[3][x];
-				top = 0x08;
-			}else if(r == li4){
-				color = line[4][x];
-				top = 0x10;
-			}
-		}
-
-		if(!(color & 0x00010000)) {
-			switch((BLDMOD >> 6) & 3) {
-				case 0:
-					break;
-				case 1:
-					if(top & BLDMOD)
-					{
-						uint32_t back = backdrop;
-						uint8_t top2 = 0x20;
-
-						if((top != 0x04) && (uint8_t)(line[2][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[2][x];
-							top2 = 0x04;
-						}
-
-						if((top != 0x08) && (uint8_t)(line[3][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[3][x];
-							top2 = 0x08;
-						}
-
-						if((top != 0x10) && (uint8_t)(line[4][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[4][x];
-							top2 = 0x10;
-						}
-
-						if(top2 & (BLDMOD>>8) && color < 0x80000000)
-						{
-							GFX_ALPHA_BLEND(color, back, coeff[COLEV & 0x1F], coeff[(COLEV >> 8) & 0x1F]);
-						}
-					}
-					break;
-				case 2:
-					if(BLDMOD & top)
-						color = gfxIncreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-				case 3:
-					if(BLDMOD & top)
-						color = gfxDecreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-			}
-		} else {
-			// semi-transparent OBJ
-			uint32_t back = backdrop;
-			uint8_t top2 = 0x20;
-
-			uint8_t li2 = (uint8_t)(line[2][x]>>24);
-			uint8_t li3 = (uint8_t)(line[3][x]>>24);
-			uint8_t r = 	(li3 < li2) ? (li3) : (li2);
-
-			if(r < (uint8_t)(back >> 24)) {
-				if(r == li2){
-					back = line[2][x];
-					top2 = 0x04;
-				}else if(r == li3){
-					back = line[3][x];
-					top2 = 0x08;
-				}
-			}
-
-			alpha_blend_brightness_switch();
-		}
-
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+	gfxCompositeLine<GFX_MODE2_LAYERS>(lineMix, true, NULL);
 	gfxBG2Changed = 0;
 	gfxBG3Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
@@ -10183,8 +10061,6 @@ void mode2RenderLineAll (void)
 #endif
 	INIT_COLOR_DEPTH_LINE_MIX();
 
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
-
 	bool inWindow0 = false;
 	bool inWindow1 = false;
 
@@ -10245,102 +10121,9 @@ void mode2RenderLineAll (void)
 				changed, line[3]);
 	}
 
-	uint32_t backdrop = (READ16LE(&palette[0]) | 0x30000000);
-
-	uint8_t inWin0Mask = io_registers[REG_WININ] & 0xFF;
-	uint8_t inWin1Mask = io_registers[REG_WININ] >> 8;
-	uint8_t outMask = io_registers[REG_WINOUT] & 0xFF;
-
-	for(int x = 0; x < 240; x++) {
-		uint32_t color = backdrop;
-		uint8_t top = 0x20;
-		uint8_t mask = outMask;
-
-		if(!(line[5][x] & 0x80000000)) {
-			mask = io_registers[REG_WINOUT] >> 8;
-		}
-
-		int32_t window1_mask = ((inWindow1 & gfxInWin[1][x]) | -(inWindow1 & gfxInWin[1][x])) >> 31;
-		int32_t window0_mask = ((inWindow0 & gfxInWin[0][x]) | -(inWindow0 & gfxInWin[0][x])) >> 31;
-		mask = (inWin1Mask & window1_mask) | (mask & ~window1_mask);
-		mask = (inWin0Mask & window0_mask) | (mask & ~window0_mask);
-
-		if((mask & 4) && line[2][x] < color) {
-			color = line[2][x];
-			top = 0x04;
-		}
-
-		if((mask & 8) && (uint8_t)(line[3][x]>>24) < (uint8_t)(color >> 24)) {
-			color = line[3][x];
-			top = 0x08;
-		}
-
-		if((mask & 16) && (uint8_t)(line[4][x]>>24) < (uint8_t)(color >> 24)) {
-			color = line[4][x];
-			top = 0x10;
-		}
-
-		if(color & 0x00010000) {
-			// semi-transparent OBJ
-			uint32_t back = backdrop;
-			uint8_t top2 = 0x20;
-
-			if((mask & 4) && line[2][x] < back) {
-				back = line[2][x];
-				top2 = 0x04;
-			}
-
-			if((mask & 8) && (uint8_t)(line[3][x]>>24) < (uint8_t)(back >> 24)) {
-				back = line[3][x];
-				top2 = 0x08;
-			}
-
-			alpha_blend_brightness_switch();
-		} else if(mask & 32) {
-			// special FX on the window
-			switch((BLDMOD >> 6) & 3) {
-				case 0:
-					break;
-				case 1:
-					if(top & BLDMOD)
-					{
-						uint32_t back = backdrop;
-						uint8_t top2 = 0x20;
-
-						if((mask & 4) && (top != 0x04) && line[2][x] < back) {
-							back = line[2][x];
-							top2 = 0x04;
-						}
-
-						if((mask & 8) && (top != 0x08) && (uint8_t)(line[3][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[3][x];
-							top2 = 0x08;
-						}
-
-						if((mask & 16) && (top != 0x10) && (uint8_t)(line[4][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[4][x];
-							top2 = 0x10;
-						}
-
-						if(top2 & (BLDMOD>>8) && color < 0x80000000)
-						{
-							GFX_ALPHA_BLEND(color, back, coeff[COLEV & 0x1F], coeff[(COLEV >> 8) & 0x1F]);
-						}
-					}
-					break;
-				case 2:
-					if(BLDMOD & top)
-						color = gfxIncreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-				case 3:
-					if(BLDMOD & top)
-						color = gfxDecreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-			}
-		}
-
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+	uint8_t mask[240];
+	gfxWindowMask(mask, inWindow0, inWindow1);
+	gfxCompositeLine<GFX_MODE2_LAYERS>(lineMix, true, mask);
 	gfxBG2Changed = 0;
 	gfxBG3Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
@@ -10360,7 +10143,6 @@ void mode3RenderLine (void)
 	fprintf(stderr, "MODE 3: Render Line\n");
 #endif
 	INIT_COLOR_DEPTH_LINE_MIX();
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
 
 	if(graphics.layerEnable & 0x0400) {
 		int changed = gfxBG2Changed;
@@ -10373,38 +10155,7 @@ void mode3RenderLine (void)
 		gfxDrawRotScreen16Bit(gfxBG2X, gfxBG2Y, changed);
 	}
 
-	uint32_t background = (READ16LE(&palette[0]) | 0x30000000);
-
-	for(int x = 0; x < 240; ++x) {
-		uint32_t color = background;
-		uint8_t top = 0x20;
-
-		if(line[2][x] < color) {
-			color = line[2][x];
-			top = 0x04;
-		}
-
-		if((uint8_t)(line[4][x]>>24) < (uint8_t)(color >>24)) {
-			color = line[4][x];
-			top = 0x10;
-
-			if(color & 0x00010000) {
-				// semi-transparent OBJ
-				uint32_t back = background;
-				uint8_t top2 = 0x20;
-
-				if(line[2][x] < background) {
-					back = line[2][x];
-					top2 = 0x04;
-				}
-
-				alpha_blend_brightness_switch();
-			}
-		}
-
-
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+	gfxCompositeLine<GFX_MODE345_LAYERS>(lineMix, false, NULL);
 	gfxBG2Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
 }
@@ -10415,7 +10166,6 @@ void mode3RenderLineNoWindow (void)
 	fprintf(stderr, "MODE 3: Render Line No Window\n");
 #endif
 	INIT_COLOR_DEPTH_LINE_MIX();
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
 
 	if(graphics.layerEnable & 0x0400) {
 		int changed = gfxBG2Changed;
@@ -10428,73 +10178,7 @@ void mode3RenderLineNoWindow (void)
 		gfxDrawRotScreen16Bit(gfxBG2X, gfxBG2Y, changed);
 	}
 
-	uint32_t background = (READ16LE(&palette[0]) | 0x30000000);
-
-	for(int x = 0; x < 240; ++x) {
-		uint32_t color = background;
-		uint8_t top = 0x20;
-
-		if(line[2][x] < background) {
-			color = line[2][x];
-			top = 0x04;
-		}
-
-		if((uint8_t)(line[4][x]>>24) < (uint8_t)(color >>24)) {
-			color = line[4][x];
-			top = 0x10;
-		}
-
-		if(!(color & 0x00010000)) {
-			switch((BLDMOD >> 6) & 3) {
-				case 0:
-					break;
-				case 1:
-					if(top & BLDMOD)
-					{
-						uint32_t back = background;
-						uint8_t top2 = 0x20;
-
-						if(top != 0x04 && (line[2][x] < background) ) {
-							back = line[2][x];
-							top2 = 0x04;
-						}
-
-						if(top != 0x10 && ((uint8_t)(line[4][x]>>24) < (uint8_t)(back >> 24))) {
-							back = line[4][x];
-							top2 = 0x10;
-						}
-
-						if(top2 & (BLDMOD>>8) && color < 0x80000000)
-						{
-							GFX_ALPHA_BLEND(color, back, coeff[COLEV & 0x1F], coeff[(COLEV >> 8) & 0x1F]);
-						}
-
-					}
-					break;
-				case 2:
-					if(BLDMOD & top)
-						color = gfxIncreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-				case 3:
-					if(BLDMOD & top)
-						color = gfxDecreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-			}
-		} else {
-			// semi-transparent OBJ
-			uint32_t back = background;
-			uint8_t top2 = 0x20;
-
-			if(line[2][x] < background) {
-				back = line[2][x];
-				top2 = 0x04;
-			}
-
-			alpha_blend_brightness_switch();
-		}
-
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+	gfxCompositeLine<GFX_MODE345_LAYERS>(lineMix, true, NULL);
 	gfxBG2Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
 }
@@ -10505,7 +10189,6 @@ void mode3RenderLineAll (void)
 	fprintf(stderr, "MODE 3: Render Line All\n");
 #endif
 	INIT_COLOR_DEPTH_LINE_MIX();
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
 
 	bool inWindow0 = false;
 	bool inWindow1 = false;
@@ -10540,101 +10223,24 @@ void mode3RenderLineAll (void)
 		if(v1 >= v0)
 			inWindow1 |= (io_registers[REG_VCOUNT] >= v0 && io_registers[REG_VCOUNT] < v1);
 		else
-			inWindow1 |= (io_registers[REG_VCOUNT] >= v0 || io_registers[REG_VCOUNT] < v1);
-#endif
-	}
-
-	if(graphics.layerEnable & 0x0400) {
-		int changed = gfxBG2Changed;
-
-#if 0
-		if(gfxLastVCOUNT > io_registers[REG_VCOUNT])
-			changed = 3;
-#endif
-
-		gfxDrawRotScreen16Bit(gfxBG2X, gfxBG2Y, changed);
-	}
-
-	uint8_t inWin0Mask = io_registers[REG_WININ] & 0xFF;
-	uint8_t inWin1Mask = io_registers[REG_WININ] >> 8;
-	uint8_t outMask = io_registers[REG_WINOUT] & 0xFF;
-
-	uint32_t background = (READ16LE(&palette[0]) | 0x30000000);
-
-	for(int x = 0; x < 240; ++x) {
-		uint32_t color = background;
-		uint8_t top = 0x20;
-		uint8_t mask = outMask;
-
-		if(!(line[5][x] & 0x80000000)) {
-			mask = io_registers[REG_WINOUT] >> 8;
-		}
-
-		int32_t window1_mask = ((inWindow1 & gfxInWin[1][x]) | -(inWindow1 & gfxInWin[1][x])) >> 31;
-		int32_t window0_mask = ((inWindow0 & gfxInWin[0][x]) | -(inWindow0 & gfxInWin[0][x])) >> 31;
-		mask = (inWin1Mask & window1_mask) | (mask & ~window1_mask);
-		mask = (inWin0Mask & window0_mask) | (mask & ~window0_mask);
-
-		if((mask & 4) && line[2][x] < background) {
-			color = line[2][x];
-			top = 0x04;
-		}
-
-		if((mask & 16) && ((uint8_t)(line[4][x]>>24) < (uint8_t)(color >>24))) {
-			color = line[4][x];
-			top = 0x10;
-		}
-
-		if(color & 0x00010000) {
-			// semi-transparent OBJ
-			uint32_t back = background;
-			uint8_t top2 = 0x20;
-
-			if((mask & 4) && line[2][x] < background) {
-				back = line[2][x];
-				top2 = 0x04;
-			}
-
-			alpha_blend_brightness_switch();
-		} else if(mask & 32) {
-			switch((BLDMOD >> 6) & 3) {
-				case 0:
-					break;
-				case 1:
-					if(top & BLDMOD)
-					{
-						uint32_t back = background;
-						uint8_t top2 = 0x20;
-
-						if((mask & 4) && (top != 0x04) && line[2][x] < back) {
-							back = line[2][x];
-							top2 = 0x04;
-						}
-
-						if((mask & 16) && (top != 0x10) && (uint8_t)(line[4][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[4][x];
-							top2 = 0x10;
-						}
-
-						if(top2 & (BLDMOD>>8) && color < 0x80000000)
-						{
-							GFX_ALPHA_BLEND(color, back, coeff[COLEV & 0x1F], coeff[(COLEV >> 8) & 0x1F]);
-						}
-					}
-					break;
-				case 2:
-					if(BLDMOD & top)
-						color = gfxIncreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-				case 3:
-					if(BLDMOD & top)
-						color = gfxDecreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-			}
-		}
+			inWindow1 |= (io_registers[REG_VCOUNT] >= v0 || io_registers[REG_VCOUNT] < v1);
+#endif
+	}
 
-		lineMix[x] = CONVERT_COLOR(color);
+	if(graphics.layerEnable & 0x0400) {
+		int changed = gfxBG2Changed;
+
+#if 0
+		if(gfxLastVCOUNT > io_registers[REG_VCOUNT])
+			changed = 3;
+#endif
+
+		gfxDrawRotScreen16Bit(gfxBG2X, gfxBG2Y, changed);
 	}
+
+	uint8_t mask[240];
+	gfxWindowMask(mask, inWindow0, inWindow1);
+	gfxCompositeLine<GFX_MODE345_LAYERS>(lineMix, true, mask);
 	gfxBG2Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
 }
@@ -10653,7 +10259,6 @@ void mode4RenderLine (void)
 	fprintf(stderr, "MODE 4: Render Line\n");
 #endif
 	INIT_COLOR_DEPTH_LINE_MIX();
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
 
 	if(graphics.layerEnable & 0x400)
 	{
@@ -10667,39 +10272,7 @@ void mode4RenderLine (void)
 		gfxDrawRotScreen256(gfxBG2X, gfxBG2Y, changed);
 	}
 
-	uint32_t backdrop = (READ16LE(&palette[0]) | 0x30000000);
-
-	for(int x = 0; x < 240; ++x)
-	{
-		uint32_t color = backdrop;
-		uint8_t top = 0x20;
-
-		if(line[2][x] < backdrop) {
-			color = line[2][x];
-			top = 0x04;
-		}
-
-		if((uint8_t)(line[4][x]>>24) < (uint8_t)(color >> 24)) {
-			color = line[4][x];
-			top = 0x10;
-
-			if(color & 0x00010000) {
-				// semi-transparent OBJ
-				uint32_t back = backdrop;
-				uint8_t top2 = 0x20;
-
-				if(line[2][x] < backdrop) {
-					back = line[2][x];
-					top2 = 0x04;
-				}
-
-				alpha_blend_brightness_switch();
-			}
-		}
-
-
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+	gfxCompositeLine<GFX_MODE345_LAYERS>(lineMix, false, NULL);
 	gfxBG2Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
 }
@@ -10710,7 +10283,6 @@ void mode4RenderLineNoWindow (void)
 	fprintf(stderr, "MODE 4: Render Line No Window\n");
 #endif
 	INIT_COLOR_DEPTH_LINE_MIX();
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
 
 	if(graphics.layerEnable & 0x400)
 	{
@@ -10724,73 +10296,7 @@ void mode4RenderLineNoWindow (void)
 		gfxDrawRotScreen256(gfxBG2X, gfxBG2Y, changed);
 	}
 
-	uint32_t backdrop = (READ16LE(&palette[0]) | 0x30000000);
-
-	for(int x = 0; x < 240; ++x)
-	{
-		uint32_t color = backdrop;
-		uint8_t top = 0x20;
-
-		if(line[2][x] < backdrop) {
-			color = line[2][x];
-			top = 0x04;
-		}
-
-		if((uint8_t)(line[4][x]>>24) < (uint8_t)(color >> 24)) {
-			color = line[4][x];
-			top = 0x10;
-		}
-
-		if(!(color & 0x00010000)) {
-			switch((BLDMOD >> 6) & 3) {
-				case 0:
-					break;
-				case 1:
-					if(top & BLDMOD)
-					{
-						uint32_t back = backdrop;
-						uint8_t top2 = 0x20;
-
-						if((top != 0x04) && line[2][x] < backdrop) {
-							back = line[2][x];
-							top2 = 0x04;
-						}
-
-						if((top != 0x10) && (uint8_t)(line[4][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[4][x];
-							top2 = 0x10;
-						}
-
-						if(top2 & (BLDMOD>>8) && color < 0x80000000)
-						{
-							GFX_ALPHA_BLEND(color, back, coeff[COLEV & 0x1F], coeff[(COLEV >> 8) & 0x1F]);
-						}
-					}
-					break;
-				case 2:
-					if(BLDMOD & top)
-						color = gfxIncreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-				case 3:
-					if(BLDMOD & top)
-						color = gfxDecreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-			}
-		} else {
-			// semi-transparent OBJ
-			uint32_t back = backdrop;
-			uint8_t top2 = 0x20;
-
-			if(line[2][x] < back) {
-				back = line[2][x];
-				top2 = 0x04;
-			}
-
-			alpha_blend_brightness_switch();
-		}
-
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+	gfxCompositeLine<GFX_MODE345_LAYERS>(lineMix, true, NULL);
 	gfxBG2Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
 }
@@ -10801,7 +10307,6 @@ void mode4RenderLineAll (void)
 	fprintf(stderr, "MODE 4: Render Line All\n");
 #endif
 	INIT_COLOR_DEPTH_LINE_MIX();
-	uint16_t *palette = (uint16_t *)graphics.paletteRAM;
 
 	bool inWindow0 = false;
 	bool inWindow1 = false;
@@ -10852,87 +10357,9 @@ void mode4RenderLineAll (void)
 		gfxDrawRotScreen256(gfxBG2X, gfxBG2Y, changed);
 	}
 
-	uint32_t backdrop = (READ16LE(&palette[0]) | 0x30000000);
-
-	uint8_t inWin0Mask = io_registers[REG_WININ] & 0xFF;
-	uint8_t inWin1Mask = io_registers[REG_WININ] >> 8;
-	uint8_t outMask = io_registers[REG_WINOUT] & 0xFF;
-
-	for(int x = 0; x < 240; ++x) {
-		uint32_t color = backdrop;
-		uint8_t top = 0x20;
-		uint8_t mask = outMask;
-
-		if(!(line[5][x] & 0x80000000))
-			mask = io_registers[REG_WINOUT] >> 8;
-
-		int32_t window1_mask = ((inWindow1 & gfxInWin[1][x]) | -(inWindow1 & gfxInWin[1][x])) >> 31;
-		int32_t window0_mask = ((inWindow0 & gfxInWin[0][x]) | -(inWindow0 & gfxInWin[0][x])) >> 31;
-		mask = (inWin1Mask & window1_mask) | (mask & ~window1_mask);
-		mask = (inWin0Mask & window0_mask) | (mask & ~window0_mask);
-
-		if((mask & 4) && (line[2][x] < backdrop))
-		{
-			color = line[2][x];
-			top = 0x04;
-		}
-
-		if((mask & 16) && ((uint8_t)(line[4][x]>>24) < (uint8_t)(color >>24)))
-		{
-			color = line[4][x];
-			top = 0x10;
-		}
-
-		if(color & 0x00010000) {
-			// semi-transparent OBJ
-			uint32_t back = backdrop;
-			uint8_t top2 = 0x20;
-
-			if((mask & 4) && line[2][x] < back) {
-				back = line[2][x];
-				top2 = 0x04;
-			}
-
-			alpha_blend_brightness_switch();
-		} else if(mask & 32) {
-			switch((BLDMOD >> 6) & 3) {
-				case 0:
-					break;
-				case 1:
-					if(top & BLDMOD)
-					{
-						uint32_t back = backdrop;
-						uint8_t top2 = 0x20;
-
-						if((mask & 4) && (top != 0x04) && (line[2][x] < backdrop)) {
-							back = line[2][x];
-							top2 = 0x04;
-						}
-
-						if((mask & 16) && (top != 0x10) && (uint8_t)(line[4][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[4][x];
-							top2 = 0x10;
-						}
-
-						if(top2 & (BLDMOD>>8) && color < 0x80000000)
-						{
-							GFX_ALPHA_BLEND(color, back, coeff[COLEV & 0x1F], coeff[(COLEV >> 8) & 0x1F]);
-						}
-					}
-					break;
-				case 2:
-					if(BLDMOD & top)
-						color = gfxIncreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-				case 3:
-					if(BLDMOD & top)
-						color = gfxDecreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-			}
-		}
-
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+	uint8_t mask[240];
+	gfxWindowMask(mask, inWindow0, inWindow1);
+	gfxCompositeLine<GFX_MODE345_LAYERS>(lineMix, true, mask);
 	gfxBG2Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
 }
@@ -10968,36 +10395,7 @@ void mode5RenderLine (void)
 	uint32_t background;
 	background = (READ16LE(&palette[0]) | 0x30000000);
 
-	for(int x = 0; x < 240; ++x) {
-		uint32_t color = background;
-		uint8_t top = 0x20;
-
-		if(line[2][x] < background) {
-			color = line[2][x];
-			top = 0x04;
-		}
-
-		if((uint8_t)(line[4][x]>>24) < (uint8_t)(color >>24)) {
-			color = line[4][x];
-			top = 0x10;
-
-			if(color & 0x00010000) {
-				// semi-transparent OBJ
-				uint32_t back = background;
-				uint8_t top2 = 0x20;
-
-				if(line[2][x] < back) {
-					back = line[2][x];
-					top2 = 0x04;
-				}
-
-				alpha_blend_brightness_switch();
-			}
-		}
-
-
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+	gfxCompositeLine<GFX_MODE345_LAYERS>(lineMix, false, NULL);
 	gfxBG2Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
 }
@@ -11025,71 +10423,7 @@ void mode5RenderLineNoWindow (void)
 	uint32_t background;
 	background = (READ16LE(&palette[0]) | 0x30000000);
 
-	for(int x = 0; x < 240; ++x) {
-		uint32_t color = background;
-		uint8_t top = 0x20;
-
-		if(line[2][x] < background) {
-			color = line[2][x];
-			top = 0x04;
-		}
-
-		if((uint8_t)(line[4][x]>>24) < (uint8_t)(color >>24)) {
-			color = line[4][x];
-			top = 0x10;
-		}
-
-		if(!(color & 0x00010000)) {
-			switch((BLDMOD >> 6) & 3) {
-				case 0:
-					break;
-				case 1:
-					if(top & BLDMOD)
-					{
-						uint32_t back = background;
-						uint8_t top2 = 0x20;
-
-						if((top != 0x04) && line[2][x] < background) {
-							back = line[2][x];
-							top2 = 0x04;
-						}
-
-						if((top != 0x10) && (uint8_t)(line[4][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[4][x];
-							top2 = 0x10;
-						}
-
-						if(top2 & (BLDMOD>>8) && color < 0x80000000)
-						{
-							GFX_ALPHA_BLEND(color, back, coeff[COLEV & 0x1F], coeff[(COLEV >> 8) & 0x1F]);
-						}
-
-					}
-					break;
-				case 2:
-					if(BLDMOD & top)
-						color = gfxIncreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-				case 3:
-					if(BLDMOD & top)
-						color = gfxDecreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-			}
-		} else {
-			// semi-transparent OBJ
-			uint32_t back = background;
-			uint8_t top2 = 0x20;
-
-			if(line[2][x] < back) {
-				back = line[2][x];
-				top2 = 0x04;
-			}
-
-			alpha_blend_brightness_switch();
-		}
-
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+	gfxCompositeLine<GFX_MODE345_LAYERS>(lineMix, true, NULL);
 	gfxBG2Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
 }
@@ -11115,8 +10449,6 @@ void mode5RenderLineAll (void)
 		gfxDrawRotScreen16Bit160(gfxBG2X, gfxBG2Y, changed);
 	}
 
-
-
 	bool inWindow0 = false;
 	bool inWindow1 = false;
 
@@ -11154,87 +10486,12 @@ void mode5RenderLineAll (void)
 #endif
 	}
 
-	uint8_t inWin0Mask = io_registers[REG_WININ] & 0xFF;
-	uint8_t inWin1Mask = io_registers[REG_WININ] >> 8;
-	uint8_t outMask = io_registers[REG_WINOUT] & 0xFF;
-
 	uint32_t background;
 	background = (READ16LE(&palette[0]) | 0x30000000);
 
-	for(int x = 0; x < 240; ++x) {
-		uint32_t color = background;
-		uint8_t top = 0x20;
-		uint8_t mask = outMask;
-
-		if(!(line[5][x] & 0x80000000)) {
-			mask = io_registers[REG_WINOUT] >> 8;
-		}
-
-		int32_t window1_mask = ((inWindow1 & gfxInWin[1][x]) | -(inWindow1 & gfxInWin[1][x])) >> 31;
-		int32_t window0_mask = ((inWindow0 & gfxInWin[0][x]) | -(inWindow0 & gfxInWin[0][x])) >> 31;
-		mask = (inWin1Mask & window1_mask) | (mask & ~window1_mask);
-		mask = (inWin0Mask & window0_mask) | (mask & ~window0_mask);
-
-		if((mask & 4) && (line[2][x] < background)) {
-			color = line[2][x];
-			top = 0x04;
-		}
-
-		if((mask & 16) && ((uint8_t)(line[4][x]>>24) < (uint8_t)(color >>24))) {
-			color = line[4][x];
-			top = 0x10;
-		}
-
-		if(color & 0x00010000) {
-			// semi-transparent OBJ
-			uint32_t back = background;
-			uint8_t top2 = 0x20;
-
-			if((mask & 4) && line[2][x] < back) {
-				back = line[2][x];
-				top2 = 0x04;
-			}
-
-			alpha_blend_brightness_switch();
-		} else if(mask & 32) {
-			switch((BLDMOD >> 6) & 3) {
-				case 0:
-					break;
-				case 1:
-					if(top & BLDMOD)
-					{
-						uint32_t back = background;
-						uint8_t top2 = 0x20;
-
-						if((mask & 4) && (top != 0x04) && (line[2][x] < background)) {
-							back = line[2][x];
-							top2 = 0x04;
-						}
-
-						if((mask & 16) && (top != 0x10) && (uint8_t)(line[4][x]>>24) < (uint8_t)(back >> 24)) {
-							back = line[4][x];
-							top2 = 0x10;
-						}
-
-						if(top2 & (BLDMOD>>8) && color < 0x80000000)
-						{
-							GFX_ALPHA_BLEND(color, back, coeff[COLEV & 0x1F], coeff[(COLEV >> 8) & 0x1F]);
-						}
-					}
-					break;
-				case 2:
-					if(BLDMOD & top)
-						color = gfxIncreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-				case 3:
-					if(BLDMOD & top)
-						color = gfxDecreaseBrightness(color, coeff[COLY & 0x1F]);
-					break;
-			}
-		}
-
-		lineMix[x] = CONVERT_COLOR(color);
-	}
+	uint8_t mask[240];
+	gfxWindowMask(mask, inWindow0, inWindow1);
+	gfxCompositeLine<GFX_MODE345_LAYERS>(lineMix, true, mask);
 	gfxBG2Changed = 0;
 	//gfxLastVCOUNT = io_registers[REG_VCOUNT];
 }
@@ -12258,6 +11515,7 @@ void CPUInit(const u8 *biosfile, const u32 biosfilelen)
 void CPUReset (void)
 {
 	rtcReset();
+	FlushCodeCache();
 	memset(&bus.reg[0], 0, sizeof(bus.reg));	// clean registers
 	memset(oam, 0, 0x400);				// clean OAM
 	memset(graphics.paletteRAM, 0, 0x400);		// clean palette
@@ -13237,6 +12495,9 @@ template<bool isReader>void SyncState(NewState *ns)
 	// address_lut; // values never change
 	
 	NSS(lagged);
+
+	if (isReader)
+		FlushCodeCache();
 }
 
 // load a legacy battery ram file to a place where it might work, who knows
@@ -13426,6 +12687,7 @@ template<bool isReader>bool SyncBatteryRam(NewState *ns)
 		systemAudioFrameSamp = numsamp;
 		lagged = true;
 		UpdateJoypad();
+		FlushCodeCache(); // memory may have been written through the pointers from FillMemoryAreas
 		do
 		{
 			CPULoop();
@@ -13523,6 +12785,8 @@ template<bool isReader>bool SyncBatteryRam(NewState *ns)
 		traceCallback = cb;
 	}
 
+	NewStateLayout stateLayout; // cached for BinStateSize/BinStateSave
+
 }; // class Gigazoid
 
 // zeroing mem operators: these are very important
@@ -13552,6 +12816,7 @@ EXPORT void Destroy(Gigazoid *g)
 
 EXPORT int LoadRom(Gigazoid *g, const u8 *romfile, const u32 romfilelen, const u8 *biosfile, const u32 biosfilelen, const FrontEndSettings *settings)
 {
+	g->stateLayout.Invalidate();
 	return g->LoadRom(romfile, romfilelen, biosfile, biosfilelen, *settings);
 }
 
@@ -13559,6 +12824,7 @@ EXPORT void Reset(Gigazoid *g)
 {
 	// TODO: this calls a soundreset that seems to remake some buffers.  that seems like it should be fixed?
 	g->Reset();
+	g->stateLayout.Invalidate();
 }
 
 EXPORT int FrameAdvance(Gigazoid *g, int input, u32 *videobuffer, s16 *audiobuffer, int *numsamp, u32 *videopalette)
@@ -13625,13 +12891,18 @@ EXPORT int SaveRamLoad(Gigazoid *g, const char *data, int length)
 
 EXPORT int BinStateSize(Gigazoid *g)
 {
-	NewStateDummy dummy;
-	g->SyncState<false>(&dummy);
-	return dummy.GetLength();
+	if (!g->stateLayout.IsValid())
+		g->stateLayout.Build(g);
+	return g->stateLayout.GetLength();
 }
 
 EXPORT int BinStateSave(Gigazoid *g, char *data, int length)
 {
+	if (!g->stateLayout.IsValid())
+		g->stateLayout.Build(g);
+	if (g->stateLayout.IsReplayable())
+		return g->stateLayout.SaveTo(data, length);
+
 	NewStateExternalBuffer saver(data, length);
 	g->SyncState<false>(&saver);
 	return !saver.Overflow() && saver.GetLength() == length;
@@ -13644,6 +12915,80 @@ EXPORT int BinStateLoad(Gigazoid *g, const char *data, int length)
 	return !loader.Overflow() && loader.GetLength() == length;
 }
 
+// runs batches of cores on a CoreBatch.  the cores don't share anything, so each one is run start to finish by
+// whichever thread picks it up
+class Batch
+{
+public:
+	Batch(int threads)
+		:pool(threads), scratch(pool.Threads())
+	{
+	}
+
+	// advances each of count cores for frames frames, with inputs[i][f] as the input of core i on frame f, and then
+	// hashes its savestate into hashes[i].  returns false if any state couldn't be saved; its hash is 0
+	bool Advance(Gigazoid **gs, int count, const int *const *inputs, int frames, u64 *hashes)
+	{
+		std::atomic<bool> ok(true);
+		pool.Run(count, [&](int i, int thread)
+		{
+			Scratch &sc = scratch[thread];
+			Gigazoid *g = gs[i];
+			for (int f = 0; f < frames; f++)
+			{
+				int numsamp;
+				g->FrameAdvance(inputs[i][f], &sc.videobuffer[0], &sc.audiobuffer[0], &numsamp, &sc.videopalette[0]);
+			}
+
+			sc.state.resize(BinStateSize(g));
+			if (BinStateSave(g, &sc.state[0], sc.state.size()))
+			{
+				hashes[i] = CoreBatch::Hash(&sc.state[0], sc.state.size());
+			}
+			else
+			{
+				hashes[i] = 0;
+				ok = false;
+			}
+		});
+		return ok;
+	}
+
+private:
+	// each thread's buffers, kept from one batch to the next
+	struct Scratch
+	{
+		// the frame is only converted through the palette, which doesn't matter here
+		std::vector<u32> videobuffer;
+		std::vector<u32> videopalette;
+		std::vector<s16> audiobuffer;
+		std::vector<char> state;
+		Scratch()
+			:videobuffer(240 * 160), videopalette(65536), audiobuffer(2048)
+		{
+		}
+	};
+
+	CoreBatch pool;
+	std::vector<Scratch> scratch;
+};
+
+// threads is the number of threads to run batches on, counting the caller; 0 for one per core
+EXPORT Batch *BatchCreate(int threads)
+{
+	return new Batch(threads);
+}
+
+EXPORT int BatchFrameAdvance(Batch *b, Gigazoid **gs, int count, const int *const *inputs, int frames, u64 *hashes)
+{
+	return b->Advance(gs, count, inputs, frames, hashes);
+}
+
+EXPORT void BatchDestroy(Batch *b)
+{
+	delete b;
+}
+
 EXPORT void TxtStateSave(Gigazoid *g, FPtrs *ff)
 {
 	NewStateExternalFunctions saver(ff);
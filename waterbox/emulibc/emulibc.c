@@ -5,3 +5,7 @@ void *alloc_sealed(size_t size) { return NULL; }
 void *alloc_invisible(size_t size) { return NULL; }
 void *alloc_plain(size_t size) { return NULL; }
 void _debug_puts(const char *s) { }
+int worker_start(int which, void (*entry)(void *), void *arg) { return 0; }
+void worker_join(int which) { }
+void worker_wait(int which) { }
+void worker_signal(int which) { }
@@ -35,6 +35,19 @@ void *alloc_plain(size_t size);
 // send a debug string somewhere, bypassing stdio
 void _debug_puts(const char *);
 
+// start worker thread `which`, running entry(arg) alongside the calling thread.  a worker may only run while the host
+// is calling into the core, so worker_join() must be called before returning to the host.
+// returns 0 if there is no such worker to be had (the host has one fewer than it has cores, up to a limit); the core
+// should then do the work itself.  workers are numbered from 0, and the core decides what each one is for.
+// a worker's stack is not in the sandbox, so nothing on it is savestated.
+int worker_start(int which, ECL_ENTRY void (*entry)(void *), void *arg);
+// wait for worker `which` to return from its entry point
+void worker_join(int which);
+// called from worker `which`, sleep until worker_signal(which) is called.  a signal that arrives first is not lost.
+void worker_wait(int which);
+// wake worker `which` from worker_wait()
+void worker_signal(int which);
+
 // put data in a section that will have similar behavior characteristics to alloc_sealed
 #define ECL_SEALED __attribute__((section(".sealed")))
 
@@ -63,12 +63,14 @@ void CPU::enter() {
       status.nmi_pending = false;
       regs.vector = (regs.e == false ? 0xffea : 0xfffa);
       op_irq();
+      debugger.op_nmi();
     }
 
     if(status.irq_pending) {
       status.irq_pending = false;
       regs.vector = (regs.e == false ? 0xffee : 0xfffe);
       op_irq();
+      debugger.op_irq();
     }
 
     op_step();
@@ -76,6 +78,16 @@ void CPU::enter() {
 }
 
 alwaysinline void CPU::op_step() {
+  debugger.op_exec(regs.pc.d);
+
+  if (interface()->wanttrace & TRACE_CPU_MASK)
+  {
+    char tmp[512];
+		disassemble_opcode(tmp, regs.pc.d);
+		tmp[511] = 0;
+    interface()->cpuTrace(TRACE_CPU, tmp);
+  }
+
   (this->*opcode_table[op_readpcfirst()])();
 }
 
@@ -104,6 +116,8 @@ void CPU::enable() {
 }
 
 void CPU::power() {
+	for(int i=0;i<128*1024;i++) wram[i] = random(config.cpu.wram_init_value);
+
   regs.a = 0x0000;
   regs.x = 0x0000;
   regs.y = 0x0000;
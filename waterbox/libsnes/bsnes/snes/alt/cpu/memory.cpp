@@ -25,6 +25,8 @@ void CPU::op_io() {
 }
 
 uint8 CPU::op_read(unsigned addr, eCDLog_Flags flags) {
+  debugger.op_read(addr);
+
 	cdlInfo.currFlags = flags;
   regs.mdr = bus.read(addr);
   add_clocks(speed(addr));
@@ -32,6 +34,8 @@ uint8 CPU::op_read(unsigned addr, eCDLog_Flags flags) {
 }
 
 void CPU::op_write(unsigned addr, uint8 data) {
+  debugger.op_write(addr, data);
+
   add_clocks(speed(addr));
   bus.write(addr, regs.mdr = data);
 }
@@ -59,7 +59,8 @@ void CPU::add_clocks(unsigned clocks) {
 }
 
 void CPU::scanline() {
-  synchronize_smp();
+  //the S-SMP already syncs on every $2140-$2143 access, so it is only forced at the frame boundary
+  if(vcounter() == system.stopline()) synchronize_smp();
   synchronize_ppu();
   synchronize_coprocessors();
   system.scanline();
@@ -112,6 +112,9 @@ uint8* PPU::Cache::tile(unsigned bpp, unsigned tile) {
 }
 
 PPU::Cache::Cache(PPU &self) : self(self) {
+}
+
+void PPU::Cache::initialize() {
   tiledata[0] = (uint8*)alloc_invisible(262144);
   tiledata[1] = (uint8*)alloc_invisible(131072);
   tiledata[2] = (uint8*)alloc_invisible(65536);
@@ -120,7 +123,7 @@ PPU::Cache::Cache(PPU &self) : self(self) {
   tilevalid[2] = (uint8*)alloc_invisible(1024);
 }
 
-PPU::Cache::invalidate() {
+void PPU::Cache::invalidate() {
   memset(tilevalid[0], 0, 4096);
   memset(tilevalid[1], 0, 2048);
   memset(tilevalid[2], 0, 1024);
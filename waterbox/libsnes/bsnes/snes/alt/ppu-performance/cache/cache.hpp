@@ -8,6 +8,7 @@ public:
   uint8* tile_8bpp(unsigned tile);
   uint8* tile(unsigned bpp, unsigned tile);
   void invalidate();
+  void initialize();
 
   Cache(PPU &self);
 	~Cache();
@@ -69,6 +69,7 @@ void PPU::scanline() {
   display.width = !hires() ? 256 : 512;
   display.height = !overscan() ? 225 : 240;
   if(vcounter() == 0) frame();
+	interface()->scanlineStart(vcounter());
   if(vcounter() == display.height && regs.display_disable == false) sprite.address_reset();
 }
 
@@ -92,11 +93,12 @@ void PPU::power() {
 	for(int i=0;i<128*1024;i++) vram[i] = 0;
 	for(int i=0;i<544;i++) oam[i] = 0;
 	for(int i=0;i<512;i++) cgram[i] = 0;
+  flush_tiledata_cache();
   reset();
 }
 
 void PPU::reset() {
-  create(Enter, system.cpu_frequency());
+  create(Enter, system.cpu_frequency(), 32768);
   PPUcounter::reset();
   memset(surface, 0, 512 * 512 * sizeof(uint32));
   mmio_reset();
@@ -126,6 +128,11 @@ void PPU::set_frameskip(unsigned frameskip) {
   display.framecounter = 0;
 }
 
+//marks all tiledata cache entries as dirty
+void PPU::flush_tiledata_cache() {
+  cache.invalidate();
+}
+
 PPU::PPU() :
 cache(*this),
 bg1(*this, Background::ID::BG1),
@@ -138,8 +145,6 @@ vram(nullptr),
 oam(nullptr),
 cgram(nullptr)
 {
-  surface = (uint32_t*)alloc_invisible(512 * 512 * sizeof(uint32_t));
-  output = surface + 16 * 512;
   display.width = 256;
   display.height = 224;
   display.frameskip = 0;
@@ -155,6 +160,11 @@ void PPU::initialize()
 	vram = (uint8*)interface()->allocSharedMemory("VRAM",128 * 1024);
   oam = (uint8*)interface()->allocSharedMemory("OAM",544);
   cgram = (uint8*)interface()->allocSharedMemory("CGRAM",512);
+
+  surface = (uint32_t*)alloc_invisible(512 * 512 * sizeof(uint32_t));
+  output = surface + 16 * 512;
+
+  cache.initialize();
 }
 
 }
@@ -22,6 +22,7 @@ public:
 
   void layer_enable(unsigned layer, unsigned priority, bool enable);
   void set_frameskip(unsigned frameskip);
+  void flush_tiledata_cache();
 
   PPU();
   ~PPU();
@@ -36,7 +36,10 @@ uint16 PPU::Screen::addsub(unsigned x, unsigned y, bool halve) {
 }
 
 void PPU::Screen::scanline() {
-  unsigned main_color = get_palette(0);
+  unsigned main_color;
+  int backdropColor = interface()->getBackdropColor();
+  if(backdropColor == -1) main_color = get_palette(0);
+  else main_color = backdropColor;
   unsigned sub_color = (self.regs.pseudo_hires == false && self.regs.bgmode != 5 && self.regs.bgmode != 6)
                      ? regs.color : main_color;
 
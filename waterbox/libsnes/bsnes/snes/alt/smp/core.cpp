@@ -18,6 +18,7 @@ uint8 SMP::op_read(uint16 addr, eCDLog_Flags flags) {
   #if defined(CYCLE_ACCURATE)
   tick();
   #endif
+  debugger.op_read(addr);
   if((addr & 0xfff0) == 0x00f0) return mmio_read(addr);
   if(addr >= 0xffc0 && status.iplrom_enable) return iplrom[addr & 0x3f];
 	cdlInfo.currFlags = flags;
@@ -29,10 +30,22 @@ void SMP::op_write(uint16 addr, uint8 data) {
   #if defined(CYCLE_ACCURATE)
   tick();
   #endif
+  debugger.op_write(addr, data);
   if((addr & 0xfff0) == 0x00f0) mmio_write(addr, data);
   apuram[addr] = data;  //all writes go to RAM, even MMIO writes
 }
 
+void SMP::op_exec_hook() {
+  debugger.op_exec(regs.pc);
+	if(interface()->wanttrace & TRACE_SMP_MASK)
+	{
+		char tmp[512];
+		disassemble_opcode(tmp, regs.pc);
+		tmp[511] = 0;
+		interface()->cpuTrace(TRACE_SMP, tmp);
+	}
+}
+
 void SMP::op_step() {
 	#define op_readpcfirst() op_read(regs.pc++,eCDLog_Flags_ExecFirst)
   #define op_readpc() op_read(regs.pc++,eCDLog_Flags_ExecOperand)
@@ -46,6 +59,7 @@ void SMP::op_step() {
   #if defined(CYCLE_ACCURATE)
 
   if(opcode_cycle == 0) {
+    op_exec_hook();
     opcode_number = op_readpcfirst();
     opcode_cycle++;
   } else switch(opcode_number) {
@@ -58,6 +72,7 @@ void SMP::op_step() {
 
   #else
 
+  op_exec_hook();
   unsigned opcode = op_readpcfirst();
   switch(opcode) {
     #include "core/op_misc.cpp"
@@ -287,8 +287,8 @@ void SMP::disassemble_opcode(char *output, uint16 addr) {
   t[strlen(t)] = ' ';
   strcat(s, t);
 
-  sprintf(t, "A:%.2x X:%.2x Y:%.2x SP:01%.2x YA:%.4x ",
-    regs.a, regs.x, regs.y, regs.sp, (uint16)regs.ya);
+  sprintf(t, "YA:%.4x A:%.2x X:%.2x Y:%.2x SP:01%.2x ",
+    (uint16)regs.ya, regs.a, regs.x, regs.y, regs.sp);
   strcat(s, t);
 
   sprintf(t, "%c%c%c%c%c%c%c%c",
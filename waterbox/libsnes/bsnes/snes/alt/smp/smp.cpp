@@ -12,6 +12,7 @@ SMP smp;
 #include "iplrom.cpp"
 #include "memory.cpp"
 #include "timing.cpp"
+#include "disassembler.cpp"
 
 void SMP::synchronize_cpu() {
   if(CPU::Threaded == true) {
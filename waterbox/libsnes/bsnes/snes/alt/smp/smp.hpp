@@ -22,6 +22,14 @@ public:
 	void initialize();
 
   void disassemble_opcode(char *output, uint16 addr);
+  uint8 disassemble_read(uint16 addr);
+  uint16 relb(int8 offset, int op_len);
+
+  struct Debugger {
+    hook<void (uint16)> op_exec;
+    hook<void (uint16)> op_read;
+    hook<void (uint16, uint8)> op_write;
+  } debugger;
 
 //private:
   struct Flags {
@@ -91,6 +99,7 @@ public:
   alwaysinline void op_io();
   alwaysinline uint8 op_read(uint16 addr, eCDLog_Flags flags);
   alwaysinline void op_write(uint16 addr, uint8 data);
+  alwaysinline void op_exec_hook();
   alwaysinline void op_step();
   static const unsigned cycle_count_table[256];
   uint64 cycle_table_cpu[256];
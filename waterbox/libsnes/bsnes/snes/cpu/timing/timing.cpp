@@ -41,7 +41,8 @@ void CPU::scanline() {
   status.line_clocks = lineclocks();
 
   //forcefully sync S-CPU to other processors, in case chips are not communicating
-  synchronize_smp();
+  //the S-SMP already syncs on every $2140-$2143 access, so it is only forced at the frame boundary
+  if(vcounter() == system.stopline()) synchronize_smp();
   synchronize_ppu();
   synchronize_coprocessors();
   system.scanline();
@@ -238,12 +238,15 @@ void System::scanline() {
    * the new numbers are the minimum possible to still capture a full frame; any lower,
    * and the last scanline(s) of the frame are still from the old frame.
    */
-  int stopline;
+  if(cpu.vcounter() == stopline()) scheduler.exit(Scheduler::ExitReason::FrameEvent);
+}
+
+//the scanline on which scanline() ends the frame
+unsigned System::stopline() {
   if (ppu.overscan()) // (region != Region::NTSC)
-    stopline = 240;
+    return 240;
   else
-    stopline = 225;
-  if(cpu.vcounter() == stopline) scheduler.exit(Scheduler::ExitReason::FrameEvent);
+    return 225;
 }
 
 void System::frame() {
@@ -16,6 +16,7 @@ struct System : property<System> {
 
   void frame();
   void scanline();
+  unsigned stopline();
 
   //return *active* system information (settings are cached upon power-on)
   readonly<Region> region;
@@ -138,9 +138,15 @@ EXPORT void SetControllerData(const uint8_t* controllerData)
 	memcpy(ControllerInput, controllerData, sizeof(ControllerInput));
 }
 
+namespace MDFN_IEN_SS
+{
+extern bool SlaveIdleSkip;
+}
+
 struct MyFrameInfo: public FrameInfo
 {
 	int32_t ResetPushed;
+	int32_t SlaveIdleSkip;
 };
 
 EXPORT void FrameAdvance(MyFrameInfo& f)
@@ -155,7 +161,9 @@ EXPORT void FrameAdvance(MyFrameInfo& f)
 	e.SoundBufMaxSize = 8192;
 	IsResetPushed = f.ResetPushed;
 	InputLagged = true;
+	SlaveIdleSkip = f.SlaveIdleSkip;
 	Emulate(&e);
+	SlaveIdleSkip = false;
 	f.Samples = e.SoundBufSize;
 	f.Cycles = e.MasterCycles;
 	f.Lagged = InputLagged;
@@ -54,6 +54,13 @@ class SH7095 final
  template<unsigned which, bool DebugMode>
  void Step(void);
 
+ //
+ // Idle loop skipping; only used for the slave CPU, see ss.cpp.
+ //
+ uint32 IdleLoop_Check(void);
+ sscpu_timestamp_t IdleLoop_Limit(void);
+ void IdleLoop_Advance(const int32 cycles);
+ void IdleLoop_Reset(void);
 
  //private:
  uint32 R[16];
@@ -352,6 +359,42 @@ class SH7095 final
  uint16 VCRDIV;
  uint8 DVCR;
 
+ //
+ //
+ // Idle loop detection state.  Tainted is set by everything an instruction can do that repeating an iteration in bulk
+ // wouldn't reproduce(external bus accesses, writes, on-chip register reads other than FTCSR); the rest is the CPU
+ // state at the anchor instruction, and the code range executed since.
+ //
+ //
+ enum { IdleLoop_MaxSteps = 16 };
+ enum { IdleLoop_MaxCodeSize = 0x100 };
+ enum { IdleLoop_TSCount = 6 };
+
+ struct
+ {
+  bool Tainted;
+  uint8 Moving;	// Which of TS[] advanced by one period per iteration(bit 0 is always timestamp).
+  uint32 Steps;
+  uint32 PCMin;
+  uint32 PCMax;
+
+  uint32 R[16];
+  uint32 PC;
+  uint32 CtrlRegs[3];
+  uint32 SysRegs[3];
+  uint32 Pipe_ID;
+  uint32 Pipe_IF;
+  uint32 IBuffer;
+  bool Standby;
+  uint8 FTCSR;
+  uint8 FTCSRM;
+  uint8 LRU[64];
+  sscpu_timestamp_t TS[IdleLoop_TSCount];
+ } IdleLoop;
+
+ void IdleLoop_Snapshot(void);
+ bool IdleLoop_Compare(const int32 period);
+
 #if 0
  struct
  {
@@ -95,6 +95,28 @@ static T INLINE SH7095_BusRead(uint32 A, const bool BurstHax, int32 *SH2DMAHax);
 static int32 ExtBusCounter[2];
 static size_t ExtBusWhich;
 
+//
+// Slave SH-2 idle loop skipping(opt-in, set for the duration of a frame by the frontend).
+//
+// Once the slave is found spinning in a loop that doesn't touch the bus(see SH7095::IdleLoop_Check()), its timestamp is moved
+// ahead by as many iterations as fit before the next event, but the rest of its state is only brought up to date(by whole
+// iterations) when the master catches up.  Anything the loop could observe that happens first(an event, a write by the master
+// to anything but work RAM, or to the loop's own code) rewinds it to where stepping it instruction by instruction would
+// have it at that point, so the results are the same either way.
+//
+bool SlaveIdleSkip;
+
+static struct
+{
+	bool Active;
+	sscpu_timestamp_t BaseTS; // Slave timestamp at the anchor the skip started from.
+	int32 Period;
+	int32 Iterations;
+	sscpu_timestamp_t SyncTS; // Master timestamp before its current instruction.
+} SlaveIdle;
+
+static void SlaveIdle_CheckWrite(uint32 A);
+
 // SH-2 region
 //  0: 0x00000000-0x01FFFFFF
 //  1: 0x02000000-0x03FFFFFF
@@ -327,6 +349,9 @@ static INLINE void BusRW(uint32 A, T &V, const bool BurstHax, int32 *SH2DMAHax)
 template <typename T>
 static void INLINE SH7095_BusWrite(uint32 A, T V, const bool BurstHax, int32 *SH2DMAHax)
 {
+	if (MDFN_UNLIKELY(SlaveIdleSkip))
+		SlaveIdle_CheckWrite(A);
+
 	BusRW<T, true>(A, V, BurstHax, SH2DMAHax);
 }
 
@@ -604,8 +629,87 @@ static INLINE bool EventHandler(const sscpu_timestamp_t timestamp)
 	return (Running);
 }
 
+//
+// Brings a skipping slave to the last anchor before "timestamp", or to the final one.
+//
+static void SlaveIdle_Resolve(const sscpu_timestamp_t timestamp)
+{
+	int32 iterations = 0;
+
+	if (timestamp > SlaveIdle.BaseTS)
+		iterations = std::min<int32>(SlaveIdle.Iterations, (timestamp - SlaveIdle.BaseTS - 1) / SlaveIdle.Period);
+
+	SlaveIdle.Active = false;
+	CPU[1].timestamp = SlaveIdle.BaseTS;
+	CPU[1].IdleLoop_Advance(iterations * SlaveIdle.Period);
+}
+
+//
+// Called before anything the slave's idle loop might observe; "timestamp" is the master's as of the last time the slave caught up with it.
+//
+static void NO_INLINE SlaveIdle_Sync(const sscpu_timestamp_t timestamp)
+{
+	CPU[1].IdleLoop.Tainted = true;
+
+	if (!SlaveIdle.Active)
+		return;
+
+	SlaveIdle_Resolve(timestamp);
+
+	// Finish the partial iteration; nothing it does is visible outside of the slave, so it doesn't matter that the master may be in the middle of an instruction.
+	while (CPU[1].timestamp < timestamp)
+		CPU[1].Step<1, false>();
+}
+
+static void NO_INLINE SlaveIdle_CheckWrite(uint32 A)
+{
+	A &= (1U << 27) - 1;
+
+	// Work RAM is only seen by the loop through its code, anything else might raise an interrupt on the slave or such.
+	if ((A >= 0x06000000 && A <= 0x07FFFFFF) || (A >= 0x00200000 && A <= 0x003FFFFF))
+	{
+		const uint32 PCMin = CPU[1].IdleLoop.PCMin;
+		const uintptr_t wa = SH7095_FastMap[A >> SH7095_EXT_MAP_GRAN_BITS] + A;
+		const uintptr_t lo = SH7095_FastMap[PCMin >> SH7095_EXT_MAP_GRAN_BITS] + PCMin - 8;
+		const uintptr_t hi = lo + (CPU[1].IdleLoop.PCMax - PCMin) + 16;
+
+		if (wa < lo || wa >= hi)
+			return;
+	}
+
+	SlaveIdle_Sync(SlaveIdle.SyncTS);
+}
+
+static INLINE void SlaveIdle_Start(void)
+{
+	const int32 period = CPU[1].IdleLoop_Check();
+
+	if (!period)
+		return;
+
+	const sscpu_timestamp_t limit = std::min<sscpu_timestamp_t>(next_event_ts, CPU[1].IdleLoop_Limit());
+	const int32 iterations = (limit - CPU[1].timestamp) / period;
+
+	if (iterations <= 0)
+		return;
+
+	SlaveIdle.BaseTS = CPU[1].timestamp;
+	SlaveIdle.Period = period;
+	SlaveIdle.Iterations = iterations;
+
+	CPU[1].timestamp += iterations * period;
+
+	if (CPU[1].timestamp < CPU[0].timestamp)
+		SlaveIdle_Resolve(CPU[0].timestamp);
+	else
+		SlaveIdle.Active = true;
+}
+
 static void NO_INLINE MDFN_HOT CheckEventsByMemTS_Sub(void)
 {
+	if (MDFN_UNLIKELY(SlaveIdleSkip))
+		SlaveIdle_Sync(SlaveIdle.SyncTS);
+
 	EventHandler(SH7095_mem_timestamp);
 }
 
@@ -648,18 +752,27 @@ static int32 NO_INLINE MDFN_HOT RunLoop(EmulateSpecStruct *espec)
 			if (DebugMode)
 				DBG_CPUHandler<0>(eff_ts);
 
+			if (MDFN_UNLIKELY(SlaveIdle.Active))
+				SlaveIdle.SyncTS = CPU[0].timestamp;
+
 			CPU[0].Step<0, DebugMode>();
 
 			if (CPU[0].DMA_RunCond(0) || CPU[0].DMA_RunCond(1))
 				CPU[0].timestamp += ExtBusCounter[0] * 16;
 
 			ExtBusWhich = 1;
+			if (MDFN_UNLIKELY(SlaveIdle.Active) && CPU[0].timestamp > CPU[1].timestamp)
+				SlaveIdle_Resolve(CPU[0].timestamp);
+
 			while (MDFN_LIKELY(CPU[0].timestamp > CPU[1].timestamp))
 			{
 				if (DebugMode)
 					DBG_CPUHandler<1>(eff_ts);
 
 				CPU[1].Step<1, DebugMode>();
+
+				if (!DebugMode && MDFN_UNLIKELY(SlaveIdleSkip))
+					SlaveIdle_Start();
 			}
 
 			eff_ts = CPU[0].timestamp;
@@ -668,6 +781,9 @@ static int32 NO_INLINE MDFN_HOT RunLoop(EmulateSpecStruct *espec)
 			else
 				SH7095_mem_timestamp = eff_ts;
 		} while (MDFN_LIKELY(eff_ts < next_event_ts));
+
+		if (MDFN_UNLIKELY(SlaveIdleSkip))
+			SlaveIdle_Sync(CPU[0].timestamp);
 	} while (MDFN_LIKELY(EventHandler(eff_ts)));
 
 	//printf(" End: %d %d -- %d\n", SH7095_mem_timestamp, CPU[0].timestamp, eff_ts);
@@ -751,7 +867,13 @@ void Emulate(EmulateSpecStruct *espec_arg)
 #endif
 		end_ts = RunLoop<false>(espec);
 
+	// Leave nothing behind that would make save states differ depending on whether idle loops were skipped.
+	CPU[0].IdleLoop_Reset();
+	CPU[1].IdleLoop_Reset();
+	memset(&SlaveIdle, 0, sizeof(SlaveIdle));
+
 	ForceEventUpdates(end_ts);
+	VDP1::EndFrame();
 	//
 	//
 	//
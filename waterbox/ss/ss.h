@@ -132,6 +132,15 @@ namespace MDFN_IEN_SS
  extern event_list_entry events[SS_EVENT__COUNT];
 
  #define SS_EVENT_DISABLED_TS			0x40000000
+
+ // Which emulibc worker thread does what; the host may provide fewer of them, in which case the work is done inline.
+ enum
+ {
+  SS_WORKER_VDP2REND = 0,	// See VDP2REND_StartFrame()
+
+  SS_WORKER_VDP1DRAW,		// First of SS_WORKER_VDP1DRAW_COUNT, see DrawQueue in vdp1.cpp
+  SS_WORKER_VDP1DRAW_COUNT = 3
+ };
  void SS_SetEventNT(event_list_entry* e, const sscpu_timestamp_t next_timestamp);
 
  // Call from init code, or power/reset code, as appropriate.
@@ -37,6 +37,9 @@
 #include "vdp2.h"
 #include "vdp1_common.h"
 
+#include <array>
+#include <atomic>
+
 enum { VDP1_UpdateTimingGran = 263 };
 enum { VDP1_IdleTimingGran = 1019 };
 
@@ -46,8 +49,8 @@ namespace VDP1
 {
 
 uint8 spr_w_shift_tab[8];
-line_data LineSetup;
 uint8 gouraud_lut[0x40];
+static draw_context DrawCtx;
 
 uint16 VRAM[0x40000];
 uint16 FB[2][0x20000];
@@ -126,10 +129,15 @@ void Init(void)
  hb_status = false;
  lastts = 0;
  FBVBEraseLastTS = 0;
+
+ DrawCtx.BandMask = ~0U;
+ DrawCtx.SkipLines = false;
 }
 
 void Reset(bool powering_up)
 {
+ EndFrame();
+
  if(powering_up)
  {
   for(unsigned i = 0; i < 0x40000; i++)
@@ -150,7 +158,7 @@ void Reset(bool powering_up)
    for(unsigned i = 0; i < 0x20000; i++)
     FB[fb][i] = 0xFFFF;
 
-  memset(&LineSetup, 0, sizeof(LineSetup));
+  memset(&DrawCtx.LineSetup, 0, sizeof(DrawCtx.LineSetup));
 
   //
   //
@@ -195,7 +203,7 @@ void Reset(bool powering_up)
  CycleCounter = 0;
 }
 
-static int32 CMD_SetUserClip(const uint16* cmd_data)
+static int32 CMD_SetUserClip(draw_context* ctx, const uint16* cmd_data)
 {
  UserClipX0 = cmd_data[0x6] & 0x3FF;
  UserClipY0 = cmd_data[0x7] & 0x1FF;
@@ -206,7 +214,7 @@ static int32 CMD_SetUserClip(const uint16* cmd_data)
  return 0;
 }
 
-int32 CMD_SetSystemClip(const uint16* cmd_data)
+static int32 CMD_SetSystemClip(draw_context* ctx, const uint16* cmd_data)
 {
  SysClipX = cmd_data[0xA] & 0x3FF;
  SysClipY = cmd_data[0xB] & 0x1FF;
@@ -214,7 +222,7 @@ int32 CMD_SetSystemClip(const uint16* cmd_data)
  return 0;
 }
 
-int32 CMD_SetLocalCoord(const uint16* cmd_data)
+static int32 CMD_SetLocalCoord(draw_context* ctx, const uint16* cmd_data)
 {
  LocalX = sign_x_to_s32(11, cmd_data[0x6] & 0x7FF);
  LocalY = sign_x_to_s32(11, cmd_data[0x7] & 0x7FF);
@@ -223,9 +231,9 @@ int32 CMD_SetLocalCoord(const uint16* cmd_data)
 }
 
 template<unsigned ECDSPDMode>
-static uint32 MDFN_FASTCALL TexFetch(uint32 x)
+static uint32 MDFN_FASTCALL TexFetch(line_data* ls, uint32 x)
 {
- const uint32 base = LineSetup.tex_base;
+ const uint32 base = ls->tex_base;
  const bool ECD = ECDSPDMode & 0x10;
  const bool SPD = ECDSPDMode & 0x08;
  const unsigned ColorMode = ECDSPDMode & 0x07;
@@ -240,10 +248,10 @@ static uint32 MDFN_FASTCALL TexFetch(uint32 x)
 
 	if(!ECD && rtd == 0xF)
 	{
-	 LineSetup.ec_count--;	
+	 ls->ec_count--;	
 	 return -1;
 	}
-	ret_or = LineSetup.cb_or;
+	ret_or = ls->cb_or;
 	
 	if(!SPD) ret_or |= (int32)(rtd - 1) >> 31;
 
@@ -254,24 +262,24 @@ static uint32 MDFN_FASTCALL TexFetch(uint32 x)
 
 	if(!ECD && rtd == 0xF)
 	{
-	 LineSetup.ec_count--;
+	 ls->ec_count--;
 	 return -1;
 	}
 
 	if(!SPD) ret_or |= (int32)(rtd - 1) >> 31;
 
-	return LineSetup.CLUT[rtd] | ret_or;
+	return ls->CLUT[rtd] | ret_or;
 
   case 2:	// 64 colors, color bank
 	rtd = (VRAM[(base + (x >> 1)) & 0x3FFFF] >> (((x & 0x1) ^ 0x1) << 3)) & 0xFF;
 
 	if(!ECD && rtd == 0xFF)
 	{
-	 LineSetup.ec_count--;
+	 ls->ec_count--;
 	 return -1;
 	}
 
-	ret_or = LineSetup.cb_or;
+	ret_or = ls->cb_or;
 
 	if(!SPD) ret_or |= (int32)(rtd - 1) >> 31;
 
@@ -282,11 +290,11 @@ static uint32 MDFN_FASTCALL TexFetch(uint32 x)
 
 	if(!ECD && rtd == 0xFF)
 	{
-	 LineSetup.ec_count--;
+	 ls->ec_count--;
 	 return -1;
 	}
 
-	ret_or = LineSetup.cb_or;
+	ret_or = ls->cb_or;
 
 	if(!SPD) ret_or |= (int32)(rtd - 1) >> 31;
 
@@ -297,11 +305,11 @@ static uint32 MDFN_FASTCALL TexFetch(uint32 x)
 
 	if(!ECD && rtd == 0xFF)
 	{
-	 LineSetup.ec_count--;
+	 ls->ec_count--;
 	 return -1;
 	}
 
-	ret_or = LineSetup.cb_or;
+	ret_or = ls->cb_or;
 
 	if(!SPD) ret_or |= (int32)(rtd - 1) >> 31;
 
@@ -317,7 +325,7 @@ static uint32 MDFN_FASTCALL TexFetch(uint32 x)
 
 	if(!ECD && (rtd & 0xC000) == 0x4000)
 	{
-	 LineSetup.ec_count--;
+	 ls->ec_count--;
 	 return -1;
 	}
 
@@ -328,7 +336,7 @@ static uint32 MDFN_FASTCALL TexFetch(uint32 x)
 }
 
 
-extern uint32 (MDFN_FASTCALL *const TexFetchTab[0x20])(uint32 x) =
+extern uint32 (MDFN_FASTCALL *const TexFetchTab[0x20])(line_data* ls, uint32 x) =
 {
  #define TF(a) (TexFetch<a>)
 
@@ -347,6 +355,277 @@ extern uint32 (MDFN_FASTCALL *const TexFetchTab[0x20])(uint32 x) =
  #undef TF
 };
 
+static int32 (*const CommandTab[0xC])(draw_context* ctx, const uint16* cmd_data) =
+{
+ /* 0x0 */         /* 0x1 */         /* 0x2 */            /* 0x3 */
+ CMD_NormalSprite, CMD_ScaledSprite, CMD_DistortedSprite, CMD_DistortedSprite,
+
+ /* 0x4 */    /* 0x5 */     /* 0x6 */ /* 0x7 */
+ CMD_Polygon, CMD_Polyline, CMD_Line, CMD_Polyline,
+
+ /* 0x8*/         /* 0x9 */           /* 0xA */          /* 0xB */
+ CMD_SetUserClip, CMD_SetSystemClip,  CMD_SetLocalCoord, CMD_SetUserClip
+};
+
+/*
+ DrawQueue:
+	Drawing commands still run on the emulation thread as they're fetched, since their cycle counts decide
+	when later commands and the CPU see VDP1 state, but the framebuffer rows are split into bands of 8 and
+	dealt out between that thread and the SS_WORKER_VDP1DRAW workers.  Lines that miss the emulation thread's
+	own bands are only stepped through there for their cycle counts(CostOnly in DrawLine()), without plotting,
+	gouraud shading, or fetching texels other than for end codes.
+
+	Each worker gets every drawing command along with a copy of the registers it was drawn with, and keeps its
+	own line setup state(CLUT, etc.) by running the commands in the same order, only skipping lines that can't
+	touch its bands.
+
+	Pixels never depend on other rows, so the result is the same as drawing everything on one thread.  The
+	queue is waited on(DrawSync()) before anything else touches the framebuffer being drawn to, or before
+	VRAM that a queued command reads from gets overwritten(DQ_PendingPages, in 256-word pages).
+*/
+struct DQ_Entry
+{
+ uint16 cmd_data[0x10];
+ draw_regs r;
+};
+
+static std::array<DQ_Entry, 0x200> DQ;
+static std::atomic_uint_least32_t DQ_WritePos;
+static uint64 DQ_PendingPages[0x40000 / 256 / 64];
+
+static draw_context DrawWorkerCtx[SS_WORKER_VDP1DRAW_COUNT];
+static std::atomic_uint_least32_t DrawWorkerReadPos[SS_WORKER_VDP1DRAW_COUNT];
+static std::atomic_bool DrawWorkerSleeping[SS_WORKER_VDP1DRAW_COUNT];
+static unsigned DrawWorkerCount;
+static bool DrawWorkersTried;
+
+static void DrawWorkerEntry(void* arg)
+{
+ const unsigned w = (uintptr_t)arg;
+ draw_context& ctx = DrawWorkerCtx[w];
+ uint32 rp = DrawWorkerReadPos[w].load(std::memory_order_relaxed);
+
+ for(;;)
+ {
+  unsigned spin = 0;
+
+  while((uint32)DQ_WritePos.load(std::memory_order_acquire) == rp)
+  {
+   if(++spin < 1024)
+    continue;
+
+   DrawWorkerSleeping[w].store(true);
+   if((uint32)DQ_WritePos.load() == rp)
+    worker_wait(SS_WORKER_VDP1DRAW + w);
+   DrawWorkerSleeping[w].store(false, std::memory_order_relaxed);
+   spin = 0;
+  }
+
+  const DQ_Entry& e = DQ[rp % DQ.size()];
+
+  if(e.cmd_data[0] & 0x8000)	// See EndFrame()
+   return;
+
+  ctx.r = e.r;
+  CommandTab[e.cmd_data[0] & 0x7](&ctx, e.cmd_data);
+
+  rp++;
+  DrawWorkerReadPos[w].store(rp, std::memory_order_release);
+ }
+}
+
+static void DQ_Push(const uint16* cmd_data)
+{
+ const uint32 wp = DQ_WritePos.load(std::memory_order_relaxed);
+
+ for(unsigned w = 0; w < DrawWorkerCount; w++)
+ {
+  while((wp - (uint32)DrawWorkerReadPos[w].load(std::memory_order_acquire)) >= DQ.size())
+  {
+   if(DrawWorkerSleeping[w].load())
+    worker_signal(SS_WORKER_VDP1DRAW + w);
+  }
+ }
+
+ DQ_Entry& e = DQ[wp % DQ.size()];
+
+ memcpy(e.cmd_data, cmd_data, sizeof(e.cmd_data));
+ e.r = DrawCtx.r;
+ DQ_WritePos.store(wp + 1);
+
+ for(unsigned w = 0; w < DrawWorkerCount; w++)
+ {
+  if(DrawWorkerSleeping[w].load())
+   worker_signal(SS_WORKER_VDP1DRAW + w);
+ }
+}
+
+static NO_INLINE void DrawSync_Sub(void)
+{
+ const uint32 wp = DQ_WritePos.load(std::memory_order_relaxed);
+
+ for(unsigned w = 0; w < DrawWorkerCount; w++)
+ {
+  while((uint32)DrawWorkerReadPos[w].load(std::memory_order_acquire) != wp)
+  {
+   if(DrawWorkerSleeping[w].load())
+    worker_signal(SS_WORKER_VDP1DRAW + w);
+  }
+ }
+
+ memset(DQ_PendingPages, 0, sizeof(DQ_PendingPages));
+}
+
+static INLINE void DrawSync(void)
+{
+ if(DrawWorkerCount)
+  DrawSync_Sub();
+}
+
+// word_addr is a VRAM word address about to be written.
+static INLINE void DrawSyncVRAM(const uint32 word_addr)
+{
+ if(MDFN_UNLIKELY((DQ_PendingPages[(word_addr >> 14) & 0xF] >> ((word_addr >> 8) & 0x3F)) & 1))
+  DrawSync_Sub();
+}
+
+static void DQ_MarkRange(uint32 word_addr, uint32 count)
+{
+ uint32 page = (word_addr >> 8) & 0x3FF;
+ uint32 page_count = std::min<uint32>(0x400, (((word_addr & 0xFF) + count + 0xFF) >> 8));
+
+ while(page_count--)
+ {
+  DQ_PendingPages[page >> 6] |= (uint64)1 << (page & 0x3F);
+  page = (page + 1) & 0x3FF;
+ }
+}
+
+// Marks the VRAM the drawing command can read from, besides the command table itself.
+static void DQ_MarkReads(const uint16* cmd_data)
+{
+ const unsigned cc = cmd_data[0] & 0xF;
+ const uint16 mode = cmd_data[0x2];
+ const unsigned cm = (mode >> 3) & 0x7;
+
+ if(mode & 0x4)	// Gouraud shading table
+  DQ_MarkRange(cmd_data[0xE] << 2, 4);
+
+ if(cc < 4)
+ {
+  const uint32 w = ((cmd_data[0x5] >> 8) & 0x3F) << 3;
+  const uint32 h = cmd_data[0x5] & 0xFF;
+
+  if(cm == 1)	// Color lookup table
+   DQ_MarkRange((cmd_data[0x3] &~ 0x3) << 2, 0x10);
+
+  if(cm >= 6)
+   DQ_MarkRange(0, 1);
+  else
+  {
+   const uint32 tex_base = (cmd_data[0x4] << 2) &~ (cm == 5 ? 0x7 : 0x0);
+
+   DQ_MarkRange(tex_base, std::max<uint32>(1, (w >> spr_w_shift_tab[cm]) * std::max<uint32>(1, h)));
+  }
+ }
+ else if(cm < 6)	// Untextured commands' SPD check still fetches through the texel path
+  DQ_MarkRange(0x3FFFF, 1);
+}
+
+static void DrawWorkersStart(void)
+{
+ DrawWorkersTried = true;
+
+ for(unsigned w = 0; w < SS_WORKER_VDP1DRAW_COUNT; w++)
+ {
+  draw_context& ctx = DrawWorkerCtx[w];
+
+  ctx.LineSetup = DrawCtx.LineSetup;
+  ctx.SkipLines = true;
+  DrawWorkerReadPos[w].store(DQ_WritePos.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  DrawWorkerSleeping[w].store(false, std::memory_order_relaxed);
+
+  if(!worker_start(SS_WORKER_VDP1DRAW + w, DrawWorkerEntry, (void*)(uintptr_t)w))
+   break;
+
+  DrawWorkerCount++;
+ }
+
+ //
+ // Deal out the bands, the emulation thread included(as member 0, though it still steps through the lines
+ // in the other bands for their cycle counts).
+ //
+ for(unsigned m = 0; m <= DrawWorkerCount; m++)
+ {
+  draw_context& ctx = m ? DrawWorkerCtx[m - 1] : DrawCtx;
+
+  ctx.BandMask = 0;
+  for(unsigned b = 0; b < 32; b++)
+  {
+   if((b % (DrawWorkerCount + 1)) == m)
+    ctx.BandMask |= 1U << b;
+  }
+ }
+}
+
+static INLINE void DrawPrepare(const uint16* cmd_data)
+{
+ draw_regs& r = DrawCtx.r;
+
+ r.FB = FB[FBDrawWhich];
+ r.FBCR = FBCR;
+ r.TVMR = TVMR;
+ r.SysClipX = SysClipX;
+ r.SysClipY = SysClipY;
+ r.UserClipX0 = UserClipX0;
+ r.UserClipY0 = UserClipY0;
+ r.UserClipX1 = UserClipX1;
+ r.UserClipY1 = UserClipY1;
+ r.LocalX = LocalX;
+ r.LocalY = LocalY;
+
+ if(MDFN_UNLIKELY(!DrawWorkersTried))
+  DrawWorkersStart();
+
+ if(DrawWorkerCount)
+ {
+  DQ_MarkReads(cmd_data);
+  DQ_Push(cmd_data);
+ }
+}
+
+//
+// Stops the workers at the end of each emulated frame, so nothing is in flight across savestates and the
+// like; they're started again by the next drawing command.
+//
+void EndFrame(void)
+{
+ if(DrawWorkerCount)
+ {
+  uint16 cmd_data[0x10] = { 0x8000 };
+
+  DQ_Push(cmd_data);
+
+  for(unsigned w = 0; w < DrawWorkerCount; w++)
+   worker_join(SS_WORKER_VDP1DRAW + w);
+
+  DrawWorkerCount = 0;
+  DQ_WritePos.store(0, std::memory_order_relaxed);
+  for(unsigned w = 0; w < SS_WORKER_VDP1DRAW_COUNT; w++)
+  {
+   DrawWorkerReadPos[w].store(0, std::memory_order_relaxed);
+   DrawWorkerSleeping[w].store(false, std::memory_order_relaxed);
+  }
+  memset(&DQ, 0, sizeof(DQ));
+  memset(DrawWorkerCtx, 0, sizeof(DrawWorkerCtx));
+  memset(DQ_PendingPages, 0, sizeof(DQ_PendingPages));
+
+  DrawCtx.BandMask = ~0U;
+ }
+
+ DrawWorkersTried = false;
+}
+
 
 
 /*
@@ -410,19 +689,10 @@ sscpu_timestamp_t Update(sscpu_timestamp_t timestamp)
     }
     else
     {
-     static int32 (*const command_table[0xC])(const uint16* cmd_data) =
-     {
-      /* 0x0 */         /* 0x1 */         /* 0x2 */            /* 0x3 */
-      CMD_NormalSprite, CMD_ScaledSprite, CMD_DistortedSprite, CMD_DistortedSprite,
-
-      /* 0x4 */    /* 0x5 */     /* 0x6 */ /* 0x7 */
-      CMD_Polygon, CMD_Polyline, CMD_Line, CMD_Polyline,
-
-      /* 0x8*/         /* 0x9 */           /* 0xA */          /* 0xB */
-      CMD_SetUserClip, CMD_SetSystemClip,  CMD_SetLocalCoord, CMD_SetUserClip
-     };
+     if(cc < 0x8)
+      DrawPrepare(cmd_data);
 
-     CycleCounter -= command_table[cc](cmd_data);
+     CycleCounter -= CommandTab[cc](&DrawCtx, cmd_data);
     }
    }
    else if(MDFN_UNLIKELY(cmd_data[0] & 0x8000))
@@ -571,6 +841,7 @@ void SetHBVB(const sscpu_timestamp_t event_timestamp, const bool new_hb_status,
      DrawingActive = false;
     }
 
+    DrawSync();
     FBDrawWhich = !FBDrawWhich;
 
     SS_DBGTI(SS_DBG_VDP1, "[VDP1] Displayed framebuffer changed to %d.", !FBDrawWhich);
@@ -800,6 +1071,7 @@ void Write8_DB(uint32 A, uint16 DB)
 
  if(A < 0x80000)
  {
+  DrawSyncVRAM(A >> 1);
   ne16_wbo_be<uint8>(VRAM, A, DB >> (((A & 1) ^ 1) << 3) );
   return;
  }
@@ -808,6 +1080,8 @@ void Write8_DB(uint32 A, uint16 DB)
  {
   uint32 FBA = A;
 
+  DrawSync();
+
   if((TVMR & (TVMR_8BPP | TVMR_ROTATE)) == (TVMR_8BPP | TVMR_ROTATE))
    FBA = (FBA & 0x1FF) | ((FBA << 1) & 0x3FC00) | ((FBA >> 8) & 0x200);
 
@@ -825,6 +1099,7 @@ void Write16_DB(uint32 A, uint16 DB)
 
  if(A < 0x80000)
  {
+  DrawSyncVRAM(A >> 1);
   VRAM[A >> 1] = DB;
   return;
  }
@@ -833,6 +1108,8 @@ void Write16_DB(uint32 A, uint16 DB)
  {
   uint32 FBA = A;
 
+  DrawSync();
+
   if((TVMR & (TVMR_8BPP | TVMR_ROTATE)) == (TVMR_8BPP | TVMR_ROTATE))
    FBA = (FBA & 0x1FF) | ((FBA << 1) & 0x3FC00) | ((FBA >> 8) & 0x200);
 
@@ -854,6 +1131,8 @@ uint16 Read16_DB(uint32 A)
  {
   uint32 FBA = A;
 
+  DrawSync();
+
   if((TVMR & (TVMR_8BPP | TVMR_ROTATE)) == (TVMR_8BPP | TVMR_ROTATE))
    FBA = (FBA & 0x1FF) | ((FBA << 1) & 0x3FC00) | ((FBA >> 8) & 0x200);
 
@@ -871,6 +1150,7 @@ uint8 PeekVRAM(const uint32 addr)
 
 void PokeVRAM(const uint32 addr, const uint8 val)
 {
+ DrawSyncVRAM((addr & 0x7FFFF) >> 1);
  ne16_wbo_be<uint8>(VRAM, addr & 0x7FFFF, val);
 }
 
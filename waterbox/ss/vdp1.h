@@ -34,6 +34,7 @@ void Reset(bool powering_up) MDFN_COLD;
 
 sscpu_timestamp_t Update(sscpu_timestamp_t timestamp);
 void AdjustTS(const int32 delta);
+void EndFrame(void);
 
 void Write8_DB(uint32 A, uint16 DB) MDFN_HOT;
 void Write16_DB(uint32 A, uint16 DB) MDFN_HOT;
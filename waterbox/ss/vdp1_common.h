@@ -30,36 +30,31 @@ namespace MDFN_IEN_SS
 namespace VDP1
 {
 
-int32 CMD_NormalSprite(const uint16*);
-int32 CMD_ScaledSprite(const uint16*);
-int32 CMD_DistortedSprite(const uint16*);
+struct line_data;
+struct draw_context;
 
-int32 CMD_Polygon(const uint16*);
-int32 CMD_Polyline(const uint16*);
-int32 CMD_Line(const uint16*);
+int32 CMD_NormalSprite(draw_context*, const uint16*);
+int32 CMD_ScaledSprite(draw_context*, const uint16*);
+int32 CMD_DistortedSprite(draw_context*, const uint16*);
 
-extern uint16 VRAM[0x40000];
-extern uint16 FB[2][0x20000];
-extern bool FBDrawWhich;
+int32 CMD_Polygon(draw_context*, const uint16*);
+int32 CMD_Polyline(draw_context*, const uint16*);
+int32 CMD_Line(draw_context*, const uint16*);
 
-extern int32 SysClipX, SysClipY;
-extern int32 UserClipX0, UserClipY0, UserClipX1, UserClipY1;
-extern int32 LocalX, LocalY;
+extern uint16 VRAM[0x40000];
 
-extern uint32 (MDFN_FASTCALL *const TexFetchTab[0x20])(uint32 x);
+extern uint32 (MDFN_FASTCALL *const TexFetchTab[0x20])(line_data* ls, uint32 x);
 
 enum { TVMR_8BPP   = 0x1 };
 enum { TVMR_ROTATE = 0x2 };
 enum { TVMR_HDTV   = 0x4 };
 enum { TVMR_VBE    = 0x8 };
-extern uint8 TVMR;
 
 enum { FBCR_FCT	   = 0x01 };	// Frame buffer change trigger
 enum { FBCR_FCM	   = 0x02 };	// Frame buffer change mode
 enum { FBCR_DIL	   = 0x04 };	// Double interlace draw line(0=even, 1=odd) (does it affect drawing to FB RAM or reading from FB RAM to VDP2?)
 enum { FBCR_DIE	   = 0x08 };	// Double interlace enable
 enum { FBCR_EOS	   = 0x10 };	// Even/Odd coordinate select(0=even, 1=odd, used with HSS)
-extern uint8 FBCR;
 
 extern uint8 spr_w_shift_tab[8];
 extern uint8 gouraud_lut[0x40];
@@ -199,25 +194,67 @@ struct VileTex
  int32 error_adj;
 };
 
+//
+//
+struct line_vertex
+{
+ int32 x, y;
+ uint16 g;
+ int32 t;
+};
+
+struct line_data
+{
+ line_vertex p[2];
+ bool PCD;
+ bool HSS;
+ uint16 color;
+ int32 ec_count;
+ uint32 (MDFN_FASTCALL *tffn)(line_data*, uint32);
+ uint16 CLUT[0x10];
+ uint32 cb_or;
+ uint32 tex_base;
+};
+
+//
+// What drawing reads from the VDP1 state, besides VRAM.  The registers are copied for each command, so that commands can
+// be drawn away from the emulation thread too(see DrawQueue in vdp1.cpp).
+//
+struct draw_regs
+{
+ uint16* FB;	// Framebuffer being drawn to
+ uint8 FBCR;
+ uint8 TVMR;
+ int32 SysClipX, SysClipY;
+ int32 UserClipX0, UserClipY0, UserClipX1, UserClipY1;
+ int32 LocalX, LocalY;
+};
+
+struct draw_context
+{
+ line_data LineSetup;
+ draw_regs r;
+
+ uint32 BandMask;	// Framebuffer rows drawn to, one bit for each band of 8 rows(after double interlace halving).
+ bool SkipLines;	// Skip lines that can't reach a row in BandMask, rather than counting their cycles; the counts returned are then meaningless.
+};
+
 //
 //
 //
 template<bool die, unsigned bpp8, bool MSBOn, bool UserClipEn, bool UserClipMode, bool MeshEn, bool HalfFGEn, bool HalfBGEn>
-static INLINE int32 PlotPixel(int32 x, int32 y, uint16 pix, bool transparent, GourauderTheTerrible* g)
+static INLINE int32 PlotPixel(const draw_context* ctx, int32 x, int32 y, uint16 pix, bool transparent, GourauderTheTerrible* g)
 {
  static_assert(!MSBOn || (!HalfFGEn && !HalfBGEn), "Table error; sub-optimal template arguments.");
  int32 ret = 0;
- uint16* fbyptr;
+ const unsigned row = (die ? (y >> 1) : y) & 0xFF;
+ uint16* const fbyptr = &ctx->r.FB[row << 9];
+
+ if(!((ctx->BandMask >> (row >> 3)) & 1))
+  return (MSBOn || HalfBGEn) ? 6 : 1;
 
  if(die)
- {
-  fbyptr = &FB[FBDrawWhich][((y >> 1) & 0xFF) << 9];
-  transparent |= ((y & 1) != (bool)(FBCR & FBCR_DIL));
- }
- else
- {
-  fbyptr = &FB[FBDrawWhich][(y & 0xFF) << 9];
- }
+  transparent |= ((y & 1) != (bool)(ctx->r.FBCR & FBCR_DIL));
 
  if(MeshEn)
   transparent |= (x ^ y) & 1;
@@ -312,47 +349,65 @@ static INLINE int32 PlotPixel(int32 x, int32 y, uint16 pix, bool transparent, Go
 }
 
 
-static INLINE void CheckUndefClipping(void)
+static INLINE void CheckUndefClipping(const draw_regs& r)
 {
- if(SysClipX < UserClipX1 || SysClipY < UserClipY1 || UserClipX0 > UserClipX1 || UserClipY0 > UserClipY1)
+ if(r.SysClipX < r.UserClipX1 || r.SysClipY < r.UserClipY1 || r.UserClipX0 > r.UserClipX1 || r.UserClipY0 > r.UserClipY1)
  {
-  //SS_DBG(SS_DBG_WARNING, "[VDP1] Illegal clipping windows; Sys=%u:%u -- User=%u:%u - %u:%u\n", SysClipX, SysClipY, UserClipX0, UserClipY0, UserClipX1, UserClipY1);
+  //SS_DBG(SS_DBG_WARNING, "[VDP1] Illegal clipping windows; Sys=%u:%u -- User=%u:%u - %u:%u\n", r.SysClipX, r.SysClipY, r.UserClipX0, r.UserClipY0, r.UserClipX1, r.UserClipY1);
  }
 }
 
-
-//
-//
-struct line_vertex
+// Whether a line from y0 to y1 can plot to a framebuffer row in the context's BandMask.
+template<bool die>
+static INLINE bool LineInBands(const draw_context* ctx, int32 y0, int32 y1)
 {
- int32 x, y;
- uint16 g;
- int32 t;
-};
+ // Antialiasing pixels are only added where the line steps to another row, on the row before or after the step,
+ // so they stay between the end points too.
+ int32 ymin = std::min<int32>(y0, y1);
+ int32 ymax = std::max<int32>(y0, y1);
+
+ if(die)
+ {
+  ymin >>= 1;
+  ymax >>= 1;
+ }
+
+ if((ymax - ymin) >= 0xF8)
+  return ctx->BandMask != 0;
+
+ const unsigned r0 = ymin & 0xFF;
+ const unsigned r1 = ymax & 0xFF;
+ const uint32 m0 = ~0U << (r0 >> 3);
+ const uint32 m1 = ~0U >> (31 - (r1 >> 3));
+
+ return (ctx->BandMask & ((r0 <= r1) ? (m0 & m1) : (m0 | m1))) != 0;
+}
 
-struct line_data
-{
- line_vertex p[2];
- bool PCD;
- bool HSS;
- uint16 color;
- int32 ec_count;
- uint32 (MDFN_FASTCALL *tffn)(uint32);
- uint16 CLUT[0x10];
- uint32 cb_or;
- uint32 tex_base;
-};
 
-extern line_data LineSetup;
 
-template<bool AA, bool die, unsigned bpp8, bool MSBOn, bool UserClipEn, bool UserClipMode, bool MeshEn, bool ECD, bool SPD, bool Textured, bool GouraudEn, bool HalfFGEn, bool HalfBGEn>
-static int32 DrawLine(void)
+//
+// CostOnly only steps through the line for the cycle count it returns, and is used for lines that don't reach a
+// row in BandMask.  Everything that doesn't affect the count is turned off for it, but texels are still fetched
+// when end codes can cut the line short.
+//
+template<bool AA, bool die, unsigned bpp8, bool MSBOn, bool UserClipEn, bool UserClipMode, bool MeshEn, bool ECD, bool SPD, bool Textured, bool GouraudEn, bool HalfFGEn, bool HalfBGEn, bool CostOnly = false>
+static int32 DrawLine(draw_context* ctx)
 {
+ line_data& LineSetup = ctx->LineSetup;
+ const draw_regs& r = ctx->r;
  const uint16 color = LineSetup.color;
  line_vertex p0 = LineSetup.p[0];
  line_vertex p1 = LineSetup.p[1];
  int32 ret = 0;
 
+ if(!CostOnly && !LineInBands<die>(ctx, p0.y, p1.y))
+ {
+  if(ctx->SkipLines)
+   return ret;
+
+  return DrawLine<AA, false, 0, false, UserClipEn, UserClipMode, false, false, false, Textured && !ECD, false, false, MSBOn || HalfBGEn, true>(ctx);
+ }
+
  if(!LineSetup.PCD)
  {
   // TODO:
@@ -368,33 +423,33 @@ static int32 DrawLine(void)
   {
    if(UserClipMode)
    {
-    // not correct: clipped |= (p0.x >= UserClipX0) & (p1.x <= UserClipX1) & (p0.y >= UserClipY0) & (p1.y <= UserClipY1);
+    // not correct: clipped |= (p0.x >= r.UserClipX0) & (p1.x <= r.UserClipX1) & (p0.y >= r.UserClipY0) & (p1.y <= r.UserClipY1);
     clipped |= (p0.x < 0) & (p1.x < 0);
-    clipped |= (p0.x > SysClipX) & (p1.x > SysClipX);
+    clipped |= (p0.x > r.SysClipX) & (p1.x > r.SysClipX);
     clipped |= (p0.y < 0) & (p1.y < 0);
-    clipped |= (p0.y > SysClipY) & (p1.y > SysClipY);
+    clipped |= (p0.y > r.SysClipY) & (p1.y > r.SysClipY);
 
-    swapped = (p0.y == p1.y) & ((p0.x < 0) | (p0.x > SysClipX));
+    swapped = (p0.y == p1.y) & ((p0.x < 0) | (p0.x > r.SysClipX));
    }
    else
    {
     // Ignore system clipping WRT pre-clip for UserClipEn == 1 && UserClipMode == 0
-    clipped |= (p0.x < UserClipX0) & (p1.x < UserClipX0);
-    clipped |= (p0.x > UserClipX1) & (p1.x > UserClipX1);
-    clipped |= (p0.y < UserClipY0) & (p1.y < UserClipY0);
-    clipped |= (p0.y > UserClipY1) & (p1.y > UserClipY1);
+    clipped |= (p0.x < r.UserClipX0) & (p1.x < r.UserClipX0);
+    clipped |= (p0.x > r.UserClipX1) & (p1.x > r.UserClipX1);
+    clipped |= (p0.y < r.UserClipY0) & (p1.y < r.UserClipY0);
+    clipped |= (p0.y > r.UserClipY1) & (p1.y > r.UserClipY1);
 
-    swapped = (p0.y == p1.y) & ((p0.x < UserClipX0) | (p0.x > UserClipX1));
+    swapped = (p0.y == p1.y) & ((p0.x < r.UserClipX0) | (p0.x > r.UserClipX1));
    }
   }
   else
   {
    clipped |= (p0.x < 0) & (p1.x < 0);
-   clipped |= (p0.x > SysClipX) & (p1.x > SysClipX);
+   clipped |= (p0.x > r.SysClipX) & (p1.x > r.SysClipX);
    clipped |= (p0.y < 0) & (p1.y < 0);
-   clipped |= (p0.y > SysClipY) & (p1.y > SysClipY);
+   clipped |= (p0.y > r.SysClipY) & (p1.y > r.SysClipY);
 
-   swapped = (p0.y == p1.y) & ((p0.x < 0) | (p0.x > SysClipX));
+   swapped = (p0.y == p1.y) & ((p0.x < 0) | (p0.x > r.SysClipX));
   }
 
   if(clipped)
@@ -432,12 +487,12 @@ static int32 DrawLine(void)
   if(MDFN_UNLIKELY(max_adx_ady < abs(p1.t - p0.t) && LineSetup.HSS))
   {
    LineSetup.ec_count = 0x7FFFFFFF;
-   t.Setup(max_adx_ady + 1, p0.t >> 1, p1.t >> 1, 2, (bool)(FBCR & FBCR_EOS));
+   t.Setup(max_adx_ady + 1, p0.t >> 1, p1.t >> 1, 2, (bool)(r.FBCR & FBCR_EOS));
   }
   else
    t.Setup(max_adx_ady + 1, p0.t, p1.t);
 
-  texel = LineSetup.tffn(t.Current());
+  texel = LineSetup.tffn(&LineSetup, t.Current());
  }
 
  #define PSTART							\
@@ -453,7 +508,7 @@ static int32 DrawLine(void)
 								\
 	  /*ret += (bool)t.IncPending();*/				\
 								\
-	  texel = LineSetup.tffn(tx);				\
+	  texel = LineSetup.tffn(&LineSetup, tx);				\
 								\
 	  if(!ECD && MDFN_UNLIKELY(LineSetup.ec_count <= 0))	\
 	   return ret;						\
@@ -472,10 +527,10 @@ static int32 DrawLine(void)
  /* hmm, possible problem with AA and drawn_ac...*/
  #define PBODY(px, py)											\
 	{												\
-	 bool clipped = ((uint32)px > (uint32)SysClipX) | ((uint32)py > (uint32)SysClipY);		\
+	 bool clipped = ((uint32)px > (uint32)r.SysClipX) | ((uint32)py > (uint32)r.SysClipY);		\
 													\
 	 if(UserClipEn && !UserClipMode)								\
-	  clipped |= (px < UserClipX0) | (px > UserClipX1) | (py < UserClipY0) | (py > UserClipY1);	\
+	  clipped |= (px < r.UserClipX0) | (px > r.UserClipX1) | (py < r.UserClipY0) | (py > r.UserClipY1);	\
 													\
 	 if(MDFN_UNLIKELY((clipped ^ drawn_ac) & clipped))						\
 	  return ret;											\
@@ -483,9 +538,12 @@ static int32 DrawLine(void)
 	 drawn_ac &= clipped;										\
 													\
 	 if(UserClipEn && UserClipMode)									\
-	  clipped |= (px >= UserClipX0) & (px <= UserClipX1) & (py >= UserClipY0) & (py <= UserClipY1);	\
+	  clipped |= (px >= r.UserClipX0) & (px <= r.UserClipX1) & (py >= r.UserClipY0) & (py <= r.UserClipY1);	\
 													\
-	 ret += PlotPixel<die, bpp8, MSBOn, UserClipEn, UserClipMode, MeshEn, HalfFGEn, HalfBGEn>(px, py, pix, transparent | clipped, (GouraudEn ? &g : NULL));	\
+	 if(CostOnly)											\
+	  ret += (MSBOn || HalfBGEn) ? 6 : 1;								\
+	 else												\
+	  ret += PlotPixel<die, bpp8, MSBOn, UserClipEn, UserClipMode, MeshEn, HalfFGEn, HalfBGEn>(ctx, px, py, pix, transparent | clipped, (GouraudEn ? &g : NULL));	\
 	}
 
  #define PEND						\
@@ -29,7 +29,7 @@ namespace MDFN_IEN_SS
 namespace VDP1
 {
 
-static int32 (*LineFuncTab[2][3][0x20][8 + 1])(void) =
+static int32 (*LineFuncTab[2][3][0x20][8 + 1])(draw_context*) =
 {
  #define LINEFN_BC(die, bpp8, b, c)	\
 	DrawLine<false, die, bpp8, c == 0x8, (bool)(b & 0x10), (b & 0x10) && (b & 0x08), (bool)(b & 0x04), false/*b & 0x02*/, (bool)(b & 0x01), false, (bool)(c & 0x4), (bool)(c & 0x2), (bool)(c & 0x1)>
@@ -72,8 +72,10 @@ static int32 (*LineFuncTab[2][3][0x20][8 + 1])(void) =
 };
 
 template<unsigned num_lines>
-static INLINE int32 CMD_Line_Polyline_T(const uint16* cmd_data)
+static INLINE int32 CMD_Line_Polyline_T(draw_context* ctx, const uint16* cmd_data)
 {
+ line_data& LineSetup = ctx->LineSetup;
+ const draw_regs& r = ctx->r;
  const uint16 mode = cmd_data[0x2];
  int32 ret = 0;
  //
@@ -85,20 +87,20 @@ static INLINE int32 CMD_Line_Polyline_T(const uint16* cmd_data)
  LineSetup.PCD = mode & 0x800;
 
  if(((mode >> 3) & 0x7) < 0x6)
-  SPD_Opaque = (int32)(TexFetchTab[(mode >> 3) & 0x1F](0xFFFFFFFF)) >= 0;
+  SPD_Opaque = (int32)(TexFetchTab[(mode >> 3) & 0x1F](&LineSetup, 0xFFFFFFFF)) >= 0;
  //
  //
  //
- auto* fnptr = LineFuncTab[(bool)(FBCR & FBCR_DIE)][(TVMR & TVMR_8BPP) ? ((TVMR & TVMR_ROTATE) ? 2 : 1) : 0][((mode >> 6) & 0x1E) | SPD_Opaque /*(mode >> 6) & 0x1F*/][(mode & 0x8000) ? 8 : (mode & 0x7)];
+ auto* fnptr = LineFuncTab[(bool)(r.FBCR & FBCR_DIE)][(r.TVMR & TVMR_8BPP) ? ((r.TVMR & TVMR_ROTATE) ? 2 : 1) : 0][((mode >> 6) & 0x1E) | SPD_Opaque /*(mode >> 6) & 0x1F*/][(mode & 0x8000) ? 8 : (mode & 0x7)];
 
- CheckUndefClipping();
+ CheckUndefClipping(r);
 
  for(unsigned n = 0; n < num_lines; n++)
  {
-  LineSetup.p[0].x = sign_x_to_s32(13, cmd_data[0x6 + (((n << 1) + 0) & 0x7)] & 0x1FFF) + LocalX;
-  LineSetup.p[0].y = sign_x_to_s32(13, cmd_data[0x7 + (((n << 1) + 0) & 0x7)] & 0x1FFF) + LocalY;
-  LineSetup.p[1].x = sign_x_to_s32(13, cmd_data[0x6 + (((n << 1) + 2) & 0x7)] & 0x1FFF) + LocalX;
-  LineSetup.p[1].y = sign_x_to_s32(13, cmd_data[0x7 + (((n << 1) + 2) & 0x7)] & 0x1FFF) + LocalY;
+  LineSetup.p[0].x = sign_x_to_s32(13, cmd_data[0x6 + (((n << 1) + 0) & 0x7)] & 0x1FFF) + r.LocalX;
+  LineSetup.p[0].y = sign_x_to_s32(13, cmd_data[0x7 + (((n << 1) + 0) & 0x7)] & 0x1FFF) + r.LocalY;
+  LineSetup.p[1].x = sign_x_to_s32(13, cmd_data[0x6 + (((n << 1) + 2) & 0x7)] & 0x1FFF) + r.LocalX;
+  LineSetup.p[1].y = sign_x_to_s32(13, cmd_data[0x7 + (((n << 1) + 2) & 0x7)] & 0x1FFF) + r.LocalY;
 
   if(mode & 0x4) // Gouraud
   {
@@ -109,20 +111,20 @@ static INLINE int32 CMD_Line_Polyline_T(const uint16* cmd_data)
    LineSetup.p[1].g = gtb[(n + 1) & 0x3];
   }
 
-  ret += fnptr();
+  ret += fnptr(ctx);
  }
 
  return ret;
 }
 
-int32 CMD_Polyline(const uint16* cmd_data)
+int32 CMD_Polyline(draw_context* ctx, const uint16* cmd_data)
 {
- return CMD_Line_Polyline_T<4>(cmd_data);
+ return CMD_Line_Polyline_T<4>(ctx, cmd_data);
 }
 
-int32 CMD_Line(const uint16* cmd_data)
+int32 CMD_Line(draw_context* ctx, const uint16* cmd_data)
 {
- return CMD_Line_Polyline_T<1>(cmd_data);
+ return CMD_Line_Polyline_T<1>(ctx, cmd_data);
 }
 
 }
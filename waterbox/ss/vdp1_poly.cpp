@@ -29,7 +29,7 @@ namespace MDFN_IEN_SS
 namespace VDP1
 {
 
-static int32 (*LineFuncTab[2][3][0x20][8 + 1])(void) =
+static int32 (*LineFuncTab[2][3][0x20][8 + 1])(draw_context*) =
 {
  #define LINEFN_BC(die, bpp8, b, c)	\
 	DrawLine<true, die, bpp8, c == 0x8, (bool)(b & 0x10), (b & 0x10) && (b & 0x08), (bool)(b & 0x04), false/*b & 0x02*/, (bool)(b & 0x01), false, (bool)(c & 0x4), (bool)(c & 0x2), (bool)(c & 0x1)>
@@ -72,8 +72,10 @@ static int32 (*LineFuncTab[2][3][0x20][8 + 1])(void) =
 };
 
 template<bool gourauden>
-static INLINE int32 CMD_PolygonG_T(const uint16* cmd_data)
+static INLINE int32 CMD_PolygonG_T(draw_context* ctx, const uint16* cmd_data)
 {
+ line_data& LineSetup = ctx->LineSetup;
+ const draw_regs& r = ctx->r;
  const uint16 mode = cmd_data[0x2];
  line_vertex p[4];
  int32 ret = 0;
@@ -86,18 +88,18 @@ static INLINE int32 CMD_PolygonG_T(const uint16* cmd_data)
  LineSetup.PCD = mode & 0x800;
 
  if(((mode >> 3) & 0x7) < 0x6)
-  SPD_Opaque = (int32)(TexFetchTab[(mode >> 3) & 0x1F](0xFFFFFFFF)) >= 0;
+  SPD_Opaque = (int32)(TexFetchTab[(mode >> 3) & 0x1F](&LineSetup, 0xFFFFFFFF)) >= 0;
  //
  //
  //
- auto* fnptr = LineFuncTab[(bool)(FBCR & FBCR_DIE)][(TVMR & TVMR_8BPP) ? ((TVMR & TVMR_ROTATE) ? 2 : 1) : 0][((mode >> 6) & 0x1E) | SPD_Opaque /*(mode >> 6) & 0x1F*/][(mode & 0x8000) ? 8 : (mode & 0x7)];
+ auto* fnptr = LineFuncTab[(bool)(r.FBCR & FBCR_DIE)][(r.TVMR & TVMR_8BPP) ? ((r.TVMR & TVMR_ROTATE) ? 2 : 1) : 0][((mode >> 6) & 0x1E) | SPD_Opaque /*(mode >> 6) & 0x1F*/][(mode & 0x8000) ? 8 : (mode & 0x7)];
 
- CheckUndefClipping();
+ CheckUndefClipping(r);
 
  for(unsigned i = 0; i < 4; i++)
  {
-  p[i].x = sign_x_to_s32(13, cmd_data[0x6 + (i << 1)]) + LocalX;
-  p[i].y = sign_x_to_s32(13, cmd_data[0x7 + (i << 1)]) + LocalY;
+  p[i].x = sign_x_to_s32(13, cmd_data[0x6 + (i << 1)]) + r.LocalX;
+  p[i].y = sign_x_to_s32(13, cmd_data[0x7 + (i << 1)]) + r.LocalY;
  }
 
  if(gourauden)
@@ -124,7 +126,7 @@ static INLINE int32 CMD_PolygonG_T(const uint16* cmd_data)
   e[1].GetVertex(&LineSetup.p[1]);
   //
   //printf("%d:%d -> %d:%d\n", lp[0].x, lp[0].y, lp[1].x, lp[1].y);
-  ret += fnptr();
+  ret += fnptr(ctx);
   //
   e[0].Step();
   e[1].Step();
@@ -133,12 +135,12 @@ static INLINE int32 CMD_PolygonG_T(const uint16* cmd_data)
  return ret;
 }
 
-int32 CMD_Polygon(const uint16* cmd_data)
+int32 CMD_Polygon(draw_context* ctx, const uint16* cmd_data)
 {
  if(cmd_data[0x2] & 0x4) // gouraud
-  return CMD_PolygonG_T<true>(cmd_data);
+  return CMD_PolygonG_T<true>(ctx, cmd_data);
  else
-  return CMD_PolygonG_T<false>(cmd_data);
+  return CMD_PolygonG_T<false>(ctx, cmd_data);
 }
 
 
@@ -31,7 +31,7 @@ namespace MDFN_IEN_SS
 namespace VDP1
 {
 
-static int32 (*LineFuncTab[2][3][0x20][8 + 1])(void) =
+static int32 (*LineFuncTab[2][3][0x20][8 + 1])(draw_context*) =
 {
  #define LINEFN_BC(die, bpp8, b, c)	\
 	DrawLine<true, die, bpp8, c == 0x8, (bool)(b & 0x10), (b & 0x10) && (b & 0x08), (bool)(b & 0x04), (bool)(b & 0x02), (bool)(b & 0x01), true, (bool)(c & 0x4), (!bpp8) && (c & 0x2), (bool)(c & 0x1)>
@@ -89,8 +89,10 @@ enum
 };
 
 template<unsigned format, bool gourauden>
-static INLINE int32 SpriteBase(const uint16* cmd_data)
+static INLINE int32 SpriteBase(draw_context* ctx, const uint16* cmd_data)
 {
+ line_data& LineSetup = ctx->LineSetup;
+ const draw_regs& r = ctx->r;
  const unsigned dir = (cmd_data[0] >> 4) & 0x3;
  const uint16 mode = cmd_data[0x2];
  const unsigned cm = (mode >> 3) & 0x7;
@@ -99,28 +101,28 @@ static INLINE int32 SpriteBase(const uint16* cmd_data)
  const uint32 h = cmd_data[0x5] & 0xFF;
  line_vertex p[4];
  int32 ret = 0;
- auto* fnptr = LineFuncTab[(bool)(FBCR & FBCR_DIE)][(TVMR & TVMR_8BPP) ? ((TVMR & TVMR_ROTATE) ? 2 : 1) : 0][(mode >> 6) & 0x1F][(mode & 0x8000) ? 8 : (mode & 0x7)];
+ auto* fnptr = LineFuncTab[(bool)(r.FBCR & FBCR_DIE)][(r.TVMR & TVMR_8BPP) ? ((r.TVMR & TVMR_ROTATE) ? 2 : 1) : 0][(mode >> 6) & 0x1F][(mode & 0x8000) ? 8 : (mode & 0x7)];
 
  LineSetup.color = cmd_data[0x3];
  LineSetup.PCD = mode & 0x0800;
  LineSetup.HSS = mode & 0x1000;
 
- CheckUndefClipping();
+ CheckUndefClipping(r);
 
  // FIXME: precision is probably not totally right.
  if(format == FORMAT_DISTORTED)
  {
   for(unsigned i = 0; i < 4; i++)
   {
-   p[i].x = sign_x_to_s32(13, cmd_data[0x6 + (i << 1)]) + LocalX;
-   p[i].y = sign_x_to_s32(13, cmd_data[0x7 + (i << 1)]) + LocalY;
+   p[i].x = sign_x_to_s32(13, cmd_data[0x6 + (i << 1)]) + r.LocalX;
+   p[i].y = sign_x_to_s32(13, cmd_data[0x7 + (i << 1)]) + r.LocalY;
   }
   //printf("Hrm: %d:%d %d:%d %d:%d %d:%d\n", p[0].x, p[0].y, p[1].x, p[1].y, p[2].x, p[2].y, p[3].x, p[3].y);
  }
  else if(format == FORMAT_NORMAL)
  {
-  p[0].x = sign_x_to_s32(13, cmd_data[0x6]) + LocalX;
-  p[0].y = sign_x_to_s32(13, cmd_data[0x7]) + LocalY;
+  p[0].x = sign_x_to_s32(13, cmd_data[0x6]) + r.LocalX;
+  p[0].y = sign_x_to_s32(13, cmd_data[0x7]) + r.LocalY;
 
   p[1].x = p[0].x + (std::max<uint32>(w, 1) - 1);
   p[1].y = p[0].y;
@@ -200,8 +202,8 @@ static INLINE int32 SpriteBase(const uint16* cmd_data)
 
    for(unsigned i = 0; i < 4; i++)
    {
-    p[i].x += LocalX;
-    p[i].y += LocalY;
+    p[i].x += r.LocalX;
+    p[i].y += r.LocalY;
    }
   }
  }
@@ -280,7 +282,7 @@ static INLINE int32 SpriteBase(const uint16* cmd_data)
   LineSetup.tex_base = tex_base + big_t.PreStep();
   //
   //printf("%d:%d -> %d:%d\n", lp[0].x, lp[0].y, lp[1].x, lp[1].y);
-  ret += fnptr();
+  ret += fnptr(ctx);
   //
   e[0].Step();
   e[1].Step();
@@ -289,29 +291,29 @@ static INLINE int32 SpriteBase(const uint16* cmd_data)
  return ret;
 }
 
-int32 CMD_DistortedSprite(const uint16* cmd_data)
+int32 CMD_DistortedSprite(draw_context* ctx, const uint16* cmd_data)
 {
  if(cmd_data[0x2] & 0x4) // gouraud
-  return SpriteBase<FORMAT_DISTORTED, true>(cmd_data);
+  return SpriteBase<FORMAT_DISTORTED, true>(ctx, cmd_data);
  else
-  return SpriteBase<FORMAT_DISTORTED, false>(cmd_data);
+  return SpriteBase<FORMAT_DISTORTED, false>(ctx, cmd_data);
 }
 
 
-int32 CMD_NormalSprite(const uint16* cmd_data)
+int32 CMD_NormalSprite(draw_context* ctx, const uint16* cmd_data)
 {
  if(cmd_data[0x2] & 0x4) // gouraud
-  return SpriteBase<FORMAT_NORMAL, true>(cmd_data);
+  return SpriteBase<FORMAT_NORMAL, true>(ctx, cmd_data);
  else
-  return SpriteBase<FORMAT_NORMAL, false>(cmd_data);
+  return SpriteBase<FORMAT_NORMAL, false>(ctx, cmd_data);
 }
 
-int32 CMD_ScaledSprite(const uint16* cmd_data)
+int32 CMD_ScaledSprite(draw_context* ctx, const uint16* cmd_data)
 {
  if(cmd_data[0x2] & 0x4) // gouraud
-  return SpriteBase<FORMAT_SCALED, true>(cmd_data);
+  return SpriteBase<FORMAT_SCALED, true>(ctx, cmd_data);
  else
-  return SpriteBase<FORMAT_SCALED, false>(cmd_data);
+  return SpriteBase<FORMAT_SCALED, false>(ctx, cmd_data);
 }
 
 
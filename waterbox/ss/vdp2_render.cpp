@@ -3215,9 +3215,28 @@ enum
  COMMAND_EXIT
 };
 
+//
+// Between VDP2REND_StartFrame() and VDP2REND_EndFrame(), commands are passed through a single producer, single consumer
+// ring buffer to the render thread, which is waterbox worker SS_WORKER_VDP2REND.  The worker must be done before the core
+// returns to the host, so VDP2REND_EndFrame() waits for it; outside of a frame, or with no worker, commands are executed
+// inline.
+//
+struct WQ_Entry
+{
+ uint16 Command;
+ uint16 Arg16;
+ uint32 Arg32;
+};
+
+static std::array<WQ_Entry, 0x400> WQ;
+static size_t WQ_ReadPos, WQ_WritePos;
+static std::atomic_int_least32_t WQ_InCount;
+static std::atomic_bool RThreadSleeping;
+static bool RThreadRunning;
+
 static int32 LastDrawnLine;
 
-static INLINE void WWQ(uint16 command, uint32 arg32 = 0, uint16 arg16 = 0)
+static INLINE void ExecuteCommand(uint16 command, uint32 arg32, uint16 arg16)
 {
   switch(command)
   {
@@ -3246,6 +3265,64 @@ static INLINE void WWQ(uint16 command, uint32 arg32 = 0, uint16 arg16 = 0)
   }
 }
 
+static void RThreadEntry(void* data)
+{
+ for(;;)
+ {
+  // Spin a little before sleeping, as the next line usually isn't far off.
+  for(unsigned spin = 0; MDFN_UNLIKELY(WQ_InCount.load(std::memory_order_acquire) == 0); spin++)
+  {
+   if(spin < 1024)
+    continue;
+
+   RThreadSleeping.store(true);
+   if(WQ_InCount.load() == 0)
+    worker_wait(SS_WORKER_VDP2REND);
+   RThreadSleeping.store(false, std::memory_order_relaxed);
+  }
+
+  const WQ_Entry e = WQ[WQ_ReadPos];
+
+  if(e.Command != COMMAND_EXIT)
+   ExecuteCommand(e.Command, e.Arg32, e.Arg16);
+
+  WQ_ReadPos = (WQ_ReadPos + 1) & (WQ.size() - 1);
+  WQ_InCount.fetch_sub(1, std::memory_order_release);
+
+  if(e.Command == COMMAND_EXIT)
+   return;
+ }
+}
+
+static INLINE void WWQ(uint16 command, uint32 arg32 = 0, uint16 arg16 = 0)
+{
+ if(!RThreadRunning)
+ {
+  ExecuteCommand(command, arg32, arg16);
+  return;
+ }
+
+ while(MDFN_UNLIKELY(WQ_InCount.load(std::memory_order_acquire) == (int32)WQ.size()))
+ {
+  if(RThreadSleeping.load())
+   worker_signal(SS_WORKER_VDP2REND);
+ }
+
+ WQ_Entry* e = &WQ[WQ_WritePos];
+ e->Command = command;
+ e->Arg16 = arg16;
+ e->Arg32 = arg32;
+ WQ_WritePos = (WQ_WritePos + 1) & (WQ.size() - 1);
+ WQ_InCount.fetch_add(1);
+
+ // Writes can wait for the next line to wake the thread up.
+ if(command == COMMAND_DRAW_LINE || command == COMMAND_EXIT)
+ {
+  if(RThreadSleeping.load())
+   worker_signal(SS_WORKER_VDP2REND);
+ }
+}
+
 
 //
 //
@@ -3258,6 +3335,11 @@ void VDP2REND_Init(const bool IsPAL)
  VisibleLines = PAL ? 288 : 240;
  //
  UserLayerEnableMask = ~0U;
+ //
+ WQ_ReadPos = WQ_WritePos = 0;
+ WQ_InCount.store(0);
+ RThreadSleeping.store(false);
+ RThreadRunning = false;
 }
 
 void VDP2REND_StartFrame(EmulateSpecStruct* espec_arg, const bool clock28m, const int SurfInterlaceField)
@@ -3279,10 +3361,19 @@ void VDP2REND_StartFrame(EmulateSpecStruct* espec_arg, const bool clock28m, cons
  espec->x = (ShowHOverscan ? 0 : 10);
  espec->y = LineVisFirst << espec->InterlaceOn;
  espec->h = (LineVisLast + 1 - LineVisFirst) << espec->InterlaceOn;
+
+ RThreadRunning = worker_start(SS_WORKER_VDP2REND, RThreadEntry, NULL) != 0;
 }
 
 void VDP2REND_EndFrame(void)
 {
+ if(RThreadRunning)
+ {
+  WWQ(COMMAND_EXIT);
+  worker_join(SS_WORKER_VDP2REND);
+  RThreadRunning = false;
+ }
+
  if(OutLineCounter < VisibleLines)
  {
   //printf("OutLineCounter(%d) < VisibleLines(%d)\n", OutLineCounter, VisibleLines);
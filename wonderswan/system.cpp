@@ -19,10 +19,13 @@
 */
 
 #include "system.h"
+#include "../corebatch/corebatch.h"
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
 #include <cstdarg>
+#include <atomic>
+#include <vector>
 
 #define EXPORT extern "C" __declspec(dllexport)
 
@@ -330,6 +333,7 @@ namespace MDFN_IEN_WSWAN
 
 	EXPORT int bizswan_load(System *s, const uint8 *data, int length, const SyncSettings *settings, int *IsRotated)
 	{
+		s->stateLayout.Invalidate();
 		bool ret = s->Load(data, length, *settings);
 		*IsRotated = s->rotate;
 		return ret;
@@ -367,13 +371,18 @@ namespace MDFN_IEN_WSWAN
 
 	EXPORT int bizswan_binstatesize(System *s)
 	{
-		NewStateDummy dummy;
-		s->SyncState<false>(&dummy);
-		return dummy.GetLength();
+		if (!s->stateLayout.IsValid())
+			s->stateLayout.Build(s);
+		return s->stateLayout.GetLength();
 	}
 
 	EXPORT int bizswan_binstatesave(System *s, char *data, int length)
 	{
+		if (!s->stateLayout.IsValid())
+			s->stateLayout.Build(s);
+		if (s->stateLayout.IsReplayable())
+			return s->stateLayout.SaveTo(data, length);
+
 		NewStateExternalBuffer saver(data, length);
 		s->SyncState<false>(&saver);
 		return !saver.Overflow() && saver.GetLength() == length;
@@ -386,6 +395,77 @@ namespace MDFN_IEN_WSWAN
 		return !loader.Overflow() && loader.GetLength() == length;
 	}
 
+		// runs batches of systems on a CoreBatch.  the systems don't share anything, so each one is run start to finish by
+	// whichever thread picks it up
+	class Batch
+	{
+	public:
+		Batch(int threads)
+			:pool(threads), scratch(pool.Threads())
+		{
+		}
+
+		// advances each of count systems for frames frames, with buttons[i][f] as the input of system i on frame f, and then
+		// hashes its savestate into hashes[i].  no video is rendered.  returns false if any state couldn't be saved; its hash is 0
+		bool Advance(System **systems, int count, const uint32 *const *buttons, int frames, uint64 *hashes)
+		{
+			std::atomic<bool> ok(true);
+			pool.Run(count, [&](int i, int thread)
+			{
+				Scratch &sc = scratch[thread];
+				System *s = systems[i];
+				for (int f = 0; f < frames; f++)
+				{
+					int soundbuffsize = sc.soundbuff.size();
+					s->Advance(buttons[i][f], true, nullptr, &sc.soundbuff[0], soundbuffsize);
+				}
+
+				sc.state.resize(bizswan_binstatesize(s));
+				if (bizswan_binstatesave(s, &sc.state[0], sc.state.size()))
+				{
+					hashes[i] = CoreBatch::Hash(&sc.state[0], sc.state.size());
+				}
+				else
+				{
+					hashes[i] = 0;
+					ok = false;
+				}
+			});
+			return ok;
+		}
+
+	private:
+		// each thread's buffers, kept from one batch to the next
+		struct Scratch
+		{
+			std::vector<int16> soundbuff;
+			std::vector<char> state;
+			Scratch()
+				:soundbuff(1536)
+			{
+			}
+		};
+
+		CoreBatch pool;
+		std::vector<Scratch> scratch;
+	};
+
+// threads is the number of threads to run batches on, counting the caller; 0 for one per core
+	EXPORT Batch *bizswan_batchnew(int threads)
+	{
+		return new Batch(threads);
+	}
+
+	EXPORT int bizswan_batchadvance(Batch *b, System **systems, int count, const uint32 *const *buttons, int frames, uint64 *hashes)
+	{
+		return b->Advance(systems, count, buttons, frames, hashes);
+	}
+
+	EXPORT void bizswan_batchdelete(Batch *b)
+	{
+		delete b;
+	}
+
 	EXPORT void bizswan_txtstatesave(System *s, FPtrs *ff)
 	{
 		NewStateExternalFunctions saver(ff);
@@ -58,6 +58,8 @@ public:
 	uint32 oldbuttons;
 
 	template<bool isReader>void SyncState(NewState *ns);
+
+	NewStateLayout stateLayout; // cached for bizswan_binstatesize/bizswan_binstatesave
 };
 
 struct SyncSettings